@@ -41,6 +41,7 @@ THE SOFTWARE.
 #ifndef _MPU6050_H_
 #define _MPU6050_H_
 
+#include <linux/bitmap.h>
 #include "i2c.h"
 
 #if ((defined MPU6050_INCLUDE_DMP_MOTIONAPPS20) || (defined MPU6050_INCLUDE_DMP_MOTIONAPPS41))
@@ -428,378 +429,429 @@ THE SOFTWARE.
 #define MPU6050_DMP_MEMORY_BANK_SIZE    256
 #define MPU6050_DMP_MEMORY_CHUNK_SIZE   16
 
-// note: DMP code memory blocks defined at end of header file
+// ACCEL_XOUT_H..GYRO_ZOUT_L burst (accel, temp and gyro)
+#define MPU6050_MOTION7_LENGTH          14
 
-// CUSTOM
-int MPU6050_init(struct platform_device * i2c_plat_dev);
-void MPU6050_deinit(void);
+#define MPU6050_FIFO_SIZE               1024
+
+// Registers with a write-through copy in memory (see MPU6050_isShadowed()). The
+// data, FIFO and status registers in between, and WHO_AM_I, are always read from the bus.
+#define MPU6050_SHADOW_FIRST            0x0D
+#define MPU6050_SHADOW_LAST             0x75
+#define MPU6050_SHADOW_SIZE             (MPU6050_SHADOW_LAST - MPU6050_SHADOW_FIRST + 1)
+
+// Time the registers need to come back after a device reset
+#define MPU6050_RESET_DELAY_MS          100
+
+// Longest burst written by writeRegisters(), register address not included
+#define MPU6050_WRITE_BURST_MAX         128
+// Shadowed registers that writeRegisterList() rewrites to join two bursts
+#define MPU6050_WRITE_BURST_MAX_GAP     4
+
+// note: DMP code memory blocks defined at end of header file
 
+// One MPU6050 on the bus. Every function of the library takes the one it works on.
 typedef struct MPU6050_t {
+    struct i2c_bus *bus;
     uint8_t devAddr;
     uint8_t buffer[14];
+    uint8_t shadow[MPU6050_SHADOW_SIZE];        // Last value written to / read from each register
+    bool shadowValid[MPU6050_SHADOW_SIZE];
 } MPU6050_t;
 
-void MPU6050(uint8_t address);
+// One entry of a sparse register configuration, see writeRegisterList()
+typedef struct MPU6050_regval_t {
+    uint8_t regAddr;
+    uint8_t value;
+} MPU6050_regval_t;
+
+// Sample rate, filter and full scales (SMPLRT_DIV..ACCEL_CONFIG), see setProfile()
+typedef struct MPU6050_profile_t {
+    uint8_t rate;           // SMPLRT_DIV
+    uint8_t dlpfMode;       // MPU6050_DLPF_BW_*
+    uint8_t gyroRange;      // MPU6050_GYRO_FS_*
+    uint8_t accelRange;     // MPU6050_ACCEL_FS_*
+} MPU6050_profile_t;
+
+// CUSTOM
+int MPU6050_init(MPU6050_t *dev, struct i2c_bus *bus, uint8_t address);
+void MPU6050_deinit(MPU6050_t *dev);
+
+void MPU6050(MPU6050_t *dev, struct i2c_bus *bus, uint8_t address);
+
+void MPU6050_initialize(MPU6050_t *dev);
+bool MPU6050_testConnection(MPU6050_t *dev);
+
+// Register shadow
+bool MPU6050_isShadowed(uint8_t regAddr);
+void MPU6050_invalidateShadow(MPU6050_t *dev);
+int MPU6050_resyncShadow(MPU6050_t *dev);
 
-void MPU6050_initialize(void);
-bool MPU6050_testConnection(void);
+// Burst configuration
+int MPU6050_writeRegisters(MPU6050_t *dev, uint8_t regAddr, uint8_t length, const uint8_t *data);
+int MPU6050_writeRegisterList(MPU6050_t *dev, const MPU6050_regval_t *list, uint8_t count);
+int MPU6050_setProfile(MPU6050_t *dev, const MPU6050_profile_t *profile);
 
 // AUX_VDDIO register
-uint8_t MPU6050_getAuxVDDIOLevel(void);
-void MPU6050_setAuxVDDIOLevel(uint8_t level);
+uint8_t MPU6050_getAuxVDDIOLevel(MPU6050_t *dev);
+void MPU6050_setAuxVDDIOLevel(MPU6050_t *dev, uint8_t level);
 
 // SMPLRT_DIV register
-uint8_t MPU6050_getRate(void);
-void MPU6050_setRate(uint8_t rate);
+uint8_t MPU6050_getRate(MPU6050_t *dev);
+void MPU6050_setRate(MPU6050_t *dev, uint8_t rate);
 
 // CONFIG register
-uint8_t MPU6050_getExternalFrameSync(void);
-void MPU6050_setExternalFrameSync(uint8_t sync);
-uint8_t MPU6050_getDLPFMode(void);
-void MPU6050_setDLPFMode(uint8_t bandwidth);
+uint8_t MPU6050_getExternalFrameSync(MPU6050_t *dev);
+void MPU6050_setExternalFrameSync(MPU6050_t *dev, uint8_t sync);
+uint8_t MPU6050_getDLPFMode(MPU6050_t *dev);
+void MPU6050_setDLPFMode(MPU6050_t *dev, uint8_t bandwidth);
 
 // GYRO_CONFIG register
-uint8_t MPU6050_getFullScaleGyroRange(void);
-void MPU6050_setFullScaleGyroRange(uint8_t range);
+uint8_t MPU6050_getFullScaleGyroRange(MPU6050_t *dev);
+void MPU6050_setFullScaleGyroRange(MPU6050_t *dev, uint8_t range);
 
 // ACCEL_CONFIG register
-bool MPU6050_getAccelXSelfTest(void);
-void MPU6050_setAccelXSelfTest(bool enabled);
-bool MPU6050_getAccelYSelfTest(void);
-void MPU6050_setAccelYSelfTest(bool enabled);
-bool MPU6050_getAccelZSelfTest(void);
-void MPU6050_setAccelZSelfTest(bool enabled);
-uint8_t MPU6050_getFullScaleAccelRange(void);
-void MPU6050_setFullScaleAccelRange(uint8_t range);
-uint8_t MPU6050_getDHPFMode(void);
-void MPU6050_setDHPFMode(uint8_t mode);
+bool MPU6050_getAccelXSelfTest(MPU6050_t *dev);
+void MPU6050_setAccelXSelfTest(MPU6050_t *dev, bool enabled);
+bool MPU6050_getAccelYSelfTest(MPU6050_t *dev);
+void MPU6050_setAccelYSelfTest(MPU6050_t *dev, bool enabled);
+bool MPU6050_getAccelZSelfTest(MPU6050_t *dev);
+void MPU6050_setAccelZSelfTest(MPU6050_t *dev, bool enabled);
+uint8_t MPU6050_getFullScaleAccelRange(MPU6050_t *dev);
+void MPU6050_setFullScaleAccelRange(MPU6050_t *dev, uint8_t range);
+uint8_t MPU6050_getDHPFMode(MPU6050_t *dev);
+void MPU6050_setDHPFMode(MPU6050_t *dev, uint8_t mode);
 
 // FF_THR register
-uint8_t MPU6050_getFreefallDetectionThreshold(void);
-void MPU6050_setFreefallDetectionThreshold(uint8_t threshold);
+uint8_t MPU6050_getFreefallDetectionThreshold(MPU6050_t *dev);
+void MPU6050_setFreefallDetectionThreshold(MPU6050_t *dev, uint8_t threshold);
 
 // FF_DUR register
-uint8_t MPU6050_getFreefallDetectionDuration(void);
-void MPU6050_setFreefallDetectionDuration(uint8_t duration);
+uint8_t MPU6050_getFreefallDetectionDuration(MPU6050_t *dev);
+void MPU6050_setFreefallDetectionDuration(MPU6050_t *dev, uint8_t duration);
 
 // MOT_THR register
-uint8_t MPU6050_getMotionDetectionThreshold(void);
-void MPU6050_setMotionDetectionThreshold(uint8_t threshold);
+uint8_t MPU6050_getMotionDetectionThreshold(MPU6050_t *dev);
+void MPU6050_setMotionDetectionThreshold(MPU6050_t *dev, uint8_t threshold);
 
 // MOT_DUR register
-uint8_t MPU6050_getMotionDetectionDuration(void);
-void MPU6050_setMotionDetectionDuration(uint8_t duration);
+uint8_t MPU6050_getMotionDetectionDuration(MPU6050_t *dev);
+void MPU6050_setMotionDetectionDuration(MPU6050_t *dev, uint8_t duration);
 
 // ZRMOT_THR register
-uint8_t MPU6050_getZeroMotionDetectionThreshold(void);
-void MPU6050_setZeroMotionDetectionThreshold(uint8_t threshold);
+uint8_t MPU6050_getZeroMotionDetectionThreshold(MPU6050_t *dev);
+void MPU6050_setZeroMotionDetectionThreshold(MPU6050_t *dev, uint8_t threshold);
 
 // ZRMOT_DUR register
-uint8_t MPU6050_getZeroMotionDetectionDuration(void);
-void MPU6050_setZeroMotionDetectionDuration(uint8_t duration);
+uint8_t MPU6050_getZeroMotionDetectionDuration(MPU6050_t *dev);
+void MPU6050_setZeroMotionDetectionDuration(MPU6050_t *dev, uint8_t duration);
 
 // FIFO_EN register
-bool MPU6050_getTempFIFOEnabled(void);
-void MPU6050_setTempFIFOEnabled(bool enabled);
-bool MPU6050_getXGyroFIFOEnabled(void);
-void MPU6050_setXGyroFIFOEnabled(bool enabled);
-bool MPU6050_getYGyroFIFOEnabled(void);
-void MPU6050_setYGyroFIFOEnabled(bool enabled);
-bool MPU6050_getZGyroFIFOEnabled(void);
-void MPU6050_setZGyroFIFOEnabled(bool enabled);
-bool MPU6050_getAccelFIFOEnabled(void);
-void MPU6050_setAccelFIFOEnabled(bool enabled);
-bool MPU6050_getSlave2FIFOEnabled(void);
-void MPU6050_setSlave2FIFOEnabled(bool enabled);
-bool MPU6050_getSlave1FIFOEnabled(void);
-void MPU6050_setSlave1FIFOEnabled(bool enabled);
-bool MPU6050_getSlave0FIFOEnabled(void);
-void MPU6050_setSlave0FIFOEnabled(bool enabled);
+bool MPU6050_getTempFIFOEnabled(MPU6050_t *dev);
+void MPU6050_setTempFIFOEnabled(MPU6050_t *dev, bool enabled);
+bool MPU6050_getXGyroFIFOEnabled(MPU6050_t *dev);
+void MPU6050_setXGyroFIFOEnabled(MPU6050_t *dev, bool enabled);
+bool MPU6050_getYGyroFIFOEnabled(MPU6050_t *dev);
+void MPU6050_setYGyroFIFOEnabled(MPU6050_t *dev, bool enabled);
+bool MPU6050_getZGyroFIFOEnabled(MPU6050_t *dev);
+void MPU6050_setZGyroFIFOEnabled(MPU6050_t *dev, bool enabled);
+bool MPU6050_getAccelFIFOEnabled(MPU6050_t *dev);
+void MPU6050_setAccelFIFOEnabled(MPU6050_t *dev, bool enabled);
+bool MPU6050_getSlave2FIFOEnabled(MPU6050_t *dev);
+void MPU6050_setSlave2FIFOEnabled(MPU6050_t *dev, bool enabled);
+bool MPU6050_getSlave1FIFOEnabled(MPU6050_t *dev);
+void MPU6050_setSlave1FIFOEnabled(MPU6050_t *dev, bool enabled);
+bool MPU6050_getSlave0FIFOEnabled(MPU6050_t *dev);
+void MPU6050_setSlave0FIFOEnabled(MPU6050_t *dev, bool enabled);
 
 // I2C_MST_CTRL register
-bool MPU6050_getMultiMasterEnabled(void);
-void MPU6050_setMultiMasterEnabled(bool enabled);
-bool MPU6050_getWaitForExternalSensorEnabled(void);
-void MPU6050_setWaitForExternalSensorEnabled(bool enabled);
-bool MPU6050_getSlave3FIFOEnabled(void);
-void MPU6050_setSlave3FIFOEnabled(bool enabled);
-bool MPU6050_getSlaveReadWriteTransitionEnabled(void);
-void MPU6050_setSlaveReadWriteTransitionEnabled(bool enabled);
-uint8_t MPU6050_getMasterClockSpeed(void);
-void MPU6050_setMasterClockSpeed(uint8_t speed);
+bool MPU6050_getMultiMasterEnabled(MPU6050_t *dev);
+void MPU6050_setMultiMasterEnabled(MPU6050_t *dev, bool enabled);
+bool MPU6050_getWaitForExternalSensorEnabled(MPU6050_t *dev);
+void MPU6050_setWaitForExternalSensorEnabled(MPU6050_t *dev, bool enabled);
+bool MPU6050_getSlave3FIFOEnabled(MPU6050_t *dev);
+void MPU6050_setSlave3FIFOEnabled(MPU6050_t *dev, bool enabled);
+bool MPU6050_getSlaveReadWriteTransitionEnabled(MPU6050_t *dev);
+void MPU6050_setSlaveReadWriteTransitionEnabled(MPU6050_t *dev, bool enabled);
+uint8_t MPU6050_getMasterClockSpeed(MPU6050_t *dev);
+void MPU6050_setMasterClockSpeed(MPU6050_t *dev, uint8_t speed);
 
 // I2C_SLV* registers (Slave 0-3)
-uint8_t MPU6050_getSlaveAddress(uint8_t num);
-void MPU6050_setSlaveAddress(uint8_t num, uint8_t address);
-uint8_t MPU6050_getSlaveRegister(uint8_t num);
-void MPU6050_setSlaveRegister(uint8_t num, uint8_t reg);
-bool MPU6050_getSlaveEnabled(uint8_t num);
-void MPU6050_setSlaveEnabled(uint8_t num, bool enabled);
-bool MPU6050_getSlaveWordByteSwap(uint8_t num);
-void MPU6050_setSlaveWordByteSwap(uint8_t num, bool enabled);
-bool MPU6050_getSlaveWriteMode(uint8_t num);
-void MPU6050_setSlaveWriteMode(uint8_t num, bool mode);
-bool MPU6050_getSlaveWordGroupOffset(uint8_t num);
-void MPU6050_setSlaveWordGroupOffset(uint8_t num, bool enabled);
-uint8_t MPU6050_getSlaveDataLength(uint8_t num);
-void MPU6050_setSlaveDataLength(uint8_t num, uint8_t length);
+uint8_t MPU6050_getSlaveAddress(MPU6050_t *dev, uint8_t num);
+void MPU6050_setSlaveAddress(MPU6050_t *dev, uint8_t num, uint8_t address);
+uint8_t MPU6050_getSlaveRegister(MPU6050_t *dev, uint8_t num);
+void MPU6050_setSlaveRegister(MPU6050_t *dev, uint8_t num, uint8_t reg);
+bool MPU6050_getSlaveEnabled(MPU6050_t *dev, uint8_t num);
+void MPU6050_setSlaveEnabled(MPU6050_t *dev, uint8_t num, bool enabled);
+bool MPU6050_getSlaveWordByteSwap(MPU6050_t *dev, uint8_t num);
+void MPU6050_setSlaveWordByteSwap(MPU6050_t *dev, uint8_t num, bool enabled);
+bool MPU6050_getSlaveWriteMode(MPU6050_t *dev, uint8_t num);
+void MPU6050_setSlaveWriteMode(MPU6050_t *dev, uint8_t num, bool mode);
+bool MPU6050_getSlaveWordGroupOffset(MPU6050_t *dev, uint8_t num);
+void MPU6050_setSlaveWordGroupOffset(MPU6050_t *dev, uint8_t num, bool enabled);
+uint8_t MPU6050_getSlaveDataLength(MPU6050_t *dev, uint8_t num);
+void MPU6050_setSlaveDataLength(MPU6050_t *dev, uint8_t num, uint8_t length);
 
 // I2C_SLV* registers (Slave 4)
-uint8_t MPU6050_getSlave4Address(void);
-void MPU6050_setSlave4Address(uint8_t address);
-uint8_t MPU6050_getSlave4Register(void);
-void MPU6050_setSlave4Register(uint8_t reg);
-void MPU6050_setSlave4OutputByte(uint8_t data);
-bool MPU6050_getSlave4Enabled(void);
-void MPU6050_setSlave4Enabled(bool enabled);
-bool MPU6050_getSlave4InterruptEnabled(void);
-void MPU6050_setSlave4InterruptEnabled(bool enabled);
-bool MPU6050_getSlave4WriteMode(void);
-void MPU6050_setSlave4WriteMode(bool mode);
-uint8_t MPU6050_getSlave4MasterDelay(void);
-void MPU6050_setSlave4MasterDelay(uint8_t delay);
-uint8_t MPU6050_getSlate4InputByte(void);
+uint8_t MPU6050_getSlave4Address(MPU6050_t *dev);
+void MPU6050_setSlave4Address(MPU6050_t *dev, uint8_t address);
+uint8_t MPU6050_getSlave4Register(MPU6050_t *dev);
+void MPU6050_setSlave4Register(MPU6050_t *dev, uint8_t reg);
+void MPU6050_setSlave4OutputByte(MPU6050_t *dev, uint8_t data);
+bool MPU6050_getSlave4Enabled(MPU6050_t *dev);
+void MPU6050_setSlave4Enabled(MPU6050_t *dev, bool enabled);
+bool MPU6050_getSlave4InterruptEnabled(MPU6050_t *dev);
+void MPU6050_setSlave4InterruptEnabled(MPU6050_t *dev, bool enabled);
+bool MPU6050_getSlave4WriteMode(MPU6050_t *dev);
+void MPU6050_setSlave4WriteMode(MPU6050_t *dev, bool mode);
+uint8_t MPU6050_getSlave4MasterDelay(MPU6050_t *dev);
+void MPU6050_setSlave4MasterDelay(MPU6050_t *dev, uint8_t delay);
+uint8_t MPU6050_getSlate4InputByte(MPU6050_t *dev);
 
 // I2C_MST_STATUS register
-bool MPU6050_getPassthroughStatus(void);
-bool MPU6050_getSlave4IsDone(void);
-bool MPU6050_getLostArbitration(void);
-bool MPU6050_getSlave4Nack(void);
-bool MPU6050_getSlave3Nack(void);
-bool MPU6050_getSlave2Nack(void);
-bool MPU6050_getSlave1Nack(void);
-bool MPU6050_getSlave0Nack(void);
+bool MPU6050_getPassthroughStatus(MPU6050_t *dev);
+bool MPU6050_getSlave4IsDone(MPU6050_t *dev);
+bool MPU6050_getLostArbitration(MPU6050_t *dev);
+bool MPU6050_getSlave4Nack(MPU6050_t *dev);
+bool MPU6050_getSlave3Nack(MPU6050_t *dev);
+bool MPU6050_getSlave2Nack(MPU6050_t *dev);
+bool MPU6050_getSlave1Nack(MPU6050_t *dev);
+bool MPU6050_getSlave0Nack(MPU6050_t *dev);
 
 // INT_PIN_CFG register
-bool MPU6050_getInterruptMode(void);
-void MPU6050_setInterruptMode(bool mode);
-bool MPU6050_getInterruptDrive(void);
-void MPU6050_setInterruptDrive(bool drive);
-bool MPU6050_getInterruptLatch(void);
-void MPU6050_setInterruptLatch(bool latch);
-bool MPU6050_getInterruptLatchClear(void);
-void MPU6050_setInterruptLatchClear(bool clear);
-bool MPU6050_getFSyncInterruptLevel(void);
-void MPU6050_setFSyncInterruptLevel(bool level);
-bool MPU6050_getFSyncInterruptEnabled(void);
-void MPU6050_setFSyncInterruptEnabled(bool enabled);
-bool MPU6050_getI2CBypassEnabled(void);
-void MPU6050_setI2CBypassEnabled(bool enabled);
-bool MPU6050_getClockOutputEnabled(void);
-void MPU6050_setClockOutputEnabled(bool enabled);
+bool MPU6050_getInterruptMode(MPU6050_t *dev);
+void MPU6050_setInterruptMode(MPU6050_t *dev, bool mode);
+bool MPU6050_getInterruptDrive(MPU6050_t *dev);
+void MPU6050_setInterruptDrive(MPU6050_t *dev, bool drive);
+bool MPU6050_getInterruptLatch(MPU6050_t *dev);
+void MPU6050_setInterruptLatch(MPU6050_t *dev, bool latch);
+bool MPU6050_getInterruptLatchClear(MPU6050_t *dev);
+void MPU6050_setInterruptLatchClear(MPU6050_t *dev, bool clear);
+bool MPU6050_getFSyncInterruptLevel(MPU6050_t *dev);
+void MPU6050_setFSyncInterruptLevel(MPU6050_t *dev, bool level);
+bool MPU6050_getFSyncInterruptEnabled(MPU6050_t *dev);
+void MPU6050_setFSyncInterruptEnabled(MPU6050_t *dev, bool enabled);
+bool MPU6050_getI2CBypassEnabled(MPU6050_t *dev);
+void MPU6050_setI2CBypassEnabled(MPU6050_t *dev, bool enabled);
+bool MPU6050_getClockOutputEnabled(MPU6050_t *dev);
+void MPU6050_setClockOutputEnabled(MPU6050_t *dev, bool enabled);
 
 // INT_ENABLE register
-uint8_t MPU6050_getIntEnabled(void);
-void MPU6050_setIntEnabled(uint8_t enabled);
-bool MPU6050_getIntFreefallEnabled(void);
-void MPU6050_setIntFreefallEnabled(bool enabled);
-bool MPU6050_getIntMotionEnabled(void);
-void MPU6050_setIntMotionEnabled(bool enabled);
-bool MPU6050_getIntZeroMotionEnabled(void);
-void MPU6050_setIntZeroMotionEnabled(bool enabled);
-bool MPU6050_getIntFIFOBufferOverflowEnabled(void);
-void MPU6050_setIntFIFOBufferOverflowEnabled(bool enabled);
-bool MPU6050_getIntI2CMasterEnabled(void);
-void MPU6050_setIntI2CMasterEnabled(bool enabled);
-bool MPU6050_getIntDataReadyEnabled(void);
-void MPU6050_setIntDataReadyEnabled(bool enabled);
+uint8_t MPU6050_getIntEnabled(MPU6050_t *dev);
+void MPU6050_setIntEnabled(MPU6050_t *dev, uint8_t enabled);
+bool MPU6050_getIntFreefallEnabled(MPU6050_t *dev);
+void MPU6050_setIntFreefallEnabled(MPU6050_t *dev, bool enabled);
+bool MPU6050_getIntMotionEnabled(MPU6050_t *dev);
+void MPU6050_setIntMotionEnabled(MPU6050_t *dev, bool enabled);
+bool MPU6050_getIntZeroMotionEnabled(MPU6050_t *dev);
+void MPU6050_setIntZeroMotionEnabled(MPU6050_t *dev, bool enabled);
+bool MPU6050_getIntFIFOBufferOverflowEnabled(MPU6050_t *dev);
+void MPU6050_setIntFIFOBufferOverflowEnabled(MPU6050_t *dev, bool enabled);
+bool MPU6050_getIntI2CMasterEnabled(MPU6050_t *dev);
+void MPU6050_setIntI2CMasterEnabled(MPU6050_t *dev, bool enabled);
+bool MPU6050_getIntDataReadyEnabled(MPU6050_t *dev);
+void MPU6050_setIntDataReadyEnabled(MPU6050_t *dev, bool enabled);
 
 // INT_STATUS register
-uint8_t MPU6050_getIntStatus(void);
-bool MPU6050_getIntFreefallStatus(void);
-bool MPU6050_getIntMotionStatus(void);
-bool MPU6050_getIntZeroMotionStatus(void);
-bool MPU6050_getIntFIFOBufferOverflowStatus(void);
-bool MPU6050_getIntI2CMasterStatus(void);
-bool MPU6050_getIntDataReadyStatus(void);
+uint8_t MPU6050_getIntStatus(MPU6050_t *dev);
+bool MPU6050_getIntFreefallStatus(MPU6050_t *dev);
+bool MPU6050_getIntMotionStatus(MPU6050_t *dev);
+bool MPU6050_getIntZeroMotionStatus(MPU6050_t *dev);
+bool MPU6050_getIntFIFOBufferOverflowStatus(MPU6050_t *dev);
+bool MPU6050_getIntI2CMasterStatus(MPU6050_t *dev);
+bool MPU6050_getIntDataReadyStatus(MPU6050_t *dev);
 
 // ACCEL_*OUT_* registers
-void MPU6050_getMotion9(int16_t* ax, int16_t* ay, int16_t* az, int16_t* gx, int16_t* gy, int16_t* gz, int16_t* mx, int16_t* my, int16_t* mz);
-void MPU6050_getMotion6(uint16_t* ax, uint16_t* ay, uint16_t* az, uint16_t* gx, uint16_t* gy, uint16_t* gz);
-void MPU6050_getAcceleration(int16_t* x, int16_t* y, int16_t* z);
-int16_t MPU6050_getAccelerationX(void);
-int16_t MPU6050_getAccelerationY(void);
-int16_t MPU6050_getAccelerationZ(void);
+void MPU6050_getMotion9(MPU6050_t *dev, int16_t* ax, int16_t* ay, int16_t* az, int16_t* gx, int16_t* gy, int16_t* gz, int16_t* mx, int16_t* my, int16_t* mz);
+void MPU6050_getMotion6(MPU6050_t *dev, uint16_t* ax, uint16_t* ay, uint16_t* az, uint16_t* gx, uint16_t* gy, uint16_t* gz);
+int MPU6050_getMotion7(MPU6050_t *dev, uint8_t *data);
+int MPU6050_getMotion7Timestamp(MPU6050_t *dev, uint8_t *data, u64 *start_ns);
+int MPU6050_submitMotion7(MPU6050_t *dev, struct i2c_request *req, uint8_t *data,
+        void (*complete)(struct i2c_request *req), void *context);
+void MPU6050_getAcceleration(MPU6050_t *dev, int16_t* x, int16_t* y, int16_t* z);
+int16_t MPU6050_getAccelerationX(MPU6050_t *dev);
+int16_t MPU6050_getAccelerationY(MPU6050_t *dev);
+int16_t MPU6050_getAccelerationZ(MPU6050_t *dev);
 
 // TEMP_OUT_* registers
-uint16_t MPU6050_getTemperature(void);
+uint16_t MPU6050_getTemperature(MPU6050_t *dev);
 
 // GYRO_*OUT_* registers
-void MPU6050_getRotation(int16_t* x, int16_t* y, int16_t* z);
-int16_t MPU6050_getRotationX(void);
-int16_t MPU6050_getRotationY(void);
-int16_t MPU6050_getRotationZ(void);
+void MPU6050_getRotation(MPU6050_t *dev, int16_t* x, int16_t* y, int16_t* z);
+int16_t MPU6050_getRotationX(MPU6050_t *dev);
+int16_t MPU6050_getRotationY(MPU6050_t *dev);
+int16_t MPU6050_getRotationZ(MPU6050_t *dev);
 
 // EXT_SENS_DATA_* registers
-uint8_t MPU6050_getExternalSensorByte(int position);
-uint16_t MPU6050_getExternalSensorWord(int position);
-uint32_t getExternalSensorDWord(int position);
+uint8_t MPU6050_getExternalSensorByte(MPU6050_t *dev, int position);
+uint16_t MPU6050_getExternalSensorWord(MPU6050_t *dev, int position);
+uint32_t MPU6050_getExternalSensorDWord(MPU6050_t *dev, int position);
 
 // MOT_DETECT_STATUS register
-bool MPU6050_getXNegMotionDetected(void);
-bool MPU6050_getXPosMotionDetected(void);
-bool MPU6050_getYNegMotionDetected(void);
-bool MPU6050_getYPosMotionDetected(void);
-bool MPU6050_getZNegMotionDetected(void);
-bool MPU6050_getZPosMotionDetected(void);
-bool MPU6050_getZeroMotionDetected(void);
+bool MPU6050_getXNegMotionDetected(MPU6050_t *dev);
+bool MPU6050_getXPosMotionDetected(MPU6050_t *dev);
+bool MPU6050_getYNegMotionDetected(MPU6050_t *dev);
+bool MPU6050_getYPosMotionDetected(MPU6050_t *dev);
+bool MPU6050_getZNegMotionDetected(MPU6050_t *dev);
+bool MPU6050_getZPosMotionDetected(MPU6050_t *dev);
+bool MPU6050_getZeroMotionDetected(MPU6050_t *dev);
 
 // I2C_SLV*_DO register
-void MPU6050_setSlaveOutputByte(uint8_t num, uint8_t data);
+void MPU6050_setSlaveOutputByte(MPU6050_t *dev, uint8_t num, uint8_t data);
 
 // I2C_MST_DELAY_CTRL register
-bool MPU6050_getExternalShadowDelayEnabled(void);
-void MPU6050_setExternalShadowDelayEnabled(bool enabled);
-bool MPU6050_getSlaveDelayEnabled(uint8_t num);
-void MPU6050_setSlaveDelayEnabled(uint8_t num, bool enabled);
+bool MPU6050_getExternalShadowDelayEnabled(MPU6050_t *dev);
+void MPU6050_setExternalShadowDelayEnabled(MPU6050_t *dev, bool enabled);
+bool MPU6050_getSlaveDelayEnabled(MPU6050_t *dev, uint8_t num);
+void MPU6050_setSlaveDelayEnabled(MPU6050_t *dev, uint8_t num, bool enabled);
 
 // SIGNAL_PATH_RESET register
-void MPU6050_resetGyroscopePath(void);
-void MPU6050_resetAccelerometerPath(void);
-void MPU6050_resetTemperaturePath(void);
+void MPU6050_resetGyroscopePath(MPU6050_t *dev);
+void MPU6050_resetAccelerometerPath(MPU6050_t *dev);
+void MPU6050_resetTemperaturePath(MPU6050_t *dev);
 
 // MOT_DETECT_CTRL register
-uint8_t MPU6050_getAccelerometerPowerOnDelay(void);
-void MPU6050_setAccelerometerPowerOnDelay(uint8_t delay);
-uint8_t MPU6050_getFreefallDetectionCounterDecrement(void);
-void MPU6050_setFreefallDetectionCounterDecrement(uint8_t decrement);
-uint8_t MPU6050_getMotionDetectionCounterDecrement(void);
-void MPU6050_setMotionDetectionCounterDecrement(uint8_t decrement);
+uint8_t MPU6050_getAccelerometerPowerOnDelay(MPU6050_t *dev);
+void MPU6050_setAccelerometerPowerOnDelay(MPU6050_t *dev, uint8_t delay);
+uint8_t MPU6050_getFreefallDetectionCounterDecrement(MPU6050_t *dev);
+void MPU6050_setFreefallDetectionCounterDecrement(MPU6050_t *dev, uint8_t decrement);
+uint8_t MPU6050_getMotionDetectionCounterDecrement(MPU6050_t *dev);
+void MPU6050_setMotionDetectionCounterDecrement(MPU6050_t *dev, uint8_t decrement);
 
 // USER_CTRL register
-bool MPU6050_getFIFOEnabled(void);
-void MPU6050_setFIFOEnabled(bool enabled);
-bool MPU6050_getI2CMasterModeEnabled(void);
-void MPU6050_setI2CMasterModeEnabled(bool enabled);
-void MPU6050_switchSPIEnabled(bool enabled);
-void MPU6050_resetFIFO(void);
-void MPU6050_resetI2CMaster(void);
-void MPU6050_resetSensors(void);
+bool MPU6050_getFIFOEnabled(MPU6050_t *dev);
+void MPU6050_setFIFOEnabled(MPU6050_t *dev, bool enabled);
+bool MPU6050_getI2CMasterModeEnabled(MPU6050_t *dev);
+void MPU6050_setI2CMasterModeEnabled(MPU6050_t *dev, bool enabled);
+void MPU6050_switchSPIEnabled(MPU6050_t *dev, bool enabled);
+void MPU6050_resetFIFO(MPU6050_t *dev);
+void MPU6050_resetI2CMaster(MPU6050_t *dev);
+void MPU6050_resetSensors(MPU6050_t *dev);
 
 // PWR_MGMT_1 register
-void MPU6050_reset(void);
-bool MPU6050_getSleepEnabled(void);
-void MPU6050_setSleepEnabled(uint8_t enabled);
-bool MPU6050_getWakeCycleEnabled(void);
-void MPU6050_setWakeCycleEnabled(bool enabled);
-bool MPU6050_getTempSensorEnabled(void);
-void MPU6050_setTempSensorEnabled(bool enabled);
-uint8_t MPU6050_getClockSource(void);
-void MPU6050_setClockSource(uint8_t source);
+void MPU6050_reset(MPU6050_t *dev);
+bool MPU6050_getSleepEnabled(MPU6050_t *dev);
+void MPU6050_setSleepEnabled(MPU6050_t *dev, uint8_t enabled);
+bool MPU6050_getWakeCycleEnabled(MPU6050_t *dev);
+void MPU6050_setWakeCycleEnabled(MPU6050_t *dev, bool enabled);
+bool MPU6050_getTempSensorEnabled(MPU6050_t *dev);
+void MPU6050_setTempSensorEnabled(MPU6050_t *dev, bool enabled);
+uint8_t MPU6050_getClockSource(MPU6050_t *dev);
+void MPU6050_setClockSource(MPU6050_t *dev, uint8_t source);
 
 // PWR_MGMT_2 register
-uint8_t MPU6050_getWakeFrequency(void);
-void MPU6050_setWakeFrequency(uint8_t frequency);
-bool MPU6050_getStandbyXAccelEnabled(void);
-void MPU6050_setStandbyXAccelEnabled(bool enabled);
-bool MPU6050_getStandbyYAccelEnabled(void);
-void MPU6050_setStandbyYAccelEnabled(bool enabled);
-bool MPU6050_getStandbyZAccelEnabled(void);
-void MPU6050_setStandbyZAccelEnabled(bool enabled);
-bool MPU6050_getStandbyXGyroEnabled(void);
-void MPU6050_setStandbyXGyroEnabled(bool enabled);
-bool MPU6050_getStandbyYGyroEnabled(void);
-void MPU6050_setStandbyYGyroEnabled(bool enabled);
-bool MPU6050_getStandbyZGyroEnabled(void);
-void MPU6050_setStandbyZGyroEnabled(bool enabled);
+uint8_t MPU6050_getWakeFrequency(MPU6050_t *dev);
+void MPU6050_setWakeFrequency(MPU6050_t *dev, uint8_t frequency);
+bool MPU6050_getStandbyXAccelEnabled(MPU6050_t *dev);
+void MPU6050_setStandbyXAccelEnabled(MPU6050_t *dev, bool enabled);
+bool MPU6050_getStandbyYAccelEnabled(MPU6050_t *dev);
+void MPU6050_setStandbyYAccelEnabled(MPU6050_t *dev, bool enabled);
+bool MPU6050_getStandbyZAccelEnabled(MPU6050_t *dev);
+void MPU6050_setStandbyZAccelEnabled(MPU6050_t *dev, bool enabled);
+bool MPU6050_getStandbyXGyroEnabled(MPU6050_t *dev);
+void MPU6050_setStandbyXGyroEnabled(MPU6050_t *dev, bool enabled);
+bool MPU6050_getStandbyYGyroEnabled(MPU6050_t *dev);
+void MPU6050_setStandbyYGyroEnabled(MPU6050_t *dev, bool enabled);
+bool MPU6050_getStandbyZGyroEnabled(MPU6050_t *dev);
+void MPU6050_setStandbyZGyroEnabled(MPU6050_t *dev, bool enabled);
 
 // FIFO_COUNT_* registers
-uint16_t MPU6050_getFIFOCount(void);
+uint16_t MPU6050_getFIFOCount(MPU6050_t *dev);
 
 // FIFO_R_W register
-uint8_t MPU6050_getFIFOByte(void);
-void MPU6050_setFIFOByte(uint8_t data);
-void MPU6050_getFIFOBytes(uint8_t *data, uint8_t length);
+uint8_t MPU6050_getFIFOByte(MPU6050_t *dev);
+void MPU6050_setFIFOByte(MPU6050_t *dev, uint8_t data);
+int MPU6050_getFIFOBytes(MPU6050_t *dev, uint8_t *data, uint16_t length);
 
 // WHO_AM_I register
-uint8_t MPU6050_getDeviceID(void);
-void MPU6050_setDeviceID(uint8_t id);
+uint8_t MPU6050_getDeviceID(MPU6050_t *dev);
+void MPU6050_setDeviceID(MPU6050_t *dev, uint8_t id);
 
 // ======== UNDOCUMENTED/DMP REGISTERS/METHODS ========
 
 // XG_OFFS_TC register
-uint8_t MPU6050_getOTPBankValid(void);
-void MPU6050_setOTPBankValid(bool enabled);
+uint8_t MPU6050_getOTPBankValid(MPU6050_t *dev);
+void MPU6050_setOTPBankValid(MPU6050_t *dev, bool enabled);
 int8_t getXGyroOffsetTC(void);
-void MPU6050_setXGyroOffsetTC(int8_t offset);
+void MPU6050_setXGyroOffsetTC(MPU6050_t *dev, int8_t offset);
 
 // YG_OFFS_TC register
 int8_t getYGyroOffsetTC(void);
-void MPU6050_setYGyroOffsetTC(int8_t offset);
+void MPU6050_setYGyroOffsetTC(MPU6050_t *dev, int8_t offset);
 
 // ZG_OFFS_TC register
 int8_t getZGyroOffsetTC(void);
-void MPU6050_setZGyroOffsetTC(int8_t offset);
+void MPU6050_setZGyroOffsetTC(MPU6050_t *dev, int8_t offset);
 
 // X_FINE_GAIN register
 int8_t getXFineGain(void);
-void MPU6050_setXFineGain(int8_t gain);
+void MPU6050_setXFineGain(MPU6050_t *dev, int8_t gain);
 
 // Y_FINE_GAIN register
 int8_t getYFineGain(void);
-void MPU6050_setYFineGain(int8_t gain);
+void MPU6050_setYFineGain(MPU6050_t *dev, int8_t gain);
 
 // Z_FINE_GAIN register
 int8_t getZFineGain(void);
-void MPU6050_setZFineGain(int8_t gain);
+void MPU6050_setZFineGain(MPU6050_t *dev, int8_t gain);
 
 // XA_OFFS_* registers
-int16_t MPU6050_getXAccelOffset(void);
-void MPU6050_setXAccelOffset(int16_t offset);
+int16_t MPU6050_getXAccelOffset(MPU6050_t *dev);
+void MPU6050_setXAccelOffset(MPU6050_t *dev, int16_t offset);
 
 // YA_OFFS_* register
-int16_t MPU6050_getYAccelOffset(void);
-void MPU6050_setYAccelOffset(int16_t offset);
+int16_t MPU6050_getYAccelOffset(MPU6050_t *dev);
+void MPU6050_setYAccelOffset(MPU6050_t *dev, int16_t offset);
 
 // ZA_OFFS_* register
-int16_t MPU6050_getZAccelOffset(void);
-void MPU6050_setZAccelOffset(int16_t offset);
+int16_t MPU6050_getZAccelOffset(MPU6050_t *dev);
+void MPU6050_setZAccelOffset(MPU6050_t *dev, int16_t offset);
 
 // XG_OFFS_USR* registers
-int16_t MPU6050_getXGyroOffset(void);
-void MPU6050_setXGyroOffset(int16_t offset);
+int16_t MPU6050_getXGyroOffset(MPU6050_t *dev);
+void MPU6050_setXGyroOffset(MPU6050_t *dev, int16_t offset);
 
 // YG_OFFS_USR* register
-int16_t MPU6050_getYGyroOffset(void);
-void MPU6050_setYGyroOffset(int16_t offset);
+int16_t MPU6050_getYGyroOffset(MPU6050_t *dev);
+void MPU6050_setYGyroOffset(MPU6050_t *dev, int16_t offset);
 
 // ZG_OFFS_USR* register
-int16_t MPU6050_getZGyroOffset(void);
-void MPU6050_setZGyroOffset(int16_t offset);
+int16_t MPU6050_getZGyroOffset(MPU6050_t *dev);
+void MPU6050_setZGyroOffset(MPU6050_t *dev, int16_t offset);
 
 // INT_ENABLE register (DMP functions)
-bool MPU6050_getIntPLLReadyEnabled(void);
-void MPU6050_setIntPLLReadyEnabled(bool enabled);
-bool MPU6050_getIntDMPEnabled(void);
-void MPU6050_setIntDMPEnabled(bool enabled);
+bool MPU6050_getIntPLLReadyEnabled(MPU6050_t *dev);
+void MPU6050_setIntPLLReadyEnabled(MPU6050_t *dev, bool enabled);
+bool MPU6050_getIntDMPEnabled(MPU6050_t *dev);
+void MPU6050_setIntDMPEnabled(MPU6050_t *dev, bool enabled);
 
 // DMP_INT_STATUS
-bool MPU6050_getDMPInt5Status(void);
-bool MPU6050_getDMPInt4Status(void);
-bool MPU6050_getDMPInt3Status(void);
-bool MPU6050_getDMPInt2Status(void);
-bool MPU6050_getDMPInt1Status(void);
-bool MPU6050_getDMPInt0Status(void);
+bool MPU6050_getDMPInt5Status(MPU6050_t *dev);
+bool MPU6050_getDMPInt4Status(MPU6050_t *dev);
+bool MPU6050_getDMPInt3Status(MPU6050_t *dev);
+bool MPU6050_getDMPInt2Status(MPU6050_t *dev);
+bool MPU6050_getDMPInt1Status(MPU6050_t *dev);
+bool MPU6050_getDMPInt0Status(MPU6050_t *dev);
 
 // INT_STATUS register (DMP functions)
-bool MPU6050_getIntPLLReadyStatus(void);
-bool MPU6050_getIntDMPStatus(void);
+bool MPU6050_getIntPLLReadyStatus(MPU6050_t *dev);
+bool MPU6050_getIntDMPStatus(MPU6050_t *dev);
 
 // USER_CTRL register (DMP functions)
-bool MPU6050_getDMPEnabled(void);
-void MPU6050_setDMPEnabled(bool enabled);
-void MPU6050_resetDMP(void);
+bool MPU6050_getDMPEnabled(MPU6050_t *dev);
+void MPU6050_setDMPEnabled(MPU6050_t *dev, bool enabled);
+void MPU6050_resetDMP(MPU6050_t *dev);
 
 // BANK_SEL register
-void MPU6050_setMemoryBank(uint8_t bank, bool prefetchEnabled, bool userBank);
+void MPU6050_setMemoryBank(MPU6050_t *dev, uint8_t bank, bool prefetchEnabled, bool userBank);
 
 // MEM_START_ADDR register
-void MPU6050_setMemoryStartAddress(uint8_t address);
+void MPU6050_setMemoryStartAddress(MPU6050_t *dev, uint8_t address);
 
 // MEM_R_W register
-uint8_t MPU6050_readMemoryByte(void);
-void MPU6050_writeMemoryByte(uint8_t data);
-void MPU6050_readMemoryBlock(uint8_t *data, uint16_t dataSize, uint8_t bank, uint8_t address);
+uint8_t MPU6050_readMemoryByte(MPU6050_t *dev);
+void MPU6050_writeMemoryByte(MPU6050_t *dev, uint8_t data);
+void MPU6050_readMemoryBlock(MPU6050_t *dev, uint8_t *data, uint16_t dataSize, uint8_t bank, uint8_t address);
 //bool MPU6050_writeMemoryBlock(const uint8_t *data, uint16_t dataSize, uint8_t bank, uint8_t address, bool verify, bool useProgMem);
 //bool MPU6050_writeProgMemoryBlock(const uint8_t *data, uint16_t dataSize, uint8_t bank, uint8_t address, bool verify);
 
@@ -807,11 +859,11 @@ void MPU6050_readMemoryBlock(uint8_t *data, uint16_t dataSize, uint8_t bank, uin
 //bool MPU6050_writeProgDMPConfigurationSet(const uint8_t *data, uint16_t dataSize);
 
 // DMP_CFG_1 register
-uint8_t MPU6050_getDMPConfig1(void);
-void MPU6050_setDMPConfig1(uint8_t config);
+uint8_t MPU6050_getDMPConfig1(MPU6050_t *dev);
+void MPU6050_setDMPConfig1(MPU6050_t *dev, uint8_t config);
 
 // DMP_CFG_2 register
-uint8_t MPU6050_getDMPConfig2(void);
-void MPU6050_setDMPConfig2(uint8_t config);
+uint8_t MPU6050_getDMPConfig2(MPU6050_t *dev);
+void MPU6050_setDMPConfig2(MPU6050_t *dev, uint8_t config);
 
 #endif /* _MPU6050_H_ */
\ No newline at end of file
@@ -0,0 +1,81 @@
+#ifndef ACQUISITION_H
+#define ACQUISITION_H
+
+#include <linux/init.h>
+#include <linux/module.h>
+#include <linux/interrupt.h>
+#include <linux/platform_device.h>
+#include <linux/of.h>
+#include <linux/of_irq.h>
+#include <linux/workqueue.h>
+#include <linux/bitops.h>
+#include <linux/wait_bit.h>
+#include <linux/atomic.h>
+#include <linux/timekeeping.h>
+#include <linux/math64.h>
+#include <asm/unaligned.h>
+#include "MPU6050.h"
+#include "sample_ring.h"
+
+// Used to find the MPU6050 node inside the bus node of the device tree.
+#define MPU6050_COMPATIBLE          "lliano,mpu6050"
+
+// Sampling engine modes
+#define ACQUISITION_MODE_POLLED     0   // Sensor read on every read(), no ring
+#define ACQUISITION_MODE_DRDY       1   // Data ready interrupt, one burst per sample
+#define ACQUISITION_MODE_FIFO       2   // MPU6050 FIFO drained every watermark
+
+// Whole samples that fit in the MPU6050 FIFO (73). One drain never reads more.
+#define ACQUISITION_FIFO_MAX_FRAMES         (MPU6050_FIFO_SIZE / MPU6050_MOTION7_LENGTH)
+// Leaves ~25ms of headroom before an overflow at 1kHz, even with HZ=100.
+#define ACQUISITION_DEFAULT_FIFO_WATERMARK  48
+
+// Default sample rate divider. With the DLPF enabled the gyro output rate is
+// 1kHz, so Sample Rate = 1kHz / (1 + SMPLRT_DIV).
+#define ACQUISITION_DEFAULT_RATE_DIV    0
+#define ACQUISITION_DLPF_MODE           MPU6050_DLPF_BW_188
+
+// FIFO mode timestamps. The sample period is measured between drains, ignoring
+// measures more than 1/TOLERANCE off the nominal one, and each measure moves
+// the estimate 1/WEIGHT of the way.
+#define ACQUISITION_FIFO_PERIOD_TOLERANCE   8
+#define ACQUISITION_FIFO_PERIOD_WEIGHT      8
+
+struct iio_trigger;
+
+// Sampling engine of one MPU6050. Each sensor of the bus has its own, feeding its
+// own sample ring.
+struct acquisition {
+    MPU6050_t *mpu;
+    struct sample_ring ring;
+    int mode;                   // Mode actually running
+    atomic_t polled_seq;        // Sequence number of the samples read on demand, by every reader
+    int irq;                    // MPU6050 INT pin. Negative when there is none.
+    struct iio_trigger *trigger;    // Data ready trigger of the IIO device, if any
+
+    // DRDY mode. The burst of a sample is in flight while 'drdy_busy' is set.
+    struct i2c_request drdy_req;
+    u8 drdy_sample[MPU6050_MOTION7_LENGTH];
+    u64 drdy_timestamp_ns;
+    unsigned long drdy_busy;
+    unsigned int drdy_missed;
+
+    // FIFO mode
+    struct delayed_work fifo_work;
+    u8 fifo_buffer[ACQUISITION_FIFO_MAX_FRAMES * MPU6050_MOTION7_LENGTH];
+    unsigned int fifo_overflows;
+    u64 fifo_period_ns;         // Sample period, as measured against ktime
+    u64 fifo_count_ns;          // When FIFO_COUNT was last read. 0 after a restart.
+    unsigned int fifo_left;     // Samples left in the FIFO by the last drain
+    u64 fifo_next_ns;           // Time of the oldest sample in the FIFO. 0 after a restart.
+};
+
+int acquisition_init(struct acquisition *acq, MPU6050_t *mpu, struct device_node *node,
+    struct device *dev, unsigned int slot, unsigned int slots);
+void acquisition_deinit(struct acquisition *acq);
+void acquisition_free(struct acquisition *acq);
+bool acquisition_is_streaming(struct acquisition *acq);
+struct sample_ring *acquisition_get_ring(struct acquisition *acq);
+int acquisition_read_polled(struct acquisition *acq, struct mpu6050_record *record);
+
+#endif // ACQUISITION_H
@@ -18,24 +18,36 @@
 #include <linux/types.h>           // typedefs varios
 #include <linux/slab.h>            // kmalloc
 #include <linux/ioctl.h>
+#include <linux/poll.h>
 #include "MPU6050.h"
+#include "acquisition.h"
+#include "sensor.h"
+#include "uapi/lliano_mpu6050.h"
 
 int char_device_create(void);
 void char_device_remove(void);
+int char_device_add(struct mpu6050_sensor *sensor, struct device *parent);
+void char_device_del(struct mpu6050_sensor *sensor);
 
 // This value can be used by "udev" rules. Check for 'SUBSYSTEM=="DEVICE_CLASS_NAME"'.
 #define DEVICE_CLASS_NAME "lliano"
 
-// Name of the device. It'll be seen as "/dev/<DEVICE_NAME>"
+// Name of the devices. Each sensor will be seen as "/dev/<DEVICE_NAME>-<bus>-<address>",
+// like "/dev/MPU6050-2-68" for the one at 0x68 on I2C2.
 #define DEVICE_NAME    "MPU6050"
+#define DEVICE_NODE_NAME DEVICE_NAME "-%d-%02x"
 
 // Minimum minor number that can be used.
 #define MINOR_NUMBER 0
 
-// Amount of devices that will be created
-#define NUMBER_OF_DEVICES 1
+// Amount of devices that can be created, one per sensor. Each controller gets
+// SENSORS_MAX minors, from 'id * SENSORS_MAX' on.
+#define NUMBER_OF_DEVICES ((I2C_BUS_ID_MAX + 1) * SENSORS_MAX)
 
-// POSIX
-#define PACKET_NUMBER 14
+// Size of every sample returned by read()
+#define RECORD_SIZE sizeof(struct mpu6050_record)
+
+// Records copied to user space at once (kept on the kernel stack)
+#define RECORD_BATCH 8
 
 #endif // CHAR_DEVICE_H
@@ -10,7 +10,8 @@
 #include <linux/sched.h>
 #include <linux/completion.h>
 #include <linux/jiffies.h>
-#include <linux/mutex.h>
+#include <linux/spinlock.h>
+#include <linux/list.h>
 #include <linux/mod_devicetable.h>
 #include <linux/property.h>
 #include <linux/platform_device.h>
@@ -19,16 +20,214 @@
 #include <linux/of_address.h>
 #include <linux/of_clk.h>
 #include <linux/clk.h>
+#include <linux/dmaengine.h>
+#include <linux/dma-mapping.h>
+#include <linux/timekeeping.h>
+#include <linux/log2.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+#include <linux/slab.h>
+#include <linux/uaccess.h>
+#include <linux/math64.h>
+#include <linux/hrtimer.h>
+#include <linux/workqueue.h>
+#include <linux/i2c.h>
 
 #define DRIVER_NAME "i2c_lliano"
 
-int i2c_init(struct platform_device *pdev);
-void i2c_deinit(void);
-int i2c_write(char slave_address, char* data, char size);
-int i2c_read(char slave_address, char* read_buff, char size);
-int i2c_read_reg(char slave_address, char reg_address, char* read_buff);
+// Statistics of each controller, in /sys/kernel/debug/<DRIVER_NAME>/i2c<id>/stats.
+// Writing to 'reset' in the same directory clears them. The histograms have a
+// bucket per power of two nanoseconds: bucket n counts the times in [2^n, 2^(n+1)) ns.
+#define I2C_STATS_HIST_BUCKETS  32      // Up to ~4.3 s
 
-#define TIMEOUT_READ_WRITE 100  // msec
+// One bus transaction: the messages go back to back, each one after a repeated
+// start, with a single STOP at the end. A message reads (I2C_M_RD) or writes
+// 'len' bytes, 1 to 65535, at its 7 bit 'addr'. I2C_M_DMA_SAFE is ignored, as
+// EDMA always goes through the bounce buffer; no other flag is supported.
+// The buffers belong to the caller and are accessed directly by the ISR, so
+// they must stay valid until the request completes. Phases long enough for
+// EDMA go through the bounce buffer instead (see I2C_DEFAULT_DMA_THRESHOLD).
+// Fill it with i2c_request_init() (a write and/or a read at one slave) or
+// i2c_request_init_msgs().
+// i2c_execute() sleeps until it's done, while i2c_submit() returns at once and
+// calls 'complete' from the I2C interrupt when it's done.
+struct i2c_request {
+    struct list_head node;      // Entry of the bus queue
+    struct i2c_msg *msgs;
+    u16 num_msgs;
+    u32 flags;                  // I2C_REQ_F_*
+    void (*complete)(struct i2c_request *req);  // Only for i2c_submit()
+    void *context;              // For the owner of 'complete'
+    struct i2c_msg inline_msgs[2];  // Used by i2c_request_init()
+
+    // Owned by the driver while the request is queued
+    u16 msg;                    // Message on the bus
+    u16 pos;                    // Bytes of it moved so far
+    u32 attempts;               // Failed tries so far (see I2C_DEFAULT_RETRIES)
+    int status;                 // "0" or negative error code, once 'done' completes
+    struct completion done;     // Only for i2c_execute()
+    u64 submit_ns;              // ktime_get_ns() at i2c_submit()
+    u64 start_ns;               // ktime_get_ns() at the START, once it completes
+    u64 end_ns;                 // ktime_get_ns() when it completed
+    u64 deadline_ns;            // ktime_get_ns() by which it must be over, once started
+    struct i2c_bus *bus;        // Where it was submitted
+};
+
+// i2c_request.flags
+#define I2C_REQ_F_URGENT    (1 << 0)    // Goes ahead of the requests already queued
+
+// Statistics (see I2C_STATS_HIST_BUCKETS), updated with the queue lock held. They
+// are always on: a few increments and a ktime_get_ns() per transaction.
+struct i2c_stats {
+    u64 transactions_write;         // Write phase only
+    u64 transactions_read;          // Read phase only
+    u64 transactions_write_read;    // Write, repeated start and read
+    u64 bytes_written;
+    u64 bytes_read;
+    u64 irqs;                       // i2c_isr() calls
+    u64 irqs_none;                  // ... with no enabled event pending
+    u64 nacks;
+    u64 arbitration_lost;
+    u64 retries;                    // Requests tried again after an AL or a data NACK
+    u64 recoveries;                 // Bus recoveries and soft resets
+    u64 timeouts;                   // Transfers aborted by the watchdog
+    u64 bus_busy_waits;             // Starts deferred to the bus free interrupt
+    u64 bus_busy_timeouts;          // ... that the watchdog had to recover the bus for
+    u32 duration_hist[I2C_STATS_HIST_BUCKETS];  // START until completion
+    u32 wait_hist[I2C_STATS_HIST_BUCKETS];      // i2c_submit() until START
+};
+
+// SCL timing, worked out by i2c_init() from the device tree (see I2C_FCLK_HZ)
+struct i2c_timing {
+    u32 bus_freq_hz;            // "clock-frequency": SCL frequency asked for
+    u32 int_clk_hz;             // Internal clock, from "int-clock-frequency"
+    u32 scl_rise_ns;            // "i2c-scl-rising-time-ns", or the I2C spec maximum
+    u32 psc;
+    u32 scll;
+    u32 sclh;
+    u32 scl_hz;                 // What it should give, rise time included
+};
+
+// Result of the last self-test of a bus (the "selftest" file in debugfs)
+struct i2c_selftest {
+    u8 addr;
+    u8 reg;
+    u16 len;                    // Bytes read per transfer
+    u32 transfers;
+    u32 errors;
+    u64 elapsed_ns;             // First submit until the last completion
+    u64 bus_ns;                 // Sum of START until completion of every transfer
+    u64 scl_cycles;             // Bits on the wire, START, STOP and ACKs included
+};
+
+// Highest controller number (I2C0 to I2C2 on the AM335x)
+#define I2C_BUS_ID_MAX  2
+
+// One I2C controller, with its own registers, interrupt, queue and EDMA
+// channels. Controllers don't share anything, so their transfers run in parallel.
+struct i2c_bus {
+    int id;                     // Number of the controller: 1 for I2C1, 2 for I2C2
+    char name[8];               // "i2c<id>", for messages and debugfs
+    phys_addr_t phys;           // Registers, from the "reg" of the device tree
+    void __iomem *regs;
+    void __iomem *clkctrl;      // CM_PER_I2C<id>_CLKCTRL
+    int irq;
+    u32 fifo_depth;             // Bytes of the TX and RX FIFOs (32 on the AM335x)
+
+    // Requests waiting for the bus, in order. The request on the bus ('active') is
+    // taken out of the queue and belongs to the ISR until it completes.
+    struct list_head queue;
+    struct i2c_request *active;
+    spinlock_t queue_lock;
+    struct hrtimer watchdog;    // Deadline of 'active', or of the bus becoming free
+    struct work_struct recovery;    // Frees a stuck bus, out of the IRQ (see __bus_recover())
+    bool recovering;            // The queue waits for 'recovery', with the controller masked
+
+    // EDMA. Optional: without channels every phase goes through the FIFO. A single
+    // bounce buffer is enough, as only one phase is on the bus at a time.
+    struct dma_chan *dma_tx;
+    struct dma_chan *dma_rx;
+    u8 *dma_buf;
+    dma_addr_t dma_buf_phys;
+    struct dma_chan *dma_running;   // Channel of the phase on the bus, if any
+    dma_cookie_t dma_cookie;        // Tells a late callback from the current one
+
+    struct i2c_adapter adapter;     // The bus for the I2C core (i2c-dev, other clients)
+
+    struct i2c_timing timing;
+    struct i2c_stats stats;
+    struct i2c_selftest selftest;   // Updated with the queue lock held
+    struct dentry *debugfs_dir;
+};
+
+void i2c_debugfs_init(void);
+void i2c_debugfs_deinit(void);
+int i2c_init(struct i2c_bus *bus, struct platform_device *pdev);
+void i2c_deinit(struct i2c_bus *bus);
+int i2c_submit(struct i2c_bus *bus, struct i2c_request *req);
+int i2c_execute(struct i2c_bus *bus, struct i2c_request *req);
+int i2c_xfer(struct i2c_bus *bus, struct i2c_msg *msgs, u16 num);
+int i2c_write(struct i2c_bus *bus, char slave_address, char* data, u16 size);
+int i2c_read(struct i2c_bus *bus, char slave_address, char* read_buff, u16 size);
+int i2c_read_reg(struct i2c_bus *bus, char slave_address, char reg_address, char* read_buff);
+int i2c_read_regs(struct i2c_bus *bus, char slave_address, char reg_address, char* read_buff, u16 size);
+
+/// @brief Fills the caller's side of a request made of 'num' messages.
+static inline void i2c_request_init_msgs(struct i2c_request *req, struct i2c_msg *msgs, u16 num, u32 flags)
+{
+    req->msgs = msgs;
+    req->num_msgs = num;
+    req->flags = flags;
+    req->complete = NULL;
+    req->context = NULL;
+}
+
+/// @brief Fills the caller's side of a request that writes 'tx_len' bytes to a
+///  slave and then, after a repeated start, reads 'rx_len' bytes from it. Either
+///  phase may be empty.
+static inline void i2c_request_init(struct i2c_request *req, u8 addr,
+    const void *tx, u16 tx_len, void *rx, u16 rx_len, u32 flags)
+{
+    struct i2c_msg *msg = req->inline_msgs;
+
+    if (tx_len != 0)
+        *msg++ = (struct i2c_msg) { .addr = addr, .flags = 0, .len = tx_len, .buf = (u8 *) tx };
+    if (rx_len != 0)
+        *msg++ = (struct i2c_msg) { .addr = addr, .flags = I2C_M_RD, .len = rx_len, .buf = rx };
+    i2c_request_init_msgs(req, req->inline_msgs, msg - req->inline_msgs, flags);
+}
+
+/// @brief Slave address of the message on the bus (of the first one, until the
+///  request is on the bus).
+static inline u8 i2c_request_addr(const struct i2c_request *req)
+{
+    return req->msgs[req->msg].addr;
+}
+
+// After a lost arbitration, the bus is recovered from a work item (up to 9 SCL
+// pulses, until the slave lets SDA go, and a STOP), the controller soft reset,
+// and the request tried again this many times before it fails with -EAGAIN.
+// A NACKed data byte only takes a STOP before the request is tried again, and
+// fails with -EREMOTEIO once these are used up. A NACKed address is never
+// retried: nobody is there, and the request fails at once with -ENXIO.
+#define I2C_DEFAULT_RETRIES         3
+#define I2C_RECOVERY_PULSES         9
+#define I2C_RESET_TIMEOUT_US        1000
+
+// Deadline of a transfer, from its START: its bits on the bus at the SCL frequency,
+// times I2C_DEADLINE_FACTOR for SCL held by a late interrupt, plus the slack of
+// "deadline_slack_us". The watchdog aborts the transfers that miss it, with
+// -ETIMEDOUT, and resets the controller. It also recovers a bus that stays busy
+// (BB) for longer than the slack while requests wait for it.
+#define I2C_DEADLINE_FACTOR             2
+#define I2C_DEFAULT_DEADLINE_SLACK_US   1000
+
+// Phases longer than this go through EDMA, when the device tree provides the
+// "tx" and "rx" channels. A phase that fits in the FIFO already takes a single
+// interrupt, so this is the FIFO size.
+#define I2C_DEFAULT_DMA_THRESHOLD   32
+// Size of the DMA bounce buffer. Longer phases use the FIFO.
+#define I2C_DMA_BUF_LEN             PAGE_SIZE
 
 #define DT_PROPERTY_PINMUX_PHANDLE  "pinmux"
 #define DT_PROPERTY_PINS            "pins"
@@ -36,15 +235,18 @@ int i2c_read_reg(char slave_address, char reg_address, char* read_buff);
 #define DT_PROPERTY_CLK_FREQ        "clock-frequency"
 #define DT_PROPERTY_INT_CLK_FREQ    "int-clock-frequency"
 #define DT_PROPERTY_BIT_RATE        "bit-rate"
+#define DT_PROPERTY_SCL_RISE_NS     "i2c-scl-rising-time-ns"
 
 // Clock Module Peripheral (CM_PER) (page 179) Length = 1K-> 0x400
 #define CM_PER                  0x44E00000
 #define CM_PER_LEN              0x00000400 // 1K
 
-// I2C2 clocks manager (page 1270)
+// I2C1 and I2C2 clocks manager (page 1270). I2C0 is in the wakeup domain (CM_WKUP).
+#define IDCM_PER_I2C1_CLKCTRL      0x00000048
 #define IDCM_PER_I2C2_CLKCTRL      0x00000044
-#define CM_PER_I2C2_CLKCTRL_MASK   0x00030003
-#define CM_PER_I2C2_CLKCTRL_ENABLE 0x00000002
+#define CM_PER_I2C_CLKCTRL_LEN     0x00000004
+#define CM_PER_I2C_CLKCTRL_MASK    0x00030003
+#define CM_PER_I2C_CLKCTRL_ENABLE  0x00000002
 
 // Config de Control Module (page180)
 #define CTRL_MODULE_BASE        0x44E10000
@@ -53,19 +255,24 @@ int i2c_read_reg(char slave_address, char reg_address, char* read_buff);
 #define CTRL_MODULE_UART1_RTSN  0x0000097C //pin 19 = scl (page1461) 
 #define CTRL_MODULE_UART1_MASK  0x0000007F
 
-// I2C2 Module (page183)
+// I2C1 and I2C2 Modules (page183). The driver finds them through the "reg" of
+// the device tree.
+#define I2C1                    0x4802A000
 #define I2C2                    0x4819C000
-#define I2C2_LEN                0x00001000
 
 // Registers' offset address
 #define I2C_REG_REVNB_LO        0x00
 #define I2C_REG_REVNB_HI        0x04
 #define I2C_REG_SYSC            0x10
-#define I2C_REG_IRQSTATUS_RAW   0x28
+#define I2C_REG_IRQSTATUS_RAW   0x24
 #define I2C_REG_IRQSTATUS       0x28
 #define I2C_REG_IRQENABLE_SET   0x2C
 #define I2C_REG_IRQENABLE_CLR   0x30
 #define I2C_REG_WE              0x34
+#define I2C_REG_DMARXENABLE_SET 0x38
+#define I2C_REG_DMATXENABLE_SET 0x3C
+#define I2C_REG_DMARXENABLE_CLR 0x40
+#define I2C_REG_DMATXENABLE_CLR 0x44
 #define I2C_REG_SYSS            0x90
 #define I2C_REG_BUF             0x94
 #define I2C_REG_CNT             0x98
@@ -76,6 +283,8 @@ int i2c_read_reg(char slave_address, char reg_address, char* read_buff);
 #define I2C_REG_PSC             0xB0
 #define I2C_REG_SCLL            0xB4
 #define I2C_REG_SCLH            0xB8
+#define I2C_REG_SYSTEST         0xBC
+#define I2C_REG_BUFSTAT         0xC0
 
 // CON
 #define I2C_BIT_ENABLE          (1 << 15)
@@ -92,8 +301,23 @@ int i2c_read_reg(char slave_address, char reg_address, char* read_buff);
 #define I2C_BIT_NOIDLE          (1 << 3)    // No idle
 #define I2C_BIT_CLKACTIVITY     (3 << 8)    // Both clocks active
 
+// SYSS
+#define I2C_BIT_RDONE           (1 << 0)    // Reset done
+
+// SYSTEST (page 4593). In the SDA/SCL IO test mode the lines are driven from
+// SCL_O and SDA_O ("1" releases them) and read back from SCL_I and SDA_I.
+#define I2C_BIT_ST_EN           (1 << 15)
+#define I2C_SYSTEST_TMODE_IO    (3 << 12)
+#define I2C_BIT_SCL_I           (1 << 3)
+#define I2C_BIT_SCL_O           (1 << 2)
+#define I2C_BIT_SDA_I           (1 << 1)
+#define I2C_BIT_SDA_O           (1 << 0)
+
 // IRQSTATUS
+#define I2C_IRQ_XDR             (1 << 14)   // TX draining: less than a threshold left to write
+#define I2C_IRQ_RDR             (1 << 13)   // RX draining: less than a threshold left to read
 #define I2C_IRQ_BB              (1 << 12)
+#define I2C_IRQ_BF              (1 << 8)    // Bus free
 #define I2C_IRQ_XRDY            (1 << 4)
 #define I2C_IRQ_RRDY            (1 << 3)
 #define I2C_IRQ_ARDY            (1 << 2)
@@ -107,23 +331,55 @@ int i2c_read_reg(char slave_address, char reg_address, char* read_buff);
 #define I2C_IRQENABLE_CLR_RX    0x00000008
 #define I2C_IRQENABLE_CLR_TX    0x00000010
 
+// Events that end a request with an error
+#define I2C_IRQ_ERRORS          (I2C_IRQ_NACK | I2C_IRQ_AL)
+
 // BUF
 #define I2C_BIT_RXFIFO_CLR      (1 << 14)
 #define I2C_BIT_TXFIFO_CLR      (1 << 6)
+#define I2C_BIT_RDMA_EN         (1 << 15)
+#define I2C_BIT_XDMA_EN         (1 << 7)
+#define I2C_BUF_RXTRSH(n)       (((n) - 1) << 8)    // RRDY once n bytes are in the RX FIFO
+#define I2C_BUF_TXTRSH(n)       ((n) - 1)           // XRDY once n bytes are free in the TX FIFO
 
-// PSC
-#define I2C_PSC_MASK            0x000000FF
-#define I2C_PSC_12MHZ           0x00000003 // divided by 3, 48MHz/4 = 12MHz (page4589)
-#define I2C_PSC_24MHZ           0x00000001 // divided by 1, 48MHz/1 = 24MHz (page4589)
+// BUFSTAT
+#define I2C_BUFSTAT_FIFODEPTH(reg)  (8 << (((reg) >> 14) & 0x3))   // FIFO size in bytes
+#define I2C_BUFSTAT_RXSTAT(reg)     (((reg) >> 8) & 0x3F)          // Bytes waiting in the RX FIFO
+#define I2C_BUFSTAT_TXSTAT(reg)     ((reg) & 0x3F)                 // Bytes still to write, when draining
 
-// SCLL
+// PSC, SCLL and SCLH (page 4589). The internal clock is the 48MHz functional
+// clock divided by PSC + 1, ~12MHz for the standard and fast modes. SCL is low
+// for SCLL + 7 and high for SCLH + 5 cycles of it, but the high time only starts
+// once SCL is seen high, so the rise time of the bus adds to the period:
+//   1 / f = (SCLL + 7 + SCLH + 5) * (PSC + 1) / 48MHz + t_rise
+#define I2C_FCLK_HZ             48000000
+#define I2C_PSC_MASK            0x000000FF
 #define I2C_SCLL_MASK           0x000000FF
-#define I2C_SCLL_400K           0x00000017 // tLOW = 1,25 US = (23+7)*(2/48MHz)
-#define I2C_SCLL_100K           0x000000E9 // tLOW = 5 US = (233+7)+(1/48MHz)
-
-// SCLH
+#define I2C_SCLL_OFFSET         7
 #define I2C_SCLH_MASK           0x000000FF
-#define I2C_SCLH_400K           0x00000019 // THIGH = 1,25 uS = (25+5)*(1/48MHz)
-#define I2C_SCLH_100K           0x000000EB // THIGH = 5 us = (235+5)*(1/48MHz)
+#define I2C_SCLH_OFFSET         5
+
+// Without these properties, like the Linux I2C drivers
+#define I2C_DEFAULT_BUS_FREQ_HZ     100000
+#define I2C_DEFAULT_INT_CLK_HZ      12000000
+
+// Standard mode (up to 100kHz) and fast mode (up to 400kHz), from the I2C spec:
+// rise time assumed if the device tree doesn't give it, and minimum SCL times
+#define I2C_STANDARD_MAX_HZ         100000
+#define I2C_STANDARD_RISE_NS        1000
+#define I2C_STANDARD_LOW_MIN_NS     4700
+#define I2C_STANDARD_HIGH_MIN_NS    4000
+#define I2C_FAST_MAX_HZ             400000
+#define I2C_FAST_RISE_NS            300
+#define I2C_FAST_LOW_MIN_NS         1300
+#define I2C_FAST_HIGH_MIN_NS        600
+
+// Self-test defaults: the accel, temp and gyro registers of a MPU6050. The
+// transfers share the queue with the sensors, so a run is kept to a few seconds.
+#define I2C_SELFTEST_REG            0x3B
+#define I2C_SELFTEST_LEN            14
+#define I2C_SELFTEST_TRANSFERS      100
+#define I2C_SELFTEST_MAX_LEN        256
+#define I2C_SELFTEST_MAX_TRANSFERS  10000
 
 #endif // _I2C_H
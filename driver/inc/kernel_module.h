@@ -5,10 +5,15 @@
 #include <linux/module.h>
 #include <linux/platform_device.h>
 #include <linux/of_device.h>
+#include <linux/slab.h>
+#include <linux/list.h>
 
 
 #include "i2c.h"
 #include "MPU6050.h"
+#include "acquisition.h"
+#include "sensor.h"
+#include "mpu6050_iio.h"
 #include "char_device.h"
 
 
@@ -19,6 +24,6 @@
 MODULE_LICENSE("Dual BSD/GPL");
 MODULE_AUTHOR("Lucas Liaño");
 MODULE_VERSION("1.0");
-MODULE_DESCRIPTION("This module is a kernel driver for the I2C2 bus.");
+MODULE_DESCRIPTION("This module is a kernel driver for the I2C1 and I2C2 buses.");
 
 #endif // MODULE_H
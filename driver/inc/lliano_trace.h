@@ -0,0 +1,202 @@
+// Tracepoints of the driver, under events/lliano/ in tracefs:
+//
+//   echo 1 > /sys/kernel/tracing/events/lliano/enable
+//   cat /sys/kernel/tracing/trace_pipe
+//
+// or 'perf record -e lliano:*'. They cost a static branch while disabled, so
+// they stay in the hot paths instead of printk.
+//
+// i2c.c defines them (CREATE_TRACE_POINTS). Any other file only includes this header.
+
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM lliano
+
+#if !defined(_LLIANO_TRACE_H) || defined(TRACE_HEADER_MULTI_READ)
+#define _LLIANO_TRACE_H
+
+#include <linux/tracepoint.h>
+#include "i2c.h"
+#include "uapi/lliano_mpu6050.h"
+
+#define LLIANO_TRACE_I2C_IRQS                   \
+    { I2C_IRQ_XDR,  "XDR" },                    \
+    { I2C_IRQ_RDR,  "RDR" },                    \
+    { I2C_IRQ_BB,   "BB" },                     \
+    { I2C_IRQ_BF,   "BF" },                     \
+    { I2C_IRQ_XRDY, "XRDY" },                   \
+    { I2C_IRQ_RRDY, "RRDY" },                   \
+    { I2C_IRQ_ARDY, "ARDY" },                   \
+    { I2C_IRQ_NACK, "NACK" },                   \
+    { I2C_IRQ_AL,   "AL" }
+
+#define LLIANO_TRACE_RECORD_FLAGS               \
+    { MPU6050_RECORD_F_POLLED,  "POLLED" },     \
+    { MPU6050_RECORD_F_DRDY,    "DRDY" },       \
+    { MPU6050_RECORD_F_FIFO,    "FIFO" }
+
+/******************************************************************************
+ * I2C requests
+******************************************************************************/
+
+DECLARE_EVENT_CLASS(lliano_i2c_request,
+
+    TP_PROTO(const struct i2c_request *req),
+
+    TP_ARGS(req),
+
+    TP_STRUCT__entry(
+        __field(const void *, req)
+        __field(int, bus)
+        __field(u8, addr)
+        __field(u16, msg)
+        __field(u16, num_msgs)
+        __field(u16, len)
+        __field(bool, read)
+        __field(u32, flags)
+    ),
+
+    TP_fast_assign(
+        __entry->req = req;
+        __entry->bus = req->bus->id;
+        __entry->addr = i2c_request_addr(req);
+        __entry->msg = req->msg;
+        __entry->num_msgs = req->num_msgs;
+        __entry->len = req->msgs[req->msg].len;
+        __entry->read = req->msgs[req->msg].flags & I2C_M_RD;
+        __entry->flags = req->flags;
+    ),
+
+    TP_printk("req=%p bus=%d addr=0x%02x msg=%u/%u %s len=%u%s",
+        __entry->req, __entry->bus, __entry->addr, __entry->msg + 1, __entry->num_msgs,
+        __entry->read ? "read" : "write", __entry->len,
+        (__entry->flags & I2C_REQ_F_URGENT) ? " urgent" : "")
+);
+
+// Queued by i2c_submit()
+DEFINE_EVENT(lliano_i2c_request, lliano_i2c_submit,
+    TP_PROTO(const struct i2c_request *req),
+    TP_ARGS(req)
+);
+
+// START on the bus
+DEFINE_EVENT(lliano_i2c_request, lliano_i2c_start,
+    TP_PROTO(const struct i2c_request *req),
+    TP_ARGS(req)
+);
+
+// Repeated START of the next message
+DEFINE_EVENT(lliano_i2c_request, lliano_i2c_restart,
+    TP_PROTO(const struct i2c_request *req),
+    TP_ARGS(req)
+);
+
+// Back in the queue after a lost arbitration (once the bus was recovered) or a
+// NACKed data byte
+DEFINE_EVENT(lliano_i2c_request, lliano_i2c_retry,
+    TP_PROTO(const struct i2c_request *req),
+    TP_ARGS(req)
+);
+
+// Off the bus (or out of the queue, if it timed out there), before its owner is told
+TRACE_EVENT(lliano_i2c_complete,
+
+    TP_PROTO(const struct i2c_request *req, int status),
+
+    TP_ARGS(req, status),
+
+    TP_STRUCT__entry(
+        __field(const void *, req)
+        __field(int, bus)
+        __field(u8, addr)
+        __field(u16, msg)
+        __field(u16, num_msgs)
+        __field(u16, pos)
+        __field(u16, len)
+        __field(int, status)
+    ),
+
+    // Where it stopped: the last message, unless it failed before
+    TP_fast_assign(
+        __entry->req = req;
+        __entry->bus = req->bus->id;
+        __entry->addr = i2c_request_addr(req);
+        __entry->msg = req->msg;
+        __entry->num_msgs = req->num_msgs;
+        __entry->pos = req->pos;
+        __entry->len = req->msgs[req->msg].len;
+        __entry->status = status;
+    ),
+
+    TP_printk("req=%p bus=%d addr=0x%02x msg=%u/%u pos=%u/%u status=%d",
+        __entry->req, __entry->bus, __entry->addr, __entry->msg + 1, __entry->num_msgs,
+        __entry->pos, __entry->len, __entry->status)
+);
+
+/******************************************************************************
+ * Interrupts
+******************************************************************************/
+
+// Every call of i2c_isr(), including the ones that aren't ours
+TRACE_EVENT(lliano_i2c_isr,
+
+    TP_PROTO(const struct i2c_bus *bus, u32 status, u32 enabled),
+
+    TP_ARGS(bus, status, enabled),
+
+    TP_STRUCT__entry(
+        __field(int, bus)
+        __field(u32, status)
+        __field(u32, enabled)
+        __field(int, addr)
+    ),
+
+    TP_fast_assign(
+        __entry->bus = bus->id;
+        __entry->status = status;
+        __entry->enabled = enabled;
+        __entry->addr = bus->active ? i2c_request_addr(bus->active) : -1;
+    ),
+
+    TP_printk("bus=%d status=%s enabled=0x%04x addr=%d",
+        __entry->bus, __print_flags(__entry->status, "|", LLIANO_TRACE_I2C_IRQS),
+        __entry->enabled, __entry->addr)
+);
+
+/******************************************************************************
+ * Samples
+******************************************************************************/
+
+// A sample of the MPU6050 was captured, right before readers can see it
+TRACE_EVENT(lliano_mpu6050_sample,
+
+    TP_PROTO(const struct mpu6050_record *record, u8 addr),
+
+    TP_ARGS(record, addr),
+
+    TP_STRUCT__entry(
+        __field(u8, addr)
+        __field(u32, seq)
+        __field(u16, flags)
+        __field(u64, timestamp_ns)
+    ),
+
+    TP_fast_assign(
+        __entry->addr = addr;
+        __entry->seq = record->seq;
+        __entry->flags = record->flags;
+        __entry->timestamp_ns = record->timestamp_ns;
+    ),
+
+    TP_printk("addr=0x%02x seq=%u %s timestamp=%llu",
+        __entry->addr, __entry->seq, __print_flags(__entry->flags, "|", LLIANO_TRACE_RECORD_FLAGS),
+        __entry->timestamp_ns)
+);
+
+#endif // _LLIANO_TRACE_H
+
+// The header is found through the include path (-I$(src)/inc)
+#undef TRACE_INCLUDE_PATH
+#define TRACE_INCLUDE_PATH .
+#undef TRACE_INCLUDE_FILE
+#define TRACE_INCLUDE_FILE lliano_trace
+#include <trace/define_trace.h>
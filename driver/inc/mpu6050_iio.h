@@ -0,0 +1,52 @@
+#ifndef MPU6050_IIO_H
+#define MPU6050_IIO_H
+
+#include <linux/kconfig.h>
+#include <linux/platform_device.h>
+
+// The MPU6050 as an IIO device (in_accel_*, in_anglvel_*, in_temp_*), next to
+// the char device. Its triggered buffer streams to /dev/iio:deviceN and works
+// with libiio and iio_readdev. Without IIO in the kernel these are no-ops.
+#if IS_ENABLED(CONFIG_IIO_TRIGGERED_BUFFER)
+
+#include <linux/iio/iio.h>
+#include <linux/iio/buffer.h>
+#include <linux/iio/trigger.h>
+#include <linux/iio/trigger_consumer.h>
+#include <linux/iio/triggered_buffer.h>
+#include "MPU6050.h"
+#include "acquisition.h"
+#include "sensor.h"
+
+int mpu6050_iio_init(struct mpu6050_sensor *sensor, struct device *parent);
+void mpu6050_iio_deinit(struct mpu6050_sensor *sensor);
+int mpu6050_iio_trigger_init(struct acquisition *acq, struct device *parent);
+void mpu6050_iio_trigger_deinit(struct acquisition *acq);
+void mpu6050_iio_trigger_poll(struct acquisition *acq);
+
+#else
+
+struct mpu6050_sensor;
+struct acquisition;
+
+static inline int mpu6050_iio_init(struct mpu6050_sensor *sensor, struct device *parent) { return 0; }
+static inline void mpu6050_iio_deinit(struct mpu6050_sensor *sensor) { }
+static inline int mpu6050_iio_trigger_init(struct acquisition *acq, struct device *parent) { return 0; }
+static inline void mpu6050_iio_trigger_deinit(struct acquisition *acq) { }
+static inline void mpu6050_iio_trigger_poll(struct acquisition *acq) { }
+
+#endif
+
+#define MPU6050_IIO_NAME            "mpu6050"
+// Told apart by their bus and address when there are several: "mpu6050-2-68"
+#define MPU6050_IIO_LABEL           "mpu6050-%d-%02x"
+// Data ready trigger of each sensor, fired by its sampling engine for every
+// sample (DRDY mode) or drain (FIFO mode). Only that sensor's device can use it.
+#define MPU6050_IIO_TRIGGER_NAME    "mpu6050-drdy-%d-%02x"
+
+// Temperature in m°C = (raw + OFFSET) * SCALE, from 'raw / 340 + 36.53' in °C
+#define MPU6050_IIO_TEMP_SCALE_MICRO    2941176     // 1000 / 340
+#define MPU6050_IIO_TEMP_OFFSET         12420       // 36.53 * 340 = 12420.2
+#define MPU6050_IIO_TEMP_OFFSET_MICRO   200000
+
+#endif // MPU6050_IIO_H
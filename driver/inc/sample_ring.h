@@ -0,0 +1,49 @@
+#ifndef SAMPLE_RING_H
+#define SAMPLE_RING_H
+
+#include <linux/types.h>
+#include <linux/wait.h>
+#include <linux/compiler.h>
+#include <asm/barrier.h>
+#include <linux/mm.h>
+#include "uapi/lliano_mpu6050.h"
+
+// Amount of samples kept by the ring. Must be a power of two.
+#define SAMPLE_RING_SLOTS 1024
+
+// The ring lives in one vmalloc area that user space can mmap(): a header page
+// followed by the slots (see struct mpu6050_ring_header).
+#define SAMPLE_RING_DATA_OFFSET PAGE_SIZE
+#define SAMPLE_RING_MMAP_SIZE   PAGE_ALIGN(SAMPLE_RING_DATA_OFFSET + \
+                                    SAMPLE_RING_SLOTS * sizeof(struct mpu6050_record))
+
+// Single-producer ring buffer. The producer never blocks: when a reader falls
+// behind, the oldest samples are overwritten and the reader skips over them.
+// Every reader keeps its own tail, so readers never interfere with each other.
+struct sample_ring {
+    struct mpu6050_ring_header *header; // Start of the area. header->head counts the samples pushed.
+    struct mpu6050_record *slots;       // SAMPLE_RING_DATA_OFFSET bytes into the area
+    u32 mask;                           // SAMPLE_RING_SLOTS - 1
+    wait_queue_head_t wait;             // Readers sleep here until head moves.
+};
+
+int sample_ring_init(struct sample_ring *ring);
+void sample_ring_free(struct sample_ring *ring);
+struct mpu6050_record *sample_ring_reserve(struct sample_ring *ring);
+void sample_ring_commit(struct sample_ring *ring);
+int sample_ring_pop(struct sample_ring *ring, u32 *tail, struct mpu6050_record *record, u32 *dropped);
+int sample_ring_mmap(struct sample_ring *ring, struct vm_area_struct *vma);
+
+/// @brief Current head of the ring, as seen by a reader.
+static inline u32 sample_ring_head(struct sample_ring *ring)
+{
+    return smp_load_acquire(&ring->header->head);
+}
+
+/// @brief Amount of samples that a reader at 'tail' has not consumed yet.
+static inline u32 sample_ring_available(struct sample_ring *ring, u32 tail)
+{
+    return sample_ring_head(ring) - tail;
+}
+
+#endif // SAMPLE_RING_H
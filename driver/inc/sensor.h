@@ -0,0 +1,44 @@
+#ifndef SENSOR_H
+#define SENSOR_H
+
+#include <linux/list.h>
+#include <linux/kref.h>
+#include <linux/rwsem.h>
+#include <linux/cdev.h>
+#include <linux/device.h>
+#include "i2c.h"
+#include "MPU6050.h"
+#include "acquisition.h"
+
+// MPU6050 on one bus, one per child node of the device tree (0x68 and 0x69,
+// AD0 low and high). Each bus has this many minors of the char device.
+#define SENSORS_MAX     4
+
+struct iio_dev;
+
+// Everything that belongs to one MPU6050: the sensor, its sampling engine and
+// the devices user space sees it through. The bus holds a reference and every
+// open file another one, so the sensor (and its ring) outlives its removal
+// until the last file is closed. Once 'gone', the bus can't be used anymore.
+struct mpu6050_sensor {
+    struct list_head node;      // In the list of the bus, in probe order
+    unsigned int index;         // Position in that list
+    struct kref ref;
+    struct rw_semaphore lock;   // Read held while a file uses the bus, write to set 'gone'
+    bool gone;                  // Removed from the bus, only its samples are left
+    MPU6050_t mpu;
+    struct acquisition acq;
+    struct cdev *cdev;          // /dev/MPU6050-<bus>-<addr>. Outlives the sensor while open.
+    struct device *char_dev;
+    struct iio_dev *iio;
+};
+
+// A controller and the sensors on its bus, one per platform device
+struct mpu6050_bus {
+    struct i2c_bus i2c;
+    struct list_head sensors;   // struct mpu6050_sensor, in probe order
+};
+
+void sensor_put(struct mpu6050_sensor *sensor);
+
+#endif // SENSOR_H
@@ -0,0 +1,127 @@
+#ifndef _UAPI_LLIANO_MPU6050_H
+#define _UAPI_LLIANO_MPU6050_H
+
+// User space interface of /dev/MPU6050. This header is shared by the driver and
+// by user space programs, so it must only depend on UAPI headers.
+
+#include <linux/types.h>
+#include <linux/ioctl.h>
+
+// Bumped every time the layout or the meaning of struct mpu6050_record changes.
+#define MPU6050_RECORD_VERSION      1
+
+// mpu6050_record.flags
+#define MPU6050_RECORD_F_POLLED     (1 << 0)    // Read on demand by read()
+#define MPU6050_RECORD_F_DRDY       (1 << 1)    // Captured on the data ready interrupt
+#define MPU6050_RECORD_F_FIFO       (1 << 2)    // Drained from the MPU6050 FIFO
+
+// One sample of the sensor. read() returns as many whole records as fit in the
+// user buffer and are available, so the buffer should be N * sizeof(record).
+// Every field is naturally aligned and the axes are in native endianness.
+struct mpu6050_record {
+    __u16 version;          // MPU6050_RECORD_VERSION
+    __u16 flags;            // MPU6050_RECORD_F_*
+    __u32 seq;              // Sample number. A gap means samples were lost.
+    __u64 timestamp_ns;     // CLOCK_MONOTONIC time of the sample (see below)
+    __s16 accel[3];         // Raw ACCEL_[XYZ]OUT. Divide by ioctl(fd, 0) to get g.
+    __s16 temp;             // Raw TEMP_OUT. T[C] = temp / 340 + 36.53
+    __s16 gyro[3];          // Raw GYRO_[XYZ]OUT. Divide by ioctl(fd, 1) / 10 to get deg/s.
+    __u16 reserved;
+};
+
+// mpu6050_record.timestamp_ns is taken by the driver, as close to the sample as
+// each mode allows:
+//  - DRDY: in the data ready interrupt handler, before the sample is read.
+//  - POLLED: when the burst that reads the sample starts on the bus. The sample
+//    is the latest one taken by the sensor, up to a sample period before.
+//  - FIFO: the samples are stamped a sample period apart, with the period
+//    measured against CLOCK_MONOTONIC, so the intervals follow the sensor's
+//    own clock. They are kept within a period of the time the FIFO is counted.
+
+// ioctl() commands. Commands 0 and 1 (accel and gyro scale modifiers) predate
+// these and keep their raw numbers.
+#define MPU6050_IOC_MAGIC           'M'
+
+// Samples that must be waiting for the file to be readable, both for poll() and
+// for a blocking read() (default 1). It is per open file.
+#define MPU6050_IOC_SET_WATERMARK   _IOW(MPU6050_IOC_MAGIC, 0x10, __u32)
+#define MPU6050_IOC_GET_WATERMARK   _IOR(MPU6050_IOC_MAGIC, 0x11, __u32)
+
+/******************************************************************************
+ * Shared memory ring
+ ******************************************************************************
+ * While the driver is streaming (DRDY or FIFO mode), its sample ring can be
+ * mapped read only:
+ *
+ *   mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0)
+ *
+ * The mapping starts with a page holding struct mpu6050_ring_header, followed by
+ * 'slots' records at 'data_offset'. Map one page first to learn 'mmap_size'.
+ *
+ * There is a single producer (the driver) and it never waits for the readers:
+ * 'head' counts the samples published so far, and sample N lives in slot
+ * N & (slots - 1) until sample N + slots overwrites it. Every reader keeps its
+ * own 'tail' (the next sample it wants) in its own memory, so any amount of
+ * readers, mmap() and read() alike, can consume the ring without interfering.
+ * To read sample 'tail':
+ *
+ *   1. head = load-acquire(header->head). If head == tail the ring is empty:
+ *      poll() the same fd (see MPU6050_IOC_SET_WATERMARK) and try again.
+ *   2. If head - tail >= slots the reader fell behind: samples were lost, skip
+ *      to tail = head - slots + 1. The slot at 'head' may be being written.
+ *   3. Copy slots[tail & (slots - 1)], then issue a read (acquire) fence.
+ *   4. Load header->head again. The copy is only valid if head - tail < slots,
+ *      otherwise the producer overwrote it meanwhile: go back to step 1.
+ *
+ * All the counters are __u32 and wrap around, so always compare differences.
+ * mpu6050_ring_pop() below implements these steps.
+ */
+
+struct mpu6050_ring_header {
+    __u32 version;          // MPU6050_RECORD_VERSION of the records
+    __u32 record_size;      // sizeof(struct mpu6050_record)
+    __u32 slots;            // Records in the ring, a power of two
+    __u32 data_offset;      // Offset of the first record from the start of the mapping
+    __u32 mmap_size;        // Size of the whole mapping
+    __u32 reserved[11];
+    __u32 head;             // Samples published. Only the driver writes it. On its own cache line.
+};
+
+#ifndef __KERNEL__
+
+/// @brief Copies the oldest sample of a mapped ring not read yet (see above).
+/// @param base Address returned by mmap().
+/// @param tail Reader position, updated on success.
+/// @param dropped Incremented with the samples overwritten before the reader got to them.
+/// @return "1" if a sample was copied, "0" if the ring is empty.
+static inline int mpu6050_ring_pop(const void *base, __u32 *tail,
+    struct mpu6050_record *record, __u32 *dropped)
+{
+    const struct mpu6050_ring_header *header = (const struct mpu6050_ring_header *) base;
+    const struct mpu6050_record *slots =
+        (const struct mpu6050_record *) ((const char *) base + header->data_offset);
+    __u32 head;
+
+    for (;;) {
+        head = __atomic_load_n(&header->head, __ATOMIC_ACQUIRE);
+        if (head == *tail)
+            return 0;
+
+        if (head - *tail >= header->slots) {
+            *dropped += head - *tail - (header->slots - 1);
+            *tail = head - (header->slots - 1);
+        }
+
+        *record = slots[*tail & (header->slots - 1)];
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&header->head, __ATOMIC_RELAXED) - *tail < header->slots) {
+            (*tail)++;
+            return 1;
+        }
+    }
+}
+
+#endif // __KERNEL__
+
+#endif // _UAPI_LLIANO_MPU6050_H
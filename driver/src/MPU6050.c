@@ -40,69 +40,203 @@ THE SOFTWARE.
 
 #include "MPU6050.h"
 
-MPU6050_t mpu6050;
+/* =========================== REGISTER SHADOW ===================================== */
+/** Check whether a register is kept in the shadow.
+ * Every configuration register between MPU6050_SHADOW_FIRST and
+ * MPU6050_SHADOW_LAST is, so reading it and read-modify-write bit updates
+ * don't touch the bus. Registers changed by the device itself (sensor data,
+ * FIFO, status, the I2C master SLV4 transfer and the DMP memory pointer) are not.
+ * Neither is WHO_AM_I, so testConnection() always asks the device.
+ * @param regAddr Register address
+ * @return True if the register is shadowed
+ */
+bool MPU6050_isShadowed(uint8_t regAddr) {
+    if (regAddr < MPU6050_SHADOW_FIRST || regAddr > MPU6050_SHADOW_LAST)
+        return false;
+    if (regAddr >= MPU6050_RA_I2C_SLV4_CTRL && regAddr <= MPU6050_RA_I2C_MST_STATUS)
+        return false;
+    if (regAddr >= MPU6050_RA_DMP_INT_STATUS && regAddr <= MPU6050_RA_MOT_DETECT_STATUS + 1)
+        return false;
+    if (regAddr == MPU6050_RA_MEM_START_ADDR || regAddr == MPU6050_RA_MEM_R_W)
+        return false;
+    if (regAddr >= MPU6050_RA_FIFO_COUNTH && regAddr <= MPU6050_RA_FIFO_R_W)
+        return false;
+    if (regAddr == MPU6050_RA_WHO_AM_I)
+        return false;
+    return true;
+}
+
+/** Forget every shadowed value, so the next access goes to the bus.
+ * Called by reset(), as the device goes back to its power-on values.
+ * @see resyncShadow()
+ */
+void MPU6050_invalidateShadow(MPU6050_t *dev) {
+    memset(dev->shadowValid, 0, sizeof(dev->shadowValid));
+}
+
+/** Reload the shadow from the device.
+ * Each run of consecutive shadowed registers is read with one burst.
+ * @return Status of read operation (0 = success)
+ */
+int MPU6050_resyncShadow(MPU6050_t *dev) {
+    uint8_t first, last;
+    uint8_t *data;
+
+    MPU6050_invalidateShadow(dev);
+    for (first = MPU6050_SHADOW_FIRST; first <= MPU6050_SHADOW_LAST; first = last + 1) {
+        if (!MPU6050_isShadowed(first)) {
+            last = first;
+            continue;
+        }
+        for (last = first; last < MPU6050_SHADOW_LAST && MPU6050_isShadowed(last + 1); last++);
+
+        data = &dev->shadow[first - MPU6050_SHADOW_FIRST];
+        if (i2c_read_regs(dev->bus, dev->devAddr, first, data, last - first + 1) != 0)
+            return -1;
+        memset(&dev->shadowValid[first - MPU6050_SHADOW_FIRST], true, last - first + 1);
+    }
+    return 0;
+}
+
+/** Serve a read from the shadow, if every register of it is there.
+ * @return True if 'data' was filled
+ */
+static bool MPU6050_readShadow(MPU6050_t *dev, uint8_t regAddr, uint8_t length, uint8_t *data) {
+    unsigned int i;
+
+    for (i = 0; i < length; i++) {
+        if (!MPU6050_isShadowed(regAddr + i) || !dev->shadowValid[regAddr + i - MPU6050_SHADOW_FIRST])
+            return false;
+    }
+    memcpy(data, &dev->shadow[regAddr - MPU6050_SHADOW_FIRST], length);
+    return true;
+}
+
+/** Record values read from or written to the device.
+ * Self-clearing bits are stored as the device will have them afterwards, and a
+ * device reset invalidates the whole shadow.
+ */
+static void MPU6050_updateShadow(MPU6050_t *dev, uint8_t regAddr, uint8_t length, const uint8_t *data) {
+    unsigned int i;
+    uint8_t reg, value;
 
+    for (i = 0; i < length; i++) {
+        reg = regAddr + i;
+        value = data[i];
+        if (!MPU6050_isShadowed(reg))
+            continue;
+
+        if (reg == MPU6050_RA_PWR_MGMT_1 && (value & (1 << MPU6050_PWR1_DEVICE_RESET_BIT))) {
+            MPU6050_invalidateShadow(dev);
+            return;
+        }
+        if (reg == MPU6050_RA_USER_CTRL)
+            value &= ~((1 << MPU6050_USERCTRL_DMP_RESET_BIT) | (1 << MPU6050_USERCTRL_FIFO_RESET_BIT) |
+                (1 << MPU6050_USERCTRL_I2C_MST_RESET_BIT) | (1 << MPU6050_USERCTRL_SIG_COND_RESET_BIT));
+        if (reg == MPU6050_RA_SIGNAL_PATH_RESET)
+            value = 0;
+
+        dev->shadow[reg - MPU6050_SHADOW_FIRST] = value;
+        dev->shadowValid[reg - MPU6050_SHADOW_FIRST] = true;
+    }
+}
 
 /* =========================== R/W ROUTINES ======================================== */
 /** Read multiple bytes from an 8-bit device register.
- * @param devAddr I2C slave device address
+ * Shadowed registers are served from memory when possible, otherwise they are
+ * read in one repeated-start transaction.
+ * @param dev Device
  * @param regAddr First register regAddr to read from
  * @param length Number of bytes to read
  * @param data Buffer to store read data in
  * @return Number of bytes read (-1 indicates failure)
  */
-int8_t MPU6050_readBytes(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8_t *data) {
-    int retVal = -1;
+int8_t MPU6050_readBytes(MPU6050_t *dev, uint8_t regAddr, uint8_t length, uint8_t *data) {
+    if (MPU6050_readShadow(dev, regAddr, length, data))
+        return length;
 
-    if (i2c_write(devAddr, &regAddr, 1) != 0)
-        return retVal;
-    
-    if (i2c_read(devAddr, data, length)!= 0)
-        return retVal;
+    if (i2c_read_regs(dev->bus, dev->devAddr, regAddr, data, length) != 0)
+        return -1;
 
+    MPU6050_updateShadow(dev, regAddr, length, data);
     return length;
 }
 
+/** Read multiple bytes from consecutive 8-bit device registers in one transaction.
+ * The register address is sent and the data is read back after a repeated start,
+ * so the slave samples all the registers at the same instant.
+ * @param dev Device
+ * @param regAddr First register regAddr to read from
+ * @param length Number of bytes to read
+ * @param data Buffer to store read data in
+ * @return Number of bytes read (-1 indicates failure)
+ */
+int MPU6050_readBurst(MPU6050_t *dev, uint8_t regAddr, uint16_t length, uint8_t *data) {
+    if (i2c_read_regs(dev->bus, dev->devAddr, regAddr, data, length) != 0)
+        return -1;
+
+    return length;
+}
+
+/** Burst read of sensor data, queued ahead of any pending configuration access
+ * so that sampling latency doesn't depend on other bus users.
+ * @param regAddr First register regAddr to read from
+ * @param length Number of bytes to read
+ * @param data Buffer to store read data in
+ * @param start_ns If not NULL, ktime_get_ns() at the START of the burst
+ * @return Status of read operation (0 = success)
+ */
+static int MPU6050_readSample(MPU6050_t *dev, uint8_t regAddr, uint16_t length, uint8_t *data, u64 *start_ns) {
+    struct i2c_request req;
+
+    i2c_request_init(&req, dev->devAddr, &regAddr, 1, data, length, I2C_REQ_F_URGENT);
+    if (i2c_execute(dev->bus, &req) != 0)
+        return -1;
+    if (start_ns != NULL)
+        *start_ns = req.start_ns;
+    return 0;
+}
+
 /** Read single byte from an 8-bit device register.
- * @param devAddr I2C slave device address
+ * @param dev Device
  * @param regAddr Register regAddr to read from
  * @param data Container for byte value read from device
  * @return Status of read operation (0 = success)
  */
-int8_t MPU6050_readByte(uint8_t devAddr, uint8_t regAddr, uint8_t *data) {
-    return MPU6050_readBytes(devAddr, regAddr, 1, data);
+int8_t MPU6050_readByte(MPU6050_t *dev, uint8_t regAddr, uint8_t *data) {
+    return MPU6050_readBytes(dev, regAddr, 1, data);
 }
 
 /** Read a single bit from an 8-bit device register.
- * @param devAddr I2C slave device address
+ * @param dev Device
  * @param regAddr Register regAddr to read from
  * @param bitNum Bit position to read (0-7)
  * @param data Container for single bit value
  * @return Status of read operation (0 = success)
  */
-int8_t MPU6050_readBit(uint8_t devAddr, uint8_t regAddr, uint8_t bitNum, uint8_t *data) {
+int8_t MPU6050_readBit(MPU6050_t *dev, uint8_t regAddr, uint8_t bitNum, uint8_t *data) {
     uint8_t b;
-    uint8_t count = MPU6050_readByte(devAddr, regAddr, &b);
+    uint8_t count = MPU6050_readByte(dev, regAddr, &b);
     *data = b & (1 << bitNum);
     return count;
 }
 
 /** Read multiple bits from an 8-bit device register.
- * @param devAddr I2C slave device address
+ * @param dev Device
  * @param regAddr Register regAddr to read from
  * @param bitStart First bit position to read (0-7)
  * @param length Number of bits to read (not more than 8)
  * @param data Container for right-aligned value (i.e. '101' read from any bitStart position will equal 0x05)
  * @return Status of read operation (0 = success)
  */
-int8_t MPU6050_readBits(uint8_t devAddr, uint8_t regAddr, uint8_t bitStart, uint8_t length, uint8_t *data) {
+int8_t MPU6050_readBits(MPU6050_t *dev, uint8_t regAddr, uint8_t bitStart, uint8_t length, uint8_t *data) {
     // 01101001 read byte
     // 76543210 bit numbers
     //    xxx   args: bitStart=4, length=3
     //    010   masked
     //   -> 010 shifted
     uint8_t count, b;
-    if ((count = MPU6050_readByte(devAddr, regAddr, &b)) != 0) {
+    if ((count = MPU6050_readByte(dev, regAddr, &b)) != 0) {
         uint8_t mask = ((1 << length) - 1) << (bitStart - length + 1);
         b &= mask;
         b >>= (bitStart - length + 1);
@@ -112,57 +246,63 @@ int8_t MPU6050_readBits(uint8_t devAddr, uint8_t regAddr, uint8_t bitStart, uint
 }
 
 /** Write single byte to an 8-bit device register.
- * @param devAddr I2C slave device address
+ * @param dev Device
  * @param regAddr Register address to write to
  * @param data New byte value to write
  * @return Status of operation (0 = success)
  */
-int MPU6050_writeByte(uint8_t devAddr, uint8_t regAddr, uint8_t data) {
+int MPU6050_writeByte(MPU6050_t *dev, uint8_t regAddr, uint8_t data) {
 
     uint8_t data_buffer [2] = {regAddr, data};
+    int retVal;
 
-    return i2c_write(devAddr, data_buffer, 2);
+    if ((retVal = i2c_write(dev->bus, dev->devAddr, data_buffer, 2)) == 0)
+        MPU6050_updateShadow(dev, regAddr, 1, &data_buffer[1]);
+    return retVal;
 }
 
 /** Write single word to a 16-bit device register.
- * @param devAddr I2C slave device address
+ * @param dev Device
  * @param regAddr Register address to write to
  * @param data New word value to write
  * @return Status of operation (0 = success)
  */
-int MPU6050_writeWord(uint8_t devAddr, uint8_t regAddr, uint16_t data) {
+int MPU6050_writeWord(MPU6050_t *dev, uint8_t regAddr, uint16_t data) {
     uint8_t data_buffer [3] = {regAddr, data};
 
     data_buffer[0] = regAddr;
     data_buffer[1] = data >> 8;
     data_buffer[2] = data & 0xFF;
 
-    return i2c_write(devAddr, data_buffer, 3);
+    if (i2c_write(dev->bus, dev->devAddr, data_buffer, 3) != 0)
+        return -1;
+    MPU6050_updateShadow(dev, regAddr, 2, &data_buffer[1]);
+    return 0;
 }
 
 /** write a single bit in an 8-bit device register.
- * @param devAddr I2C slave device address
+ * @param dev Device
  * @param regAddr Register regAddr to write to
  * @param bitNum Bit position to write (0-7)
  * @param value New bit value to write
  * @return Status of operation (0 = success)
  */
-int MPU6050_writeBit(uint8_t devAddr, uint8_t regAddr, uint8_t bitNum, uint8_t data) {
+int MPU6050_writeBit(MPU6050_t *dev, uint8_t regAddr, uint8_t bitNum, uint8_t data) {
     uint8_t b;
-    MPU6050_readByte(devAddr, regAddr, &b);
+    if (MPU6050_readByte(dev, regAddr, &b) != 1)
+        return -EIO;
     b = (data != 0) ? (b | (1 << bitNum)) : (b & ~(1 << bitNum));
-    return MPU6050_writeByte(devAddr, regAddr, b);
+    return MPU6050_writeByte(dev, regAddr, b);
 }
 
-/** Write multiple bits in an 8-bit device register.
- * @param devAddr I2C slave device address
- * @param regAddr Register regAddr to write to
+/** Replace a bit field of a register value.
+ * @param b Current register value
  * @param bitStart First bit position to write (0-7)
  * @param length Number of bits to write (not more than 8)
  * @param data Right-aligned value to write
- * @return Status of operation (0 = success)
+ * @return New register value
  */
-int MPU6050_writeBits(uint8_t devAddr, uint8_t regAddr, uint8_t bitStart, uint8_t length, uint8_t data) {
+static uint8_t MPU6050_mergeBits(uint8_t b, uint8_t bitStart, uint8_t length, uint8_t data) {
     //      010 value to write
     // 76543210 bit numbers
     //    xxx   args: bitStart=4, length=3
@@ -170,70 +310,177 @@ int MPU6050_writeBits(uint8_t devAddr, uint8_t regAddr, uint8_t bitStart, uint8_
     // 10101111 original value (sample)
     // 10100011 original & ~mask
     // 10101011 masked | value
+    uint8_t mask = ((1 << length) - 1) << (bitStart - length + 1);
+    data <<= (bitStart - length + 1); // shift data into correct position
+    data &= mask; // zero all non-important bits in data
+    b &= ~(mask); // zero all important bits in existing byte
+    b |= data; // combine data with existing byte
+    return b;
+}
+
+/** Write multiple bits in an 8-bit device register.
+ * @param dev Device
+ * @param regAddr Register regAddr to write to
+ * @param bitStart First bit position to write (0-7)
+ * @param length Number of bits to write (not more than 8)
+ * @param data Right-aligned value to write
+ * @return Status of operation (0 = success)
+ */
+int MPU6050_writeBits(MPU6050_t *dev, uint8_t regAddr, uint8_t bitStart, uint8_t length, uint8_t data) {
     uint8_t b;
-    if (MPU6050_readByte(devAddr, regAddr, &b) != 0) {
-        uint8_t mask = ((1 << length) - 1) << (bitStart - length + 1);
-        data <<= (bitStart - length + 1); // shift data into correct position
-        data &= mask; // zero all non-important bits in data
-        b &= ~(mask); // zero all important bits in existing byte
-        b |= data; // combine data with existing byte
-        return MPU6050_writeByte(devAddr, regAddr, b);
-    } else {
-        return false;
+    if (MPU6050_readByte(dev, regAddr, &b) != 1)
+        return -EIO;
+    return MPU6050_writeByte(dev, regAddr, MPU6050_mergeBits(b, bitStart, length, data));
+}
+
+/* =========================== BURST CONFIGURATION ================================= */
+/** Write consecutive registers with auto-incrementing bursts.
+ * Bursts are at most MPU6050_WRITE_BURST_MAX bytes long, so a range up to that
+ * size takes a single bus transaction.
+ * @param dev Device
+ * @param regAddr First register address to write to
+ * @param length Number of registers to write
+ * @param data New register values
+ * @return Status of operation (0 = success)
+ */
+int MPU6050_writeRegisters(MPU6050_t *dev, uint8_t regAddr, uint8_t length, const uint8_t *data) {
+    uint8_t data_buffer[MPU6050_WRITE_BURST_MAX + 1];
+    uint8_t chunkSize;
+
+    while (length != 0) {
+        chunkSize = min_t(uint8_t, length, MPU6050_WRITE_BURST_MAX);
+        data_buffer[0] = regAddr;
+        memcpy(&data_buffer[1], data, chunkSize);
+        if (i2c_write(dev->bus, dev->devAddr, data_buffer, chunkSize + 1) != 0)
+            return -1;
+        MPU6050_updateShadow(dev, regAddr, chunkSize, data);
+
+        regAddr += chunkSize;
+        data += chunkSize;
+        length -= chunkSize;
+    }
+    return 0;
+}
+
+/** Write a sparse set of registers with the fewest bursts.
+ * Registers are written in address order, so calls must be split where the
+ * order matters. Values that the shadow says are already in place are skipped,
+ * and gaps of up to MPU6050_WRITE_BURST_MAX_GAP valid shadowed registers are
+ * filled with their current values to join two bursts into one. If a register
+ * appears more than once, its last value wins.
+ * @param dev Device
+ * @param list Registers and values
+ * @param count Number of entries of the list
+ * @return Status of operation (0 = success)
+ */
+int MPU6050_writeRegisterList(MPU6050_t *dev, const MPU6050_regval_t *list, uint8_t count) {
+    uint8_t values[256];
+    DECLARE_BITMAP(pending, 256);
+    unsigned int first, last, next, reg, i;
+
+    bitmap_zero(pending, 256);
+    for (i = 0; i < count; i++) {
+        reg = list[i].regAddr;
+        values[reg] = list[i].value;
+        if (MPU6050_isShadowed(reg) && dev->shadowValid[reg - MPU6050_SHADOW_FIRST] &&
+                dev->shadow[reg - MPU6050_SHADOW_FIRST] == list[i].value)
+            clear_bit(reg, pending);
+        else
+            set_bit(reg, pending);
     }
+
+    for (first = find_first_bit(pending, 256); first < 256; first = find_next_bit(pending, 256, last + 1)) {
+        last = first;
+        for (;;) {
+            while (last + 1 < 256 && test_bit(last + 1, pending))
+                last++;
+
+            // Try to bridge the gap up to the next register with the shadow
+            next = find_next_bit(pending, 256, last + 1);
+            if (next >= 256 || next - last - 1 > MPU6050_WRITE_BURST_MAX_GAP)
+                break;
+            for (reg = last + 1; reg < next; reg++) {
+                if (!MPU6050_isShadowed(reg) || !dev->shadowValid[reg - MPU6050_SHADOW_FIRST])
+                    break;
+            }
+            if (reg != next)
+                break;
+            for (reg = last + 1; reg < next; reg++)
+                values[reg] = dev->shadow[reg - MPU6050_SHADOW_FIRST];
+            last = next;
+        }
+
+        if (MPU6050_writeRegisters(dev, first, last - first + 1, &values[first]) != 0)
+            return -1;
+    }
+    return 0;
+}
+
+/** Program sample rate, low pass filter and full scale ranges in one burst.
+ * SMPLRT_DIV, CONFIG, GYRO_CONFIG and ACCEL_CONFIG are consecutive, so the
+ * whole profile is a single bus transaction. The other bits of these registers
+ * (external sync, self-test, high pass filter) keep their current values.
+ * @param profile New configuration
+ * @return Status of operation (0 = success)
+ */
+int MPU6050_setProfile(MPU6050_t *dev, const MPU6050_profile_t *profile) {
+    uint8_t regs[4];
+
+    if (MPU6050_readBytes(dev, MPU6050_RA_SMPLRT_DIV, 4, regs) != 4)
+        return -1;
+
+    regs[0] = profile->rate;
+    regs[1] = MPU6050_mergeBits(regs[1], MPU6050_CFG_DLPF_CFG_BIT, MPU6050_CFG_DLPF_CFG_LENGTH, profile->dlpfMode);
+    regs[2] = MPU6050_mergeBits(regs[2], MPU6050_GCONFIG_FS_SEL_BIT, MPU6050_GCONFIG_FS_SEL_LENGTH, profile->gyroRange);
+    regs[3] = MPU6050_mergeBits(regs[3], MPU6050_ACONFIG_AFS_SEL_BIT, MPU6050_ACONFIG_AFS_SEL_LENGTH, profile->accelRange);
+
+    return MPU6050_writeRegisters(dev, MPU6050_RA_SMPLRT_DIV, 4, regs);
 }
 
 /* ================================================================================== */
 
 
 
-int MPU6050_init(struct platform_device * i2c_plat_dev)
+int MPU6050_init(MPU6050_t *dev, struct i2c_bus *bus, uint8_t address)
 {
     int retVal = -1;
-    int16_t ax, ay, az, gx, gy, gz;
-    int i;
 
-    MPU6050(0x68);
-    pr_info("MPU6050: Testing connection...\n");
+    MPU6050(dev, bus, address);
+    pr_info("MPU6050 %s-0x%02x: Testing connection...\n", bus->name, address);
 
-    if (!MPU6050_testConnection())
+    if (!MPU6050_testConnection(dev))
         return retVal;
 
-    MPU6050_reset();
-    MPU6050_initialize();
-
-    pr_info("MPU6050: Getting some samples...\n");
-
-    for (i = 0; i < 10; i++)
-    {
-        MPU6050_getMotion6(&ax, &ay, &az, &gx, &gy, &gz);
-        pr_info("acc:\t%d\t%d\t%d\n", ax, ay, az);
-        pr_info("vel:\t%d\t%d\t%d\n", gx, gy, gz);
-
-        msleep(25);
-    }
+    // The reset drops the shadow. Reload it once the device is back.
+    MPU6050_reset(dev);
+    msleep(MPU6050_RESET_DELAY_MS);
+    if (MPU6050_resyncShadow(dev) != 0)
+        return retVal;
+    MPU6050_initialize(dev);
 
-    pr_info("MPU6050 - DEV ID: %d\n", MPU6050_getDeviceID());
+    pr_info("MPU6050 %s-0x%02x - DEV ID: %d\n", bus->name, address, MPU6050_getDeviceID(dev));
 
     return 0;
 }
 
-void MPU6050_deinit(void)
+void MPU6050_deinit(MPU6050_t *dev)
 {
-    MPU6050_setSleepEnabled(1);
+    MPU6050_setSleepEnabled(dev, 1);
     return;
 }
 
 
 
 /** Specific address constructor.
+ * @param bus I2C bus the device is on
  * @param address I2C address
  * @see MPU6050_DEFAULT_ADDRESS
  * @see MPU6050_ADDRESS_AD0_LOW
  * @see MPU6050_ADDRESS_AD0_HIGH
  */
-void MPU6050(uint8_t address) {
-    mpu6050.devAddr = address;
+void MPU6050(MPU6050_t *dev, struct i2c_bus *bus, uint8_t address) {
+    dev->bus = bus;
+    dev->devAddr = address;
 }
 
 /** Power on and prepare for general usage.
@@ -243,19 +490,25 @@ void MPU6050(uint8_t address) {
  * the clock source to use the X Gyro for reference, which is slightly better than
  * the default internal clock source.
  */
-void MPU6050_initialize(void) {
-    MPU6050_setSleepEnabled(0); // thanks to Jack Elston for pointing this one out!
-    // MPU6050_setClockSource(MPU6050_CLOCK_PLL_XGYRO);
-    MPU6050_setFullScaleGyroRange(MPU6050_GYRO_FS_250);
-    MPU6050_setFullScaleAccelRange(MPU6050_ACCEL_FS_2);
+void MPU6050_initialize(MPU6050_t *dev) {
+    MPU6050_profile_t profile = {
+        .rate = MPU6050_getRate(dev),
+        .dlpfMode = MPU6050_getDLPFMode(dev),
+        .gyroRange = MPU6050_GYRO_FS_250,
+        .accelRange = MPU6050_ACCEL_FS_2,
+    };
+
+    MPU6050_setSleepEnabled(dev, 0); // thanks to Jack Elston for pointing this one out!
+    // MPU6050_setClockSource(dev, MPU6050_CLOCK_PLL_XGYRO);
+    MPU6050_setProfile(dev, &profile);
 }
 
 /** Verify the I2C connection.
  * Make sure the device is connected and responds as expected.
  * @return True if connection is valid, false otherwise
  */
-bool MPU6050_testConnection(void) {
-    return MPU6050_getDeviceID() == 0x34;
+bool MPU6050_testConnection(MPU6050_t *dev) {
+    return MPU6050_getDeviceID(dev) == 0x34;
 }
 
 // AUX_VDDIO register (InvenSense demo code calls this RA_*G_OFFS_TC)
@@ -266,9 +519,9 @@ bool MPU6050_testConnection(void) {
  * the MPU-6000, which does not have a VLOGIC pin.
  * @return I2C supply voltage level (0=VLOGIC, 1=VDD)
  */
-uint8_t MPU6050_getAuxVDDIOLevel(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_YG_OFFS_TC, MPU6050_TC_PWR_MODE_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+uint8_t MPU6050_getAuxVDDIOLevel(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_YG_OFFS_TC, MPU6050_TC_PWR_MODE_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set the auxiliary I2C supply voltage level.
  * When set to 1, the auxiliary I2C bus high logic level is VDD. When cleared to
@@ -276,8 +529,8 @@ uint8_t MPU6050_getAuxVDDIOLevel(void) {
  * the MPU-6000, which does not have a VLOGIC pin.
  * @param level I2C supply voltage level (0=VLOGIC, 1=VDD)
  */
-void MPU6050_setAuxVDDIOLevel(uint8_t level) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_YG_OFFS_TC, MPU6050_TC_PWR_MODE_BIT, level);
+void MPU6050_setAuxVDDIOLevel(MPU6050_t *dev, uint8_t level) {
+    MPU6050_writeBit(dev, MPU6050_RA_YG_OFFS_TC, MPU6050_TC_PWR_MODE_BIT, level);
 }
 
 // SMPLRT_DIV register
@@ -303,17 +556,17 @@ void MPU6050_setAuxVDDIOLevel(uint8_t level) {
  * @return Current sample rate
  * @see MPU6050_RA_SMPLRT_DIV
  */
-uint8_t MPU6050_getRate(void) {
-    MPU6050_readByte(mpu6050.devAddr, MPU6050_RA_SMPLRT_DIV, mpu6050.buffer);
-    return mpu6050.buffer[0];
+uint8_t MPU6050_getRate(MPU6050_t *dev) {
+    MPU6050_readByte(dev, MPU6050_RA_SMPLRT_DIV, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set gyroscope sample rate divider.
  * @param rate New sample rate divider
  * @see getRate()
  * @see MPU6050_RA_SMPLRT_DIV
  */
-void MPU6050_setRate(uint8_t rate) {
-    MPU6050_writeByte(mpu6050.devAddr, MPU6050_RA_SMPLRT_DIV, rate);
+void MPU6050_setRate(MPU6050_t *dev, uint8_t rate) {
+    MPU6050_writeByte(dev, MPU6050_RA_SMPLRT_DIV, rate);
 }
 
 // CONFIG register
@@ -345,17 +598,17 @@ void MPU6050_setRate(uint8_t rate) {
  *
  * @return FSYNC configuration value
  */
-uint8_t MPU6050_getExternalFrameSync(void) {
-    MPU6050_readBits(mpu6050.devAddr, MPU6050_RA_CONFIG, MPU6050_CFG_EXT_SYNC_SET_BIT, MPU6050_CFG_EXT_SYNC_SET_LENGTH, mpu6050.buffer);
-    return mpu6050.buffer[0];
+uint8_t MPU6050_getExternalFrameSync(MPU6050_t *dev) {
+    MPU6050_readBits(dev, MPU6050_RA_CONFIG, MPU6050_CFG_EXT_SYNC_SET_BIT, MPU6050_CFG_EXT_SYNC_SET_LENGTH, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set external FSYNC configuration.
  * @see getExternalFrameSync()
  * @see MPU6050_RA_CONFIG
  * @param sync New FSYNC configuration value
  */
-void MPU6050_setExternalFrameSync(uint8_t sync) {
-    MPU6050_writeBits(mpu6050.devAddr, MPU6050_RA_CONFIG, MPU6050_CFG_EXT_SYNC_SET_BIT, MPU6050_CFG_EXT_SYNC_SET_LENGTH, sync);
+void MPU6050_setExternalFrameSync(MPU6050_t *dev, uint8_t sync) {
+    MPU6050_writeBits(dev, MPU6050_RA_CONFIG, MPU6050_CFG_EXT_SYNC_SET_BIT, MPU6050_CFG_EXT_SYNC_SET_LENGTH, sync);
 }
 /** Get digital low-pass filter configuration.
  * The DLPF_CFG parameter sets the digital low pass filter configuration. It
@@ -385,9 +638,9 @@ void MPU6050_setExternalFrameSync(uint8_t sync) {
  * @see MPU6050_CFG_DLPF_CFG_BIT
  * @see MPU6050_CFG_DLPF_CFG_LENGTH
  */
-uint8_t MPU6050_getDLPFMode(void) {
-    MPU6050_readBits(mpu6050.devAddr, MPU6050_RA_CONFIG, MPU6050_CFG_DLPF_CFG_BIT, MPU6050_CFG_DLPF_CFG_LENGTH, mpu6050.buffer);
-    return mpu6050.buffer[0];
+uint8_t MPU6050_getDLPFMode(MPU6050_t *dev) {
+    MPU6050_readBits(dev, MPU6050_RA_CONFIG, MPU6050_CFG_DLPF_CFG_BIT, MPU6050_CFG_DLPF_CFG_LENGTH, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set digital low-pass filter configuration.
  * @param mode New DLFP configuration setting
@@ -397,8 +650,8 @@ uint8_t MPU6050_getDLPFMode(void) {
  * @see MPU6050_CFG_DLPF_CFG_BIT
  * @see MPU6050_CFG_DLPF_CFG_LENGTH
  */
-void MPU6050_setDLPFMode(uint8_t mode) {
-    MPU6050_writeBits(mpu6050.devAddr, MPU6050_RA_CONFIG, MPU6050_CFG_DLPF_CFG_BIT, MPU6050_CFG_DLPF_CFG_LENGTH, mode);
+void MPU6050_setDLPFMode(MPU6050_t *dev, uint8_t mode) {
+    MPU6050_writeBits(dev, MPU6050_RA_CONFIG, MPU6050_CFG_DLPF_CFG_BIT, MPU6050_CFG_DLPF_CFG_LENGTH, mode);
 }
 
 // GYRO_CONFIG register
@@ -420,9 +673,9 @@ void MPU6050_setDLPFMode(uint8_t mode) {
  * @see MPU6050_GCONFIG_FS_SEL_BIT
  * @see MPU6050_GCONFIG_FS_SEL_LENGTH
  */
-uint8_t MPU6050_getFullScaleGyroRange(void) {
-    MPU6050_readBits(mpu6050.devAddr, MPU6050_RA_GYRO_CONFIG, MPU6050_GCONFIG_FS_SEL_BIT, MPU6050_GCONFIG_FS_SEL_LENGTH, mpu6050.buffer);
-    return mpu6050.buffer[0];
+uint8_t MPU6050_getFullScaleGyroRange(MPU6050_t *dev) {
+    MPU6050_readBits(dev, MPU6050_RA_GYRO_CONFIG, MPU6050_GCONFIG_FS_SEL_BIT, MPU6050_GCONFIG_FS_SEL_LENGTH, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set full-scale gyroscope range.
  * @param range New full-scale gyroscope range value
@@ -432,8 +685,8 @@ uint8_t MPU6050_getFullScaleGyroRange(void) {
  * @see MPU6050_GCONFIG_FS_SEL_BIT
  * @see MPU6050_GCONFIG_FS_SEL_LENGTH
  */
-void MPU6050_setFullScaleGyroRange(uint8_t range) {
-    MPU6050_writeBits(mpu6050.devAddr, MPU6050_RA_GYRO_CONFIG, MPU6050_GCONFIG_FS_SEL_BIT, MPU6050_GCONFIG_FS_SEL_LENGTH, range);
+void MPU6050_setFullScaleGyroRange(MPU6050_t *dev, uint8_t range) {
+    MPU6050_writeBits(dev, MPU6050_RA_GYRO_CONFIG, MPU6050_GCONFIG_FS_SEL_BIT, MPU6050_GCONFIG_FS_SEL_LENGTH, range);
 }
 
 // ACCEL_CONFIG register
@@ -442,46 +695,46 @@ void MPU6050_setFullScaleGyroRange(uint8_t range) {
  * @return Self-test enabled value
  * @see MPU6050_RA_ACCEL_CONFIG
  */
-bool MPU6050_getAccelXSelfTest(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_ACCEL_CONFIG, MPU6050_ACONFIG_XA_ST_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getAccelXSelfTest(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_ACCEL_CONFIG, MPU6050_ACONFIG_XA_ST_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Get self-test enabled setting for accelerometer X axis.
  * @param enabled Self-test enabled value
  * @see MPU6050_RA_ACCEL_CONFIG
  */
-void MPU6050_setAccelXSelfTest(bool enabled) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_ACCEL_CONFIG, MPU6050_ACONFIG_XA_ST_BIT, enabled);
+void MPU6050_setAccelXSelfTest(MPU6050_t *dev, bool enabled) {
+    MPU6050_writeBit(dev, MPU6050_RA_ACCEL_CONFIG, MPU6050_ACONFIG_XA_ST_BIT, enabled);
 }
 /** Get self-test enabled value for accelerometer Y axis.
  * @return Self-test enabled value
  * @see MPU6050_RA_ACCEL_CONFIG
  */
-bool MPU6050_getAccelYSelfTest(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_ACCEL_CONFIG, MPU6050_ACONFIG_YA_ST_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getAccelYSelfTest(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_ACCEL_CONFIG, MPU6050_ACONFIG_YA_ST_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Get self-test enabled value for accelerometer Y axis.
  * @param enabled Self-test enabled value
  * @see MPU6050_RA_ACCEL_CONFIG
  */
-void MPU6050_setAccelYSelfTest(bool enabled) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_ACCEL_CONFIG, MPU6050_ACONFIG_YA_ST_BIT, enabled);
+void MPU6050_setAccelYSelfTest(MPU6050_t *dev, bool enabled) {
+    MPU6050_writeBit(dev, MPU6050_RA_ACCEL_CONFIG, MPU6050_ACONFIG_YA_ST_BIT, enabled);
 }
 /** Get self-test enabled value for accelerometer Z axis.
  * @return Self-test enabled value
  * @see MPU6050_RA_ACCEL_CONFIG
  */
-bool MPU6050_getAccelZSelfTest(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_ACCEL_CONFIG, MPU6050_ACONFIG_ZA_ST_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getAccelZSelfTest(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_ACCEL_CONFIG, MPU6050_ACONFIG_ZA_ST_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set self-test enabled value for accelerometer Z axis.
  * @param enabled Self-test enabled value
  * @see MPU6050_RA_ACCEL_CONFIG
  */
-void MPU6050_setAccelZSelfTest(bool enabled) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_ACCEL_CONFIG, MPU6050_ACONFIG_ZA_ST_BIT, enabled);
+void MPU6050_setAccelZSelfTest(MPU6050_t *dev, bool enabled) {
+    MPU6050_writeBit(dev, MPU6050_RA_ACCEL_CONFIG, MPU6050_ACONFIG_ZA_ST_BIT, enabled);
 }
 /** Get full-scale accelerometer range.
  * The FS_SEL parameter allows setting the full-scale range of the accelerometer
@@ -500,16 +753,16 @@ void MPU6050_setAccelZSelfTest(bool enabled) {
  * @see MPU6050_ACONFIG_AFS_SEL_BIT
  * @see MPU6050_ACONFIG_AFS_SEL_LENGTH
  */
-uint8_t MPU6050_getFullScaleAccelRange(void) {
-    MPU6050_readBits(mpu6050.devAddr, MPU6050_RA_ACCEL_CONFIG, MPU6050_ACONFIG_AFS_SEL_BIT, MPU6050_ACONFIG_AFS_SEL_LENGTH, mpu6050.buffer);
-    return mpu6050.buffer[0];
+uint8_t MPU6050_getFullScaleAccelRange(MPU6050_t *dev) {
+    MPU6050_readBits(dev, MPU6050_RA_ACCEL_CONFIG, MPU6050_ACONFIG_AFS_SEL_BIT, MPU6050_ACONFIG_AFS_SEL_LENGTH, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set full-scale accelerometer range.
  * @param range New full-scale accelerometer range setting
  * @see getFullScaleAccelRange()
  */
-void MPU6050_setFullScaleAccelRange(uint8_t range) {
-    MPU6050_writeBits(mpu6050.devAddr, MPU6050_RA_ACCEL_CONFIG, MPU6050_ACONFIG_AFS_SEL_BIT, MPU6050_ACONFIG_AFS_SEL_LENGTH, range);
+void MPU6050_setFullScaleAccelRange(MPU6050_t *dev, uint8_t range) {
+    MPU6050_writeBits(dev, MPU6050_RA_ACCEL_CONFIG, MPU6050_ACONFIG_AFS_SEL_BIT, MPU6050_ACONFIG_AFS_SEL_LENGTH, range);
 }
 /** Get the high-pass filter configuration.
  * The DHPF is a filter module in the path leading to motion detectors (Free
@@ -546,9 +799,9 @@ void MPU6050_setFullScaleAccelRange(uint8_t range) {
  * @see MPU6050_DHPF_RESET
  * @see MPU6050_RA_ACCEL_CONFIG
  */
-uint8_t MPU6050_getDHPFMode(void) {
-    MPU6050_readBits(mpu6050.devAddr, MPU6050_RA_ACCEL_CONFIG, MPU6050_ACONFIG_ACCEL_HPF_BIT, MPU6050_ACONFIG_ACCEL_HPF_LENGTH, mpu6050.buffer);
-    return mpu6050.buffer[0];
+uint8_t MPU6050_getDHPFMode(MPU6050_t *dev) {
+    MPU6050_readBits(dev, MPU6050_RA_ACCEL_CONFIG, MPU6050_ACONFIG_ACCEL_HPF_BIT, MPU6050_ACONFIG_ACCEL_HPF_LENGTH, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set the high-pass filter configuration.
  * @param bandwidth New high-pass filter configuration
@@ -556,8 +809,8 @@ uint8_t MPU6050_getDHPFMode(void) {
  * @see MPU6050_DHPF_RESET
  * @see MPU6050_RA_ACCEL_CONFIG
  */
-void MPU6050_setDHPFMode(uint8_t bandwidth) {
-    MPU6050_writeBits(mpu6050.devAddr, MPU6050_RA_ACCEL_CONFIG, MPU6050_ACONFIG_ACCEL_HPF_BIT, MPU6050_ACONFIG_ACCEL_HPF_LENGTH, bandwidth);
+void MPU6050_setDHPFMode(MPU6050_t *dev, uint8_t bandwidth) {
+    MPU6050_writeBits(dev, MPU6050_RA_ACCEL_CONFIG, MPU6050_ACONFIG_ACCEL_HPF_BIT, MPU6050_ACONFIG_ACCEL_HPF_LENGTH, bandwidth);
 }
 
 // FF_THR register
@@ -577,17 +830,17 @@ void MPU6050_setDHPFMode(uint8_t bandwidth) {
  * @return Current free-fall acceleration threshold value (LSB = 2mg)
  * @see MPU6050_RA_FF_THR
  */
-uint8_t MPU6050_getFreefallDetectionThreshold(void) {
-    MPU6050_readByte(mpu6050.devAddr, MPU6050_RA_FF_THR, mpu6050.buffer);
-    return mpu6050.buffer[0];
+uint8_t MPU6050_getFreefallDetectionThreshold(MPU6050_t *dev) {
+    MPU6050_readByte(dev, MPU6050_RA_FF_THR, dev->buffer);
+    return dev->buffer[0];
 }
 /** Get free-fall event acceleration threshold.
  * @param threshold New free-fall acceleration threshold value (LSB = 2mg)
  * @see getFreefallDetectionThreshold()
  * @see MPU6050_RA_FF_THR
  */
-void MPU6050_setFreefallDetectionThreshold(uint8_t threshold) {
-    MPU6050_writeByte(mpu6050.devAddr, MPU6050_RA_FF_THR, threshold);
+void MPU6050_setFreefallDetectionThreshold(MPU6050_t *dev, uint8_t threshold) {
+    MPU6050_writeByte(dev, MPU6050_RA_FF_THR, threshold);
 }
 
 // FF_DUR register
@@ -609,17 +862,17 @@ void MPU6050_setFreefallDetectionThreshold(uint8_t threshold) {
  * @return Current free-fall duration threshold value (LSB = 1ms)
  * @see MPU6050_RA_FF_DUR
  */
-uint8_t MPU6050_getFreefallDetectionDuration(void) {
-    MPU6050_readByte(mpu6050.devAddr, MPU6050_RA_FF_DUR, mpu6050.buffer);
-    return mpu6050.buffer[0];
+uint8_t MPU6050_getFreefallDetectionDuration(MPU6050_t *dev) {
+    MPU6050_readByte(dev, MPU6050_RA_FF_DUR, dev->buffer);
+    return dev->buffer[0];
 }
 /** Get free-fall event duration threshold.
  * @param duration New free-fall duration threshold value (LSB = 1ms)
  * @see getFreefallDetectionDuration()
  * @see MPU6050_RA_FF_DUR
  */
-void MPU6050_setFreefallDetectionDuration(uint8_t duration) {
-    MPU6050_writeByte(mpu6050.devAddr, MPU6050_RA_FF_DUR, duration);
+void MPU6050_setFreefallDetectionDuration(MPU6050_t *dev, uint8_t duration) {
+    MPU6050_writeByte(dev, MPU6050_RA_FF_DUR, duration);
 }
 
 // MOT_THR register
@@ -643,17 +896,17 @@ void MPU6050_setFreefallDetectionDuration(uint8_t duration) {
  * @return Current motion detection acceleration threshold value (LSB = 2mg)
  * @see MPU6050_RA_MOT_THR
  */
-uint8_t MPU6050_getMotionDetectionThreshold(void) {
-    MPU6050_readByte(mpu6050.devAddr, MPU6050_RA_MOT_THR, mpu6050.buffer);
-    return mpu6050.buffer[0];
+uint8_t MPU6050_getMotionDetectionThreshold(MPU6050_t *dev) {
+    MPU6050_readByte(dev, MPU6050_RA_MOT_THR, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set free-fall event acceleration threshold.
  * @param threshold New motion detection acceleration threshold value (LSB = 2mg)
  * @see getMotionDetectionThreshold()
  * @see MPU6050_RA_MOT_THR
  */
-void MPU6050_setMotionDetectionThreshold(uint8_t threshold) {
-    MPU6050_writeByte(mpu6050.devAddr, MPU6050_RA_MOT_THR, threshold);
+void MPU6050_setMotionDetectionThreshold(MPU6050_t *dev, uint8_t threshold) {
+    MPU6050_writeByte(dev, MPU6050_RA_MOT_THR, threshold);
 }
 
 // MOT_DUR register
@@ -673,17 +926,17 @@ void MPU6050_setMotionDetectionThreshold(uint8_t threshold) {
  * @return Current motion detection duration threshold value (LSB = 1ms)
  * @see MPU6050_RA_MOT_DUR
  */
-uint8_t MPU6050_getMotionDetectionDuration(void) {
-    MPU6050_readByte(mpu6050.devAddr, MPU6050_RA_MOT_DUR, mpu6050.buffer);
-    return mpu6050.buffer[0];
+uint8_t MPU6050_getMotionDetectionDuration(MPU6050_t *dev) {
+    MPU6050_readByte(dev, MPU6050_RA_MOT_DUR, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set motion detection event duration threshold.
  * @param duration New motion detection duration threshold value (LSB = 1ms)
  * @see getMotionDetectionDuration()
  * @see MPU6050_RA_MOT_DUR
  */
-void MPU6050_setMotionDetectionDuration(uint8_t duration) {
-    MPU6050_writeByte(mpu6050.devAddr, MPU6050_RA_MOT_DUR, duration);
+void MPU6050_setMotionDetectionDuration(MPU6050_t *dev, uint8_t duration) {
+    MPU6050_writeByte(dev, MPU6050_RA_MOT_DUR, duration);
 }
 
 // ZRMOT_THR register
@@ -713,17 +966,17 @@ void MPU6050_setMotionDetectionDuration(uint8_t duration) {
  * @return Current zero motion detection acceleration threshold value (LSB = 2mg)
  * @see MPU6050_RA_ZRMOT_THR
  */
-uint8_t MPU6050_getZeroMotionDetectionThreshold(void) {
-    MPU6050_readByte(mpu6050.devAddr, MPU6050_RA_ZRMOT_THR, mpu6050.buffer);
-    return mpu6050.buffer[0];
+uint8_t MPU6050_getZeroMotionDetectionThreshold(MPU6050_t *dev) {
+    MPU6050_readByte(dev, MPU6050_RA_ZRMOT_THR, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set zero motion detection event acceleration threshold.
  * @param threshold New zero motion detection acceleration threshold value (LSB = 2mg)
  * @see getZeroMotionDetectionThreshold()
  * @see MPU6050_RA_ZRMOT_THR
  */
-void MPU6050_setZeroMotionDetectionThreshold(uint8_t threshold) {
-    MPU6050_writeByte(mpu6050.devAddr, MPU6050_RA_ZRMOT_THR, threshold);
+void MPU6050_setZeroMotionDetectionThreshold(MPU6050_t *dev, uint8_t threshold) {
+    MPU6050_writeByte(dev, MPU6050_RA_ZRMOT_THR, threshold);
 }
 
 // ZRMOT_DUR register
@@ -744,165 +997,165 @@ void MPU6050_setZeroMotionDetectionThreshold(uint8_t threshold) {
  * @return Current zero motion detection duration threshold value (LSB = 64ms)
  * @see MPU6050_RA_ZRMOT_DUR
  */
-uint8_t MPU6050_getZeroMotionDetectionDuration(void) {
-    MPU6050_readByte(mpu6050.devAddr, MPU6050_RA_ZRMOT_DUR, mpu6050.buffer);
-    return mpu6050.buffer[0];
+uint8_t MPU6050_getZeroMotionDetectionDuration(MPU6050_t *dev) {
+    MPU6050_readByte(dev, MPU6050_RA_ZRMOT_DUR, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set zero motion detection event duration threshold.
  * @param duration New zero motion detection duration threshold value (LSB = 1ms)
  * @see getZeroMotionDetectionDuration()
  * @see MPU6050_RA_ZRMOT_DUR
  */
-void MPU6050_setZeroMotionDetectionDuration(uint8_t duration) {
-    MPU6050_writeByte(mpu6050.devAddr, MPU6050_RA_ZRMOT_DUR, duration);
+void MPU6050_setZeroMotionDetectionDuration(MPU6050_t *dev, uint8_t duration) {
+    MPU6050_writeByte(dev, MPU6050_RA_ZRMOT_DUR, duration);
 }
 
 // FIFO_EN register
 
 /** Get temperature FIFO enabled value.
  * When set to 1, this bit enables TEMP_OUT_H and TEMP_OUT_L (Registers 65 and
- * 66) to be written into the FIFO mpu6050.buffer.
+ * 66) to be written into the FIFO dev->buffer.
  * @return Current temperature FIFO enabled value
  * @see MPU6050_RA_FIFO_EN
  */
-bool MPU6050_getTempFIFOEnabled(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_FIFO_EN, MPU6050_TEMP_FIFO_EN_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getTempFIFOEnabled(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_FIFO_EN, MPU6050_TEMP_FIFO_EN_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set temperature FIFO enabled value.
  * @param enabled New temperature FIFO enabled value
  * @see getTempFIFOEnabled()
  * @see MPU6050_RA_FIFO_EN
  */
-void MPU6050_setTempFIFOEnabled(bool enabled) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_FIFO_EN, MPU6050_TEMP_FIFO_EN_BIT, enabled);
+void MPU6050_setTempFIFOEnabled(MPU6050_t *dev, bool enabled) {
+    MPU6050_writeBit(dev, MPU6050_RA_FIFO_EN, MPU6050_TEMP_FIFO_EN_BIT, enabled);
 }
 /** Get gyroscope X-axis FIFO enabled value.
  * When set to 1, this bit enables GYRO_XOUT_H and GYRO_XOUT_L (Registers 67 and
- * 68) to be written into the FIFO mpu6050.buffer.
+ * 68) to be written into the FIFO dev->buffer.
  * @return Current gyroscope X-axis FIFO enabled value
  * @see MPU6050_RA_FIFO_EN
  */
-bool MPU6050_getXGyroFIFOEnabled(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_FIFO_EN, MPU6050_XG_FIFO_EN_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getXGyroFIFOEnabled(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_FIFO_EN, MPU6050_XG_FIFO_EN_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set gyroscope X-axis FIFO enabled value.
  * @param enabled New gyroscope X-axis FIFO enabled value
  * @see getXGyroFIFOEnabled()
  * @see MPU6050_RA_FIFO_EN
  */
-void MPU6050_setXGyroFIFOEnabled(bool enabled) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_FIFO_EN, MPU6050_XG_FIFO_EN_BIT, enabled);
+void MPU6050_setXGyroFIFOEnabled(MPU6050_t *dev, bool enabled) {
+    MPU6050_writeBit(dev, MPU6050_RA_FIFO_EN, MPU6050_XG_FIFO_EN_BIT, enabled);
 }
 /** Get gyroscope Y-axis FIFO enabled value.
  * When set to 1, this bit enables GYRO_YOUT_H and GYRO_YOUT_L (Registers 69 and
- * 70) to be written into the FIFO mpu6050.buffer.
+ * 70) to be written into the FIFO dev->buffer.
  * @return Current gyroscope Y-axis FIFO enabled value
  * @see MPU6050_RA_FIFO_EN
  */
-bool MPU6050_getYGyroFIFOEnabled(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_FIFO_EN, MPU6050_YG_FIFO_EN_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getYGyroFIFOEnabled(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_FIFO_EN, MPU6050_YG_FIFO_EN_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set gyroscope Y-axis FIFO enabled value.
  * @param enabled New gyroscope Y-axis FIFO enabled value
  * @see getYGyroFIFOEnabled()
  * @see MPU6050_RA_FIFO_EN
  */
-void MPU6050_setYGyroFIFOEnabled(bool enabled) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_FIFO_EN, MPU6050_YG_FIFO_EN_BIT, enabled);
+void MPU6050_setYGyroFIFOEnabled(MPU6050_t *dev, bool enabled) {
+    MPU6050_writeBit(dev, MPU6050_RA_FIFO_EN, MPU6050_YG_FIFO_EN_BIT, enabled);
 }
 /** Get gyroscope Z-axis FIFO enabled value.
  * When set to 1, this bit enables GYRO_ZOUT_H and GYRO_ZOUT_L (Registers 71 and
- * 72) to be written into the FIFO mpu6050.buffer.
+ * 72) to be written into the FIFO dev->buffer.
  * @return Current gyroscope Z-axis FIFO enabled value
  * @see MPU6050_RA_FIFO_EN
  */
-bool MPU6050_getZGyroFIFOEnabled(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_FIFO_EN, MPU6050_ZG_FIFO_EN_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getZGyroFIFOEnabled(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_FIFO_EN, MPU6050_ZG_FIFO_EN_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set gyroscope Z-axis FIFO enabled value.
  * @param enabled New gyroscope Z-axis FIFO enabled value
  * @see getZGyroFIFOEnabled()
  * @see MPU6050_RA_FIFO_EN
  */
-void MPU6050_setZGyroFIFOEnabled(bool enabled) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_FIFO_EN, MPU6050_ZG_FIFO_EN_BIT, enabled);
+void MPU6050_setZGyroFIFOEnabled(MPU6050_t *dev, bool enabled) {
+    MPU6050_writeBit(dev, MPU6050_RA_FIFO_EN, MPU6050_ZG_FIFO_EN_BIT, enabled);
 }
 /** Get accelerometer FIFO enabled value.
  * When set to 1, this bit enables ACCEL_XOUT_H, ACCEL_XOUT_L, ACCEL_YOUT_H,
  * ACCEL_YOUT_L, ACCEL_ZOUT_H, and ACCEL_ZOUT_L (Registers 59 to 64) to be
- * written into the FIFO mpu6050.buffer.
+ * written into the FIFO dev->buffer.
  * @return Current accelerometer FIFO enabled value
  * @see MPU6050_RA_FIFO_EN
  */
-bool MPU6050_getAccelFIFOEnabled(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_FIFO_EN, MPU6050_ACCEL_FIFO_EN_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getAccelFIFOEnabled(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_FIFO_EN, MPU6050_ACCEL_FIFO_EN_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set accelerometer FIFO enabled value.
  * @param enabled New accelerometer FIFO enabled value
  * @see getAccelFIFOEnabled()
  * @see MPU6050_RA_FIFO_EN
  */
-void MPU6050_setAccelFIFOEnabled(bool enabled) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_FIFO_EN, MPU6050_ACCEL_FIFO_EN_BIT, enabled);
+void MPU6050_setAccelFIFOEnabled(MPU6050_t *dev, bool enabled) {
+    MPU6050_writeBit(dev, MPU6050_RA_FIFO_EN, MPU6050_ACCEL_FIFO_EN_BIT, enabled);
 }
 /** Get Slave 2 FIFO enabled value.
  * When set to 1, this bit enables EXT_SENS_DATA registers (Registers 73 to 96)
- * associated with Slave 2 to be written into the FIFO mpu6050.buffer.
+ * associated with Slave 2 to be written into the FIFO dev->buffer.
  * @return Current Slave 2 FIFO enabled value
  * @see MPU6050_RA_FIFO_EN
  */
-bool MPU6050_getSlave2FIFOEnabled(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_FIFO_EN, MPU6050_SLV2_FIFO_EN_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getSlave2FIFOEnabled(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_FIFO_EN, MPU6050_SLV2_FIFO_EN_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set Slave 2 FIFO enabled value.
  * @param enabled New Slave 2 FIFO enabled value
  * @see getSlave2FIFOEnabled()
  * @see MPU6050_RA_FIFO_EN
  */
-void MPU6050_setSlave2FIFOEnabled(bool enabled) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_FIFO_EN, MPU6050_SLV2_FIFO_EN_BIT, enabled);
+void MPU6050_setSlave2FIFOEnabled(MPU6050_t *dev, bool enabled) {
+    MPU6050_writeBit(dev, MPU6050_RA_FIFO_EN, MPU6050_SLV2_FIFO_EN_BIT, enabled);
 }
 /** Get Slave 1 FIFO enabled value.
  * When set to 1, this bit enables EXT_SENS_DATA registers (Registers 73 to 96)
- * associated with Slave 1 to be written into the FIFO mpu6050.buffer.
+ * associated with Slave 1 to be written into the FIFO dev->buffer.
  * @return Current Slave 1 FIFO enabled value
  * @see MPU6050_RA_FIFO_EN
  */
-bool MPU6050_getSlave1FIFOEnabled(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_FIFO_EN, MPU6050_SLV1_FIFO_EN_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getSlave1FIFOEnabled(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_FIFO_EN, MPU6050_SLV1_FIFO_EN_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set Slave 1 FIFO enabled value.
  * @param enabled New Slave 1 FIFO enabled value
  * @see getSlave1FIFOEnabled()
  * @see MPU6050_RA_FIFO_EN
  */
-void MPU6050_setSlave1FIFOEnabled(bool enabled) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_FIFO_EN, MPU6050_SLV1_FIFO_EN_BIT, enabled);
+void MPU6050_setSlave1FIFOEnabled(MPU6050_t *dev, bool enabled) {
+    MPU6050_writeBit(dev, MPU6050_RA_FIFO_EN, MPU6050_SLV1_FIFO_EN_BIT, enabled);
 }
 /** Get Slave 0 FIFO enabled value.
  * When set to 1, this bit enables EXT_SENS_DATA registers (Registers 73 to 96)
- * associated with Slave 0 to be written into the FIFO mpu6050.buffer.
+ * associated with Slave 0 to be written into the FIFO dev->buffer.
  * @return Current Slave 0 FIFO enabled value
  * @see MPU6050_RA_FIFO_EN
  */
-bool MPU6050_getSlave0FIFOEnabled(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_FIFO_EN, MPU6050_SLV0_FIFO_EN_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getSlave0FIFOEnabled(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_FIFO_EN, MPU6050_SLV0_FIFO_EN_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set Slave 0 FIFO enabled value.
  * @param enabled New Slave 0 FIFO enabled value
  * @see getSlave0FIFOEnabled()
  * @see MPU6050_RA_FIFO_EN
  */
-void MPU6050_setSlave0FIFOEnabled(bool enabled) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_FIFO_EN, MPU6050_SLV0_FIFO_EN_BIT, enabled);
+void MPU6050_setSlave0FIFOEnabled(MPU6050_t *dev, bool enabled) {
+    MPU6050_writeBit(dev, MPU6050_RA_FIFO_EN, MPU6050_SLV0_FIFO_EN_BIT, enabled);
 }
 
 // I2C_MST_CTRL register
@@ -922,17 +1175,17 @@ void MPU6050_setSlave0FIFOEnabled(bool enabled) {
  * @return Current multi-master enabled value
  * @see MPU6050_RA_I2C_MST_CTRL
  */
-bool MPU6050_getMultiMasterEnabled(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_I2C_MST_CTRL, MPU6050_MULT_MST_EN_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getMultiMasterEnabled(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_I2C_MST_CTRL, MPU6050_MULT_MST_EN_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set multi-master enabled value.
  * @param enabled New multi-master enabled value
  * @see getMultiMasterEnabled()
  * @see MPU6050_RA_I2C_MST_CTRL
  */
-void MPU6050_setMultiMasterEnabled(bool enabled) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_I2C_MST_CTRL, MPU6050_MULT_MST_EN_BIT, enabled);
+void MPU6050_setMultiMasterEnabled(MPU6050_t *dev, bool enabled) {
+    MPU6050_writeBit(dev, MPU6050_RA_I2C_MST_CTRL, MPU6050_MULT_MST_EN_BIT, enabled);
 }
 /** Get wait-for-external-sensor-data enabled value.
  * When the WAIT_FOR_ES bit is set to 1, the Data Ready interrupt will be
@@ -945,35 +1198,35 @@ void MPU6050_setMultiMasterEnabled(bool enabled) {
  * @return Current wait-for-external-sensor-data enabled value
  * @see MPU6050_RA_I2C_MST_CTRL
  */
-bool MPU6050_getWaitForExternalSensorEnabled(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_I2C_MST_CTRL, MPU6050_WAIT_FOR_ES_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getWaitForExternalSensorEnabled(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_I2C_MST_CTRL, MPU6050_WAIT_FOR_ES_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set wait-for-external-sensor-data enabled value.
  * @param enabled New wait-for-external-sensor-data enabled value
  * @see getWaitForExternalSensorEnabled()
  * @see MPU6050_RA_I2C_MST_CTRL
  */
-void MPU6050_setWaitForExternalSensorEnabled(bool enabled) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_I2C_MST_CTRL, MPU6050_WAIT_FOR_ES_BIT, enabled);
+void MPU6050_setWaitForExternalSensorEnabled(MPU6050_t *dev, bool enabled) {
+    MPU6050_writeBit(dev, MPU6050_RA_I2C_MST_CTRL, MPU6050_WAIT_FOR_ES_BIT, enabled);
 }
 /** Get Slave 3 FIFO enabled value.
  * When set to 1, this bit enables EXT_SENS_DATA registers (Registers 73 to 96)
- * associated with Slave 3 to be written into the FIFO mpu6050.buffer.
+ * associated with Slave 3 to be written into the FIFO dev->buffer.
  * @return Current Slave 3 FIFO enabled value
  * @see MPU6050_RA_MST_CTRL
  */
-bool MPU6050_getSlave3FIFOEnabled(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_I2C_MST_CTRL, MPU6050_SLV_3_FIFO_EN_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getSlave3FIFOEnabled(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_I2C_MST_CTRL, MPU6050_SLV_3_FIFO_EN_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set Slave 3 FIFO enabled value.
  * @param enabled New Slave 3 FIFO enabled value
  * @see getSlave3FIFOEnabled()
  * @see MPU6050_RA_MST_CTRL
  */
-void MPU6050_setSlave3FIFOEnabled(bool enabled) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_I2C_MST_CTRL, MPU6050_SLV_3_FIFO_EN_BIT, enabled);
+void MPU6050_setSlave3FIFOEnabled(MPU6050_t *dev, bool enabled) {
+    MPU6050_writeBit(dev, MPU6050_RA_I2C_MST_CTRL, MPU6050_SLV_3_FIFO_EN_BIT, enabled);
 }
 /** Get slave read/write transition enabled value.
  * The I2C_MST_P_NSR bit configures the I2C Master's transition from one slave
@@ -985,17 +1238,17 @@ void MPU6050_setSlave3FIFOEnabled(bool enabled) {
  * @return Current slave read/write transition enabled value
  * @see MPU6050_RA_I2C_MST_CTRL
  */
-bool MPU6050_getSlaveReadWriteTransitionEnabled(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_I2C_MST_CTRL, MPU6050_I2C_MST_P_NSR_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getSlaveReadWriteTransitionEnabled(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_I2C_MST_CTRL, MPU6050_I2C_MST_P_NSR_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set slave read/write transition enabled value.
  * @param enabled New slave read/write transition enabled value
  * @see getSlaveReadWriteTransitionEnabled()
  * @see MPU6050_RA_I2C_MST_CTRL
  */
-void MPU6050_setSlaveReadWriteTransitionEnabled(bool enabled) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_I2C_MST_CTRL, MPU6050_I2C_MST_P_NSR_BIT, enabled);
+void MPU6050_setSlaveReadWriteTransitionEnabled(MPU6050_t *dev, bool enabled) {
+    MPU6050_writeBit(dev, MPU6050_RA_I2C_MST_CTRL, MPU6050_I2C_MST_P_NSR_BIT, enabled);
 }
 /** Get I2C master clock speed.
  * I2C_MST_CLK is a 4 bit unsigned value which configures a divider on the
@@ -1026,16 +1279,16 @@ void MPU6050_setSlaveReadWriteTransitionEnabled(bool enabled) {
  * @return Current I2C master clock speed
  * @see MPU6050_RA_I2C_MST_CTRL
  */
-uint8_t MPU6050_getMasterClockSpeed(void) {
-    MPU6050_readBits(mpu6050.devAddr, MPU6050_RA_I2C_MST_CTRL, MPU6050_I2C_MST_CLK_BIT, MPU6050_I2C_MST_CLK_LENGTH, mpu6050.buffer);
-    return mpu6050.buffer[0];
+uint8_t MPU6050_getMasterClockSpeed(MPU6050_t *dev) {
+    MPU6050_readBits(dev, MPU6050_RA_I2C_MST_CTRL, MPU6050_I2C_MST_CLK_BIT, MPU6050_I2C_MST_CLK_LENGTH, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set I2C master clock speed.
  * @reparam speed Current I2C master clock speed
  * @see MPU6050_RA_I2C_MST_CTRL
  */
-void MPU6050_setMasterClockSpeed(uint8_t speed) {
-    MPU6050_writeBits(mpu6050.devAddr, MPU6050_RA_I2C_MST_CTRL, MPU6050_I2C_MST_CLK_BIT, MPU6050_I2C_MST_CLK_LENGTH, speed);
+void MPU6050_setMasterClockSpeed(MPU6050_t *dev, uint8_t speed) {
+    MPU6050_writeBits(dev, MPU6050_RA_I2C_MST_CTRL, MPU6050_I2C_MST_CLK_BIT, MPU6050_I2C_MST_CLK_LENGTH, speed);
 }
 
 // I2C_SLV* registers (Slave 0-3)
@@ -1081,10 +1334,10 @@ void MPU6050_setMasterClockSpeed(uint8_t speed) {
  * @return Current address for specified slave
  * @see MPU6050_RA_I2C_SLV0_ADDR
  */
-uint8_t MPU6050_getSlaveAddress(uint8_t num) {
+uint8_t MPU6050_getSlaveAddress(MPU6050_t *dev, uint8_t num) {
     if (num > 3) return 0;
-    MPU6050_readByte(mpu6050.devAddr, MPU6050_RA_I2C_SLV0_ADDR + num*3, mpu6050.buffer);
-    return mpu6050.buffer[0];
+    MPU6050_readByte(dev, MPU6050_RA_I2C_SLV0_ADDR + num*3, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set the I2C address of the specified slave (0-3).
  * @param num Slave number (0-3)
@@ -1092,9 +1345,9 @@ uint8_t MPU6050_getSlaveAddress(uint8_t num) {
  * @see getSlaveAddress()
  * @see MPU6050_RA_I2C_SLV0_ADDR
  */
-void MPU6050_setSlaveAddress(uint8_t num, uint8_t address) {
+void MPU6050_setSlaveAddress(MPU6050_t *dev, uint8_t num, uint8_t address) {
     if (num > 3) return;
-    MPU6050_writeByte(mpu6050.devAddr, MPU6050_RA_I2C_SLV0_ADDR + num*3, address);
+    MPU6050_writeByte(dev, MPU6050_RA_I2C_SLV0_ADDR + num*3, address);
 }
 /** Get the active internal register for the specified slave (0-3).
  * Read/write operations for this slave will be done to whatever internal
@@ -1107,10 +1360,10 @@ void MPU6050_setSlaveAddress(uint8_t num, uint8_t address) {
  * @return Current active register for specified slave
  * @see MPU6050_RA_I2C_SLV0_REG
  */
-uint8_t MPU6050_getSlaveRegister(uint8_t num) {
+uint8_t MPU6050_getSlaveRegister(MPU6050_t *dev, uint8_t num) {
     if (num > 3) return 0;
-    MPU6050_readByte(mpu6050.devAddr, MPU6050_RA_I2C_SLV0_REG + num*3, mpu6050.buffer);
-    return mpu6050.buffer[0];
+    MPU6050_readByte(dev, MPU6050_RA_I2C_SLV0_REG + num*3, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set the active internal register for the specified slave (0-3).
  * @param num Slave number (0-3)
@@ -1118,9 +1371,9 @@ uint8_t MPU6050_getSlaveRegister(uint8_t num) {
  * @see getSlaveRegister()
  * @see MPU6050_RA_I2C_SLV0_REG
  */
-void MPU6050_setSlaveRegister(uint8_t num, uint8_t reg) {
+void MPU6050_setSlaveRegister(MPU6050_t *dev, uint8_t num, uint8_t reg) {
     if (num > 3) return;
-    MPU6050_writeByte(mpu6050.devAddr, MPU6050_RA_I2C_SLV0_REG + num*3, reg);
+    MPU6050_writeByte(dev, MPU6050_RA_I2C_SLV0_REG + num*3, reg);
 }
 /** Get the enabled value for the specified slave (0-3).
  * When set to 1, this bit enables Slave 0 for data transfer operations. When
@@ -1129,10 +1382,10 @@ void MPU6050_setSlaveRegister(uint8_t num, uint8_t reg) {
  * @return Current enabled value for specified slave
  * @see MPU6050_RA_I2C_SLV0_CTRL
  */
-bool MPU6050_getSlaveEnabled(uint8_t num) {
+bool MPU6050_getSlaveEnabled(MPU6050_t *dev, uint8_t num) {
     if (num > 3) return 0;
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_I2C_SLV0_CTRL + num*3, MPU6050_I2C_SLV_EN_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+    MPU6050_readBit(dev, MPU6050_RA_I2C_SLV0_CTRL + num*3, MPU6050_I2C_SLV_EN_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set the enabled value for the specified slave (0-3).
  * @param num Slave number (0-3)
@@ -1140,9 +1393,9 @@ bool MPU6050_getSlaveEnabled(uint8_t num) {
  * @see getSlaveEnabled()
  * @see MPU6050_RA_I2C_SLV0_CTRL
  */
-void MPU6050_setSlaveEnabled(uint8_t num, bool enabled) {
+void MPU6050_setSlaveEnabled(MPU6050_t *dev, uint8_t num, bool enabled) {
     if (num > 3) return;
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_I2C_SLV0_CTRL + num*3, MPU6050_I2C_SLV_EN_BIT, enabled);
+    MPU6050_writeBit(dev, MPU6050_RA_I2C_SLV0_CTRL + num*3, MPU6050_I2C_SLV_EN_BIT, enabled);
 }
 /** Get word pair byte-swapping enabled for the specified slave (0-3).
  * When set to 1, this bit enables byte swapping. When byte swapping is enabled,
@@ -1155,10 +1408,10 @@ void MPU6050_setSlaveEnabled(uint8_t num, bool enabled) {
  * @return Current word pair byte-swapping enabled value for specified slave
  * @see MPU6050_RA_I2C_SLV0_CTRL
  */
-bool MPU6050_getSlaveWordByteSwap(uint8_t num) {
+bool MPU6050_getSlaveWordByteSwap(MPU6050_t *dev, uint8_t num) {
     if (num > 3) return 0;
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_I2C_SLV0_CTRL + num*3, MPU6050_I2C_SLV_BYTE_SW_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+    MPU6050_readBit(dev, MPU6050_RA_I2C_SLV0_CTRL + num*3, MPU6050_I2C_SLV_BYTE_SW_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set word pair byte-swapping enabled for the specified slave (0-3).
  * @param num Slave number (0-3)
@@ -1166,9 +1419,9 @@ bool MPU6050_getSlaveWordByteSwap(uint8_t num) {
  * @see getSlaveWordByteSwap()
  * @see MPU6050_RA_I2C_SLV0_CTRL
  */
-void MPU6050_setSlaveWordByteSwap(uint8_t num, bool enabled) {
+void MPU6050_setSlaveWordByteSwap(MPU6050_t *dev, uint8_t num, bool enabled) {
     if (num > 3) return;
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_I2C_SLV0_CTRL + num*3, MPU6050_I2C_SLV_BYTE_SW_BIT, enabled);
+    MPU6050_writeBit(dev, MPU6050_RA_I2C_SLV0_CTRL + num*3, MPU6050_I2C_SLV_BYTE_SW_BIT, enabled);
 }
 /** Get write mode for the specified slave (0-3).
  * When set to 1, the transaction will read or write data only. When cleared to
@@ -1180,10 +1433,10 @@ void MPU6050_setSlaveWordByteSwap(uint8_t num, bool enabled) {
  * @return Current write mode for specified slave (0 = register address + data, 1 = data only)
  * @see MPU6050_RA_I2C_SLV0_CTRL
  */
-bool MPU6050_getSlaveWriteMode(uint8_t num) {
+bool MPU6050_getSlaveWriteMode(MPU6050_t *dev, uint8_t num) {
     if (num > 3) return 0;
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_I2C_SLV0_CTRL + num*3, MPU6050_I2C_SLV_REG_DIS_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+    MPU6050_readBit(dev, MPU6050_RA_I2C_SLV0_CTRL + num*3, MPU6050_I2C_SLV_REG_DIS_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set write mode for the specified slave (0-3).
  * @param num Slave number (0-3)
@@ -1191,9 +1444,9 @@ bool MPU6050_getSlaveWriteMode(uint8_t num) {
  * @see getSlaveWriteMode()
  * @see MPU6050_RA_I2C_SLV0_CTRL
  */
-void MPU6050_setSlaveWriteMode(uint8_t num, bool mode) {
+void MPU6050_setSlaveWriteMode(MPU6050_t *dev, uint8_t num, bool mode) {
     if (num > 3) return;
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_I2C_SLV0_CTRL + num*3, MPU6050_I2C_SLV_REG_DIS_BIT, mode);
+    MPU6050_writeBit(dev, MPU6050_RA_I2C_SLV0_CTRL + num*3, MPU6050_I2C_SLV_REG_DIS_BIT, mode);
 }
 /** Get word pair grouping order offset for the specified slave (0-3).
  * This sets specifies the grouping order of word pairs received from registers.
@@ -1206,10 +1459,10 @@ void MPU6050_setSlaveWriteMode(uint8_t num, bool mode) {
  * @return Current word pair grouping order offset for specified slave
  * @see MPU6050_RA_I2C_SLV0_CTRL
  */
-bool MPU6050_getSlaveWordGroupOffset(uint8_t num) {
+bool MPU6050_getSlaveWordGroupOffset(MPU6050_t *dev, uint8_t num) {
     if (num > 3) return 0;
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_I2C_SLV0_CTRL + num*3, MPU6050_I2C_SLV_GRP_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+    MPU6050_readBit(dev, MPU6050_RA_I2C_SLV0_CTRL + num*3, MPU6050_I2C_SLV_GRP_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set word pair grouping order offset for the specified slave (0-3).
  * @param num Slave number (0-3)
@@ -1217,9 +1470,9 @@ bool MPU6050_getSlaveWordGroupOffset(uint8_t num) {
  * @see getSlaveWordGroupOffset()
  * @see MPU6050_RA_I2C_SLV0_CTRL
  */
-void MPU6050_setSlaveWordGroupOffset(uint8_t num, bool enabled) {
+void MPU6050_setSlaveWordGroupOffset(MPU6050_t *dev, uint8_t num, bool enabled) {
     if (num > 3) return;
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_I2C_SLV0_CTRL + num*3, MPU6050_I2C_SLV_GRP_BIT, enabled);
+    MPU6050_writeBit(dev, MPU6050_RA_I2C_SLV0_CTRL + num*3, MPU6050_I2C_SLV_GRP_BIT, enabled);
 }
 /** Get number of bytes to read for the specified slave (0-3).
  * Specifies the number of bytes transferred to and from Slave 0. Clearing this
@@ -1228,10 +1481,10 @@ void MPU6050_setSlaveWordGroupOffset(uint8_t num, bool enabled) {
  * @return Number of bytes to read for specified slave
  * @see MPU6050_RA_I2C_SLV0_CTRL
  */
-uint8_t MPU6050_getSlaveDataLength(uint8_t num) {
+uint8_t MPU6050_getSlaveDataLength(MPU6050_t *dev, uint8_t num) {
     if (num > 3) return 0;
-    MPU6050_readBits(mpu6050.devAddr, MPU6050_RA_I2C_SLV0_CTRL + num*3, MPU6050_I2C_SLV_LEN_BIT, MPU6050_I2C_SLV_LEN_LENGTH, mpu6050.buffer);
-    return mpu6050.buffer[0];
+    MPU6050_readBits(dev, MPU6050_RA_I2C_SLV0_CTRL + num*3, MPU6050_I2C_SLV_LEN_BIT, MPU6050_I2C_SLV_LEN_LENGTH, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set number of bytes to read for the specified slave (0-3).
  * @param num Slave number (0-3)
@@ -1239,9 +1492,9 @@ uint8_t MPU6050_getSlaveDataLength(uint8_t num) {
  * @see getSlaveDataLength()
  * @see MPU6050_RA_I2C_SLV0_CTRL
  */
-void MPU6050_setSlaveDataLength(uint8_t num, uint8_t length) {
+void MPU6050_setSlaveDataLength(MPU6050_t *dev, uint8_t num, uint8_t length) {
     if (num > 3) return;
-    MPU6050_writeBits(mpu6050.devAddr, MPU6050_RA_I2C_SLV0_CTRL + num*3, MPU6050_I2C_SLV_LEN_BIT, MPU6050_I2C_SLV_LEN_LENGTH, length);
+    MPU6050_writeBits(dev, MPU6050_RA_I2C_SLV0_CTRL + num*3, MPU6050_I2C_SLV_LEN_BIT, MPU6050_I2C_SLV_LEN_LENGTH, length);
 }
 
 // I2C_SLV* registers (Slave 4)
@@ -1255,17 +1508,17 @@ void MPU6050_setSlaveDataLength(uint8_t num, uint8_t length) {
  * @see getSlaveAddress()
  * @see MPU6050_RA_I2C_SLV4_ADDR
  */
-uint8_t MPU6050_getSlave4Address(void) {
-    MPU6050_readByte(mpu6050.devAddr, MPU6050_RA_I2C_SLV4_ADDR, mpu6050.buffer);
-    return mpu6050.buffer[0];
+uint8_t MPU6050_getSlave4Address(MPU6050_t *dev) {
+    MPU6050_readByte(dev, MPU6050_RA_I2C_SLV4_ADDR, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set the I2C address of Slave 4.
  * @param address New address for Slave 4
  * @see getSlave4Address()
  * @see MPU6050_RA_I2C_SLV4_ADDR
  */
-void MPU6050_setSlave4Address(uint8_t address) {
-    MPU6050_writeByte(mpu6050.devAddr, MPU6050_RA_I2C_SLV4_ADDR, address);
+void MPU6050_setSlave4Address(MPU6050_t *dev, uint8_t address) {
+    MPU6050_writeByte(dev, MPU6050_RA_I2C_SLV4_ADDR, address);
 }
 /** Get the active internal register for the Slave 4.
  * Read/write operations for this slave will be done to whatever internal
@@ -1274,17 +1527,17 @@ void MPU6050_setSlave4Address(uint8_t address) {
  * @return Current active register for Slave 4
  * @see MPU6050_RA_I2C_SLV4_REG
  */
-uint8_t MPU6050_getSlave4Register(void) {
-    MPU6050_readByte(mpu6050.devAddr, MPU6050_RA_I2C_SLV4_REG, mpu6050.buffer);
-    return mpu6050.buffer[0];
+uint8_t MPU6050_getSlave4Register(MPU6050_t *dev) {
+    MPU6050_readByte(dev, MPU6050_RA_I2C_SLV4_REG, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set the active internal register for Slave 4.
  * @param reg New active register for Slave 4
  * @see getSlave4Register()
  * @see MPU6050_RA_I2C_SLV4_REG
  */
-void MPU6050_setSlave4Register(uint8_t reg) {
-    MPU6050_writeByte(mpu6050.devAddr, MPU6050_RA_I2C_SLV4_REG, reg);
+void MPU6050_setSlave4Register(MPU6050_t *dev, uint8_t reg) {
+    MPU6050_writeByte(dev, MPU6050_RA_I2C_SLV4_REG, reg);
 }
 /** Set new byte to write to Slave 4.
  * This register stores the data to be written into the Slave 4. If I2C_SLV4_RW
@@ -1292,8 +1545,8 @@ void MPU6050_setSlave4Register(uint8_t reg) {
  * @param data New byte to write to Slave 4
  * @see MPU6050_RA_I2C_SLV4_DO
  */
-void MPU6050_setSlave4OutputByte(uint8_t data) {
-    MPU6050_writeByte(mpu6050.devAddr, MPU6050_RA_I2C_SLV4_DO, data);
+void MPU6050_setSlave4OutputByte(MPU6050_t *dev, uint8_t data) {
+    MPU6050_writeByte(dev, MPU6050_RA_I2C_SLV4_DO, data);
 }
 /** Get the enabled value for the Slave 4.
  * When set to 1, this bit enables Slave 4 for data transfer operations. When
@@ -1301,17 +1554,17 @@ void MPU6050_setSlave4OutputByte(uint8_t data) {
  * @return Current enabled value for Slave 4
  * @see MPU6050_RA_I2C_SLV4_CTRL
  */
-bool MPU6050_getSlave4Enabled(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_I2C_SLV4_CTRL, MPU6050_I2C_SLV4_EN_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getSlave4Enabled(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_I2C_SLV4_CTRL, MPU6050_I2C_SLV4_EN_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set the enabled value for Slave 4.
  * @param enabled New enabled value for Slave 4
  * @see getSlave4Enabled()
  * @see MPU6050_RA_I2C_SLV4_CTRL
  */
-void MPU6050_setSlave4Enabled(bool enabled) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_I2C_SLV4_CTRL, MPU6050_I2C_SLV4_EN_BIT, enabled);
+void MPU6050_setSlave4Enabled(MPU6050_t *dev, bool enabled) {
+    MPU6050_writeBit(dev, MPU6050_RA_I2C_SLV4_CTRL, MPU6050_I2C_SLV4_EN_BIT, enabled);
 }
 /** Get the enabled value for Slave 4 transaction interrupts.
  * When set to 1, this bit enables the generation of an interrupt signal upon
@@ -1322,17 +1575,17 @@ void MPU6050_setSlave4Enabled(bool enabled) {
  * @return Current enabled value for Slave 4 transaction interrupts.
  * @see MPU6050_RA_I2C_SLV4_CTRL
  */
-bool MPU6050_getSlave4InterruptEnabled(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_I2C_SLV4_CTRL, MPU6050_I2C_SLV4_INT_EN_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getSlave4InterruptEnabled(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_I2C_SLV4_CTRL, MPU6050_I2C_SLV4_INT_EN_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set the enabled value for Slave 4 transaction interrupts.
  * @param enabled New enabled value for Slave 4 transaction interrupts.
  * @see getSlave4InterruptEnabled()
  * @see MPU6050_RA_I2C_SLV4_CTRL
  */
-void MPU6050_setSlave4InterruptEnabled(bool enabled) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_I2C_SLV4_CTRL, MPU6050_I2C_SLV4_INT_EN_BIT, enabled);
+void MPU6050_setSlave4InterruptEnabled(MPU6050_t *dev, bool enabled) {
+    MPU6050_writeBit(dev, MPU6050_RA_I2C_SLV4_CTRL, MPU6050_I2C_SLV4_INT_EN_BIT, enabled);
 }
 /** Get write mode for Slave 4.
  * When set to 1, the transaction will read or write data only. When cleared to
@@ -1343,17 +1596,17 @@ void MPU6050_setSlave4InterruptEnabled(bool enabled) {
  * @return Current write mode for Slave 4 (0 = register address + data, 1 = data only)
  * @see MPU6050_RA_I2C_SLV4_CTRL
  */
-bool MPU6050_getSlave4WriteMode(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_I2C_SLV4_CTRL, MPU6050_I2C_SLV4_REG_DIS_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getSlave4WriteMode(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_I2C_SLV4_CTRL, MPU6050_I2C_SLV4_REG_DIS_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set write mode for the Slave 4.
  * @param mode New write mode for Slave 4 (0 = register address + data, 1 = data only)
  * @see getSlave4WriteMode()
  * @see MPU6050_RA_I2C_SLV4_CTRL
  */
-void MPU6050_setSlave4WriteMode(bool mode) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_I2C_SLV4_CTRL, MPU6050_I2C_SLV4_REG_DIS_BIT, mode);
+void MPU6050_setSlave4WriteMode(MPU6050_t *dev, bool mode) {
+    MPU6050_writeBit(dev, MPU6050_RA_I2C_SLV4_CTRL, MPU6050_I2C_SLV4_REG_DIS_BIT, mode);
 }
 /** Get Slave 4 master delay value.
  * This configures the reduced access rate of I2C slaves relative to the Sample
@@ -1370,17 +1623,17 @@ void MPU6050_setSlave4WriteMode(bool mode) {
  * @return Current Slave 4 master delay value
  * @see MPU6050_RA_I2C_SLV4_CTRL
  */
-uint8_t MPU6050_getSlave4MasterDelay(void) {
-    MPU6050_readBits(mpu6050.devAddr, MPU6050_RA_I2C_SLV4_CTRL, MPU6050_I2C_SLV4_MST_DLY_BIT, MPU6050_I2C_SLV4_MST_DLY_LENGTH, mpu6050.buffer);
-    return mpu6050.buffer[0];
+uint8_t MPU6050_getSlave4MasterDelay(MPU6050_t *dev) {
+    MPU6050_readBits(dev, MPU6050_RA_I2C_SLV4_CTRL, MPU6050_I2C_SLV4_MST_DLY_BIT, MPU6050_I2C_SLV4_MST_DLY_LENGTH, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set Slave 4 master delay value.
  * @param delay New Slave 4 master delay value
  * @see getSlave4MasterDelay()
  * @see MPU6050_RA_I2C_SLV4_CTRL
  */
-void MPU6050_setSlave4MasterDelay(uint8_t delay) {
-    MPU6050_writeBits(mpu6050.devAddr, MPU6050_RA_I2C_SLV4_CTRL, MPU6050_I2C_SLV4_MST_DLY_BIT, MPU6050_I2C_SLV4_MST_DLY_LENGTH, delay);
+void MPU6050_setSlave4MasterDelay(MPU6050_t *dev, uint8_t delay) {
+    MPU6050_writeBits(dev, MPU6050_RA_I2C_SLV4_CTRL, MPU6050_I2C_SLV4_MST_DLY_BIT, MPU6050_I2C_SLV4_MST_DLY_LENGTH, delay);
 }
 /** Get last available byte read from Slave 4.
  * This register stores the data read from Slave 4. This field is populated
@@ -1388,9 +1641,9 @@ void MPU6050_setSlave4MasterDelay(uint8_t delay) {
  * @return Last available byte read from to Slave 4
  * @see MPU6050_RA_I2C_SLV4_DI
  */
-uint8_t MPU6050_getSlate4InputByte(void) {
-    MPU6050_readByte(mpu6050.devAddr, MPU6050_RA_I2C_SLV4_DI, mpu6050.buffer);
-    return mpu6050.buffer[0];
+uint8_t MPU6050_getSlate4InputByte(MPU6050_t *dev) {
+    MPU6050_readByte(dev, MPU6050_RA_I2C_SLV4_DI, dev->buffer);
+    return dev->buffer[0];
 }
 
 // I2C_MST_STATUS register
@@ -1404,9 +1657,9 @@ uint8_t MPU6050_getSlate4InputByte(void) {
  * @return FSYNC interrupt status
  * @see MPU6050_RA_I2C_MST_STATUS
  */
-bool MPU6050_getPassthroughStatus(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_I2C_MST_STATUS, MPU6050_MST_PASS_THROUGH_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getPassthroughStatus(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_I2C_MST_STATUS, MPU6050_MST_PASS_THROUGH_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Get Slave 4 transaction done status.
  * Automatically sets to 1 when a Slave 4 transaction has completed. This
@@ -1416,9 +1669,9 @@ bool MPU6050_getPassthroughStatus(void) {
  * @return Slave 4 transaction done status
  * @see MPU6050_RA_I2C_MST_STATUS
  */
-bool MPU6050_getSlave4IsDone(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_I2C_MST_STATUS, MPU6050_MST_I2C_SLV4_DONE_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getSlave4IsDone(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_I2C_MST_STATUS, MPU6050_MST_I2C_SLV4_DONE_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Get master arbitration lost status.
  * This bit automatically sets to 1 when the I2C Master has lost arbitration of
@@ -1427,9 +1680,9 @@ bool MPU6050_getSlave4IsDone(void) {
  * @return Master arbitration lost status
  * @see MPU6050_RA_I2C_MST_STATUS
  */
-bool MPU6050_getLostArbitration(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_I2C_MST_STATUS, MPU6050_MST_I2C_LOST_ARB_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getLostArbitration(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_I2C_MST_STATUS, MPU6050_MST_I2C_LOST_ARB_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Get Slave 4 NACK status.
  * This bit automatically sets to 1 when the I2C Master receives a NACK in a
@@ -1438,9 +1691,9 @@ bool MPU6050_getLostArbitration(void) {
  * @return Slave 4 NACK interrupt status
  * @see MPU6050_RA_I2C_MST_STATUS
  */
-bool MPU6050_getSlave4Nack(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_I2C_MST_STATUS, MPU6050_MST_I2C_SLV4_NACK_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getSlave4Nack(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_I2C_MST_STATUS, MPU6050_MST_I2C_SLV4_NACK_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Get Slave 3 NACK status.
  * This bit automatically sets to 1 when the I2C Master receives a NACK in a
@@ -1449,9 +1702,9 @@ bool MPU6050_getSlave4Nack(void) {
  * @return Slave 3 NACK interrupt status
  * @see MPU6050_RA_I2C_MST_STATUS
  */
-bool MPU6050_getSlave3Nack(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_I2C_MST_STATUS, MPU6050_MST_I2C_SLV3_NACK_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getSlave3Nack(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_I2C_MST_STATUS, MPU6050_MST_I2C_SLV3_NACK_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Get Slave 2 NACK status.
  * This bit automatically sets to 1 when the I2C Master receives a NACK in a
@@ -1460,9 +1713,9 @@ bool MPU6050_getSlave3Nack(void) {
  * @return Slave 2 NACK interrupt status
  * @see MPU6050_RA_I2C_MST_STATUS
  */
-bool MPU6050_getSlave2Nack(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_I2C_MST_STATUS, MPU6050_MST_I2C_SLV2_NACK_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getSlave2Nack(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_I2C_MST_STATUS, MPU6050_MST_I2C_SLV2_NACK_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Get Slave 1 NACK status.
  * This bit automatically sets to 1 when the I2C Master receives a NACK in a
@@ -1471,9 +1724,9 @@ bool MPU6050_getSlave2Nack(void) {
  * @return Slave 1 NACK interrupt status
  * @see MPU6050_RA_I2C_MST_STATUS
  */
-bool MPU6050_getSlave1Nack(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_I2C_MST_STATUS, MPU6050_MST_I2C_SLV1_NACK_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getSlave1Nack(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_I2C_MST_STATUS, MPU6050_MST_I2C_SLV1_NACK_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Get Slave 0 NACK status.
  * This bit automatically sets to 1 when the I2C Master receives a NACK in a
@@ -1482,9 +1735,9 @@ bool MPU6050_getSlave1Nack(void) {
  * @return Slave 0 NACK interrupt status
  * @see MPU6050_RA_I2C_MST_STATUS
  */
-bool MPU6050_getSlave0Nack(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_I2C_MST_STATUS, MPU6050_MST_I2C_SLV0_NACK_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getSlave0Nack(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_I2C_MST_STATUS, MPU6050_MST_I2C_SLV0_NACK_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 
 // INT_PIN_CFG register
@@ -1495,9 +1748,9 @@ bool MPU6050_getSlave0Nack(void) {
  * @see MPU6050_RA_INT_PIN_CFG
  * @see MPU6050_INTCFG_INT_LEVEL_BIT
  */
-bool MPU6050_getInterruptMode(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_INT_PIN_CFG, MPU6050_INTCFG_INT_LEVEL_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getInterruptMode(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_INT_PIN_CFG, MPU6050_INTCFG_INT_LEVEL_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set interrupt logic level mode.
  * @param mode New interrupt mode (0=active-high, 1=active-low)
@@ -1505,8 +1758,8 @@ bool MPU6050_getInterruptMode(void) {
  * @see MPU6050_RA_INT_PIN_CFG
  * @see MPU6050_INTCFG_INT_LEVEL_BIT
  */
-void MPU6050_setInterruptMode(bool mode) {
-   MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_INT_PIN_CFG, MPU6050_INTCFG_INT_LEVEL_BIT, mode);
+void MPU6050_setInterruptMode(MPU6050_t *dev, bool mode) {
+   MPU6050_writeBit(dev, MPU6050_RA_INT_PIN_CFG, MPU6050_INTCFG_INT_LEVEL_BIT, mode);
 }
 /** Get interrupt drive mode.
  * Will be set 0 for push-pull, 1 for open-drain.
@@ -1514,9 +1767,9 @@ void MPU6050_setInterruptMode(bool mode) {
  * @see MPU6050_RA_INT_PIN_CFG
  * @see MPU6050_INTCFG_INT_OPEN_BIT
  */
-bool MPU6050_getInterruptDrive(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_INT_PIN_CFG, MPU6050_INTCFG_INT_OPEN_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getInterruptDrive(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_INT_PIN_CFG, MPU6050_INTCFG_INT_OPEN_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set interrupt drive mode.
  * @param drive New interrupt drive mode (0=push-pull, 1=open-drain)
@@ -1524,8 +1777,8 @@ bool MPU6050_getInterruptDrive(void) {
  * @see MPU6050_RA_INT_PIN_CFG
  * @see MPU6050_INTCFG_INT_OPEN_BIT
  */
-void MPU6050_setInterruptDrive(bool drive) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_INT_PIN_CFG, MPU6050_INTCFG_INT_OPEN_BIT, drive);
+void MPU6050_setInterruptDrive(MPU6050_t *dev, bool drive) {
+    MPU6050_writeBit(dev, MPU6050_RA_INT_PIN_CFG, MPU6050_INTCFG_INT_OPEN_BIT, drive);
 }
 /** Get interrupt latch mode.
  * Will be set 0 for 50us-pulse, 1 for latch-until-int-cleared.
@@ -1533,9 +1786,9 @@ void MPU6050_setInterruptDrive(bool drive) {
  * @see MPU6050_RA_INT_PIN_CFG
  * @see MPU6050_INTCFG_LATCH_INT_EN_BIT
  */
-bool MPU6050_getInterruptLatch(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_INT_PIN_CFG, MPU6050_INTCFG_LATCH_INT_EN_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getInterruptLatch(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_INT_PIN_CFG, MPU6050_INTCFG_LATCH_INT_EN_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set interrupt latch mode.
  * @param latch New latch mode (0=50us-pulse, 1=latch-until-int-cleared)
@@ -1543,8 +1796,8 @@ bool MPU6050_getInterruptLatch(void) {
  * @see MPU6050_RA_INT_PIN_CFG
  * @see MPU6050_INTCFG_LATCH_INT_EN_BIT
  */
-void MPU6050_setInterruptLatch(bool latch) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_INT_PIN_CFG, MPU6050_INTCFG_LATCH_INT_EN_BIT, latch);
+void MPU6050_setInterruptLatch(MPU6050_t *dev, bool latch) {
+    MPU6050_writeBit(dev, MPU6050_RA_INT_PIN_CFG, MPU6050_INTCFG_LATCH_INT_EN_BIT, latch);
 }
 /** Get interrupt latch clear mode.
  * Will be set 0 for status-read-only, 1 for any-register-read.
@@ -1552,9 +1805,9 @@ void MPU6050_setInterruptLatch(bool latch) {
  * @see MPU6050_RA_INT_PIN_CFG
  * @see MPU6050_INTCFG_INT_RD_CLEAR_BIT
  */
-bool MPU6050_getInterruptLatchClear(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_INT_PIN_CFG, MPU6050_INTCFG_INT_RD_CLEAR_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getInterruptLatchClear(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_INT_PIN_CFG, MPU6050_INTCFG_INT_RD_CLEAR_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set interrupt latch clear mode.
  * @param clear New latch clear mode (0=status-read-only, 1=any-register-read)
@@ -1562,8 +1815,8 @@ bool MPU6050_getInterruptLatchClear(void) {
  * @see MPU6050_RA_INT_PIN_CFG
  * @see MPU6050_INTCFG_INT_RD_CLEAR_BIT
  */
-void MPU6050_setInterruptLatchClear(bool clear) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_INT_PIN_CFG, MPU6050_INTCFG_INT_RD_CLEAR_BIT, clear);
+void MPU6050_setInterruptLatchClear(MPU6050_t *dev, bool clear) {
+    MPU6050_writeBit(dev, MPU6050_RA_INT_PIN_CFG, MPU6050_INTCFG_INT_RD_CLEAR_BIT, clear);
 }
 /** Get FSYNC interrupt logic level mode.
  * @return Current FSYNC interrupt mode (0=active-high, 1=active-low)
@@ -1571,9 +1824,9 @@ void MPU6050_setInterruptLatchClear(bool clear) {
  * @see MPU6050_RA_INT_PIN_CFG
  * @see MPU6050_INTCFG_FSYNC_INT_LEVEL_BIT
  */
-bool MPU6050_getFSyncInterruptLevel(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_INT_PIN_CFG, MPU6050_INTCFG_FSYNC_INT_LEVEL_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getFSyncInterruptLevel(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_INT_PIN_CFG, MPU6050_INTCFG_FSYNC_INT_LEVEL_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set FSYNC interrupt logic level mode.
  * @param mode New FSYNC interrupt mode (0=active-high, 1=active-low)
@@ -1581,8 +1834,8 @@ bool MPU6050_getFSyncInterruptLevel(void) {
  * @see MPU6050_RA_INT_PIN_CFG
  * @see MPU6050_INTCFG_FSYNC_INT_LEVEL_BIT
  */
-void MPU6050_setFSyncInterruptLevel(bool level) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_INT_PIN_CFG, MPU6050_INTCFG_FSYNC_INT_LEVEL_BIT, level);
+void MPU6050_setFSyncInterruptLevel(MPU6050_t *dev, bool level) {
+    MPU6050_writeBit(dev, MPU6050_RA_INT_PIN_CFG, MPU6050_INTCFG_FSYNC_INT_LEVEL_BIT, level);
 }
 /** Get FSYNC pin interrupt enabled setting.
  * Will be set 0 for disabled, 1 for enabled.
@@ -1590,9 +1843,9 @@ void MPU6050_setFSyncInterruptLevel(bool level) {
  * @see MPU6050_RA_INT_PIN_CFG
  * @see MPU6050_INTCFG_FSYNC_INT_EN_BIT
  */
-bool MPU6050_getFSyncInterruptEnabled(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_INT_PIN_CFG, MPU6050_INTCFG_FSYNC_INT_EN_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getFSyncInterruptEnabled(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_INT_PIN_CFG, MPU6050_INTCFG_FSYNC_INT_EN_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set FSYNC pin interrupt enabled setting.
  * @param enabled New FSYNC pin interrupt enabled setting
@@ -1600,8 +1853,8 @@ bool MPU6050_getFSyncInterruptEnabled(void) {
  * @see MPU6050_RA_INT_PIN_CFG
  * @see MPU6050_INTCFG_FSYNC_INT_EN_BIT
  */
-void MPU6050_setFSyncInterruptEnabled(bool enabled) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_INT_PIN_CFG, MPU6050_INTCFG_FSYNC_INT_EN_BIT, enabled);
+void MPU6050_setFSyncInterruptEnabled(MPU6050_t *dev, bool enabled) {
+    MPU6050_writeBit(dev, MPU6050_RA_INT_PIN_CFG, MPU6050_INTCFG_FSYNC_INT_EN_BIT, enabled);
 }
 /** Get I2C bypass enabled status.
  * When this bit is equal to 1 and I2C_MST_EN (Register 106 bit[5]) is equal to
@@ -1614,9 +1867,9 @@ void MPU6050_setFSyncInterruptEnabled(bool enabled) {
  * @see MPU6050_RA_INT_PIN_CFG
  * @see MPU6050_INTCFG_I2C_BYPASS_EN_BIT
  */
-bool MPU6050_getI2CBypassEnabled(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_INT_PIN_CFG, MPU6050_INTCFG_I2C_BYPASS_EN_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getI2CBypassEnabled(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_INT_PIN_CFG, MPU6050_INTCFG_I2C_BYPASS_EN_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set I2C bypass enabled status.
  * When this bit is equal to 1 and I2C_MST_EN (Register 106 bit[5]) is equal to
@@ -1629,8 +1882,8 @@ bool MPU6050_getI2CBypassEnabled(void) {
  * @see MPU6050_RA_INT_PIN_CFG
  * @see MPU6050_INTCFG_I2C_BYPASS_EN_BIT
  */
-void MPU6050_setI2CBypassEnabled(bool enabled) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_INT_PIN_CFG, MPU6050_INTCFG_I2C_BYPASS_EN_BIT, enabled);
+void MPU6050_setI2CBypassEnabled(MPU6050_t *dev, bool enabled) {
+    MPU6050_writeBit(dev, MPU6050_RA_INT_PIN_CFG, MPU6050_INTCFG_I2C_BYPASS_EN_BIT, enabled);
 }
 /** Get reference clock output enabled status.
  * When this bit is equal to 1, a reference clock output is provided at the
@@ -1641,9 +1894,9 @@ void MPU6050_setI2CBypassEnabled(bool enabled) {
  * @see MPU6050_RA_INT_PIN_CFG
  * @see MPU6050_INTCFG_CLKOUT_EN_BIT
  */
-bool MPU6050_getClockOutputEnabled(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_INT_PIN_CFG, MPU6050_INTCFG_CLKOUT_EN_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getClockOutputEnabled(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_INT_PIN_CFG, MPU6050_INTCFG_CLKOUT_EN_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set reference clock output enabled status.
  * When this bit is equal to 1, a reference clock output is provided at the
@@ -1654,8 +1907,8 @@ bool MPU6050_getClockOutputEnabled(void) {
  * @see MPU6050_RA_INT_PIN_CFG
  * @see MPU6050_INTCFG_CLKOUT_EN_BIT
  */
-void MPU6050_setClockOutputEnabled(bool enabled) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_INT_PIN_CFG, MPU6050_INTCFG_CLKOUT_EN_BIT, enabled);
+void MPU6050_setClockOutputEnabled(MPU6050_t *dev, bool enabled) {
+    MPU6050_writeBit(dev, MPU6050_RA_INT_PIN_CFG, MPU6050_INTCFG_CLKOUT_EN_BIT, enabled);
 }
 
 // INT_ENABLE register
@@ -1667,9 +1920,9 @@ void MPU6050_setClockOutputEnabled(bool enabled) {
  * @see MPU6050_RA_INT_ENABLE
  * @see MPU6050_INTERRUPT_FF_BIT
  **/
-uint8_t MPU6050_getIntEnabled(void) {
-    MPU6050_readByte(mpu6050.devAddr, MPU6050_RA_INT_ENABLE, mpu6050.buffer);
-    return mpu6050.buffer[0];
+uint8_t MPU6050_getIntEnabled(MPU6050_t *dev) {
+    MPU6050_readByte(dev, MPU6050_RA_INT_ENABLE, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set full interrupt enabled status.
  * Full register byte for all interrupts, for quick reading. Each bit should be
@@ -1679,8 +1932,8 @@ uint8_t MPU6050_getIntEnabled(void) {
  * @see MPU6050_RA_INT_ENABLE
  * @see MPU6050_INTERRUPT_FF_BIT
  **/
-void MPU6050_setIntEnabled(uint8_t enabled) {
-    MPU6050_writeByte(mpu6050.devAddr, MPU6050_RA_INT_ENABLE, enabled);
+void MPU6050_setIntEnabled(MPU6050_t *dev, uint8_t enabled) {
+    MPU6050_writeByte(dev, MPU6050_RA_INT_ENABLE, enabled);
 }
 /** Get Free Fall interrupt enabled status.
  * Will be set 0 for disabled, 1 for enabled.
@@ -1688,9 +1941,9 @@ void MPU6050_setIntEnabled(uint8_t enabled) {
  * @see MPU6050_RA_INT_ENABLE
  * @see MPU6050_INTERRUPT_FF_BIT
  **/
-bool MPU6050_getIntFreefallEnabled(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_INT_ENABLE, MPU6050_INTERRUPT_FF_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getIntFreefallEnabled(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_INT_ENABLE, MPU6050_INTERRUPT_FF_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set Free Fall interrupt enabled status.
  * @param enabled New interrupt enabled status
@@ -1698,8 +1951,8 @@ bool MPU6050_getIntFreefallEnabled(void) {
  * @see MPU6050_RA_INT_ENABLE
  * @see MPU6050_INTERRUPT_FF_BIT
  **/
-void MPU6050_setIntFreefallEnabled(bool enabled) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_INT_ENABLE, MPU6050_INTERRUPT_FF_BIT, enabled);
+void MPU6050_setIntFreefallEnabled(MPU6050_t *dev, bool enabled) {
+    MPU6050_writeBit(dev, MPU6050_RA_INT_ENABLE, MPU6050_INTERRUPT_FF_BIT, enabled);
 }
 /** Get Motion Detection interrupt enabled status.
  * Will be set 0 for disabled, 1 for enabled.
@@ -1707,9 +1960,9 @@ void MPU6050_setIntFreefallEnabled(bool enabled) {
  * @see MPU6050_RA_INT_ENABLE
  * @see MPU6050_INTERRUPT_MOT_BIT
  **/
-bool MPU6050_getIntMotionEnabled(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_INT_ENABLE, MPU6050_INTERRUPT_MOT_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getIntMotionEnabled(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_INT_ENABLE, MPU6050_INTERRUPT_MOT_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set Motion Detection interrupt enabled status.
  * @param enabled New interrupt enabled status
@@ -1717,8 +1970,8 @@ bool MPU6050_getIntMotionEnabled(void) {
  * @see MPU6050_RA_INT_ENABLE
  * @see MPU6050_INTERRUPT_MOT_BIT
  **/
-void MPU6050_setIntMotionEnabled(bool enabled) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_INT_ENABLE, MPU6050_INTERRUPT_MOT_BIT, enabled);
+void MPU6050_setIntMotionEnabled(MPU6050_t *dev, bool enabled) {
+    MPU6050_writeBit(dev, MPU6050_RA_INT_ENABLE, MPU6050_INTERRUPT_MOT_BIT, enabled);
 }
 /** Get Zero Motion Detection interrupt enabled status.
  * Will be set 0 for disabled, 1 for enabled.
@@ -1726,9 +1979,9 @@ void MPU6050_setIntMotionEnabled(bool enabled) {
  * @see MPU6050_RA_INT_ENABLE
  * @see MPU6050_INTERRUPT_ZMOT_BIT
  **/
-bool MPU6050_getIntZeroMotionEnabled(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_INT_ENABLE, MPU6050_INTERRUPT_ZMOT_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getIntZeroMotionEnabled(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_INT_ENABLE, MPU6050_INTERRUPT_ZMOT_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set Zero Motion Detection interrupt enabled status.
  * @param enabled New interrupt enabled status
@@ -1736,8 +1989,8 @@ bool MPU6050_getIntZeroMotionEnabled(void) {
  * @see MPU6050_RA_INT_ENABLE
  * @see MPU6050_INTERRUPT_ZMOT_BIT
  **/
-void MPU6050_setIntZeroMotionEnabled(bool enabled) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_INT_ENABLE, MPU6050_INTERRUPT_ZMOT_BIT, enabled);
+void MPU6050_setIntZeroMotionEnabled(MPU6050_t *dev, bool enabled) {
+    MPU6050_writeBit(dev, MPU6050_RA_INT_ENABLE, MPU6050_INTERRUPT_ZMOT_BIT, enabled);
 }
 /** Get FIFO Buffer Overflow interrupt enabled status.
  * Will be set 0 for disabled, 1 for enabled.
@@ -1745,9 +1998,9 @@ void MPU6050_setIntZeroMotionEnabled(bool enabled) {
  * @see MPU6050_RA_INT_ENABLE
  * @see MPU6050_INTERRUPT_FIFO_OFLOW_BIT
  **/
-bool MPU6050_getIntFIFOBufferOverflowEnabled(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_INT_ENABLE, MPU6050_INTERRUPT_FIFO_OFLOW_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getIntFIFOBufferOverflowEnabled(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_INT_ENABLE, MPU6050_INTERRUPT_FIFO_OFLOW_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set FIFO Buffer Overflow interrupt enabled status.
  * @param enabled New interrupt enabled status
@@ -1755,8 +2008,8 @@ bool MPU6050_getIntFIFOBufferOverflowEnabled(void) {
  * @see MPU6050_RA_INT_ENABLE
  * @see MPU6050_INTERRUPT_FIFO_OFLOW_BIT
  **/
-void MPU6050_setIntFIFOBufferOverflowEnabled(bool enabled) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_INT_ENABLE, MPU6050_INTERRUPT_FIFO_OFLOW_BIT, enabled);
+void MPU6050_setIntFIFOBufferOverflowEnabled(MPU6050_t *dev, bool enabled) {
+    MPU6050_writeBit(dev, MPU6050_RA_INT_ENABLE, MPU6050_INTERRUPT_FIFO_OFLOW_BIT, enabled);
 }
 /** Get I2C Master interrupt enabled status.
  * This enables any of the I2C Master interrupt sources to generate an
@@ -1765,9 +2018,9 @@ void MPU6050_setIntFIFOBufferOverflowEnabled(bool enabled) {
  * @see MPU6050_RA_INT_ENABLE
  * @see MPU6050_INTERRUPT_I2C_MST_INT_BIT
  **/
-bool MPU6050_getIntI2CMasterEnabled(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_INT_ENABLE, MPU6050_INTERRUPT_I2C_MST_INT_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getIntI2CMasterEnabled(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_INT_ENABLE, MPU6050_INTERRUPT_I2C_MST_INT_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set I2C Master interrupt enabled status.
  * @param enabled New interrupt enabled status
@@ -1775,8 +2028,8 @@ bool MPU6050_getIntI2CMasterEnabled(void) {
  * @see MPU6050_RA_INT_ENABLE
  * @see MPU6050_INTERRUPT_I2C_MST_INT_BIT
  **/
-void MPU6050_setIntI2CMasterEnabled(bool enabled) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_INT_ENABLE, MPU6050_INTERRUPT_I2C_MST_INT_BIT, enabled);
+void MPU6050_setIntI2CMasterEnabled(MPU6050_t *dev, bool enabled) {
+    MPU6050_writeBit(dev, MPU6050_RA_INT_ENABLE, MPU6050_INTERRUPT_I2C_MST_INT_BIT, enabled);
 }
 /** Get Data Ready interrupt enabled setting.
  * This event occurs each time a write operation to all of the sensor registers
@@ -1785,9 +2038,9 @@ void MPU6050_setIntI2CMasterEnabled(bool enabled) {
  * @see MPU6050_RA_INT_ENABLE
  * @see MPU6050_INTERRUPT_DATA_RDY_BIT
  */
-bool MPU6050_getIntDataReadyEnabled(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_INT_ENABLE, MPU6050_INTERRUPT_DATA_RDY_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getIntDataReadyEnabled(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_INT_ENABLE, MPU6050_INTERRUPT_DATA_RDY_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set Data Ready interrupt enabled status.
  * @param enabled New interrupt enabled status
@@ -1795,8 +2048,8 @@ bool MPU6050_getIntDataReadyEnabled(void) {
  * @see MPU6050_RA_INT_CFG
  * @see MPU6050_INTERRUPT_DATA_RDY_BIT
  */
-void MPU6050_setIntDataReadyEnabled(bool enabled) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_INT_ENABLE, MPU6050_INTERRUPT_DATA_RDY_BIT, enabled);
+void MPU6050_setIntDataReadyEnabled(MPU6050_t *dev, bool enabled) {
+    MPU6050_writeBit(dev, MPU6050_RA_INT_ENABLE, MPU6050_INTERRUPT_DATA_RDY_BIT, enabled);
 }
 
 // INT_STATUS register
@@ -1808,9 +2061,9 @@ void MPU6050_setIntDataReadyEnabled(bool enabled) {
  * @return Current interrupt status
  * @see MPU6050_RA_INT_STATUS
  */
-uint8_t MPU6050_getIntStatus(void) {
-    MPU6050_readByte(mpu6050.devAddr, MPU6050_RA_INT_STATUS, mpu6050.buffer);
-    return mpu6050.buffer[0];
+uint8_t MPU6050_getIntStatus(MPU6050_t *dev) {
+    MPU6050_readByte(dev, MPU6050_RA_INT_STATUS, dev->buffer);
+    return dev->buffer[0];
 }
 /** Get Free Fall interrupt status.
  * This bit automatically sets to 1 when a Free Fall interrupt has been
@@ -1819,9 +2072,9 @@ uint8_t MPU6050_getIntStatus(void) {
  * @see MPU6050_RA_INT_STATUS
  * @see MPU6050_INTERRUPT_FF_BIT
  */
-bool MPU6050_getIntFreefallStatus(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_INT_STATUS, MPU6050_INTERRUPT_FF_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getIntFreefallStatus(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_INT_STATUS, MPU6050_INTERRUPT_FF_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Get Motion Detection interrupt status.
  * This bit automatically sets to 1 when a Motion Detection interrupt has been
@@ -1830,9 +2083,9 @@ bool MPU6050_getIntFreefallStatus(void) {
  * @see MPU6050_RA_INT_STATUS
  * @see MPU6050_INTERRUPT_MOT_BIT
  */
-bool MPU6050_getIntMotionStatus(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_INT_STATUS, MPU6050_INTERRUPT_MOT_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getIntMotionStatus(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_INT_STATUS, MPU6050_INTERRUPT_MOT_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Get Zero Motion Detection interrupt status.
  * This bit automatically sets to 1 when a Zero Motion Detection interrupt has
@@ -1841,9 +2094,9 @@ bool MPU6050_getIntMotionStatus(void) {
  * @see MPU6050_RA_INT_STATUS
  * @see MPU6050_INTERRUPT_ZMOT_BIT
  */
-bool MPU6050_getIntZeroMotionStatus(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_INT_STATUS, MPU6050_INTERRUPT_ZMOT_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getIntZeroMotionStatus(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_INT_STATUS, MPU6050_INTERRUPT_ZMOT_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Get FIFO Buffer Overflow interrupt status.
  * This bit automatically sets to 1 when a Free Fall interrupt has been
@@ -1852,9 +2105,9 @@ bool MPU6050_getIntZeroMotionStatus(void) {
  * @see MPU6050_RA_INT_STATUS
  * @see MPU6050_INTERRUPT_FIFO_OFLOW_BIT
  */
-bool MPU6050_getIntFIFOBufferOverflowStatus(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_INT_STATUS, MPU6050_INTERRUPT_FIFO_OFLOW_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getIntFIFOBufferOverflowStatus(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_INT_STATUS, MPU6050_INTERRUPT_FIFO_OFLOW_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Get I2C Master interrupt status.
  * This bit automatically sets to 1 when an I2C Master interrupt has been
@@ -1864,9 +2117,9 @@ bool MPU6050_getIntFIFOBufferOverflowStatus(void) {
  * @see MPU6050_RA_INT_STATUS
  * @see MPU6050_INTERRUPT_I2C_MST_INT_BIT
  */
-bool MPU6050_getIntI2CMasterStatus(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_INT_STATUS, MPU6050_INTERRUPT_I2C_MST_INT_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getIntI2CMasterStatus(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_INT_STATUS, MPU6050_INTERRUPT_I2C_MST_INT_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Get Data Ready interrupt status.
  * This bit automatically sets to 1 when a Data Ready interrupt has been
@@ -1875,9 +2128,9 @@ bool MPU6050_getIntI2CMasterStatus(void) {
  * @see MPU6050_RA_INT_STATUS
  * @see MPU6050_INTERRUPT_DATA_RDY_BIT
  */
-bool MPU6050_getIntDataReadyStatus(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_INT_STATUS, MPU6050_INTERRUPT_DATA_RDY_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getIntDataReadyStatus(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_INT_STATUS, MPU6050_INTERRUPT_DATA_RDY_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 
 // ACCEL_*OUT_* registers
@@ -1898,8 +2151,8 @@ bool MPU6050_getIntDataReadyStatus(void) {
  * @see getRotation()
  * @see MPU6050_RA_ACCEL_XOUT_H
  */
-void MPU6050_getMotion9(int16_t* ax, int16_t* ay, int16_t* az, int16_t* gx, int16_t* gy, int16_t* gz, int16_t* mx, int16_t* my, int16_t* mz) {
-    MPU6050_getMotion6(ax, ay, az, gx, gy, gz);
+void MPU6050_getMotion9(MPU6050_t *dev, int16_t* ax, int16_t* ay, int16_t* az, int16_t* gx, int16_t* gy, int16_t* gz, int16_t* mx, int16_t* my, int16_t* mz) {
+    MPU6050_getMotion6(dev, ax, ay, az, gx, gy, gz);
     // TODO: magnetometer integration
 }
 /** Get raw 6-axis motion sensor readings (accel/gyro).
@@ -1914,15 +2167,65 @@ void MPU6050_getMotion9(int16_t* ax, int16_t* ay, int16_t* az, int16_t* gx, int1
  * @see getRotation()
  * @see MPU6050_RA_ACCEL_XOUT_H
  */
-void MPU6050_getMotion6(uint16_t* ax, uint16_t* ay, uint16_t* az, uint16_t* gx, uint16_t* gy, uint16_t* gz) {
-    MPU6050_setSleepEnabled(0);
-    MPU6050_readBytes(mpu6050.devAddr, MPU6050_RA_ACCEL_XOUT_H, 14, mpu6050.buffer);
-    *ax = (((uint16_t)mpu6050.buffer[0]) << 8) | mpu6050.buffer[1];
-    *ay = (((uint16_t)mpu6050.buffer[2]) << 8) | mpu6050.buffer[3];
-    *az = (((uint16_t)mpu6050.buffer[4]) << 8) | mpu6050.buffer[5];
-    *gx = (((uint16_t)mpu6050.buffer[8]) << 8) | mpu6050.buffer[9];
-    *gy = (((uint16_t)mpu6050.buffer[10]) << 8) | mpu6050.buffer[11];
-    *gz = (((uint16_t)mpu6050.buffer[12]) << 8) | mpu6050.buffer[13];
+void MPU6050_getMotion6(MPU6050_t *dev, uint16_t* ax, uint16_t* ay, uint16_t* az, uint16_t* gx, uint16_t* gy, uint16_t* gz) {
+    MPU6050_setSleepEnabled(dev, 0);
+    MPU6050_readBytes(dev, MPU6050_RA_ACCEL_XOUT_H, 14, dev->buffer);
+    *ax = (((uint16_t)dev->buffer[0]) << 8) | dev->buffer[1];
+    *ay = (((uint16_t)dev->buffer[2]) << 8) | dev->buffer[3];
+    *az = (((uint16_t)dev->buffer[4]) << 8) | dev->buffer[5];
+    *gx = (((uint16_t)dev->buffer[8]) << 8) | dev->buffer[9];
+    *gy = (((uint16_t)dev->buffer[10]) << 8) | dev->buffer[11];
+    *gz = (((uint16_t)dev->buffer[12]) << 8) | dev->buffer[13];
+}
+/** Get raw 7-channel motion sensor readings (accel/temp/gyro).
+ * Reads ACCEL_XOUT_H through GYRO_ZOUT_L in a single repeated-start burst and
+ * leaves the registers untouched (big-endian, in register order):
+ *
+ * <pre>
+ * Byte  | Content
+ * ------+-----------------------
+ * 0-5   | ACCEL_XOUT, _YOUT, _ZOUT
+ * 6-7   | TEMP_OUT
+ * 8-13  | GYRO_XOUT, _YOUT, _ZOUT
+ * </pre>
+ *
+ * Unlike getMotion6(), this does not touch PWR_MGMT_1, so the device must have
+ * been woken up beforehand (see initialize()).
+ * @param data Buffer of at least MPU6050_MOTION7_LENGTH bytes
+ * @return Status of read operation (0 = success)
+ * @see MPU6050_RA_ACCEL_XOUT_H
+ */
+int MPU6050_getMotion7(MPU6050_t *dev, uint8_t *data) {
+    return MPU6050_readSample(dev, MPU6050_RA_ACCEL_XOUT_H, MPU6050_MOTION7_LENGTH, data, NULL);
+}
+/** Same burst as getMotion7(), telling when it started on the bus.
+ * @param data Buffer of at least MPU6050_MOTION7_LENGTH bytes
+ * @param start_ns ktime_get_ns() at the START of the burst
+ * @return Status of read operation (0 = success)
+ * @see getMotion7()
+ */
+int MPU6050_getMotion7Timestamp(MPU6050_t *dev, uint8_t *data, u64 *start_ns) {
+    return MPU6050_readSample(dev, MPU6050_RA_ACCEL_XOUT_H, MPU6050_MOTION7_LENGTH, data, start_ns);
+}
+/** Start the same burst as getMotion7() without waiting for it.
+ * The burst is queued ahead of the configuration accesses and complete() is
+ * called from the I2C interrupt once 'data' is filled, with req->status set.
+ * It must not sleep. 'req' and 'data' must stay valid until then.
+ * @param req Request to use, idle
+ * @param data Buffer of at least MPU6050_MOTION7_LENGTH bytes
+ * @param complete Called when the burst is done
+ * @param context Saved in req->context for complete()
+ * @return Status of submit operation (0 = success)
+ * @see getMotion7()
+ */
+int MPU6050_submitMotion7(MPU6050_t *dev, struct i2c_request *req, uint8_t *data,
+        void (*complete)(struct i2c_request *req), void *context) {
+    static const uint8_t regAddr = MPU6050_RA_ACCEL_XOUT_H;
+
+    i2c_request_init(req, dev->devAddr, &regAddr, 1, data, MPU6050_MOTION7_LENGTH, I2C_REQ_F_URGENT);
+    req->complete = complete;
+    req->context = context;
+    return i2c_submit(dev->bus, req);
 }
 /** Get 3-axis accelerometer readings.
  * These registers store the most recent accelerometer measurements.
@@ -1960,38 +2263,38 @@ void MPU6050_getMotion6(uint16_t* ax, uint16_t* ay, uint16_t* az, uint16_t* gx,
  * @param z 16-bit signed integer container for Z-axis acceleration
  * @see MPU6050_RA_GYRO_XOUT_H
  */
-void MPU6050_getAcceleration(int16_t* x, int16_t* y, int16_t* z) {
-    MPU6050_readBytes(mpu6050.devAddr, MPU6050_RA_ACCEL_XOUT_H, 6, mpu6050.buffer);
-    *x = (((int16_t)mpu6050.buffer[0]) << 8) | mpu6050.buffer[1];
-    *y = (((int16_t)mpu6050.buffer[2]) << 8) | mpu6050.buffer[3];
-    *z = (((int16_t)mpu6050.buffer[4]) << 8) | mpu6050.buffer[5];
+void MPU6050_getAcceleration(MPU6050_t *dev, int16_t* x, int16_t* y, int16_t* z) {
+    MPU6050_readBytes(dev, MPU6050_RA_ACCEL_XOUT_H, 6, dev->buffer);
+    *x = (((int16_t)dev->buffer[0]) << 8) | dev->buffer[1];
+    *y = (((int16_t)dev->buffer[2]) << 8) | dev->buffer[3];
+    *z = (((int16_t)dev->buffer[4]) << 8) | dev->buffer[5];
 }
 /** Get X-axis accelerometer reading.
  * @return X-axis acceleration measurement in 16-bit 2's complement format
  * @see getMotion6()
  * @see MPU6050_RA_ACCEL_XOUT_H
  */
-int16_t MPU6050_getAccelerationX(void) {
-    MPU6050_readBytes(mpu6050.devAddr, MPU6050_RA_ACCEL_XOUT_H, 2, mpu6050.buffer);
-    return (((int16_t)mpu6050.buffer[0]) << 8) | mpu6050.buffer[1];
+int16_t MPU6050_getAccelerationX(MPU6050_t *dev) {
+    MPU6050_readBytes(dev, MPU6050_RA_ACCEL_XOUT_H, 2, dev->buffer);
+    return (((int16_t)dev->buffer[0]) << 8) | dev->buffer[1];
 }
 /** Get Y-axis accelerometer reading.
  * @return Y-axis acceleration measurement in 16-bit 2's complement format
  * @see getMotion6()
  * @see MPU6050_RA_ACCEL_YOUT_H
  */
-int16_t MPU6050_getAccelerationY(void) {
-    MPU6050_readBytes(mpu6050.devAddr, MPU6050_RA_ACCEL_YOUT_H, 2, mpu6050.buffer);
-    return (((int16_t)mpu6050.buffer[0]) << 8) | mpu6050.buffer[1];
+int16_t MPU6050_getAccelerationY(MPU6050_t *dev) {
+    MPU6050_readBytes(dev, MPU6050_RA_ACCEL_YOUT_H, 2, dev->buffer);
+    return (((int16_t)dev->buffer[0]) << 8) | dev->buffer[1];
 }
 /** Get Z-axis accelerometer reading.
  * @return Z-axis acceleration measurement in 16-bit 2's complement format
  * @see getMotion6()
  * @see MPU6050_RA_ACCEL_ZOUT_H
  */
-int16_t MPU6050_getAccelerationZ(void) {
-    MPU6050_readBytes(mpu6050.devAddr, MPU6050_RA_ACCEL_ZOUT_H, 2, mpu6050.buffer);
-    return (((int16_t)mpu6050.buffer[0]) << 8) | mpu6050.buffer[1];
+int16_t MPU6050_getAccelerationZ(MPU6050_t *dev) {
+    MPU6050_readBytes(dev, MPU6050_RA_ACCEL_ZOUT_H, 2, dev->buffer);
+    return (((int16_t)dev->buffer[0]) << 8) | dev->buffer[1];
 }
 
 // TEMP_OUT_* registers
@@ -2000,9 +2303,9 @@ int16_t MPU6050_getAccelerationZ(void) {
  * @return Temperature reading in 16-bit 2's complement format
  * @see MPU6050_RA_TEMP_OUT_H
  */
-uint16_t MPU6050_getTemperature(void) {
-    MPU6050_readBytes(mpu6050.devAddr, MPU6050_RA_TEMP_OUT_H, 2, mpu6050.buffer);
-    return (((uint16_t)mpu6050.buffer[0]) << 8) | mpu6050.buffer[1];
+uint16_t MPU6050_getTemperature(MPU6050_t *dev) {
+    MPU6050_readBytes(dev, MPU6050_RA_TEMP_OUT_H, 2, dev->buffer);
+    return (((uint16_t)dev->buffer[0]) << 8) | dev->buffer[1];
 }
 
 // GYRO_*OUT_* registers
@@ -2039,38 +2342,38 @@ uint16_t MPU6050_getTemperature(void) {
  * @see getMotion6()
  * @see MPU6050_RA_GYRO_XOUT_H
  */
-void MPU6050_getRotation(int16_t* x, int16_t* y, int16_t* z) {
-    MPU6050_readBytes(mpu6050.devAddr, MPU6050_RA_GYRO_XOUT_H, 6, mpu6050.buffer);
-    *x = (((int16_t)mpu6050.buffer[0]) << 8) | mpu6050.buffer[1];
-    *y = (((int16_t)mpu6050.buffer[2]) << 8) | mpu6050.buffer[3];
-    *z = (((int16_t)mpu6050.buffer[4]) << 8) | mpu6050.buffer[5];
+void MPU6050_getRotation(MPU6050_t *dev, int16_t* x, int16_t* y, int16_t* z) {
+    MPU6050_readBytes(dev, MPU6050_RA_GYRO_XOUT_H, 6, dev->buffer);
+    *x = (((int16_t)dev->buffer[0]) << 8) | dev->buffer[1];
+    *y = (((int16_t)dev->buffer[2]) << 8) | dev->buffer[3];
+    *z = (((int16_t)dev->buffer[4]) << 8) | dev->buffer[5];
 }
 /** Get X-axis gyroscope reading.
  * @return X-axis rotation measurement in 16-bit 2's complement format
  * @see getMotion6()
  * @see MPU6050_RA_GYRO_XOUT_H
  */
-int16_t MPU6050_getRotationX(void) {
-    MPU6050_readBytes(mpu6050.devAddr, MPU6050_RA_GYRO_XOUT_H, 2, mpu6050.buffer);
-    return (((int16_t)mpu6050.buffer[0]) << 8) | mpu6050.buffer[1];
+int16_t MPU6050_getRotationX(MPU6050_t *dev) {
+    MPU6050_readBytes(dev, MPU6050_RA_GYRO_XOUT_H, 2, dev->buffer);
+    return (((int16_t)dev->buffer[0]) << 8) | dev->buffer[1];
 }
 /** Get Y-axis gyroscope reading.
  * @return Y-axis rotation measurement in 16-bit 2's complement format
  * @see getMotion6()
  * @see MPU6050_RA_GYRO_YOUT_H
  */
-int16_t MPU6050_getRotationY(void) {
-    MPU6050_readBytes(mpu6050.devAddr, MPU6050_RA_GYRO_YOUT_H, 2, mpu6050.buffer);
-    return (((int16_t)mpu6050.buffer[0]) << 8) | mpu6050.buffer[1];
+int16_t MPU6050_getRotationY(MPU6050_t *dev) {
+    MPU6050_readBytes(dev, MPU6050_RA_GYRO_YOUT_H, 2, dev->buffer);
+    return (((int16_t)dev->buffer[0]) << 8) | dev->buffer[1];
 }
 /** Get Z-axis gyroscope reading.
  * @return Z-axis rotation measurement in 16-bit 2's complement format
  * @see getMotion6()
  * @see MPU6050_RA_GYRO_ZOUT_H
  */
-int16_t MPU6050_getRotationZ(void) {
-    MPU6050_readBytes(mpu6050.devAddr, MPU6050_RA_GYRO_ZOUT_H, 2, mpu6050.buffer);
-    return (((int16_t)mpu6050.buffer[0]) << 8) | mpu6050.buffer[1];
+int16_t MPU6050_getRotationZ(MPU6050_t *dev) {
+    MPU6050_readBytes(dev, MPU6050_RA_GYRO_ZOUT_H, 2, dev->buffer);
+    return (((int16_t)dev->buffer[0]) << 8) | dev->buffer[1];
 }
 
 // EXT_SENS_DATA_* registers
@@ -2149,27 +2452,27 @@ int16_t MPU6050_getRotationZ(void) {
  * @param position Starting position (0-23)
  * @return Byte read from register
  */
-uint8_t MPU6050_getExternalSensorByte(int position) {
-    MPU6050_readByte(mpu6050.devAddr, MPU6050_RA_EXT_SENS_DATA_00 + position, mpu6050.buffer);
-    return mpu6050.buffer[0];
+uint8_t MPU6050_getExternalSensorByte(MPU6050_t *dev, int position) {
+    MPU6050_readByte(dev, MPU6050_RA_EXT_SENS_DATA_00 + position, dev->buffer);
+    return dev->buffer[0];
 }
 /** Read word (2 bytes) from external sensor data registers.
  * @param position Starting position (0-21)
  * @return Word read from register
  * @see getExternalSensorByte()
  */
-uint16_t MPU6050_getExternalSensorWord(int position) {
-    MPU6050_readBytes(mpu6050.devAddr, MPU6050_RA_EXT_SENS_DATA_00 + position, 2, mpu6050.buffer);
-    return (((uint16_t)mpu6050.buffer[0]) << 8) | mpu6050.buffer[1];
+uint16_t MPU6050_getExternalSensorWord(MPU6050_t *dev, int position) {
+    MPU6050_readBytes(dev, MPU6050_RA_EXT_SENS_DATA_00 + position, 2, dev->buffer);
+    return (((uint16_t)dev->buffer[0]) << 8) | dev->buffer[1];
 }
 /** Read double word (4 bytes) from external sensor data registers.
  * @param position Starting position (0-20)
  * @return Double word read from registers
  * @see getExternalSensorByte()
  */
-uint32_t MPU6050_getExternalSensorDWord(int position) {
-    MPU6050_readBytes(mpu6050.devAddr, MPU6050_RA_EXT_SENS_DATA_00 + position, 4, mpu6050.buffer);
-    return (((uint32_t)mpu6050.buffer[0]) << 24) | (((uint32_t)mpu6050.buffer[1]) << 16) | (((uint16_t)mpu6050.buffer[2]) << 8) | mpu6050.buffer[3];
+uint32_t MPU6050_getExternalSensorDWord(MPU6050_t *dev, int position) {
+    MPU6050_readBytes(dev, MPU6050_RA_EXT_SENS_DATA_00 + position, 4, dev->buffer);
+    return (((uint32_t)dev->buffer[0]) << 24) | (((uint32_t)dev->buffer[1]) << 16) | (((uint16_t)dev->buffer[2]) << 8) | dev->buffer[3];
 }
 
 // MOT_DETECT_STATUS register
@@ -2179,63 +2482,63 @@ uint32_t MPU6050_getExternalSensorDWord(int position) {
  * @see MPU6050_RA_MOT_DETECT_STATUS
  * @see MPU6050_MOTION_MOT_XNEG_BIT
  */
-bool MPU6050_getXNegMotionDetected(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_MOT_DETECT_STATUS, MPU6050_MOTION_MOT_XNEG_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getXNegMotionDetected(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_MOT_DETECT_STATUS, MPU6050_MOTION_MOT_XNEG_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Get X-axis positive motion detection interrupt status.
  * @return Motion detection status
  * @see MPU6050_RA_MOT_DETECT_STATUS
  * @see MPU6050_MOTION_MOT_XPOS_BIT
  */
-bool MPU6050_getXPosMotionDetected(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_MOT_DETECT_STATUS, MPU6050_MOTION_MOT_XPOS_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getXPosMotionDetected(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_MOT_DETECT_STATUS, MPU6050_MOTION_MOT_XPOS_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Get Y-axis negative motion detection interrupt status.
  * @return Motion detection status
  * @see MPU6050_RA_MOT_DETECT_STATUS
  * @see MPU6050_MOTION_MOT_YNEG_BIT
  */
-bool MPU6050_getYNegMotionDetected(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_MOT_DETECT_STATUS, MPU6050_MOTION_MOT_YNEG_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getYNegMotionDetected(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_MOT_DETECT_STATUS, MPU6050_MOTION_MOT_YNEG_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Get Y-axis positive motion detection interrupt status.
  * @return Motion detection status
  * @see MPU6050_RA_MOT_DETECT_STATUS
  * @see MPU6050_MOTION_MOT_YPOS_BIT
  */
-bool MPU6050_getYPosMotionDetected(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_MOT_DETECT_STATUS, MPU6050_MOTION_MOT_YPOS_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getYPosMotionDetected(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_MOT_DETECT_STATUS, MPU6050_MOTION_MOT_YPOS_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Get Z-axis negative motion detection interrupt status.
  * @return Motion detection status
  * @see MPU6050_RA_MOT_DETECT_STATUS
  * @see MPU6050_MOTION_MOT_ZNEG_BIT
  */
-bool MPU6050_getZNegMotionDetected(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_MOT_DETECT_STATUS, MPU6050_MOTION_MOT_ZNEG_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getZNegMotionDetected(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_MOT_DETECT_STATUS, MPU6050_MOTION_MOT_ZNEG_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Get Z-axis positive motion detection interrupt status.
  * @return Motion detection status
  * @see MPU6050_RA_MOT_DETECT_STATUS
  * @see MPU6050_MOTION_MOT_ZPOS_BIT
  */
-bool MPU6050_getZPosMotionDetected(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_MOT_DETECT_STATUS, MPU6050_MOTION_MOT_ZPOS_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getZPosMotionDetected(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_MOT_DETECT_STATUS, MPU6050_MOTION_MOT_ZPOS_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Get zero motion detection interrupt status.
  * @return Motion detection status
  * @see MPU6050_RA_MOT_DETECT_STATUS
  * @see MPU6050_MOTION_MOT_ZRMOT_BIT
  */
-bool MPU6050_getZeroMotionDetected(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_MOT_DETECT_STATUS, MPU6050_MOTION_MOT_ZRMOT_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getZeroMotionDetected(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_MOT_DETECT_STATUS, MPU6050_MOTION_MOT_ZRMOT_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 
 // I2C_SLV*_DO register
@@ -2248,9 +2551,9 @@ bool MPU6050_getZeroMotionDetected(void) {
  * @param data Byte to write
  * @see MPU6050_RA_I2C_SLV0_DO
  */
-void MPU6050_setSlaveOutputByte(uint8_t num, uint8_t data) {
+void MPU6050_setSlaveOutputByte(MPU6050_t *dev, uint8_t num, uint8_t data) {
     if (num > 3) return;
-    MPU6050_writeByte(mpu6050.devAddr, MPU6050_RA_I2C_SLV0_DO + num, data);
+    MPU6050_writeByte(dev, MPU6050_RA_I2C_SLV0_DO + num, data);
 }
 
 // I2C_MST_DELAY_CTRL register
@@ -2263,9 +2566,9 @@ void MPU6050_setSlaveOutputByte(uint8_t num, uint8_t data) {
  * @see MPU6050_RA_I2C_MST_DELAY_CTRL
  * @see MPU6050_DELAYCTRL_DELAY_ES_SHADOW_BIT
  */
-bool MPU6050_getExternalShadowDelayEnabled(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_I2C_MST_DELAY_CTRL, MPU6050_DELAYCTRL_DELAY_ES_SHADOW_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getExternalShadowDelayEnabled(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_I2C_MST_DELAY_CTRL, MPU6050_DELAYCTRL_DELAY_ES_SHADOW_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set external data shadow delay enabled status.
  * @param enabled New external data shadow delay enabled status.
@@ -2273,8 +2576,8 @@ bool MPU6050_getExternalShadowDelayEnabled(void) {
  * @see MPU6050_RA_I2C_MST_DELAY_CTRL
  * @see MPU6050_DELAYCTRL_DELAY_ES_SHADOW_BIT
  */
-void MPU6050_setExternalShadowDelayEnabled(bool enabled) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_I2C_MST_DELAY_CTRL, MPU6050_DELAYCTRL_DELAY_ES_SHADOW_BIT, enabled);
+void MPU6050_setExternalShadowDelayEnabled(MPU6050_t *dev, bool enabled) {
+    MPU6050_writeBit(dev, MPU6050_RA_I2C_MST_DELAY_CTRL, MPU6050_DELAYCTRL_DELAY_ES_SHADOW_BIT, enabled);
 }
 /** Get slave delay enabled status.
  * When a particular slave delay is enabled, the rate of access for the that
@@ -2294,11 +2597,11 @@ void MPU6050_setExternalShadowDelayEnabled(bool enabled) {
  * @see MPU6050_RA_I2C_MST_DELAY_CTRL
  * @see MPU6050_DELAYCTRL_I2C_SLV0_DLY_EN_BIT
  */
-bool MPU6050_getSlaveDelayEnabled(uint8_t num) {
+bool MPU6050_getSlaveDelayEnabled(MPU6050_t *dev, uint8_t num) {
     // MPU6050_DELAYCTRL_I2C_SLV4_DLY_EN_BIT is 4, SLV3 is 3, etc.
     if (num > 4) return 0;
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_I2C_MST_DELAY_CTRL, num, mpu6050.buffer);
-    return mpu6050.buffer[0];
+    MPU6050_readBit(dev, MPU6050_RA_I2C_MST_DELAY_CTRL, num, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set slave delay enabled status.
  * @param num Slave number (0-4)
@@ -2306,8 +2609,8 @@ bool MPU6050_getSlaveDelayEnabled(uint8_t num) {
  * @see MPU6050_RA_I2C_MST_DELAY_CTRL
  * @see MPU6050_DELAYCTRL_I2C_SLV0_DLY_EN_BIT
  */
-void MPU6050_setSlaveDelayEnabled(uint8_t num, bool enabled) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_I2C_MST_DELAY_CTRL, num, enabled);
+void MPU6050_setSlaveDelayEnabled(MPU6050_t *dev, uint8_t num, bool enabled) {
+    MPU6050_writeBit(dev, MPU6050_RA_I2C_MST_DELAY_CTRL, num, enabled);
 }
 
 // SIGNAL_PATH_RESET register
@@ -2318,8 +2621,8 @@ void MPU6050_setSlaveDelayEnabled(uint8_t num, bool enabled) {
  * @see MPU6050_RA_SIGNAL_PATH_RESET
  * @see MPU6050_PATHRESET_GYRO_RESET_BIT
  */
-void MPU6050_resetGyroscopePath(void) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_SIGNAL_PATH_RESET, MPU6050_PATHRESET_GYRO_RESET_BIT, true);
+void MPU6050_resetGyroscopePath(MPU6050_t *dev) {
+    MPU6050_writeBit(dev, MPU6050_RA_SIGNAL_PATH_RESET, MPU6050_PATHRESET_GYRO_RESET_BIT, true);
 }
 /** Reset accelerometer signal path.
  * The reset will revert the signal path analog to digital converters and
@@ -2327,8 +2630,8 @@ void MPU6050_resetGyroscopePath(void) {
  * @see MPU6050_RA_SIGNAL_PATH_RESET
  * @see MPU6050_PATHRESET_ACCEL_RESET_BIT
  */
-void MPU6050_resetAccelerometerPath(void) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_SIGNAL_PATH_RESET, MPU6050_PATHRESET_ACCEL_RESET_BIT, true);
+void MPU6050_resetAccelerometerPath(MPU6050_t *dev) {
+    MPU6050_writeBit(dev, MPU6050_RA_SIGNAL_PATH_RESET, MPU6050_PATHRESET_ACCEL_RESET_BIT, true);
 }
 /** Reset temperature sensor signal path.
  * The reset will revert the signal path analog to digital converters and
@@ -2336,8 +2639,8 @@ void MPU6050_resetAccelerometerPath(void) {
  * @see MPU6050_RA_SIGNAL_PATH_RESET
  * @see MPU6050_PATHRESET_TEMP_RESET_BIT
  */
-void MPU6050_resetTemperaturePath(void) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_SIGNAL_PATH_RESET, MPU6050_PATHRESET_TEMP_RESET_BIT, true);
+void MPU6050_resetTemperaturePath(MPU6050_t *dev) {
+    MPU6050_writeBit(dev, MPU6050_RA_SIGNAL_PATH_RESET, MPU6050_PATHRESET_TEMP_RESET_BIT, true);
 }
 
 // MOT_DETECT_CTRL register
@@ -2356,9 +2659,9 @@ void MPU6050_resetTemperaturePath(void) {
  * @see MPU6050_RA_MOT_DETECT_CTRL
  * @see MPU6050_DETECT_ACCEL_ON_DELAY_BIT
  */
-uint8_t MPU6050_getAccelerometerPowerOnDelay(void) {
-    MPU6050_readBits(mpu6050.devAddr, MPU6050_RA_MOT_DETECT_CTRL, MPU6050_DETECT_ACCEL_ON_DELAY_BIT, MPU6050_DETECT_ACCEL_ON_DELAY_LENGTH, mpu6050.buffer);
-    return mpu6050.buffer[0];
+uint8_t MPU6050_getAccelerometerPowerOnDelay(MPU6050_t *dev) {
+    MPU6050_readBits(dev, MPU6050_RA_MOT_DETECT_CTRL, MPU6050_DETECT_ACCEL_ON_DELAY_BIT, MPU6050_DETECT_ACCEL_ON_DELAY_LENGTH, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set accelerometer power-on delay.
  * @param delay New accelerometer power-on delay (0-3)
@@ -2366,8 +2669,8 @@ uint8_t MPU6050_getAccelerometerPowerOnDelay(void) {
  * @see MPU6050_RA_MOT_DETECT_CTRL
  * @see MPU6050_DETECT_ACCEL_ON_DELAY_BIT
  */
-void MPU6050_setAccelerometerPowerOnDelay(uint8_t delay) {
-    MPU6050_writeBits(mpu6050.devAddr, MPU6050_RA_MOT_DETECT_CTRL, MPU6050_DETECT_ACCEL_ON_DELAY_BIT, MPU6050_DETECT_ACCEL_ON_DELAY_LENGTH, delay);
+void MPU6050_setAccelerometerPowerOnDelay(MPU6050_t *dev, uint8_t delay) {
+    MPU6050_writeBits(dev, MPU6050_RA_MOT_DETECT_CTRL, MPU6050_DETECT_ACCEL_ON_DELAY_BIT, MPU6050_DETECT_ACCEL_ON_DELAY_LENGTH, delay);
 }
 /** Get Free Fall detection counter decrement configuration.
  * Detection is registered by the Free Fall detection module after accelerometer
@@ -2395,9 +2698,9 @@ void MPU6050_setAccelerometerPowerOnDelay(uint8_t delay) {
  * @see MPU6050_RA_MOT_DETECT_CTRL
  * @see MPU6050_DETECT_FF_COUNT_BIT
  */
-uint8_t MPU6050_getFreefallDetectionCounterDecrement(void) {
-    MPU6050_readBits(mpu6050.devAddr, MPU6050_RA_MOT_DETECT_CTRL, MPU6050_DETECT_FF_COUNT_BIT, MPU6050_DETECT_FF_COUNT_LENGTH, mpu6050.buffer);
-    return mpu6050.buffer[0];
+uint8_t MPU6050_getFreefallDetectionCounterDecrement(MPU6050_t *dev) {
+    MPU6050_readBits(dev, MPU6050_RA_MOT_DETECT_CTRL, MPU6050_DETECT_FF_COUNT_BIT, MPU6050_DETECT_FF_COUNT_LENGTH, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set Free Fall detection counter decrement configuration.
  * @param decrement New decrement configuration value
@@ -2405,8 +2708,8 @@ uint8_t MPU6050_getFreefallDetectionCounterDecrement(void) {
  * @see MPU6050_RA_MOT_DETECT_CTRL
  * @see MPU6050_DETECT_FF_COUNT_BIT
  */
-void MPU6050_setFreefallDetectionCounterDecrement(uint8_t decrement) {
-    MPU6050_writeBits(mpu6050.devAddr, MPU6050_RA_MOT_DETECT_CTRL, MPU6050_DETECT_FF_COUNT_BIT, MPU6050_DETECT_FF_COUNT_LENGTH, decrement);
+void MPU6050_setFreefallDetectionCounterDecrement(MPU6050_t *dev, uint8_t decrement) {
+    MPU6050_writeBits(dev, MPU6050_RA_MOT_DETECT_CTRL, MPU6050_DETECT_FF_COUNT_BIT, MPU6050_DETECT_FF_COUNT_LENGTH, decrement);
 }
 /** Get Motion detection counter decrement configuration.
  * Detection is registered by the Motion detection module after accelerometer
@@ -2431,9 +2734,9 @@ void MPU6050_setFreefallDetectionCounterDecrement(uint8_t decrement) {
  * please refer to Registers 29 to 32.
  *
  */
-uint8_t MPU6050_getMotionDetectionCounterDecrement(void) {
-    MPU6050_readBits(mpu6050.devAddr, MPU6050_RA_MOT_DETECT_CTRL, MPU6050_DETECT_MOT_COUNT_BIT, MPU6050_DETECT_MOT_COUNT_LENGTH, mpu6050.buffer);
-    return mpu6050.buffer[0];
+uint8_t MPU6050_getMotionDetectionCounterDecrement(MPU6050_t *dev) {
+    MPU6050_readBits(dev, MPU6050_RA_MOT_DETECT_CTRL, MPU6050_DETECT_MOT_COUNT_BIT, MPU6050_DETECT_MOT_COUNT_LENGTH, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set Motion detection counter decrement configuration.
  * @param decrement New decrement configuration value
@@ -2441,23 +2744,23 @@ uint8_t MPU6050_getMotionDetectionCounterDecrement(void) {
  * @see MPU6050_RA_MOT_DETECT_CTRL
  * @see MPU6050_DETECT_MOT_COUNT_BIT
  */
-void MPU6050_setMotionDetectionCounterDecrement(uint8_t decrement) {
-    MPU6050_writeBits(mpu6050.devAddr, MPU6050_RA_MOT_DETECT_CTRL, MPU6050_DETECT_MOT_COUNT_BIT, MPU6050_DETECT_MOT_COUNT_LENGTH, decrement);
+void MPU6050_setMotionDetectionCounterDecrement(MPU6050_t *dev, uint8_t decrement) {
+    MPU6050_writeBits(dev, MPU6050_RA_MOT_DETECT_CTRL, MPU6050_DETECT_MOT_COUNT_BIT, MPU6050_DETECT_MOT_COUNT_LENGTH, decrement);
 }
 
 // USER_CTRL register
 
 /** Get FIFO enabled status.
- * When this bit is set to 0, the FIFO mpu6050.buffer is disabled. The FIFO mpu6050.buffer
- * cannot be written to or read from while disabled. The FIFO mpu6050.buffer's state
+ * When this bit is set to 0, the FIFO dev->buffer is disabled. The FIFO dev->buffer
+ * cannot be written to or read from while disabled. The FIFO dev->buffer's state
  * does not change unless the MPU-60X0 is power cycled.
  * @return Current FIFO enabled status
  * @see MPU6050_RA_USER_CTRL
  * @see MPU6050_USERCTRL_FIFO_EN_BIT
  */
-bool MPU6050_getFIFOEnabled(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_USER_CTRL, MPU6050_USERCTRL_FIFO_EN_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getFIFOEnabled(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_USER_CTRL, MPU6050_USERCTRL_FIFO_EN_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set FIFO enabled status.
  * @param enabled New FIFO enabled status
@@ -2465,8 +2768,8 @@ bool MPU6050_getFIFOEnabled(void) {
  * @see MPU6050_RA_USER_CTRL
  * @see MPU6050_USERCTRL_FIFO_EN_BIT
  */
-void MPU6050_setFIFOEnabled(bool enabled) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_USER_CTRL, MPU6050_USERCTRL_FIFO_EN_BIT, enabled);
+void MPU6050_setFIFOEnabled(MPU6050_t *dev, bool enabled) {
+    MPU6050_writeBit(dev, MPU6050_RA_USER_CTRL, MPU6050_USERCTRL_FIFO_EN_BIT, enabled);
 }
 /** Get I2C Master Mode enabled status.
  * When this mode is enabled, the MPU-60X0 acts as the I2C Master to the
@@ -2479,9 +2782,9 @@ void MPU6050_setFIFOEnabled(bool enabled) {
  * @see MPU6050_RA_USER_CTRL
  * @see MPU6050_USERCTRL_I2C_MST_EN_BIT
  */
-bool MPU6050_getI2CMasterModeEnabled(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_USER_CTRL, MPU6050_USERCTRL_I2C_MST_EN_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getI2CMasterModeEnabled(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_USER_CTRL, MPU6050_USERCTRL_I2C_MST_EN_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set I2C Master Mode enabled status.
  * @param enabled New I2C Master Mode enabled status
@@ -2489,24 +2792,24 @@ bool MPU6050_getI2CMasterModeEnabled(void) {
  * @see MPU6050_RA_USER_CTRL
  * @see MPU6050_USERCTRL_I2C_MST_EN_BIT
  */
-void MPU6050_setI2CMasterModeEnabled(bool enabled) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_USER_CTRL, MPU6050_USERCTRL_I2C_MST_EN_BIT, enabled);
+void MPU6050_setI2CMasterModeEnabled(MPU6050_t *dev, bool enabled) {
+    MPU6050_writeBit(dev, MPU6050_RA_USER_CTRL, MPU6050_USERCTRL_I2C_MST_EN_BIT, enabled);
 }
 /** Switch from I2C to SPI mode (MPU-6000 only)
  * If this is set, the primary SPI interface will be enabled in place of the
  * disabled primary I2C interface.
  */
-void MPU6050_switchSPIEnabled(bool enabled) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_USER_CTRL, MPU6050_USERCTRL_I2C_IF_DIS_BIT, enabled);
+void MPU6050_switchSPIEnabled(MPU6050_t *dev, bool enabled) {
+    MPU6050_writeBit(dev, MPU6050_RA_USER_CTRL, MPU6050_USERCTRL_I2C_IF_DIS_BIT, enabled);
 }
 /** Reset the FIFO.
- * This bit resets the FIFO mpu6050.buffer when set to 1 while FIFO_EN equals 0. This
+ * This bit resets the FIFO dev->buffer when set to 1 while FIFO_EN equals 0. This
  * bit automatically clears to 0 after the reset has been triggered.
  * @see MPU6050_RA_USER_CTRL
  * @see MPU6050_USERCTRL_FIFO_RESET_BIT
  */
-void MPU6050_resetFIFO(void) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_USER_CTRL, MPU6050_USERCTRL_FIFO_RESET_BIT, true);
+void MPU6050_resetFIFO(MPU6050_t *dev) {
+    MPU6050_writeBit(dev, MPU6050_RA_USER_CTRL, MPU6050_USERCTRL_FIFO_RESET_BIT, true);
 }
 /** Reset the I2C Master.
  * This bit resets the I2C Master when set to 1 while I2C_MST_EN equals 0.
@@ -2514,8 +2817,8 @@ void MPU6050_resetFIFO(void) {
  * @see MPU6050_RA_USER_CTRL
  * @see MPU6050_USERCTRL_I2C_MST_RESET_BIT
  */
-void MPU6050_resetI2CMaster(void) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_USER_CTRL, MPU6050_USERCTRL_I2C_MST_RESET_BIT, true);
+void MPU6050_resetI2CMaster(MPU6050_t *dev) {
+    MPU6050_writeBit(dev, MPU6050_RA_USER_CTRL, MPU6050_USERCTRL_I2C_MST_RESET_BIT, true);
 }
 /** Reset all sensor registers and signal paths.
  * When set to 1, this bit resets the signal paths for all sensors (gyroscopes,
@@ -2529,19 +2832,20 @@ void MPU6050_resetI2CMaster(void) {
  * @see MPU6050_RA_USER_CTRL
  * @see MPU6050_USERCTRL_SIG_COND_RESET_BIT
  */
-void MPU6050_resetSensors(void) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_USER_CTRL, MPU6050_USERCTRL_SIG_COND_RESET_BIT, true);
+void MPU6050_resetSensors(MPU6050_t *dev) {
+    MPU6050_writeBit(dev, MPU6050_RA_USER_CTRL, MPU6050_USERCTRL_SIG_COND_RESET_BIT, true);
 }
 
 // PWR_MGMT_1 register
 
 /** Trigger a full device reset.
- * A small delay of ~50ms may be desirable after triggering a reset.
+ * A small delay of ~50ms may be desirable after triggering a reset. The register
+ * shadow is invalidated; call resyncShadow() after the delay to reload it.
  * @see MPU6050_RA_PWR_MGMT_1
  * @see MPU6050_PWR1_DEVICE_RESET_BIT
  */
-void MPU6050_reset(void) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_PWR_MGMT_1, MPU6050_PWR1_DEVICE_RESET_BIT, true);
+void MPU6050_reset(MPU6050_t *dev) {
+    MPU6050_writeBit(dev, MPU6050_RA_PWR_MGMT_1, MPU6050_PWR1_DEVICE_RESET_BIT, true);
 }
 /** Get sleep mode status.
  * Setting the SLEEP bit in the register puts the device into very low power
@@ -2554,9 +2858,9 @@ void MPU6050_reset(void) {
  * @see MPU6050_RA_PWR_MGMT_1
  * @see MPU6050_PWR1_SLEEP_BIT
  */
-bool MPU6050_getSleepEnabled(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_PWR_MGMT_1, MPU6050_PWR1_SLEEP_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getSleepEnabled(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_PWR_MGMT_1, MPU6050_PWR1_SLEEP_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set sleep mode status.
  * @param enabled New sleep mode enabled status
@@ -2564,8 +2868,8 @@ bool MPU6050_getSleepEnabled(void) {
  * @see MPU6050_RA_PWR_MGMT_1
  * @see MPU6050_PWR1_SLEEP_BIT
  */
-void MPU6050_setSleepEnabled(uint8_t enabled) {
-    MPU6050_writeByte(mpu6050.devAddr, MPU6050_RA_PWR_MGMT_1, enabled);
+void MPU6050_setSleepEnabled(MPU6050_t *dev, uint8_t enabled) {
+    MPU6050_writeByte(dev, MPU6050_RA_PWR_MGMT_1, enabled);
 }
 /** Get wake cycle enabled status.
  * When this bit is set to 1 and SLEEP is disabled, the MPU-60X0 will cycle
@@ -2575,9 +2879,9 @@ void MPU6050_setSleepEnabled(uint8_t enabled) {
  * @see MPU6050_RA_PWR_MGMT_1
  * @see MPU6050_PWR1_CYCLE_BIT
  */
-bool MPU6050_getWakeCycleEnabled(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_PWR_MGMT_1, MPU6050_PWR1_CYCLE_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getWakeCycleEnabled(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_PWR_MGMT_1, MPU6050_PWR1_CYCLE_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set wake cycle enabled status.
  * @param enabled New sleep mode enabled status
@@ -2585,8 +2889,8 @@ bool MPU6050_getWakeCycleEnabled(void) {
  * @see MPU6050_RA_PWR_MGMT_1
  * @see MPU6050_PWR1_CYCLE_BIT
  */
-void MPU6050_setWakeCycleEnabled(bool enabled) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_PWR_MGMT_1, MPU6050_PWR1_CYCLE_BIT, enabled);
+void MPU6050_setWakeCycleEnabled(MPU6050_t *dev, bool enabled) {
+    MPU6050_writeBit(dev, MPU6050_RA_PWR_MGMT_1, MPU6050_PWR1_CYCLE_BIT, enabled);
 }
 /** Get temperature sensor enabled status.
  * Control the usage of the internal temperature sensor.
@@ -2599,9 +2903,9 @@ void MPU6050_setWakeCycleEnabled(bool enabled) {
  * @see MPU6050_RA_PWR_MGMT_1
  * @see MPU6050_PWR1_TEMP_DIS_BIT
  */
-bool MPU6050_getTempSensorEnabled(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_PWR_MGMT_1, MPU6050_PWR1_TEMP_DIS_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0] == 0; // 1 is actually disabled here
+bool MPU6050_getTempSensorEnabled(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_PWR_MGMT_1, MPU6050_PWR1_TEMP_DIS_BIT, dev->buffer);
+    return dev->buffer[0] == 0; // 1 is actually disabled here
 }
 /** Set temperature sensor enabled status.
  * Note: this register stores the *disabled* value, but for consistency with the
@@ -2613,9 +2917,9 @@ bool MPU6050_getTempSensorEnabled(void) {
  * @see MPU6050_RA_PWR_MGMT_1
  * @see MPU6050_PWR1_TEMP_DIS_BIT
  */
-void MPU6050_setTempSensorEnabled(bool enabled) {
+void MPU6050_setTempSensorEnabled(MPU6050_t *dev, bool enabled) {
     // 1 is actually disabled here
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_PWR_MGMT_1, MPU6050_PWR1_TEMP_DIS_BIT, !enabled);
+    MPU6050_writeBit(dev, MPU6050_RA_PWR_MGMT_1, MPU6050_PWR1_TEMP_DIS_BIT, !enabled);
 }
 /** Get clock source setting.
  * @return Current clock source setting
@@ -2623,9 +2927,9 @@ void MPU6050_setTempSensorEnabled(bool enabled) {
  * @see MPU6050_PWR1_CLKSEL_BIT
  * @see MPU6050_PWR1_CLKSEL_LENGTH
  */
-uint8_t MPU6050_getClockSource(void) {
-    MPU6050_readBits(mpu6050.devAddr, MPU6050_RA_PWR_MGMT_1, MPU6050_PWR1_CLKSEL_BIT, MPU6050_PWR1_CLKSEL_LENGTH, mpu6050.buffer);
-    return mpu6050.buffer[0];
+uint8_t MPU6050_getClockSource(MPU6050_t *dev) {
+    MPU6050_readBits(dev, MPU6050_RA_PWR_MGMT_1, MPU6050_PWR1_CLKSEL_BIT, MPU6050_PWR1_CLKSEL_LENGTH, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set clock source setting.
  * An internal 8MHz oscillator, gyroscope based clock, or external sources can
@@ -2657,8 +2961,8 @@ uint8_t MPU6050_getClockSource(void) {
  * @see MPU6050_PWR1_CLKSEL_BIT
  * @see MPU6050_PWR1_CLKSEL_LENGTH
  */
-void MPU6050_setClockSource(uint8_t source) {
-    MPU6050_writeBits(mpu6050.devAddr, MPU6050_RA_PWR_MGMT_1, MPU6050_PWR1_CLKSEL_BIT, MPU6050_PWR1_CLKSEL_LENGTH, source);
+void MPU6050_setClockSource(MPU6050_t *dev, uint8_t source) {
+    MPU6050_writeBits(dev, MPU6050_RA_PWR_MGMT_1, MPU6050_PWR1_CLKSEL_BIT, MPU6050_PWR1_CLKSEL_LENGTH, source);
 }
 
 // PWR_MGMT_2 register
@@ -2686,16 +2990,16 @@ void MPU6050_setClockSource(uint8_t source) {
  * @return Current wake frequency
  * @see MPU6050_RA_PWR_MGMT_2
  */
-uint8_t MPU6050_getWakeFrequency(void) {
-    MPU6050_readBits(mpu6050.devAddr, MPU6050_RA_PWR_MGMT_2, MPU6050_PWR2_LP_WAKE_CTRL_BIT, MPU6050_PWR2_LP_WAKE_CTRL_LENGTH, mpu6050.buffer);
-    return mpu6050.buffer[0];
+uint8_t MPU6050_getWakeFrequency(MPU6050_t *dev) {
+    MPU6050_readBits(dev, MPU6050_RA_PWR_MGMT_2, MPU6050_PWR2_LP_WAKE_CTRL_BIT, MPU6050_PWR2_LP_WAKE_CTRL_LENGTH, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set wake frequency in Accel-Only Low Power Mode.
  * @param frequency New wake frequency
  * @see MPU6050_RA_PWR_MGMT_2
  */
-void MPU6050_setWakeFrequency(uint8_t frequency) {
-    MPU6050_writeBits(mpu6050.devAddr, MPU6050_RA_PWR_MGMT_2, MPU6050_PWR2_LP_WAKE_CTRL_BIT, MPU6050_PWR2_LP_WAKE_CTRL_LENGTH, frequency);
+void MPU6050_setWakeFrequency(MPU6050_t *dev, uint8_t frequency) {
+    MPU6050_writeBits(dev, MPU6050_RA_PWR_MGMT_2, MPU6050_PWR2_LP_WAKE_CTRL_BIT, MPU6050_PWR2_LP_WAKE_CTRL_LENGTH, frequency);
 }
 
 /** Get X-axis accelerometer standby enabled status.
@@ -2704,9 +3008,9 @@ void MPU6050_setWakeFrequency(uint8_t frequency) {
  * @see MPU6050_RA_PWR_MGMT_2
  * @see MPU6050_PWR2_STBY_XA_BIT
  */
-bool MPU6050_getStandbyXAccelEnabled(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_PWR_MGMT_2, MPU6050_PWR2_STBY_XA_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getStandbyXAccelEnabled(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_PWR_MGMT_2, MPU6050_PWR2_STBY_XA_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set X-axis accelerometer standby enabled status.
  * @param New X-axis standby enabled status
@@ -2714,8 +3018,8 @@ bool MPU6050_getStandbyXAccelEnabled(void) {
  * @see MPU6050_RA_PWR_MGMT_2
  * @see MPU6050_PWR2_STBY_XA_BIT
  */
-void MPU6050_setStandbyXAccelEnabled(bool enabled) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_PWR_MGMT_2, MPU6050_PWR2_STBY_XA_BIT, enabled);
+void MPU6050_setStandbyXAccelEnabled(MPU6050_t *dev, bool enabled) {
+    MPU6050_writeBit(dev, MPU6050_RA_PWR_MGMT_2, MPU6050_PWR2_STBY_XA_BIT, enabled);
 }
 /** Get Y-axis accelerometer standby enabled status.
  * If enabled, the Y-axis will not gather or report data (or use power).
@@ -2723,9 +3027,9 @@ void MPU6050_setStandbyXAccelEnabled(bool enabled) {
  * @see MPU6050_RA_PWR_MGMT_2
  * @see MPU6050_PWR2_STBY_YA_BIT
  */
-bool MPU6050_getStandbyYAccelEnabled(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_PWR_MGMT_2, MPU6050_PWR2_STBY_YA_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getStandbyYAccelEnabled(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_PWR_MGMT_2, MPU6050_PWR2_STBY_YA_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set Y-axis accelerometer standby enabled status.
  * @param New Y-axis standby enabled status
@@ -2733,8 +3037,8 @@ bool MPU6050_getStandbyYAccelEnabled(void) {
  * @see MPU6050_RA_PWR_MGMT_2
  * @see MPU6050_PWR2_STBY_YA_BIT
  */
-void MPU6050_setStandbyYAccelEnabled(bool enabled) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_PWR_MGMT_2, MPU6050_PWR2_STBY_YA_BIT, enabled);
+void MPU6050_setStandbyYAccelEnabled(MPU6050_t *dev, bool enabled) {
+    MPU6050_writeBit(dev, MPU6050_RA_PWR_MGMT_2, MPU6050_PWR2_STBY_YA_BIT, enabled);
 }
 /** Get Z-axis accelerometer standby enabled status.
  * If enabled, the Z-axis will not gather or report data (or use power).
@@ -2742,9 +3046,9 @@ void MPU6050_setStandbyYAccelEnabled(bool enabled) {
  * @see MPU6050_RA_PWR_MGMT_2
  * @see MPU6050_PWR2_STBY_ZA_BIT
  */
-bool MPU6050_getStandbyZAccelEnabled(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_PWR_MGMT_2, MPU6050_PWR2_STBY_ZA_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getStandbyZAccelEnabled(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_PWR_MGMT_2, MPU6050_PWR2_STBY_ZA_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set Z-axis accelerometer standby enabled status.
  * @param New Z-axis standby enabled status
@@ -2752,8 +3056,8 @@ bool MPU6050_getStandbyZAccelEnabled(void) {
  * @see MPU6050_RA_PWR_MGMT_2
  * @see MPU6050_PWR2_STBY_ZA_BIT
  */
-void MPU6050_setStandbyZAccelEnabled(bool enabled) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_PWR_MGMT_2, MPU6050_PWR2_STBY_ZA_BIT, enabled);
+void MPU6050_setStandbyZAccelEnabled(MPU6050_t *dev, bool enabled) {
+    MPU6050_writeBit(dev, MPU6050_RA_PWR_MGMT_2, MPU6050_PWR2_STBY_ZA_BIT, enabled);
 }
 /** Get X-axis gyroscope standby enabled status.
  * If enabled, the X-axis will not gather or report data (or use power).
@@ -2761,9 +3065,9 @@ void MPU6050_setStandbyZAccelEnabled(bool enabled) {
  * @see MPU6050_RA_PWR_MGMT_2
  * @see MPU6050_PWR2_STBY_XG_BIT
  */
-bool MPU6050_getStandbyXGyroEnabled(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_PWR_MGMT_2, MPU6050_PWR2_STBY_XG_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getStandbyXGyroEnabled(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_PWR_MGMT_2, MPU6050_PWR2_STBY_XG_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set X-axis gyroscope standby enabled status.
  * @param New X-axis standby enabled status
@@ -2771,8 +3075,8 @@ bool MPU6050_getStandbyXGyroEnabled(void) {
  * @see MPU6050_RA_PWR_MGMT_2
  * @see MPU6050_PWR2_STBY_XG_BIT
  */
-void MPU6050_setStandbyXGyroEnabled(bool enabled) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_PWR_MGMT_2, MPU6050_PWR2_STBY_XG_BIT, enabled);
+void MPU6050_setStandbyXGyroEnabled(MPU6050_t *dev, bool enabled) {
+    MPU6050_writeBit(dev, MPU6050_RA_PWR_MGMT_2, MPU6050_PWR2_STBY_XG_BIT, enabled);
 }
 /** Get Y-axis gyroscope standby enabled status.
  * If enabled, the Y-axis will not gather or report data (or use power).
@@ -2780,9 +3084,9 @@ void MPU6050_setStandbyXGyroEnabled(bool enabled) {
  * @see MPU6050_RA_PWR_MGMT_2
  * @see MPU6050_PWR2_STBY_YG_BIT
  */
-bool MPU6050_getStandbyYGyroEnabled(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_PWR_MGMT_2, MPU6050_PWR2_STBY_YG_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getStandbyYGyroEnabled(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_PWR_MGMT_2, MPU6050_PWR2_STBY_YG_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set Y-axis gyroscope standby enabled status.
  * @param New Y-axis standby enabled status
@@ -2790,8 +3094,8 @@ bool MPU6050_getStandbyYGyroEnabled(void) {
  * @see MPU6050_RA_PWR_MGMT_2
  * @see MPU6050_PWR2_STBY_YG_BIT
  */
-void MPU6050_setStandbyYGyroEnabled(bool enabled) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_PWR_MGMT_2, MPU6050_PWR2_STBY_YG_BIT, enabled);
+void MPU6050_setStandbyYGyroEnabled(MPU6050_t *dev, bool enabled) {
+    MPU6050_writeBit(dev, MPU6050_RA_PWR_MGMT_2, MPU6050_PWR2_STBY_YG_BIT, enabled);
 }
 /** Get Z-axis gyroscope standby enabled status.
  * If enabled, the Z-axis will not gather or report data (or use power).
@@ -2799,9 +3103,9 @@ void MPU6050_setStandbyYGyroEnabled(bool enabled) {
  * @see MPU6050_RA_PWR_MGMT_2
  * @see MPU6050_PWR2_STBY_ZG_BIT
  */
-bool MPU6050_getStandbyZGyroEnabled(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_PWR_MGMT_2, MPU6050_PWR2_STBY_ZG_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getStandbyZGyroEnabled(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_PWR_MGMT_2, MPU6050_PWR2_STBY_ZG_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set Z-axis gyroscope standby enabled status.
  * @param New Z-axis standby enabled status
@@ -2809,28 +3113,28 @@ bool MPU6050_getStandbyZGyroEnabled(void) {
  * @see MPU6050_RA_PWR_MGMT_2
  * @see MPU6050_PWR2_STBY_ZG_BIT
  */
-void MPU6050_setStandbyZGyroEnabled(bool enabled) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_PWR_MGMT_2, MPU6050_PWR2_STBY_ZG_BIT, enabled);
+void MPU6050_setStandbyZGyroEnabled(MPU6050_t *dev, bool enabled) {
+    MPU6050_writeBit(dev, MPU6050_RA_PWR_MGMT_2, MPU6050_PWR2_STBY_ZG_BIT, enabled);
 }
 
 // FIFO_COUNT* registers
 
-/** Get current FIFO mpu6050.buffer size.
- * This value indicates the number of bytes stored in the FIFO mpu6050.buffer. This
- * number is in turn the number of bytes that can be read from the FIFO mpu6050.buffer
+/** Get current FIFO dev->buffer size.
+ * This value indicates the number of bytes stored in the FIFO dev->buffer. This
+ * number is in turn the number of bytes that can be read from the FIFO dev->buffer
  * and it is directly proportional to the number of samples available given the
  * set of sensor data bound to be stored in the FIFO (register 35 and 36).
- * @return Current FIFO mpu6050.buffer size
+ * @return Current FIFO dev->buffer size
  */
-uint16_t MPU6050_getFIFOCount(void) {
-    MPU6050_readBytes(mpu6050.devAddr, MPU6050_RA_FIFO_COUNTH, 2, mpu6050.buffer);
-    return (((uint16_t)mpu6050.buffer[0]) << 8) | mpu6050.buffer[1];
+uint16_t MPU6050_getFIFOCount(MPU6050_t *dev) {
+    MPU6050_readBytes(dev, MPU6050_RA_FIFO_COUNTH, 2, dev->buffer);
+    return (((uint16_t)dev->buffer[0]) << 8) | dev->buffer[1];
 }
 
 // FIFO_R_W register
 
-/** Get byte from FIFO mpu6050.buffer.
- * This register is used to read and write data from the FIFO mpu6050.buffer. Data is
+/** Get byte from FIFO dev->buffer.
+ * This register is used to read and write data from the FIFO dev->buffer. Data is
  * written to the FIFO in order of register number (from lowest to highest). If
  * all the FIFO enable flags (see below) are enabled and all External Sensor
  * Data registers (Registers 73 to 96) are associated with a Slave device, the
@@ -2838,35 +3142,42 @@ uint16_t MPU6050_getFIFOCount(void) {
  * Rate.
  *
  * The contents of the sensor data registers (Registers 59 to 96) are written
- * into the FIFO mpu6050.buffer when their corresponding FIFO enable flags are set to 1
+ * into the FIFO dev->buffer when their corresponding FIFO enable flags are set to 1
  * in FIFO_EN (Register 35). An additional flag for the sensor data registers
  * associated with I2C Slave 3 can be found in I2C_MST_CTRL (Register 36).
  *
- * If the FIFO mpu6050.buffer has overflowed, the status bit FIFO_OFLOW_INT is
+ * If the FIFO dev->buffer has overflowed, the status bit FIFO_OFLOW_INT is
  * automatically set to 1. This bit is located in INT_STATUS (Register 58).
- * When the FIFO mpu6050.buffer has overflowed, the oldest data will be lost and new
+ * When the FIFO dev->buffer has overflowed, the oldest data will be lost and new
  * data will be written to the FIFO.
  *
- * If the FIFO mpu6050.buffer is empty, reading this register will return the last byte
+ * If the FIFO dev->buffer is empty, reading this register will return the last byte
  * that was previously read from the FIFO until new data is available. The user
- * should check FIFO_COUNT to ensure that the FIFO mpu6050.buffer is not read when
+ * should check FIFO_COUNT to ensure that the FIFO dev->buffer is not read when
  * empty.
  *
- * @return Byte from FIFO mpu6050.buffer
+ * @return Byte from FIFO dev->buffer
  */
-uint8_t MPU6050_getFIFOByte(void) {
-    MPU6050_readByte(mpu6050.devAddr, MPU6050_RA_FIFO_R_W, mpu6050.buffer);
-    return mpu6050.buffer[0];
+uint8_t MPU6050_getFIFOByte(MPU6050_t *dev) {
+    MPU6050_readByte(dev, MPU6050_RA_FIFO_R_W, dev->buffer);
+    return dev->buffer[0];
 }
-void MPU6050_getFIFOBytes(uint8_t *data, uint8_t length) {
-    MPU6050_readBytes(mpu6050.devAddr, MPU6050_RA_FIFO_R_W, length, data);
+/** Get several bytes from FIFO dev->buffer in a single burst.
+ * FIFO_R_W doesn't auto-increment, so every byte of the burst pops the FIFO.
+ * @param data Buffer of at least 'length' bytes
+ * @param length Amount of bytes to pop, up to MPU6050_FIFO_SIZE
+ * @return Status of read operation (0 = success)
+ * @see getFIFOCount()
+ */
+int MPU6050_getFIFOBytes(MPU6050_t *dev, uint8_t *data, uint16_t length) {
+    return MPU6050_readSample(dev, MPU6050_RA_FIFO_R_W, length, data, NULL);
 }
-/** Write byte to FIFO mpu6050.buffer.
+/** Write byte to FIFO dev->buffer.
  * @see getFIFOByte()
  * @see MPU6050_RA_FIFO_R_W
  */
-void MPU6050_setFIFOByte(uint8_t data) {
-    MPU6050_writeByte(mpu6050.devAddr, MPU6050_RA_FIFO_R_W, data);
+void MPU6050_setFIFOByte(MPU6050_t *dev, uint8_t data) {
+    MPU6050_writeByte(dev, MPU6050_RA_FIFO_R_W, data);
 }
 
 // WHO_AM_I register
@@ -2878,9 +3189,9 @@ void MPU6050_setFIFOByte(uint8_t data) {
  * @see MPU6050_WHO_AM_I_BIT
  * @see MPU6050_WHO_AM_I_LENGTH
  */
-uint8_t MPU6050_getDeviceID(void) {
-    MPU6050_readBits(mpu6050.devAddr, MPU6050_RA_WHO_AM_I, MPU6050_WHO_AM_I_BIT, MPU6050_WHO_AM_I_LENGTH, mpu6050.buffer);
-    return mpu6050.buffer[0];
+uint8_t MPU6050_getDeviceID(MPU6050_t *dev) {
+    MPU6050_readBits(dev, MPU6050_RA_WHO_AM_I, MPU6050_WHO_AM_I_BIT, MPU6050_WHO_AM_I_LENGTH, dev->buffer);
+    return dev->buffer[0];
 }
 /** Set Device ID.
  * Write a new ID into the WHO_AM_I register (no idea why this should ever be
@@ -2891,248 +3202,246 @@ uint8_t MPU6050_getDeviceID(void) {
  * @see MPU6050_WHO_AM_I_BIT
  * @see MPU6050_WHO_AM_I_LENGTH
  */
-void MPU6050_setDeviceID(uint8_t id) {
-    MPU6050_writeBits(mpu6050.devAddr, MPU6050_RA_WHO_AM_I, MPU6050_WHO_AM_I_BIT, MPU6050_WHO_AM_I_LENGTH, id);
+void MPU6050_setDeviceID(MPU6050_t *dev, uint8_t id) {
+    MPU6050_writeBits(dev, MPU6050_RA_WHO_AM_I, MPU6050_WHO_AM_I_BIT, MPU6050_WHO_AM_I_LENGTH, id);
 }
 
 // ======== UNDOCUMENTED/DMP REGISTERS/METHODS ========
 
 // XG_OFFS_TC register
 
-uint8_t MPU6050_getOTPBankValid(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_XG_OFFS_TC, MPU6050_TC_OTP_BNK_VLD_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+uint8_t MPU6050_getOTPBankValid(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_XG_OFFS_TC, MPU6050_TC_OTP_BNK_VLD_BIT, dev->buffer);
+    return dev->buffer[0];
 }
-void MPU6050_setOTPBankValid(bool enabled) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_XG_OFFS_TC, MPU6050_TC_OTP_BNK_VLD_BIT, enabled);
+void MPU6050_setOTPBankValid(MPU6050_t *dev, bool enabled) {
+    MPU6050_writeBit(dev, MPU6050_RA_XG_OFFS_TC, MPU6050_TC_OTP_BNK_VLD_BIT, enabled);
 }
-int8_t MPU6050_getXGyroOffsetTC(void) {
-    MPU6050_readBits(mpu6050.devAddr, MPU6050_RA_XG_OFFS_TC, MPU6050_TC_OFFSET_BIT, MPU6050_TC_OFFSET_LENGTH, mpu6050.buffer);
-    return mpu6050.buffer[0];
+int8_t MPU6050_getXGyroOffsetTC(MPU6050_t *dev) {
+    MPU6050_readBits(dev, MPU6050_RA_XG_OFFS_TC, MPU6050_TC_OFFSET_BIT, MPU6050_TC_OFFSET_LENGTH, dev->buffer);
+    return dev->buffer[0];
 }
-void MPU6050_setXGyroOffsetTC(int8_t offset) {
-    MPU6050_writeBits(mpu6050.devAddr, MPU6050_RA_XG_OFFS_TC, MPU6050_TC_OFFSET_BIT, MPU6050_TC_OFFSET_LENGTH, offset);
+void MPU6050_setXGyroOffsetTC(MPU6050_t *dev, int8_t offset) {
+    MPU6050_writeBits(dev, MPU6050_RA_XG_OFFS_TC, MPU6050_TC_OFFSET_BIT, MPU6050_TC_OFFSET_LENGTH, offset);
 }
 
 // YG_OFFS_TC register
 
-int8_t MPU6050_getYGyroOffsetTC(void) {
-    MPU6050_readBits(mpu6050.devAddr, MPU6050_RA_YG_OFFS_TC, MPU6050_TC_OFFSET_BIT, MPU6050_TC_OFFSET_LENGTH, mpu6050.buffer);
-    return mpu6050.buffer[0];
+int8_t MPU6050_getYGyroOffsetTC(MPU6050_t *dev) {
+    MPU6050_readBits(dev, MPU6050_RA_YG_OFFS_TC, MPU6050_TC_OFFSET_BIT, MPU6050_TC_OFFSET_LENGTH, dev->buffer);
+    return dev->buffer[0];
 }
-void MPU6050_setYGyroOffsetTC(int8_t offset) {
-    MPU6050_writeBits(mpu6050.devAddr, MPU6050_RA_YG_OFFS_TC, MPU6050_TC_OFFSET_BIT, MPU6050_TC_OFFSET_LENGTH, offset);
+void MPU6050_setYGyroOffsetTC(MPU6050_t *dev, int8_t offset) {
+    MPU6050_writeBits(dev, MPU6050_RA_YG_OFFS_TC, MPU6050_TC_OFFSET_BIT, MPU6050_TC_OFFSET_LENGTH, offset);
 }
 
 // ZG_OFFS_TC register
 
-int8_t MPU6050_getZGyroOffsetTC(void) {
-    MPU6050_readBits(mpu6050.devAddr, MPU6050_RA_ZG_OFFS_TC, MPU6050_TC_OFFSET_BIT, MPU6050_TC_OFFSET_LENGTH, mpu6050.buffer);
-    return mpu6050.buffer[0];
+int8_t MPU6050_getZGyroOffsetTC(MPU6050_t *dev) {
+    MPU6050_readBits(dev, MPU6050_RA_ZG_OFFS_TC, MPU6050_TC_OFFSET_BIT, MPU6050_TC_OFFSET_LENGTH, dev->buffer);
+    return dev->buffer[0];
 }
-void MPU6050_setZGyroOffsetTC(int8_t offset) {
-    MPU6050_writeBits(mpu6050.devAddr, MPU6050_RA_ZG_OFFS_TC, MPU6050_TC_OFFSET_BIT, MPU6050_TC_OFFSET_LENGTH, offset);
+void MPU6050_setZGyroOffsetTC(MPU6050_t *dev, int8_t offset) {
+    MPU6050_writeBits(dev, MPU6050_RA_ZG_OFFS_TC, MPU6050_TC_OFFSET_BIT, MPU6050_TC_OFFSET_LENGTH, offset);
 }
 
 // X_FINE_GAIN register
 
-int8_t MPU6050_getXFineGain(void) {
-    MPU6050_readByte(mpu6050.devAddr, MPU6050_RA_X_FINE_GAIN, mpu6050.buffer);
-    return mpu6050.buffer[0];
+int8_t MPU6050_getXFineGain(MPU6050_t *dev) {
+    MPU6050_readByte(dev, MPU6050_RA_X_FINE_GAIN, dev->buffer);
+    return dev->buffer[0];
 }
-void MPU6050_setXFineGain(int8_t gain) {
-    MPU6050_writeByte(mpu6050.devAddr, MPU6050_RA_X_FINE_GAIN, gain);
+void MPU6050_setXFineGain(MPU6050_t *dev, int8_t gain) {
+    MPU6050_writeByte(dev, MPU6050_RA_X_FINE_GAIN, gain);
 }
 
 // Y_FINE_GAIN register
 
-int8_t MPU6050_getYFineGain(void) {
-    MPU6050_readByte(mpu6050.devAddr, MPU6050_RA_Y_FINE_GAIN, mpu6050.buffer);
-    return mpu6050.buffer[0];
+int8_t MPU6050_getYFineGain(MPU6050_t *dev) {
+    MPU6050_readByte(dev, MPU6050_RA_Y_FINE_GAIN, dev->buffer);
+    return dev->buffer[0];
 }
-void MPU6050_setYFineGain(int8_t gain) {
-    MPU6050_writeByte(mpu6050.devAddr, MPU6050_RA_Y_FINE_GAIN, gain);
+void MPU6050_setYFineGain(MPU6050_t *dev, int8_t gain) {
+    MPU6050_writeByte(dev, MPU6050_RA_Y_FINE_GAIN, gain);
 }
 
 // Z_FINE_GAIN register
 
-int8_t MPU6050_getZFineGain(void) {
-    MPU6050_readByte(mpu6050.devAddr, MPU6050_RA_Z_FINE_GAIN, mpu6050.buffer);
-    return mpu6050.buffer[0];
+int8_t MPU6050_getZFineGain(MPU6050_t *dev) {
+    MPU6050_readByte(dev, MPU6050_RA_Z_FINE_GAIN, dev->buffer);
+    return dev->buffer[0];
 }
-void MPU6050_setZFineGain(int8_t gain) {
-    MPU6050_writeByte(mpu6050.devAddr, MPU6050_RA_Z_FINE_GAIN, gain);
+void MPU6050_setZFineGain(MPU6050_t *dev, int8_t gain) {
+    MPU6050_writeByte(dev, MPU6050_RA_Z_FINE_GAIN, gain);
 }
 
 // XA_OFFS_* registers
 
-int16_t MPU6050_getXAccelOffset(void) {
-    MPU6050_readBytes(mpu6050.devAddr, MPU6050_RA_XA_OFFS_H, 2, mpu6050.buffer);
-    return (((int16_t)mpu6050.buffer[0]) << 8) | mpu6050.buffer[1];
+int16_t MPU6050_getXAccelOffset(MPU6050_t *dev) {
+    MPU6050_readBytes(dev, MPU6050_RA_XA_OFFS_H, 2, dev->buffer);
+    return (((int16_t)dev->buffer[0]) << 8) | dev->buffer[1];
 }
-void MPU6050_setXAccelOffset(int16_t offset) {
-    MPU6050_writeWord(mpu6050.devAddr, MPU6050_RA_XA_OFFS_H, offset);
+void MPU6050_setXAccelOffset(MPU6050_t *dev, int16_t offset) {
+    MPU6050_writeWord(dev, MPU6050_RA_XA_OFFS_H, offset);
 }
 
 // YA_OFFS_* register
 
-int16_t MPU6050_getYAccelOffset(void) {
-    MPU6050_readBytes(mpu6050.devAddr, MPU6050_RA_YA_OFFS_H, 2, mpu6050.buffer);
-    return (((int16_t)mpu6050.buffer[0]) << 8) | mpu6050.buffer[1];
+int16_t MPU6050_getYAccelOffset(MPU6050_t *dev) {
+    MPU6050_readBytes(dev, MPU6050_RA_YA_OFFS_H, 2, dev->buffer);
+    return (((int16_t)dev->buffer[0]) << 8) | dev->buffer[1];
 }
-void MPU6050_setYAccelOffset(int16_t offset) {
-    MPU6050_writeWord(mpu6050.devAddr, MPU6050_RA_YA_OFFS_H, offset);
+void MPU6050_setYAccelOffset(MPU6050_t *dev, int16_t offset) {
+    MPU6050_writeWord(dev, MPU6050_RA_YA_OFFS_H, offset);
 }
 
 // ZA_OFFS_* register
 
-int16_t MPU6050_getZAccelOffset(void) {
-    MPU6050_readBytes(mpu6050.devAddr, MPU6050_RA_ZA_OFFS_H, 2, mpu6050.buffer);
-    return (((int16_t)mpu6050.buffer[0]) << 8) | mpu6050.buffer[1];
+int16_t MPU6050_getZAccelOffset(MPU6050_t *dev) {
+    MPU6050_readBytes(dev, MPU6050_RA_ZA_OFFS_H, 2, dev->buffer);
+    return (((int16_t)dev->buffer[0]) << 8) | dev->buffer[1];
 }
-void MPU6050_setZAccelOffset(int16_t offset) {
-    MPU6050_writeWord(mpu6050.devAddr, MPU6050_RA_ZA_OFFS_H, offset);
+void MPU6050_setZAccelOffset(MPU6050_t *dev, int16_t offset) {
+    MPU6050_writeWord(dev, MPU6050_RA_ZA_OFFS_H, offset);
 }
 
 // XG_OFFS_USR* registers
 
-int16_t MPU6050_getXGyroOffset(void) {
-    MPU6050_readBytes(mpu6050.devAddr, MPU6050_RA_XG_OFFS_USRH, 2, mpu6050.buffer);
-    return (((int16_t)mpu6050.buffer[0]) << 8) | mpu6050.buffer[1];
+int16_t MPU6050_getXGyroOffset(MPU6050_t *dev) {
+    MPU6050_readBytes(dev, MPU6050_RA_XG_OFFS_USRH, 2, dev->buffer);
+    return (((int16_t)dev->buffer[0]) << 8) | dev->buffer[1];
 }
-void MPU6050_setXGyroOffset(int16_t offset) {
-    MPU6050_writeWord(mpu6050.devAddr, MPU6050_RA_XG_OFFS_USRH, offset);
+void MPU6050_setXGyroOffset(MPU6050_t *dev, int16_t offset) {
+    MPU6050_writeWord(dev, MPU6050_RA_XG_OFFS_USRH, offset);
 }
 
 // YG_OFFS_USR* register
 
-int16_t MPU6050_getYGyroOffset(void) {
-    MPU6050_readBytes(mpu6050.devAddr, MPU6050_RA_YG_OFFS_USRH, 2, mpu6050.buffer);
-    return (((int16_t)mpu6050.buffer[0]) << 8) | mpu6050.buffer[1];
+int16_t MPU6050_getYGyroOffset(MPU6050_t *dev) {
+    MPU6050_readBytes(dev, MPU6050_RA_YG_OFFS_USRH, 2, dev->buffer);
+    return (((int16_t)dev->buffer[0]) << 8) | dev->buffer[1];
 }
-void MPU6050_setYGyroOffset(int16_t offset) {
-    MPU6050_writeWord(mpu6050.devAddr, MPU6050_RA_YG_OFFS_USRH, offset);
+void MPU6050_setYGyroOffset(MPU6050_t *dev, int16_t offset) {
+    MPU6050_writeWord(dev, MPU6050_RA_YG_OFFS_USRH, offset);
 }
 
 // ZG_OFFS_USR* register
 
-int16_t MPU6050_getZGyroOffset(void) {
-    MPU6050_readBytes(mpu6050.devAddr, MPU6050_RA_ZG_OFFS_USRH, 2, mpu6050.buffer);
-    return (((int16_t)mpu6050.buffer[0]) << 8) | mpu6050.buffer[1];
+int16_t MPU6050_getZGyroOffset(MPU6050_t *dev) {
+    MPU6050_readBytes(dev, MPU6050_RA_ZG_OFFS_USRH, 2, dev->buffer);
+    return (((int16_t)dev->buffer[0]) << 8) | dev->buffer[1];
 }
-void MPU6050_setZGyroOffset(int16_t offset) {
-    MPU6050_writeWord(mpu6050.devAddr, MPU6050_RA_ZG_OFFS_USRH, offset);
+void MPU6050_setZGyroOffset(MPU6050_t *dev, int16_t offset) {
+    MPU6050_writeWord(dev, MPU6050_RA_ZG_OFFS_USRH, offset);
 }
 
 // INT_ENABLE register (DMP functions)
 
-bool MPU6050_getIntPLLReadyEnabled(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_INT_ENABLE, MPU6050_INTERRUPT_PLL_RDY_INT_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getIntPLLReadyEnabled(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_INT_ENABLE, MPU6050_INTERRUPT_PLL_RDY_INT_BIT, dev->buffer);
+    return dev->buffer[0];
 }
-void MPU6050_setIntPLLReadyEnabled(bool enabled) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_INT_ENABLE, MPU6050_INTERRUPT_PLL_RDY_INT_BIT, enabled);
+void MPU6050_setIntPLLReadyEnabled(MPU6050_t *dev, bool enabled) {
+    MPU6050_writeBit(dev, MPU6050_RA_INT_ENABLE, MPU6050_INTERRUPT_PLL_RDY_INT_BIT, enabled);
 }
-bool MPU6050_getIntDMPEnabled(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_INT_ENABLE, MPU6050_INTERRUPT_DMP_INT_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getIntDMPEnabled(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_INT_ENABLE, MPU6050_INTERRUPT_DMP_INT_BIT, dev->buffer);
+    return dev->buffer[0];
 }
-void MPU6050_setIntDMPEnabled(bool enabled) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_INT_ENABLE, MPU6050_INTERRUPT_DMP_INT_BIT, enabled);
+void MPU6050_setIntDMPEnabled(MPU6050_t *dev, bool enabled) {
+    MPU6050_writeBit(dev, MPU6050_RA_INT_ENABLE, MPU6050_INTERRUPT_DMP_INT_BIT, enabled);
 }
 
 // DMP_INT_STATUS
 
-bool MPU6050_getDMPInt5Status(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_DMP_INT_STATUS, MPU6050_DMPINT_5_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getDMPInt5Status(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_DMP_INT_STATUS, MPU6050_DMPINT_5_BIT, dev->buffer);
+    return dev->buffer[0];
 }
-bool MPU6050_getDMPInt4Status(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_DMP_INT_STATUS, MPU6050_DMPINT_4_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getDMPInt4Status(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_DMP_INT_STATUS, MPU6050_DMPINT_4_BIT, dev->buffer);
+    return dev->buffer[0];
 }
-bool MPU6050_getDMPInt3Status(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_DMP_INT_STATUS, MPU6050_DMPINT_3_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getDMPInt3Status(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_DMP_INT_STATUS, MPU6050_DMPINT_3_BIT, dev->buffer);
+    return dev->buffer[0];
 }
-bool MPU6050_getDMPInt2Status(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_DMP_INT_STATUS, MPU6050_DMPINT_2_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getDMPInt2Status(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_DMP_INT_STATUS, MPU6050_DMPINT_2_BIT, dev->buffer);
+    return dev->buffer[0];
 }
-bool MPU6050_getDMPInt1Status(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_DMP_INT_STATUS, MPU6050_DMPINT_1_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getDMPInt1Status(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_DMP_INT_STATUS, MPU6050_DMPINT_1_BIT, dev->buffer);
+    return dev->buffer[0];
 }
-bool MPU6050_getDMPInt0Status(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_DMP_INT_STATUS, MPU6050_DMPINT_0_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getDMPInt0Status(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_DMP_INT_STATUS, MPU6050_DMPINT_0_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 
 // INT_STATUS register (DMP functions)
 
-bool MPU6050_getIntPLLReadyStatus(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_INT_STATUS, MPU6050_INTERRUPT_PLL_RDY_INT_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getIntPLLReadyStatus(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_INT_STATUS, MPU6050_INTERRUPT_PLL_RDY_INT_BIT, dev->buffer);
+    return dev->buffer[0];
 }
-bool MPU6050_getIntDMPStatus(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_INT_STATUS, MPU6050_INTERRUPT_DMP_INT_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getIntDMPStatus(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_INT_STATUS, MPU6050_INTERRUPT_DMP_INT_BIT, dev->buffer);
+    return dev->buffer[0];
 }
 
 // USER_CTRL register (DMP functions)
 
-bool MPU6050_getDMPEnabled(void) {
-    MPU6050_readBit(mpu6050.devAddr, MPU6050_RA_USER_CTRL, MPU6050_USERCTRL_DMP_EN_BIT, mpu6050.buffer);
-    return mpu6050.buffer[0];
+bool MPU6050_getDMPEnabled(MPU6050_t *dev) {
+    MPU6050_readBit(dev, MPU6050_RA_USER_CTRL, MPU6050_USERCTRL_DMP_EN_BIT, dev->buffer);
+    return dev->buffer[0];
 }
-void MPU6050_setDMPEnabled(bool enabled) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_USER_CTRL, MPU6050_USERCTRL_DMP_EN_BIT, enabled);
+void MPU6050_setDMPEnabled(MPU6050_t *dev, bool enabled) {
+    MPU6050_writeBit(dev, MPU6050_RA_USER_CTRL, MPU6050_USERCTRL_DMP_EN_BIT, enabled);
 }
-void MPU6050_resetDMP(void) {
-    MPU6050_writeBit(mpu6050.devAddr, MPU6050_RA_USER_CTRL, MPU6050_USERCTRL_DMP_RESET_BIT, true);
+void MPU6050_resetDMP(MPU6050_t *dev) {
+    MPU6050_writeBit(dev, MPU6050_RA_USER_CTRL, MPU6050_USERCTRL_DMP_RESET_BIT, true);
 }
 
 // BANK_SEL register
 
-void MPU6050_setMemoryBank(uint8_t bank, bool prefetchEnabled, bool userBank) {
+void MPU6050_setMemoryBank(MPU6050_t *dev, uint8_t bank, bool prefetchEnabled, bool userBank) {
     bank &= 0x1F;
     if (userBank) bank |= 0x20;
     if (prefetchEnabled) bank |= 0x40;
-    MPU6050_writeByte(mpu6050.devAddr, MPU6050_RA_BANK_SEL, bank);
+    MPU6050_writeByte(dev, MPU6050_RA_BANK_SEL, bank);
 }
 
 // MEM_START_ADDR register
 
-void MPU6050_setMemoryStartAddress(uint8_t address) {
-    MPU6050_writeByte(mpu6050.devAddr, MPU6050_RA_MEM_START_ADDR, address);
+void MPU6050_setMemoryStartAddress(MPU6050_t *dev, uint8_t address) {
+    MPU6050_writeByte(dev, MPU6050_RA_MEM_START_ADDR, address);
 }
 
 // MEM_R_W register
 
-uint8_t MPU6050_readMemoryByte(void) {
-    MPU6050_readByte(mpu6050.devAddr, MPU6050_RA_MEM_R_W, mpu6050.buffer);
-    return mpu6050.buffer[0];
+uint8_t MPU6050_readMemoryByte(MPU6050_t *dev) {
+    MPU6050_readByte(dev, MPU6050_RA_MEM_R_W, dev->buffer);
+    return dev->buffer[0];
 }
-void MPU6050_writeMemoryByte(uint8_t data) {
-    MPU6050_writeByte(mpu6050.devAddr, MPU6050_RA_MEM_R_W, data);
+void MPU6050_writeMemoryByte(MPU6050_t *dev, uint8_t data) {
+    MPU6050_writeByte(dev, MPU6050_RA_MEM_R_W, data);
 }
-void MPU6050_readMemoryBlock(uint8_t *data, uint16_t dataSize, uint8_t bank, uint8_t address) {
-    uint8_t chunkSize;
+void MPU6050_readMemoryBlock(MPU6050_t *dev, uint8_t *data, uint16_t dataSize, uint8_t bank, uint8_t address) {
+    uint16_t chunkSize;
     unsigned int i;
-    MPU6050_setMemoryBank(bank, false, false);
-    MPU6050_setMemoryStartAddress(address);
+    MPU6050_setMemoryBank(dev, bank, false, false);
+    MPU6050_setMemoryStartAddress(dev, address);
     for (i = 0; i < dataSize;) {
-        // determine correct chunk size according to bank position and data size
-        chunkSize = MPU6050_DMP_MEMORY_CHUNK_SIZE;
-
-        // make sure we don't go past the data size
-        if (i + chunkSize > dataSize) chunkSize = dataSize - i;
+        // The bus driver has no small buffer to respect (and moves long bursts
+        // with DMA), so read up to the end of the data or of the bank.
+        chunkSize = dataSize - i;
 
         // make sure this chunk doesn't go past the bank boundary (256 bytes)
         if (chunkSize > 256 - address) chunkSize = 256 - address;
 
         // read the chunk of data as specified
-        MPU6050_readBytes(mpu6050.devAddr, MPU6050_RA_MEM_R_W, chunkSize, data + i);
+        MPU6050_readBurst(dev, MPU6050_RA_MEM_R_W, chunkSize, data + i);
         
         // increase byte index by [chunkSize]
         i += chunkSize;
@@ -3143,28 +3452,28 @@ void MPU6050_readMemoryBlock(uint8_t *data, uint16_t dataSize, uint8_t bank, uin
         // if we aren't done, update bank (if necessary) and address
         if (i < dataSize) {
             if (address == 0) bank++;
-            MPU6050_setMemoryBank(bank, false, false);
-            MPU6050_setMemoryStartAddress(address);
+            MPU6050_setMemoryBank(dev, bank, false, false);
+            MPU6050_setMemoryStartAddress(dev, address);
         }
     }
 }
 
 // DMP_CFG_1 register
 
-uint8_t MPU6050_getDMPConfig1(void) {
-    MPU6050_readByte(mpu6050.devAddr, MPU6050_RA_DMP_CFG_1, mpu6050.buffer);
-    return mpu6050.buffer[0];
+uint8_t MPU6050_getDMPConfig1(MPU6050_t *dev) {
+    MPU6050_readByte(dev, MPU6050_RA_DMP_CFG_1, dev->buffer);
+    return dev->buffer[0];
 }
-void MPU6050_setDMPConfig1(uint8_t config) {
-    MPU6050_writeByte(mpu6050.devAddr, MPU6050_RA_DMP_CFG_1, config);
+void MPU6050_setDMPConfig1(MPU6050_t *dev, uint8_t config) {
+    MPU6050_writeByte(dev, MPU6050_RA_DMP_CFG_1, config);
 }
 
 // DMP_CFG_2 register
 
-uint8_t MPU6050_getDMPConfig2(void) {
-    MPU6050_readByte(mpu6050.devAddr, MPU6050_RA_DMP_CFG_2, mpu6050.buffer);
-    return mpu6050.buffer[0];
+uint8_t MPU6050_getDMPConfig2(MPU6050_t *dev) {
+    MPU6050_readByte(dev, MPU6050_RA_DMP_CFG_2, dev->buffer);
+    return dev->buffer[0];
 }
-void MPU6050_setDMPConfig2(uint8_t config) {
-    MPU6050_writeByte(mpu6050.devAddr, MPU6050_RA_DMP_CFG_2, config);
+void MPU6050_setDMPConfig2(MPU6050_t *dev, uint8_t config) {
+    MPU6050_writeByte(dev, MPU6050_RA_DMP_CFG_2, config);
 }
\ No newline at end of file
@@ -0,0 +1,444 @@
+#include "acquisition.h"
+#include "mpu6050_iio.h"
+#include "lliano_trace.h"
+
+/******************************************************************************
+ * Module parameters
+******************************************************************************/
+
+static unsigned char smplrt_div = ACQUISITION_DEFAULT_RATE_DIV;
+module_param(smplrt_div, byte, 0444);
+MODULE_PARM_DESC(smplrt_div, "MPU6050 SMPLRT_DIV: sample rate = 1kHz / (1 + smplrt_div)");
+
+static int acq_mode = ACQUISITION_MODE_DRDY;
+module_param(acq_mode, int, 0444);
+MODULE_PARM_DESC(acq_mode, "0 = polled, 1 = data ready interrupt (polled without one), 2 = hardware FIFO");
+
+static unsigned int fifo_watermark = ACQUISITION_DEFAULT_FIFO_WATERMARK;
+module_param(fifo_watermark, uint, 0444);
+MODULE_PARM_DESC(fifo_watermark, "Samples to let accumulate in the MPU6050 FIFO before draining it");
+
+/******************************************************************************
+ * Static functions
+******************************************************************************/
+
+/// @brief Time it takes the sensor to produce 'samples' samples.
+static unsigned long __samples_to_jiffies(unsigned int samples)
+{
+    return msecs_to_jiffies(samples * (1 + smplrt_div));
+}
+
+/// @brief Fills a record from the raw registers of a motion7 burst (big-endian,
+///  accel XYZ, temp, gyro XYZ). The sequence number is left untouched.
+static void __fill_record(struct mpu6050_record *record, const u8 *motion7, u64 timestamp_ns, u16 flags)
+{
+    int i;
+
+    record->version = MPU6050_RECORD_VERSION;
+    record->flags = flags;
+    record->timestamp_ns = timestamp_ns;
+    for (i = 0; i < 3; i++) {
+        record->accel[i] = (s16) get_unaligned_be16(&motion7[2 * i]);
+        record->gyro[i] = (s16) get_unaligned_be16(&motion7[8 + 2 * i]);
+    }
+    record->temp = (s16) get_unaligned_be16(&motion7[6]);
+    record->reserved = 0;
+}
+
+/// @brief Nominal sample period of the sensor.
+static u64 __sample_period_ns(void)
+{
+    return (u64) (1 + smplrt_div) * NSEC_PER_MSEC;
+}
+
+/// @brief Schedules the next drain for when a watermark worth of samples is
+///  expected in the FIFO, counting from 'count_ns', when 'pending' of them were
+///  already there. Counting from the FIFO count instead of the end of the drain
+///  keeps the time the drain (or the drain of another sensor) took on the bus
+///  out of the period.
+static void __fifo_schedule(struct acquisition *acq, u64 count_ns, unsigned int pending)
+{
+    u64 due_ns, now_ns = ktime_get_ns();
+
+    if (pending >= fifo_watermark) {
+        schedule_delayed_work(&acq->fifo_work, 0);
+        return;
+    }
+    due_ns = count_ns + (fifo_watermark - pending) * __sample_period_ns();
+    schedule_delayed_work(&acq->fifo_work, due_ns > now_ns ? nsecs_to_jiffies(due_ns - now_ns) : 0);
+}
+
+/// @brief Follows the sensor's clock: 'produced' samples entered the FIFO since
+///  it was last counted, at 'now_ns'. Measures far off the nominal period (a
+///  drain that was late by a whole sample, for instance) are ignored.
+static void __fifo_track_period(struct acquisition *acq, u64 now_ns, unsigned int produced)
+{
+    u64 nominal = __sample_period_ns();
+    u64 measured;
+
+    if (acq->fifo_count_ns != 0 && produced != 0) {
+        measured = div_u64(now_ns - acq->fifo_count_ns, produced);
+        if (measured > nominal - nominal / ACQUISITION_FIFO_PERIOD_TOLERANCE &&
+                measured < nominal + nominal / ACQUISITION_FIFO_PERIOD_TOLERANCE)
+            acq->fifo_period_ns += (s64) (measured - acq->fifo_period_ns) / ACQUISITION_FIFO_PERIOD_WEIGHT;
+    }
+    acq->fifo_count_ns = now_ns;
+}
+
+/// @brief Time of the oldest of the 'available' samples in the FIFO, counted at
+///  'now_ns'. The samples are a period apart and the newest one was taken during
+///  the last period, so the times carry on from the previous drain unless that
+///  would break this bound.
+static u64 __fifo_first_timestamp(struct acquisition *acq, u64 now_ns, unsigned int available)
+{
+    u64 span = (u64) (available - 1) * acq->fifo_period_ns;
+    u64 newest = acq->fifo_next_ns + span;
+
+    if (acq->fifo_next_ns == 0 || newest > now_ns)
+        newest = now_ns;
+    else if (newest + acq->fifo_period_ns < now_ns)
+        newest = now_ns - acq->fifo_period_ns;
+    return newest - span;
+}
+
+/// @brief Empties the MPU6050 FIFO and starts filling it again with accel, temp
+///  and gyro (the same 14 bytes layout as MPU6050_getMotion7()).
+static void __fifo_restart(struct acquisition *acq)
+{
+    acq->fifo_count_ns = 0;
+    acq->fifo_left = 0;
+    acq->fifo_next_ns = 0;
+
+    MPU6050_setFIFOEnabled(acq->mpu, false);
+    MPU6050_resetFIFO(acq->mpu);
+    MPU6050_setAccelFIFOEnabled(acq->mpu, true);
+    MPU6050_setTempFIFOEnabled(acq->mpu, true);
+    MPU6050_setXGyroFIFOEnabled(acq->mpu, true);
+    MPU6050_setYGyroFIFOEnabled(acq->mpu, true);
+    MPU6050_setZGyroFIFOEnabled(acq->mpu, true);
+    MPU6050_setFIFOEnabled(acq->mpu, true);
+}
+
+/// @brief Reads how many bytes the MPU6050 FIFO holds. Unlike MPU6050_getFIFOCount(),
+///  a failed read doesn't go unnoticed.
+/// @return "0" on success, negative error code on error.
+static int __fifo_count(struct acquisition *acq, unsigned int *count)
+{
+    u8 regs[2];
+    int ret;
+
+    ret = i2c_read_regs(acq->mpu->bus, acq->mpu->devAddr, MPU6050_RA_FIFO_COUNTH, (char *) regs, sizeof(regs));
+    if (ret != 0)
+        return ret;
+    *count = ((unsigned int) regs[0] << 8) | regs[1];
+    return 0;
+}
+
+/// @brief Stops the MPU6050 FIFO.
+static void __fifo_stop(struct acquisition *acq)
+{
+    MPU6050_setFIFOEnabled(acq->mpu, false);
+    MPU6050_setAccelFIFOEnabled(acq->mpu, false);
+    MPU6050_setTempFIFOEnabled(acq->mpu, false);
+    MPU6050_setXGyroFIFOEnabled(acq->mpu, false);
+    MPU6050_setYGyroFIFOEnabled(acq->mpu, false);
+    MPU6050_setZGyroFIFOEnabled(acq->mpu, false);
+    MPU6050_resetFIFO(acq->mpu);
+}
+
+/******************************************************************************
+ * Producers
+******************************************************************************/
+
+/// @brief Called from the I2C interrupt when the burst of a sample is done. Only
+///  one burst per sensor is in flight at a time, so this is the only producer of
+///  its ring and it may push without locking.
+static void acquisition_drdy_complete(struct i2c_request *req)
+{
+    struct acquisition *acq = req->context;
+    struct mpu6050_record *record;
+
+    if (req->status == 0) {
+        record = sample_ring_reserve(&acq->ring);
+        __fill_record(record, acq->drdy_sample, acq->drdy_timestamp_ns, MPU6050_RECORD_F_DRDY);
+        trace_lliano_mpu6050_sample(record, acq->mpu->devAddr);
+        sample_ring_commit(&acq->ring);
+        mpu6050_iio_trigger_poll(acq);
+    } else {
+        pr_warn_ratelimited("%s: DRDY 0x%02x - Couldn't read the sample.\n", DRIVER_NAME, acq->mpu->devAddr);
+    }
+
+    clear_bit_unlock(0, &acq->drdy_busy);
+    wake_up_var(&acq->drdy_busy);
+}
+
+/// @brief Handler for the MPU6050 data ready interrupt. The burst is queued right
+///  away from here, with no thread to wake up, and finishes in acquisition_drdy_complete().
+///  The bursts of several sensors queue up behind each other on the bus.
+static irqreturn_t acquisition_drdy_isr(int irq_number, void *dev_id)
+{
+    struct acquisition *acq = dev_id;
+    // The sample was taken right before the edge: this is its time.
+    u64 timestamp_ns = ktime_get_ns();
+
+    // The previous sample is still on the bus: this one is lost.
+    if (test_and_set_bit_lock(0, &acq->drdy_busy)) {
+        acq->drdy_missed++;
+        pr_warn_ratelimited("%s: DRDY 0x%02x - Bus too slow, %u samples missed so far.\n",
+            DRIVER_NAME, acq->mpu->devAddr, acq->drdy_missed);
+        return IRQ_HANDLED;
+    }
+
+    acq->drdy_timestamp_ns = timestamp_ns;
+    if (MPU6050_submitMotion7(acq->mpu, &acq->drdy_req, acq->drdy_sample, acquisition_drdy_complete, acq) != 0)
+        clear_bit_unlock(0, &acq->drdy_busy);
+    return IRQ_HANDLED;
+}
+
+/// @brief Drains every complete sample of the MPU6050 FIFO with one burst and
+///  sleeps until a watermark worth of samples is expected to be there again.
+///  This work is the only producer of the ring in FIFO mode.
+///  The samples are stamped a sample period apart, following the sensor's clock
+///  instead of the drains (see __fifo_first_timestamp()).
+static void acquisition_fifo_work(struct work_struct *work)
+{
+    struct acquisition *acq = container_of(to_delayed_work(work), struct acquisition, fifo_work);
+    struct mpu6050_record *record;
+    unsigned int count, frames, available, i;
+    unsigned int pending = 0;      // Complete samples left in the FIFO after the drain
+    u64 count_ns, first_ns;
+
+    // Stamped once the count is back: with several sensors on the bus it may
+    // have waited for the drain of another one.
+    if (__fifo_count(acq, &count) != 0) {
+        // The samples are still there: try again one period later
+        pr_warn_ratelimited("%s: FIFO 0x%02x - Couldn't read the FIFO count.\n", DRIVER_NAME, acq->mpu->devAddr);
+        count_ns = ktime_get_ns();
+        pending = fifo_watermark - 1;
+        goto reschedule;
+    }
+    count_ns = ktime_get_ns();
+
+    // Once it overflows the FIFO drops its oldest bytes, so the frames are no
+    // longer aligned. The only way out is to start over.
+    if (count >= MPU6050_FIFO_SIZE) {
+        acq->fifo_overflows++;
+        pr_warn_ratelimited("%s: FIFO 0x%02x - Overflow, %u so far.\n",
+            DRIVER_NAME, acq->mpu->devAddr, acq->fifo_overflows);
+        __fifo_restart(acq);
+        goto reschedule;
+    }
+
+    available = count / MPU6050_MOTION7_LENGTH;
+    __fifo_track_period(acq, count_ns, available - min(acq->fifo_left, available));
+
+    frames = min_t(unsigned int, available, ACQUISITION_FIFO_MAX_FRAMES);
+    if (frames != 0) {
+        // An aborted drain may have taken part of a frame: start over, like
+        // after an overflow, rather than hand out torn samples
+        if (MPU6050_getFIFOBytes(acq->mpu, acq->fifo_buffer, frames * MPU6050_MOTION7_LENGTH) != 0) {
+            pr_warn_ratelimited("%s: FIFO 0x%02x - Couldn't drain the FIFO.\n", DRIVER_NAME, acq->mpu->devAddr);
+            __fifo_restart(acq);
+            goto reschedule;
+        }
+        first_ns = __fifo_first_timestamp(acq, count_ns, available);
+        for (i = 0; i < frames; i++) {
+            record = sample_ring_reserve(&acq->ring);
+            __fill_record(record, &acq->fifo_buffer[i * MPU6050_MOTION7_LENGTH],
+                first_ns + i * acq->fifo_period_ns, MPU6050_RECORD_F_FIFO);
+            trace_lliano_mpu6050_sample(record, acq->mpu->devAddr);
+            sample_ring_commit(&acq->ring);
+        }
+        acq->fifo_next_ns = first_ns + frames * acq->fifo_period_ns;
+        mpu6050_iio_trigger_poll(acq);
+    }
+    pending = available - frames;
+    acq->fifo_left = pending;
+
+    reschedule:
+    __fifo_schedule(acq, count_ns, pending);
+}
+
+/// @brief Threaded handler for the MPU6050 interrupt in FIFO mode, only enabled
+///  for FIFO overflows. The drain recovers from it right away.
+static irqreturn_t acquisition_fifo_thread(int irq_number, void *dev_id)
+{
+    struct acquisition *acq = dev_id;
+
+    mod_delayed_work(system_wq, &acq->fifo_work, 0);
+    return IRQ_HANDLED;
+}
+
+/******************************************************************************
+ * Functions
+******************************************************************************/
+
+/// @brief Sets up the sampling engine of a sensor:
+///  - ACQUISITION_MODE_FIFO: the MPU6050 FIFO is drained every 'fifo_watermark'
+///    samples. The interrupt, if any, only reports FIFO overflows.
+///  - ACQUISITION_MODE_DRDY: if the MPU6050 node of the device tree has an
+///    interrupt, the sensor's data ready signal feeds the sample ring.
+///  - ACQUISITION_MODE_POLLED, or DRDY without an interrupt: the char device
+///    reads the sensor on every read().
+/// @param node MPU6050 node of the device tree, for its interrupt.
+/// @param dev Device of the bus, parent of the IIO trigger.
+/// @param slot Position of the sensor among the 'slots' ones of the bus. In FIFO
+///  mode their drains are spread evenly over a watermark, so they interleave on
+///  the bus instead of queuing up behind each other.
+/// @return "0" on success, not "0" on error.
+int acquisition_init(struct acquisition *acq, MPU6050_t *mpu, struct device_node *node,
+    struct device *dev, unsigned int slot, unsigned int slots)
+{
+    irq_handler_t handler, thread;
+    unsigned long irq_flags;
+    int retval = -1;
+    MPU6050_profile_t profile = {
+        .rate = smplrt_div,
+        .dlpfMode = ACQUISITION_DLPF_MODE,
+        .gyroRange = MPU6050_getFullScaleGyroRange(mpu),
+        .accelRange = MPU6050_getFullScaleAccelRange(mpu),
+    };
+
+    acq->mpu = mpu;
+    acq->mode = ACQUISITION_MODE_POLLED;
+    acq->trigger = NULL;
+
+    if (MPU6050_setProfile(mpu, &profile) != 0) {
+        pr_err("%s: ACQ 0x%02x - Couldn't configure the sample rate.\n", DRIVER_NAME, mpu->devAddr);
+        return -EIO;
+    }
+
+    if (fifo_watermark == 0 || fifo_watermark > ACQUISITION_FIFO_MAX_FRAMES) {
+        pr_err("%s: ACQ - fifo_watermark must be between 1 and %d.\n", DRIVER_NAME, ACQUISITION_FIFO_MAX_FRAMES);
+        return -EINVAL;
+    }
+
+    acq->irq = of_irq_get(node, 0);
+    if (acq->irq == -EPROBE_DEFER)
+        return acq->irq;
+    if (acq->irq <= 0)
+        acq->irq = -1;
+
+    if (acq_mode == ACQUISITION_MODE_FIFO) {
+        acq->mode = ACQUISITION_MODE_FIFO;
+        handler = NULL;
+        thread = acquisition_fifo_thread;
+        irq_flags = IRQF_TRIGGER_RISING | IRQF_ONESHOT;
+    } else if (acq_mode == ACQUISITION_MODE_DRDY && acq->irq > 0) {
+        acq->mode = ACQUISITION_MODE_DRDY;
+        handler = acquisition_drdy_isr;
+        thread = NULL;
+        irq_flags = IRQF_TRIGGER_RISING;
+    } else {
+        pr_info("%s: ACQ 0x%02x - Using polled mode.\n", DRIVER_NAME, mpu->devAddr);
+        return 0;
+    }
+
+    if ((retval = sample_ring_init(&acq->ring)) != 0) {
+        pr_err("%s: ACQ 0x%02x - Couldn't allocate the sample ring.\n", DRIVER_NAME, mpu->devAddr);
+        goto ring_error;
+    }
+    acq->drdy_busy = 0;
+    INIT_DELAYED_WORK(&acq->fifo_work, acquisition_fifo_work);
+
+    if ((retval = mpu6050_iio_trigger_init(acq, dev)) != 0)
+        goto trigger_error;
+
+    if (acq->irq > 0) {
+        // 50us active high pulse on every enabled event
+        MPU6050_setInterruptMode(mpu, MPU6050_INTMODE_ACTIVEHIGH);
+        MPU6050_setInterruptDrive(mpu, MPU6050_INTDRV_PUSHPULL);
+        MPU6050_setInterruptLatch(mpu, MPU6050_INTLATCH_50USPULSE);
+
+        if ((retval = request_threaded_irq(acq->irq, handler, thread,
+                irq_flags, MPU6050_COMPATIBLE, acq)) != 0) {
+            pr_err("%s: ACQ 0x%02x - Couldn't request the MPU6050 IRQ.\n", DRIVER_NAME, mpu->devAddr);
+            goto irq_error;
+        }
+    }
+
+    if (acq->mode == ACQUISITION_MODE_FIFO) {
+        acq->fifo_period_ns = __sample_period_ns();
+        __fifo_restart(acq);
+        if (acq->irq > 0)
+            MPU6050_setIntFIFOBufferOverflowEnabled(mpu, true);
+        schedule_delayed_work(&acq->fifo_work,
+            __samples_to_jiffies(fifo_watermark + fifo_watermark * slot / max(slots, 1U)));
+        pr_info("%s: ACQ 0x%02x - Streaming at %d Hz from the FIFO, %u samples per drain.\n",
+            DRIVER_NAME, mpu->devAddr, 1000 / (1 + smplrt_div), fifo_watermark);
+    } else {
+        MPU6050_setIntDataReadyEnabled(mpu, true);
+        pr_info("%s: ACQ 0x%02x - Streaming at %d Hz from the data ready interrupt.\n",
+            DRIVER_NAME, mpu->devAddr, 1000 / (1 + smplrt_div));
+    }
+    return 0;
+
+    irq_error: mpu6050_iio_trigger_deinit(acq);
+    trigger_error: sample_ring_free(&acq->ring);
+    ring_error: acq->mode = ACQUISITION_MODE_POLLED;
+    return retval;
+}
+
+/// @brief Stops the sampling engine of a sensor. The ring is left to the readers
+///  still on it, see acquisition_free().
+void acquisition_deinit(struct acquisition *acq)
+{
+    if (acq->mode == ACQUISITION_MODE_POLLED)
+        return;
+
+    if (acq->mode == ACQUISITION_MODE_FIFO) {
+        if (acq->irq > 0) {
+            MPU6050_setIntFIFOBufferOverflowEnabled(acq->mpu, false);
+            free_irq(acq->irq, acq);
+        }
+        cancel_delayed_work_sync(&acq->fifo_work);
+        __fifo_stop(acq);
+    } else {
+        MPU6050_setIntDataReadyEnabled(acq->mpu, false);
+        free_irq(acq->irq, acq);
+        // The last burst may still be on the bus
+        wait_var_event(&acq->drdy_busy, !test_bit(0, &acq->drdy_busy));
+    }
+
+    mpu6050_iio_trigger_deinit(acq);
+}
+
+/// @brief Frees the ring, once acquisition_deinit() stopped feeding it and no
+///  reader is left.
+void acquisition_free(struct acquisition *acq)
+{
+    if (acq->mode == ACQUISITION_MODE_POLLED)
+        return;
+
+    sample_ring_free(&acq->ring);
+    acq->mode = ACQUISITION_MODE_POLLED;
+}
+
+/// @brief Whether samples are captured by the driver (true) or must be read on demand (false).
+bool acquisition_is_streaming(struct acquisition *acq)
+{
+    return acq->mode != ACQUISITION_MODE_POLLED;
+}
+
+/// @brief Reads a sample on demand, for the polled mode.
+/// @return "0" on success, "-EIO" on error.
+int acquisition_read_polled(struct acquisition *acq, struct mpu6050_record *record)
+{
+    u8 sample[MPU6050_MOTION7_LENGTH];
+    u64 timestamp_ns;
+
+    // Stamped when the burst starts on the bus, not when it was asked for
+    if (MPU6050_getMotion7Timestamp(acq->mpu, sample, &timestamp_ns) != 0)
+        return -EIO;
+
+    __fill_record(record, sample, timestamp_ns, MPU6050_RECORD_F_POLLED);
+    record->seq = atomic_inc_return(&acq->polled_seq) - 1;
+    trace_lliano_mpu6050_sample(record, acq->mpu->devAddr);
+    return 0;
+}
+
+/// @brief Ring fed by the data ready interrupt or the FIFO drain. Only valid when streaming.
+struct sample_ring *acquisition_get_ring(struct acquisition *acq)
+{
+    return &acq->ring;
+}
@@ -4,19 +4,36 @@
  * Static functions' prototypes
 ******************************************************************************/
 
+struct char_device_reader;
+
 static int char_device_open(struct inode *device_file, struct file *instance);
 static int char_device_release(struct inode *device_file, struct file *instance);
 static ssize_t char_device_write(struct file *file, const char *user_buffer, size_t count, loff_t *offs);
 static ssize_t char_device_read(struct file *file, char *user_buffer, size_t count, loff_t *offs);
 static long int char_device_ioctl(struct file *file, unsigned cmd, unsigned long arg);
+static long int __char_device_ioctl(struct char_device_reader *reader, unsigned cmd, unsigned long arg);
+static __poll_t char_device_poll(struct file *file, poll_table *wait);
+static int char_device_mmap(struct file *file, struct vm_area_struct *vma);
 
 /******************************************************************************
  * Static variables
 ******************************************************************************/
 
+// Per open() state, saved in file->private_data.
+struct char_device_reader {
+    struct mpu6050_sensor *sensor;
+    u32 tail;       // Next sample of the ring to be read.
+    u32 dropped;    // Samples overwritten before this reader could read them.
+    u32 watermark;  // Samples needed to be readable (POLLIN, blocking read()).
+};
+
 static dev_t device_number;
 static struct class *device_class;
-static struct cdev my_device;
+
+// Sensor behind each minor. open() takes its reference under the lock, so it
+// can't race with char_device_del().
+static struct mpu6050_sensor *sensors[NUMBER_OF_DEVICES];
+static DEFINE_MUTEX(sensors_lock);
 static struct file_operations fops = {
     .owner = THIS_MODULE,
     .open = char_device_open,
@@ -24,13 +41,16 @@ static struct file_operations fops = {
     .write = char_device_write,
     .read = char_device_read,
     .unlocked_ioctl = char_device_ioctl,
+    .poll = char_device_poll,
+    .mmap = char_device_mmap,
 };
 
 /******************************************************************************
  * Char device control
 ******************************************************************************/
 
-/// @brief Creates the char device
+/// @brief Reserves the device numbers and the class of the sensors. Each one
+///  gets its device file later, from char_device_add().
 /// @return "0"on success, non zero error code on error.
 int char_device_create() {
     int retval = -1;
@@ -43,61 +63,133 @@ int char_device_create() {
 
     // Create device class (This name will be seen as SUBSYSTEM=="DEVICE_CLASS_NAME"
     // for udev, and a folder with the same will be created inside "/sys/class/DEVICE_CLASS_NAME" )
-    if ((device_class = class_create(THIS_MODULE, DEVICE_CLASS_NAME)) == NULL) {
+    if (IS_ERR(device_class = class_create(THIS_MODULE, DEVICE_CLASS_NAME))) {
         pr_err("Device class couldn't be created.\n");
-        retval = -1;
+        retval = PTR_ERR(device_class);
         goto class_error;
     }
+    return 0;
 
-    // Create device file (/sys/class/<DEVICE_CLASS_NAME>/<DEVICE_NAME>)
-    if (device_create(device_class, NULL, device_number, NULL, DEVICE_NAME) == NULL) {
-        pr_err("Couldn't create device file.\n");
-        retval = -1;
-        goto device_error;
-    }
+    class_error: unregister_chrdev_region(device_number, NUMBER_OF_DEVICES);
+    chrdev_error: return retval;
+}
+
+/// @brief Releases the device numbers and the class, once every sensor was removed.
+void char_device_remove(void) {
+    class_destroy(device_class);
+    unregister_chrdev_region(device_number, NUMBER_OF_DEVICES);
+}
+
+/// @brief Creates the device file of a sensor. Its minor comes from the controller
+///  and its index on the bus. The cdev is allocated on its own, since the files
+///  open on it hold it a bit longer than they hold the sensor.
+/// @return "0"on success, non zero error code on error.
+int char_device_add(struct mpu6050_sensor *sensor, struct device *parent) {
+    int bus = sensor->mpu.bus->id;
+    unsigned int minor = bus * SENSORS_MAX + sensor->index;
+    dev_t devt = MKDEV(MAJOR(device_number), MINOR(device_number) + minor);
+    int retval = -1;
 
     // Initializing and registering device file
-    cdev_init(&my_device, &fops);
-    if ((retval = cdev_add(&my_device, device_number, NUMBER_OF_DEVICES)) != 0 ) {
+    if ((sensor->cdev = cdev_alloc()) == NULL)
+        return -ENOMEM;
+    sensor->cdev->ops = &fops;
+    sensor->cdev->owner = THIS_MODULE;
+    if ((retval = cdev_add(sensor->cdev, devt, 1)) != 0 ) {
         pr_err("Registering of device to kernel failed.\n");
+        kobject_put(&sensor->cdev->kobj);
         goto cdev_add_error;
     }
+    mutex_lock(&sensors_lock);
+    sensors[minor] = sensor;
+    mutex_unlock(&sensors_lock);
+
+    // Create device file (/sys/class/<DEVICE_CLASS_NAME>/<DEVICE_NAME>-<bus>-<address>)
+    sensor->char_dev = device_create(device_class, parent, devt, sensor, DEVICE_NODE_NAME, bus, sensor->mpu.devAddr);
+    if (IS_ERR(sensor->char_dev)) {
+        pr_err("Couldn't create device file.\n");
+        retval = PTR_ERR(sensor->char_dev);
+        goto device_error;
+    }
 
-    pr_info("Device /dev/%s created successfully. Major: %d, Minor: %d.\n",
-        DEVICE_NAME, MAJOR(device_number), MINOR(device_number));
+    pr_info("Device /dev/" DEVICE_NODE_NAME " created successfully. Major: %d, Minor: %d.\n",
+        bus, sensor->mpu.devAddr, MAJOR(devt), MINOR(devt));
     return 0;
 
-    cdev_add_error: device_destroy(device_class, device_number);
-    device_error: class_destroy(device_class);
-    class_error: unregister_chrdev(device_number, DEVICE_NAME);
-    chrdev_error: return retval;
+    device_error: mutex_lock(&sensors_lock);
+    sensors[minor] = NULL;
+    mutex_unlock(&sensors_lock);
+    cdev_del(sensor->cdev);
+    cdev_add_error: sensor->cdev = NULL;
+    return retval;
 }
 
-/// @brief Remove previously created device.
-void char_device_remove(void) {
-    device_destroy(device_class, device_number);
-    class_destroy(device_class);
-    unregister_chrdev(device_number, DEVICE_NAME);
+/// @brief Removes the device file of a sensor. No new file can be opened on it,
+///  the ones already open keep their reference.
+void char_device_del(struct mpu6050_sensor *sensor) {
+    unsigned int minor = sensor->mpu.bus->id * SENSORS_MAX + sensor->index;
+
+    mutex_lock(&sensors_lock);
+    sensors[minor] = NULL;
+    mutex_unlock(&sensors_lock);
+    device_destroy(device_class, sensor->cdev->dev);
+    cdev_del(sensor->cdev);
+    sensor->cdev = NULL;
 }
 
 /******************************************************************************
  * File operations
 ******************************************************************************/
 
-/// @brief This function is called when the device is opened
+/// @brief This function is called when the device is opened. A new reader starts
+///  at the newest sample of the ring, it doesn't get the ones captured before.
+///  The reader keeps the sensor alive until it's closed.
 static int char_device_open(struct inode *device_file, struct file *instance)
 {
-    if(!MPU6050_testConnection()) {
+    struct mpu6050_sensor *sensor;
+    struct char_device_reader *reader;
+    bool connected;
+
+    mutex_lock(&sensors_lock);
+    if ((sensor = sensors[iminor(device_file) - MINOR(device_number)]) != NULL)
+        kref_get(&sensor->ref);
+    mutex_unlock(&sensors_lock);
+    if (sensor == NULL)
+        return -ENODEV;
+
+    down_read(&sensor->lock);
+    connected = !sensor->gone && MPU6050_testConnection(&sensor->mpu);
+    up_read(&sensor->lock);
+    if (!connected) {
         pr_err("Couldn't open device.\n");
-        return -1;
+        sensor_put(sensor);
+        return -ENODEV;
     }
+
+    if ((reader = kzalloc(sizeof(*reader), GFP_KERNEL)) == NULL) {
+        sensor_put(sensor);
+        return -ENOMEM;
+    }
+
+    reader->sensor = sensor;
+    if (acquisition_is_streaming(&sensor->acq))
+        reader->tail = sample_ring_head(acquisition_get_ring(&sensor->acq));
+    reader->watermark = 1;
+
+    instance->private_data = reader;
     return 0;
 }
 
-/// @brief This function is called when the device is closed
+/// @brief This function is called when the device is closed. The last file of a
+///  removed sensor frees it.
 static int char_device_release(struct inode *device_file, struct file *instance)
 {
-    // pr_info("%s: RELEASE was handled but there's nothing to do here!\n", DEVICE_NAME);
+    struct char_device_reader *reader = instance->private_data;
+
+    if (reader->dropped)
+        pr_info("%s: Reader closed after losing %u samples.\n", DEVICE_NAME, reader->dropped);
+    sensor_put(reader->sensor);
+    kfree(reader);
     return 0;
 }
 
@@ -109,79 +201,147 @@ static ssize_t char_device_write(struct file *file, const char __user *user_buff
     return count;
 }
 
-/// @brief Reads all acceleration, angular velocity and temperature from a char[] buffer.
-/// @return Amount of bytes read, or "-1" on error.
+/// @brief Reads as many whole samples (struct mpu6050_record) as fit in the user
+///  buffer and are available. When streaming, these are the oldest samples of the
+///  ring not read yet by this reader. A blocking read sleeps until the reader's
+///  watermark (or the whole request, if smaller) is available, while a O_NONBLOCK
+///  read returns what there is or -EAGAIN. Otherwise a single sample is read from
+///  the sensor with one burst. Once the sensor is removed, -ENODEV.
+/// @return Amount of bytes read, or negative error code.
 static ssize_t char_device_read(struct file *file, char __user *user_buffer, size_t count, loff_t *offs)
 {
+    struct char_device_reader *reader = file->private_data;
+    struct mpu6050_sensor *sensor = reader->sensor;
+    struct acquisition *acq = &sensor->acq;
+    struct sample_ring *ring;
+    size_t wanted = count / RECORD_SIZE;
+    size_t done = 0, batch;
+    int retval;
+
     // Kernel space buffer
-    char bufferaux [PACKET_NUMBER];
+    struct mpu6050_record records[RECORD_BATCH];
 
-    // Raw data
-    unsigned short int a_x, a_y, a_z;
-    unsigned short int g_x, g_y, g_z;
-    unsigned short int raw_temp;
+    if (wanted == 0)
+    {
+        pr_alert("%s: You must read at least one record of %zu bytes.", DEVICE_NAME, RECORD_SIZE);
+        return -EINVAL;
+    }
+
+    if (!acquisition_is_streaming(acq))
+    {
+        down_read(&sensor->lock);
+        retval = sensor->gone ? -ENODEV : acquisition_read_polled(acq, &records[0]);
+        up_read(&sensor->lock);
+        if (retval == -ENODEV)
+            return retval;
+        if (retval != 0)
+        {
+            pr_alert("%s: Error while reading the sample.", DEVICE_NAME);
+            return retval;
+        }
+        if (copy_to_user(user_buffer, records, RECORD_SIZE) != 0)
+            return -EFAULT;
+        return RECORD_SIZE;
+    }
 
-    if (count < PACKET_NUMBER)
+    ring = acquisition_get_ring(acq);
+    if (file->f_flags & O_NONBLOCK)
     {
-        pr_alert("%s: You must performa full read of %d bytes.", DEVICE_NAME, PACKET_NUMBER);
-        return -1;
+        if (READ_ONCE(sensor->gone))
+            return -ENODEV;
+        if (sample_ring_available(ring, reader->tail) == 0)
+            return -EAGAIN;
     }
-    
-    // Data read
-    MPU6050_getMotion6(&a_x, &a_y, &a_z, &g_x, &g_y, &g_z);
-    raw_temp = MPU6050_getTemperature();
-
-    // Debug print
-    pr_info("MPU6050: a_x = %d\n", a_x);
-    pr_info("MPU6050: a_y = %d\n", a_y);
-    pr_info("MPU6050: a_z = %d\n", a_z);
-    pr_info("MPU6050: g_x = %d\n", g_x);
-    pr_info("MPU6050: g_y = %d\n", g_y);
-    pr_info("MPU6050: g_z = %d\n", g_z);
-    pr_info("\n");
-
-    // Output buffer formatting
-    pr_info("MPU6050: a_x = %x\n", a_x);
-    pr_info("MPU6050: (a_x >> 8) & 0xFF = %x\n", (a_x >> 8) & 0xFF);
-    pr_info("MPU6050: a_x & 0xFF= %x\n", a_x & 0xFF);
-
-    bufferaux[0] = (a_x >> 8) & 0xFF;
-    bufferaux[1] = a_x & 0xFF;
-    bufferaux[2] = (a_y >> 8) & 0xFF;
-    bufferaux[3] = a_y & 0xFF;
-    bufferaux[4] = (a_z >> 8) & 0xFF;
-    bufferaux[5] = a_z & 0xFF;
-
-    bufferaux[6] = (raw_temp >> 8) & 0xFF;
-    bufferaux[7] = raw_temp & 0xFF;
-
-    bufferaux[8] = (g_x >> 8) & 0xFF;
-    bufferaux[9] = g_x & 0xFF;
-    bufferaux[10] = (g_y >> 8) & 0xFF;
-    bufferaux[11] = g_y & 0xFF;
-    bufferaux[12] = (g_z >> 8) & 0xFF;
-    bufferaux[13] = g_z & 0xFF;
-
-    // Copy to a user level buffer
-    if(copy_to_user(user_buffer, (char*) bufferaux, PACKET_NUMBER) != 0)
+    else if (wait_event_interruptible(ring->wait, READ_ONCE(sensor->gone) ||
+        sample_ring_available(ring, reader->tail) >= min_t(size_t, reader->watermark, wanted)))
     {
-        pr_alert("%s: Error in copy_to_user().", DEVICE_NAME);
-        return -1;
+        return -ERESTARTSYS;
     }
+    if (READ_ONCE(sensor->gone))
+        return -ENODEV;
 
-    msleep(1);
-    return PACKET_NUMBER;
+    // Copy to a user level buffer, RECORD_BATCH records at a time
+    while (done < wanted)
+    {
+        for (batch = 0; batch < RECORD_BATCH && done + batch < wanted; batch++)
+        {
+            if (sample_ring_pop(ring, &reader->tail, &records[batch], &reader->dropped) != 0)
+                break;
+        }
+        if (batch == 0)
+            break;
+
+        if (copy_to_user(user_buffer + done * RECORD_SIZE, records, batch * RECORD_SIZE) != 0)
+        {
+            pr_alert("%s: Error in copy_to_user().", DEVICE_NAME);
+            return -EFAULT;
+        }
+        done += batch;
+    }
+
+    return done * RECORD_SIZE;
 }
 
+/// @brief Reports the device readable once the reader's watermark is available.
+///  In polled mode every read() produces a sample, so it is always readable.
+///  A removed sensor reports a hang up.
+static __poll_t char_device_poll(struct file *file, poll_table *wait)
+{
+    struct char_device_reader *reader = file->private_data;
+    struct acquisition *acq = &reader->sensor->acq;
+    struct sample_ring *ring;
+
+    if (!acquisition_is_streaming(acq))
+        return READ_ONCE(reader->sensor->gone) ? EPOLLHUP : EPOLLIN | EPOLLRDNORM;
+
+    ring = acquisition_get_ring(acq);
+    poll_wait(file, &ring->wait, wait);
+
+    if (READ_ONCE(reader->sensor->gone))
+        return EPOLLHUP;
+    if (sample_ring_available(ring, reader->tail) >= reader->watermark)
+        return EPOLLIN | EPOLLRDNORM;
+    return 0;
+}
+
+/// @brief Maps the sample ring read only, so readers can consume it without
+///  syscalls nor copies. See struct mpu6050_ring_header for the protocol.
+///  There is no ring in polled mode.
+static int char_device_mmap(struct file *file, struct vm_area_struct *vma)
+{
+    struct char_device_reader *reader = file->private_data;
+
+    if (!acquisition_is_streaming(&reader->sensor->acq) || READ_ONCE(reader->sensor->gone))
+        return -ENODEV;
+
+    return sample_ring_mmap(acquisition_get_ring(&reader->sensor->acq), vma);
+}
+
+/// @brief Runs an ioctl, unless the sensor was removed (-ENODEV). The sensor
+///  can't go away halfway through.
 static long int char_device_ioctl(struct file *file, unsigned cmd, unsigned long __user arg)
 {
+    struct char_device_reader *reader = file->private_data;
+    struct mpu6050_sensor *sensor = reader->sensor;
+    long int retval;
+
+    down_read(&sensor->lock);
+    retval = sensor->gone ? -ENODEV : __char_device_ioctl(reader, cmd, arg);
+    up_read(&sensor->lock);
+    return retval;
+}
+
+static long int __char_device_ioctl(struct char_device_reader *reader, unsigned cmd, unsigned long __user arg)
+{
+    MPU6050_t *mpu = &reader->sensor->mpu;
+    u32 watermark;
     int retVal = -1;
     int acc_modifier, gyro_modifier;
     int acc_range, gyro_range;
 
     switch(cmd) {
         case 0:
-            acc_range = MPU6050_getFullScaleAccelRange();
+            acc_range = MPU6050_getFullScaleAccelRange(mpu);
             
             switch (acc_range)
             {
@@ -210,7 +370,7 @@ static long int char_device_ioctl(struct file *file, unsigned cmd, unsigned long
         break;
 
         case 1:
-            gyro_range = MPU6050_getFullScaleGyroRange();
+            gyro_range = MPU6050_getFullScaleGyroRange(mpu);
             switch (gyro_range)
             {
                 case GYRO_RANGE_250DEG:
@@ -238,6 +398,17 @@ static long int char_device_ioctl(struct file *file, unsigned cmd, unsigned long
         break;
 
 
+        case MPU6050_IOC_SET_WATERMARK:
+            if (get_user(watermark, (u32 __user *) arg) != 0)
+                return -EFAULT;
+            if (watermark == 0 || watermark >= SAMPLE_RING_SLOTS)
+                return -EINVAL;
+            reader->watermark = watermark;
+            return 0;
+
+        case MPU6050_IOC_GET_WATERMARK:
+            return put_user(reader->watermark, (u32 __user *) arg);
+
         default:
             pr_info("%s: IOCTL was handled but there's nothing to do here!\n", DEVICE_NAME);
         break;
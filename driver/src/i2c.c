@@ -1,174 +1,1093 @@
 #include "i2c.h"
 
+#define CREATE_TRACE_POINTS
+#include "lliano_trace.h"
+
 /******************************************************************************
- * Static variables
+ * Module parameters
 ******************************************************************************/
 
-// Pointers to memory mapped registers of the CPU
-static void __iomem *i2c_ptr = NULL;
-static void __iomem *clk_ptr = NULL;
-static void __iomem *control_module_ptr = NULL;
-
-// Use to send to sleep processes using the driver.
-DECLARE_WAIT_QUEUE_HEAD(waiting_queue);
+static unsigned int dma_threshold = I2C_DEFAULT_DMA_THRESHOLD;
+module_param(dma_threshold, uint, 0644);
+MODULE_PARM_DESC(dma_threshold, "Transfer phases longer than this (bytes) use EDMA. 0 disables it.");
 
-// Used to enable only one process to read or write to the bus
-DEFINE_MUTEX(lock_bus);
+static unsigned int retries = I2C_DEFAULT_RETRIES;
+module_param(retries, uint, 0644);
+MODULE_PARM_DESC(retries, "Times a request is tried again after a lost arbitration or a NACKed data byte. A NACKed address fails at once.");
 
+static unsigned int deadline_slack_us = I2C_DEFAULT_DEADLINE_SLACK_US;
+module_param(deadline_slack_us, uint, 0644);
+MODULE_PARM_DESC(deadline_slack_us, "Time (us) a transfer gets on top of its bus time before it's aborted.");
 
-// I2C Data structure
-static struct i2c_buffers{
-    u8 * buff_rx;  // Pointer to user data in kernel space
-    u8 pos_rx;     // Data to be received. This will be updated by the ISR.
-    u8 buff_rx_len;
+/******************************************************************************
+ * Static variables
+******************************************************************************/
 
-    u8 * buff_tx;
-    u8 pos_tx;
-    u8 buff_tx_len;
-} data_i2c;
+// Controllers the driver can run, by the base address of their registers
+static const struct {
+    phys_addr_t phys;
+    int id;
+    u32 clkctrl;        // Offset of its clock control in CM_PER
+} i2c_controllers[] = {
+    { I2C1, 1, IDCM_PER_I2C1_CLKCTRL },
+    { I2C2, 2, IDCM_PER_I2C2_CLKCTRL },
+};
 
-int sleeping_condition;  // Condition to handle the state of the processes.
-static int g_irq;       // IRQ number, saved for deinitialization
+// /sys/kernel/debug/<DRIVER_NAME>, with a directory per controller
+static struct dentry *debugfs_root;
 
-/*****buff_tx*************************************************************************
+/******************************************************************************
  * Static functions' prototypes
 ******************************************************************************/
 
+static void __start_next(struct i2c_bus *bus);
+static void __complete_request(struct i2c_request *req, int status);
+static void __finish_request(struct i2c_request *req);
+
 /// @brief Sets the target slave address
-static inline void __set_slave_address(u8 addr)
+static inline void __set_slave_address(struct i2c_bus *bus, u8 addr)
+{
+    iowrite32(addr, bus->regs + I2C_REG_SA);
+}
+
+/// @brief Counts a time in its log2 bucket.
+static inline void __stats_hist_add(u32 *hist, u64 ns)
+{
+    hist[min_t(u32, ns ? ilog2(ns) : 0, I2C_STATS_HIST_BUCKETS - 1)]++;
+}
+
+/// @brief SCL periods a request takes on the bus: the START (or repeated START),
+///  address and data of every message, with their ACKs, and the STOP.
+static inline u32 __transfer_bits(const struct i2c_request *req)
+{
+    u32 bits = 1;
+    u16 i;
+
+    for (i = 0; i < req->num_msgs; i++)
+        bits += 1 + 9 + 9 * req->msgs[i].len;
+    return bits;
+}
+
+/// @brief Wakeup the clock of the controller. The OS might put the I2C clock to
+///  sleep, so re-enable the clock just in case.
+static void __wakeup(struct i2c_bus *bus)
+{
+    u32 aux;
+
+    aux = ioread32(bus->clkctrl);
+    aux |= CM_PER_I2C_CLKCTRL_ENABLE;
+    iowrite32(aux, bus->clkctrl);
+    while(ioread32(bus->clkctrl) != CM_PER_I2C_CLKCTRL_ENABLE);
+}
+
+/******************************************************************************
+ * I2C private operations
+******************************************************************************/
+
+/// @brief FIFO threshold for a phase of 'len' bytes. A phase that fits in the FIFO
+///  is moved with a single interrupt. Longer ones use half of it, so the bus keeps
+///  going while the ISR empties or refills the other half.
+static u32 __fifo_threshold(struct i2c_bus *bus, u16 len)
+{
+    return (len <= bus->fifo_depth) ? len : bus->fifo_depth / 2;
+}
+
+/// @brief Loads up to 'count' bytes of the message on the bus (a write) into the TX FIFO.
+static void __fill_tx_fifo(struct i2c_request *req, u32 count)
+{
+    struct i2c_bus *bus = req->bus;
+    const struct i2c_msg *msg = &req->msgs[req->msg];
+
+    count = min_t(u32, count, msg->len - req->pos);
+    while (count--)
+        iowrite32(msg->buf[req->pos++], bus->regs + I2C_REG_DATA);
+}
+
+/// @brief Moves up to 'count' bytes of the RX FIFO to the message on the bus (a read).
+static void __drain_rx_fifo(struct i2c_request *req, u32 count)
+{
+    struct i2c_bus *bus = req->bus;
+    const struct i2c_msg *msg = &req->msgs[req->msg];
+
+    count = min_t(u32, count, msg->len - req->pos);
+    while (count--)
+        msg->buf[req->pos++] = ioread32(bus->regs + I2C_REG_DATA);
+}
+
+/// @brief Whether a phase of 'len' bytes should go through EDMA.
+static bool __use_dma(struct i2c_bus *bus, u16 len)
+{
+    return bus->dma_buf != NULL && dma_threshold != 0 && len > dma_threshold && len <= I2C_DMA_BUF_LEN;
+}
+
+/// @brief Called by EDMA when the read phase is in the bounce buffer. Only the
+///  last message reads through EDMA, and the STOP was programmed with it, so the
+///  request is done. A late callback of a transfer
+///  that was aborted finds the cookie of the current one still in progress.
+static void i2c_dma_rx_callback(void *param)
+{
+    struct i2c_bus *bus = param;
+    struct i2c_request *req = NULL;
+    struct i2c_msg *msg;
+    unsigned long flags;
+
+    spin_lock_irqsave(&bus->queue_lock, flags);
+    if (bus->dma_running == bus->dma_rx && bus->active != NULL &&
+            dmaengine_tx_status(bus->dma_rx, bus->dma_cookie, NULL) == DMA_COMPLETE) {
+        req = bus->active;
+        msg = &req->msgs[req->msg];
+        memcpy(msg->buf, bus->dma_buf, msg->len);
+        req->pos = msg->len;
+        __complete_request(req, 0);
+    }
+    spin_unlock_irqrestore(&bus->queue_lock, flags);
+
+    if (req != NULL)
+        __finish_request(req);
+}
+
+/// @brief Starts EDMA for the phase of the message on the bus. The FIFO is cleared
+///  and the controller asks for a byte at a time, so there is no tail to take care of.
+/// @return "0" on success, "-ENOMEM" if the descriptor couldn't be prepared.
+static int __start_dma(struct i2c_request *req)
+{
+    struct i2c_bus *bus = req->bus;
+    const struct i2c_msg *msg = &req->msgs[req->msg];
+    struct dma_async_tx_descriptor *desc;
+    bool rx = msg->flags & I2C_M_RD;
+    struct dma_chan *chan = rx ? bus->dma_rx : bus->dma_tx;
+    u16 len = msg->len;
+
+    if (!rx)
+        memcpy(bus->dma_buf, msg->buf, len);
+
+    desc = dmaengine_prep_slave_single(chan, bus->dma_buf_phys, len,
+        rx ? DMA_DEV_TO_MEM : DMA_MEM_TO_DEV, rx ? DMA_PREP_INTERRUPT : 0);
+    if (desc == NULL)
+        return -ENOMEM;
+
+    // The write phase ends on ARDY, as the data has to leave the FIFO first.
+    if (rx) {
+        desc->callback = i2c_dma_rx_callback;
+        desc->callback_param = bus;
+    }
+
+    if (rx) {
+        iowrite32(I2C_BIT_TXFIFO_CLR | I2C_BIT_RXFIFO_CLR | I2C_BUF_RXTRSH(1) | I2C_BIT_RDMA_EN,
+            bus->regs + I2C_REG_BUF);
+        iowrite32(1, bus->regs + I2C_REG_DMARXENABLE_SET);
+    } else {
+        iowrite32(I2C_BIT_TXFIFO_CLR | I2C_BIT_RXFIFO_CLR | I2C_BUF_TXTRSH(1) | I2C_BIT_XDMA_EN,
+            bus->regs + I2C_REG_BUF);
+        iowrite32(1, bus->regs + I2C_REG_DMATXENABLE_SET);
+    }
+
+    bus->dma_cookie = dmaengine_submit(desc);
+    dma_async_issue_pending(chan);
+    bus->dma_running = chan;
+    return 0;
+}
+
+/// @brief Takes the DMA off the controller. 'abort' stops a transfer that didn't finish.
+static void __stop_dma(struct i2c_bus *bus, bool abort)
+{
+    iowrite32(1, bus->regs + I2C_REG_DMARXENABLE_CLR);
+    iowrite32(1, bus->regs + I2C_REG_DMATXENABLE_CLR);
+    iowrite32(0, bus->regs + I2C_REG_BUF);
+    if (abort)
+        dmaengine_terminate_async(bus->dma_running);
+    bus->dma_running = NULL;
+}
+
+/// @brief Loads a write phase through EDMA or the FIFO.
+/// @return Interrupts needed by the phase.
+static u32 __setup_tx_phase(struct i2c_request *req)
+{
+    struct i2c_bus *bus = req->bus;
+    u16 len = req->msgs[req->msg].len;
+
+    if (__use_dma(bus, len) && __start_dma(req) == 0)
+        return I2C_IRQ_ARDY | I2C_IRQ_ERRORS;
+
+    iowrite32(I2C_BIT_TXFIFO_CLR | I2C_BIT_RXFIFO_CLR | I2C_BUF_TXTRSH(__fifo_threshold(bus, len)),
+        bus->regs + I2C_REG_BUF);
+    return I2C_IRQ_XRDY | I2C_IRQ_XDR | I2C_IRQ_ARDY | I2C_IRQ_ERRORS;
+}
+
+/// @brief Prepares a read phase through EDMA or the FIFO.
+/// @return Interrupts needed by the phase.
+static u32 __setup_rx_phase(struct i2c_request *req)
+{
+    struct i2c_bus *bus = req->bus;
+    u16 len = req->msgs[req->msg].len;
+
+    // With DMA the request ends in i2c_dma_rx_callback(): no ARDY needed. So only
+    // the last message may read through EDMA.
+    if (req->msg + 1 == req->num_msgs && __use_dma(bus, len) && __start_dma(req) == 0)
+        return I2C_IRQ_ERRORS;
+
+    iowrite32(I2C_BIT_TXFIFO_CLR | I2C_BIT_RXFIFO_CLR | I2C_BUF_RXTRSH(__fifo_threshold(bus, len)),
+        bus->regs + I2C_REG_BUF);
+    return I2C_IRQ_RRDY | I2C_IRQ_RDR | I2C_IRQ_ARDY | I2C_IRQ_ERRORS;
+}
+
+/// @brief Puts the message 'req->msg' on the bus, after a START or a repeated START.
+///  The STOP is only programmed with the last message, so there is no gap between them.
+static void __start_phase(struct i2c_request *req)
+{
+    struct i2c_bus *bus = req->bus;
+    const struct i2c_msg *msg = &req->msgs[req->msg];
+    u32 con = I2C_BIT_ENABLE | I2C_BIT_MASTER_MODE | I2C_BIT_START;
+    u32 irqs;
+
+    req->pos = 0;
+    if (req->msg == 0 || msg->addr != req->msgs[req->msg - 1].addr)
+        __set_slave_address(bus, msg->addr);
+    if (msg->flags & I2C_M_RD)
+        irqs = __setup_rx_phase(req);
+    else {
+        irqs = __setup_tx_phase(req);
+        con |= I2C_BIT_TX;
+    }
+    if (req->msg + 1 == req->num_msgs)
+        con |= I2C_BIT_STOP;
+    iowrite32(msg->len, bus->regs + I2C_REG_CNT);
+
+    // Sends START (RX is enable with 0 at I2C_BIT_TX). It goes first, as SCL is held
+    // until then after a phase. An event before the interrupts are enabled isn't lost.
+    iowrite32(con, bus->regs + I2C_REG_CON);
+    iowrite32(irqs, bus->regs + I2C_REG_IRQENABLE_SET);
+}
+
+/// @brief Puts a request on the bus. Called with the queue lock held and the bus free.
+static void __start_request(struct i2c_request *req)
+{
+    struct i2c_bus *bus = req->bus;
+
+    trace_lliano_i2c_start(req);
+    req->start_ns = ktime_get_ns();
+    __stats_hist_add(bus->stats.wait_hist, req->start_ns - req->submit_ns);
+
+    // Retries get a deadline of their own
+    req->deadline_ns = req->start_ns + I2C_DEADLINE_FACTOR * div_u64((u64) __transfer_bits(req) * NSEC_PER_SEC,
+        bus->timing.scl_hz) + (u64) READ_ONCE(deadline_slack_us) * NSEC_PER_USEC;
+    hrtimer_start(&bus->watchdog, ns_to_ktime(req->deadline_ns), HRTIMER_MODE_ABS);
+
+    // Makes sure CLK is running
+    __wakeup(bus);
+
+    iowrite32(I2C_IRQSTATUS_CLR_ALL, bus->regs + I2C_REG_IRQSTATUS);
+    req->msg = 0;
+    __start_phase(req);
+}
+
+/// @brief Goes on with the next message of a request, with a repeated start.
+static void __start_next_phase(struct i2c_request *req)
+{
+    struct i2c_bus *bus = req->bus;
+
+    if (bus->dma_running != NULL)
+        __stop_dma(bus, false);
+
+    iowrite32(I2C_IRQENABLE_CLR_MASK, bus->regs + I2C_REG_IRQENABLE_CLR);
+    req->msg++;
+    trace_lliano_i2c_restart(req);
+    __start_phase(req);
+}
+
+/// @brief Adds a request that is off the bus to the statistics.
+static void __stats_add_request(struct i2c_bus *bus, const struct i2c_request *req)
 {
-    iowrite32(addr, i2c_ptr + I2C_REG_SA);
+    bool read = false, written = false;
+    u32 moved;
+    u16 i;
+
+    for (i = 0; i <= req->msg; i++) {
+        moved = (i < req->msg) ? req->msgs[i].len : req->pos;
+        if (req->msgs[i].flags & I2C_M_RD) {
+            bus->stats.bytes_read += moved;
+            read = true;
+        } else {
+            bus->stats.bytes_written += moved;
+            written = true;
+        }
+    }
+    if (!read)
+        bus->stats.transactions_write++;
+    else if (!written)
+        bus->stats.transactions_read++;
+    else
+        bus->stats.transactions_write_read++;
 }
 
-/// @brief Wakeup the I2C2 clock. The OS might put the I2C clock to sleep, so
-///  re-enable the clock just in case.
-static void __wakeup(void)
+/// @brief Takes the active request off the bus and chains the next one. Called
+///  with the queue lock held. Its owner must be told with __finish_request() once
+///  the lock is released.
+static void __complete_request(struct i2c_request *req, int status)
 {
-    int aux;
+    struct i2c_bus *bus = req->bus;
+
+    trace_lliano_i2c_complete(req, status);
+    req->end_ns = ktime_get_ns();
+    __stats_hist_add(bus->stats.duration_hist, req->end_ns - req->start_ns);
+    __stats_add_request(bus, req);
+
+    iowrite32(I2C_IRQENABLE_CLR_MASK, bus->regs + I2C_REG_IRQENABLE_CLR);
+    if (bus->dma_running != NULL)
+        __stop_dma(bus, status != 0);
+    bus->active = NULL;
+    req->status = status;
+    hrtimer_try_to_cancel(&bus->watchdog);
 
-    aux = (unsigned int)clk_ptr + (unsigned int)(IDCM_PER_I2C2_CLKCTRL); 
-    aux = (unsigned int)ioread32((unsigned int *) aux); 
-    aux |= 0x02;
-    iowrite32(aux, clk_ptr + IDCM_PER_I2C2_CLKCTRL);
-    while(ioread32(clk_ptr + IDCM_PER_I2C2_CLKCTRL) != CM_PER_I2C2_CLKCTRL_ENABLE);
+    __start_next(bus);
 }
 
-/// @brief Wait until the bus is freed.
-/// @return "0" if the bus is free. "-1" on timeout.
-static int __wait_for_bus_busy(void) 
+/// @brief Hands a completed request back to its owner: runs its callback, or wakes
+///  up the i2c_execute() sleeping on it. The request can't be touched afterwards.
+static void __finish_request(struct i2c_request *req)
 {
-    u8 i = 0;
+    if (req->complete != NULL)
+        req->complete(req);
+    else
+        complete(&req->done);
+}
 
-    while(mutex_is_locked(&lock_bus)) {
-        msleep(1);
-        if (i++ == 100) {
-            pr_warn("%s: TIMEOUT ERROR: I2C bus is locked.\n", DRIVER_NAME);
-            return -1;
+/// @brief Adds a request to the queue. Urgent requests go after the other urgent
+///  ones but ahead of the regular ones. Called with the queue lock held.
+static void __enqueue_request(struct i2c_request *req)
+{
+    struct i2c_bus *bus = req->bus;
+    struct i2c_request *pos;
+
+    if (req->flags & I2C_REQ_F_URGENT) {
+        list_for_each_entry(pos, &bus->queue, node) {
+            if (!(pos->flags & I2C_REQ_F_URGENT)) {
+                list_add_tail(&req->node, &pos->node);
+                return;
+            }
         }
     }
+    list_add_tail(&req->node, &bus->queue);
+}
+
+/// @brief Starts the first queued request, unless the bus is in use. If a STOP
+///  is still on the wire, the bus free interrupt will try again. Called with
+///  the queue lock held.
+static void __start_next(struct i2c_bus *bus)
+{
+    if (bus->active != NULL || bus->recovering || list_empty(&bus->queue))
+        return;
+
+    // Arm BF before checking BB, so the bus can't become free unnoticed
+    iowrite32(I2C_IRQ_BF, bus->regs + I2C_REG_IRQSTATUS);
+    iowrite32(I2C_IRQ_BF, bus->regs + I2C_REG_IRQENABLE_SET);
+    if (ioread32(bus->regs + I2C_REG_IRQSTATUS_RAW) & I2C_IRQ_BB) {
+        bus->stats.bus_busy_waits++;
+        hrtimer_start(&bus->watchdog,
+            ns_to_ktime(ktime_get_ns() + (u64) READ_ONCE(deadline_slack_us) * NSEC_PER_USEC), HRTIMER_MODE_ABS);
+        return;
+    }
+    iowrite32(I2C_IRQ_BF, bus->regs + I2C_REG_IRQENABLE_CLR);
+
+    bus->active = list_first_entry(&bus->queue, struct i2c_request, node);
+    list_del_init(&bus->active->node);
+    __start_request(bus->active);
+}
+
+/// @brief Cycles of the internal clock that last at least 'ns'.
+static u32 __ns_to_cycles(u32 ns, u32 clk_hz)
+{
+    return div_u64((u64) ns * clk_hz + NSEC_PER_SEC - 1, NSEC_PER_SEC);
+}
+
+/// @brief Works out PSC, SCLL and SCLH from "clock-frequency", "int-clock-frequency"
+///  and "i2c-scl-rising-time-ns" (see I2C_FCLK_HZ). The SCL period is never shorter
+///  than asked for, and the low and high times never shorter than the I2C spec.
+/// @return "0" on success, "-EINVAL" if the bus can't run at that frequency.
+static int __timing_init(struct i2c_bus *bus, struct device *dev)
+{
+    struct i2c_timing *t = &bus->timing;
+    u32 period_ns, cycles, low, high;
+    bool fast;
+
+    if (device_property_read_u32(dev, DT_PROPERTY_CLK_FREQ, &t->bus_freq_hz) != 0)
+        t->bus_freq_hz = I2C_DEFAULT_BUS_FREQ_HZ;
+    if (device_property_read_u32(dev, DT_PROPERTY_INT_CLK_FREQ, &t->int_clk_hz) != 0)
+        t->int_clk_hz = I2C_DEFAULT_INT_CLK_HZ;
+    if (t->bus_freq_hz == 0 || t->bus_freq_hz > I2C_FAST_MAX_HZ
+            || t->int_clk_hz == 0 || t->int_clk_hz > I2C_FCLK_HZ) {
+        pr_err("%s: %s: Unsupported %s = %u or %s = %u.\n", DRIVER_NAME, bus->name,
+            DT_PROPERTY_CLK_FREQ, t->bus_freq_hz, DT_PROPERTY_INT_CLK_FREQ, t->int_clk_hz);
+        return -EINVAL;
+    }
+    fast = t->bus_freq_hz > I2C_STANDARD_MAX_HZ;
+    if (device_property_read_u32(dev, DT_PROPERTY_SCL_RISE_NS, &t->scl_rise_ns) != 0)
+        t->scl_rise_ns = fast ? I2C_FAST_RISE_NS : I2C_STANDARD_RISE_NS;
+
+    // The internal clock can't go over "int-clock-frequency"
+    t->psc = min_t(u32, DIV_ROUND_UP(I2C_FCLK_HZ, t->int_clk_hz) - 1, I2C_PSC_MASK);
+    t->int_clk_hz = I2C_FCLK_HZ / (t->psc + 1);
+
+    // The controller doesn't count while SCL rises, so that time is left out
+    period_ns = DIV_ROUND_UP(NSEC_PER_SEC, t->bus_freq_hz);
+    if (period_ns <= t->scl_rise_ns) {
+        pr_err("%s: %s: %s = %u doesn't fit in a SCL period.\n", DRIVER_NAME, bus->name,
+            DT_PROPERTY_SCL_RISE_NS, t->scl_rise_ns);
+        return -EINVAL;
+    }
+    cycles = __ns_to_cycles(period_ns - t->scl_rise_ns, t->int_clk_hz);
+
+    // Half and half in standard mode. The fast mode needs a longer low time.
+    low = fast ? cycles * 2 / 3 : cycles / 2;
+    low = max(low, __ns_to_cycles(fast ? I2C_FAST_LOW_MIN_NS : I2C_STANDARD_LOW_MIN_NS, t->int_clk_hz));
+    high = max(cycles - min(low, cycles),
+        __ns_to_cycles(fast ? I2C_FAST_HIGH_MIN_NS : I2C_STANDARD_HIGH_MIN_NS, t->int_clk_hz));
+    if (low < I2C_SCLL_OFFSET || low - I2C_SCLL_OFFSET > I2C_SCLL_MASK
+            || high < I2C_SCLH_OFFSET || high - I2C_SCLH_OFFSET > I2C_SCLH_MASK) {
+        pr_err("%s: %s: %u Hz can't be done with a %u Hz internal clock, check %s.\n",
+            DRIVER_NAME, bus->name, t->bus_freq_hz, t->int_clk_hz, DT_PROPERTY_INT_CLK_FREQ);
+        return -EINVAL;
+    }
+    t->scll = low - I2C_SCLL_OFFSET;
+    t->sclh = high - I2C_SCLH_OFFSET;
+    t->scl_hz = NSEC_PER_SEC / (u32) (div_u64((u64) (low + high) * NSEC_PER_SEC, t->int_clk_hz) + t->scl_rise_ns);
+
+    pr_info("%s: %s: SCL %u Hz (%u Hz asked, rise %u ns): PSC %u, SCLL %u, SCLH %u\n", DRIVER_NAME,
+        bus->name, t->scl_hz, t->bus_freq_hz, t->scl_rise_ns, t->psc, t->scll, t->sclh);
     return 0;
 }
 
-/// @brief Clears the i2c_buffers global structure.
-/// @return None.
-static void __clean_data_i2c(void)
+/// @brief Gets the EDMA channels of the device tree ("tx" and "rx") and the bounce
+///  buffer. They are optional.
+/// @return "0" with or without DMA, "-EPROBE_DEFER" if EDMA isn't there yet.
+static int __dma_init(struct i2c_bus *bus, struct device *dev)
 {
-    memset(data_i2c.buff_rx, 0, 4096);
-    data_i2c.pos_rx = 0;
-    data_i2c.buff_rx_len = 0;
+    struct dma_slave_config config = {
+        .src_addr = bus->phys + I2C_REG_DATA,
+        .dst_addr = bus->phys + I2C_REG_DATA,
+        .src_addr_width = DMA_SLAVE_BUSWIDTH_1_BYTE,
+        .dst_addr_width = DMA_SLAVE_BUSWIDTH_1_BYTE,
+        .src_maxburst = 1,
+        .dst_maxburst = 1,
+    };
+    int retval;
+
+    bus->dma_tx = dma_request_chan(dev, "tx");
+    if (IS_ERR(bus->dma_tx)) {
+        retval = PTR_ERR(bus->dma_tx);
+        goto tx_error;
+    }
+    bus->dma_rx = dma_request_chan(dev, "rx");
+    if (IS_ERR(bus->dma_rx)) {
+        retval = PTR_ERR(bus->dma_rx);
+        goto rx_error;
+    }
+    if ((retval = dmaengine_slave_config(bus->dma_tx, &config)) != 0 ||
+        (retval = dmaengine_slave_config(bus->dma_rx, &config)) != 0)
+        goto config_error;
+
+    bus->dma_buf = dma_alloc_coherent(bus->dma_tx->device->dev, I2C_DMA_BUF_LEN, &bus->dma_buf_phys, GFP_KERNEL);
+    if (bus->dma_buf == NULL) {
+        retval = -ENOMEM;
+        goto config_error;
+    }
 
-    memset(data_i2c.buff_tx, 0, 4096);
-    data_i2c.pos_tx = 0;
-    data_i2c.buff_tx_len = 0;
+    pr_info("%s: %s: Using EDMA for transfers longer than %u bytes.\n", DRIVER_NAME, bus->name, dma_threshold);
+    return 0;
+
+    config_error: dma_release_channel(bus->dma_rx);
+    rx_error: dma_release_channel(bus->dma_tx);
+    tx_error: bus->dma_tx = NULL; bus->dma_rx = NULL;
+    if (retval == -EPROBE_DEFER)
+        return retval;
+    pr_info("%s: %s: No EDMA channels (%d), using the FIFO only.\n", DRIVER_NAME, bus->name, retval);
+    return 0;
 }
 
-/******************************************************************************
- * I2C private operations
-******************************************************************************/
+/// @brief Releases what __dma_init() got.
+static void __dma_deinit(struct i2c_bus *bus)
+{
+    if (bus->dma_buf == NULL)
+        return;
+
+    dmaengine_terminate_sync(bus->dma_tx);
+    dmaengine_terminate_sync(bus->dma_rx);
+    dma_free_coherent(bus->dma_tx->device->dev, I2C_DMA_BUF_LEN, bus->dma_buf, bus->dma_buf_phys);
+    dma_release_channel(bus->dma_rx);
+    dma_release_channel(bus->dma_tx);
+    bus->dma_buf = NULL;
+}
+
+/// @brief Programs the SCL timing and enables the controller, as master. After
+///  probing and after every soft reset.
+static void __hw_setup(struct i2c_bus *bus)
+{
+    // Disable I2C while configuring..
+    iowrite32(0x0, bus->regs + I2C_REG_CON);
 
+    // Clock Configuration
+    iowrite32(bus->timing.psc, bus->regs + I2C_REG_PSC);
+    iowrite32(bus->timing.scll, bus->regs + I2C_REG_SCLL);
+    iowrite32(bus->timing.sclh, bus->regs + I2C_REG_SCLH);
 
-/// @brief Handler for the I2C IRQ.
-static irqreturn_t i2c_isr(int irq_number, void *dev_id)
+    // Force Idle
+    iowrite32(0x00, bus->regs + I2C_REG_SYSC);
+
+    // Enable I2C device
+    iowrite32(I2C_BIT_ENABLE | I2C_BIT_MASTER_MODE | I2C_BIT_TX, // 0x8600
+        bus->regs + I2C_REG_CON);
+}
+
+/// @brief Hands a stuck bus (a lost arbitration, a missed deadline, BB that
+///  never clears) to the recovery work. The controller is masked and the queue
+///  stops until the work is done. Called with the queue lock held, from the ISR
+///  or the watchdog, where the recovery itself would busy wait far too long.
+static void __bus_recover(struct i2c_bus *bus)
 {
-    int irq = ioread32(i2c_ptr + I2C_REG_IRQSTATUS);
+    bus->stats.recoveries++;
+    bus->recovering = true;
+    if (bus->dma_running != NULL)
+        __stop_dma(bus, true);
+    iowrite32(I2C_IRQENABLE_CLR_MASK, bus->regs + I2C_REG_IRQENABLE_CLR);
+    schedule_work(&bus->recovery);
+}
 
-    if (irq & I2C_IRQ_XRDY) // TX
-    { 
-        // Loads data register
-        iowrite32(data_i2c.buff_tx[data_i2c.pos_tx++], i2c_ptr + I2C_REG_DATA);
-    
-        if(data_i2c.buff_tx_len == data_i2c.pos_tx)
-        { 
-            iowrite32(I2C_IRQENABLE_CLR_TX, i2c_ptr + I2C_REG_IRQENABLE_CLR);
-            sleeping_condition = 1;
-            wake_up_interruptible(&waiting_queue);
+/// @brief Work of __bus_recover(). A slave that lost track of the clock may be
+///  holding SDA low in the middle of a byte, so SCL is pulsed by hand (SYSTEST)
+///  until it lets go, and a STOP puts every slave back to idle. Then the
+///  controller is soft reset and set up again, and the queue goes on. Nothing
+///  else touches the controller meanwhile.
+static void i2c_recovery_work(struct work_struct *work)
+{
+    struct i2c_bus *bus = container_of(work, struct i2c_bus, recovery);
+    u32 half_ns = NSEC_PER_SEC / (2 * bus->timing.scl_hz);
+    u32 io = I2C_BIT_ST_EN | I2C_SYSTEST_TMODE_IO;
+    unsigned long flags;
+    int i;
+
+    // Both lines released, then SCL pulses while SDA is held low
+    iowrite32(io | I2C_BIT_SCL_O | I2C_BIT_SDA_O, bus->regs + I2C_REG_SYSTEST);
+    ndelay(half_ns);
+    for (i = 0; i < I2C_RECOVERY_PULSES && !(ioread32(bus->regs + I2C_REG_SYSTEST) & I2C_BIT_SDA_I); i++) {
+        iowrite32(io | I2C_BIT_SDA_O, bus->regs + I2C_REG_SYSTEST);
+        ndelay(half_ns);
+        iowrite32(io | I2C_BIT_SCL_O | I2C_BIT_SDA_O, bus->regs + I2C_REG_SYSTEST);
+        ndelay(half_ns);
+    }
+
+    // STOP: SDA goes up while SCL is high
+    iowrite32(io, bus->regs + I2C_REG_SYSTEST);
+    ndelay(half_ns);
+    iowrite32(io | I2C_BIT_SCL_O, bus->regs + I2C_REG_SYSTEST);
+    ndelay(half_ns);
+    iowrite32(io | I2C_BIT_SCL_O | I2C_BIT_SDA_O, bus->regs + I2C_REG_SYSTEST);
+    ndelay(half_ns);
+    iowrite32(0, bus->regs + I2C_REG_SYSTEST);
+    if (i == I2C_RECOVERY_PULSES)
+        pr_warn_ratelimited("%s: %s: SDA still low after %d SCL pulses.\n", DRIVER_NAME, bus->name, i);
+
+    // Soft reset. It's only done with the controller enabled.
+    iowrite32(I2C_BIT_RESET, bus->regs + I2C_REG_SYSC);
+    iowrite32(I2C_BIT_ENABLE, bus->regs + I2C_REG_CON);
+    for (i = 0; i < I2C_RESET_TIMEOUT_US && !(ioread32(bus->regs + I2C_REG_SYSS) & I2C_BIT_RDONE); i += 10)
+        usleep_range(10, 20);
+    if (i >= I2C_RESET_TIMEOUT_US)
+        pr_err_ratelimited("%s: %s: Soft reset didn't finish.\n", DRIVER_NAME, bus->name);
+    __hw_setup(bus);
+
+    spin_lock_irqsave(&bus->queue_lock, flags);
+    bus->recovering = false;
+    __start_next(bus);
+    spin_unlock_irqrestore(&bus->queue_lock, flags);
+}
+
+/// @brief Puts the active request back at the head of the queue, to be done from
+///  the start once the bus was recovered. Called with the queue lock held.
+static void __retry_request(struct i2c_request *req)
+{
+    struct i2c_bus *bus = req->bus;
+
+    trace_lliano_i2c_retry(req);
+    bus->stats.retries++;
+    bus->active = NULL;
+    req->msg = 0;
+    req->pos = 0;
+    list_add(&req->node, &bus->queue);
+    __start_next(bus);
+}
+
+/// @brief Timer of the deadlines (see I2C_DEADLINE_FACTOR). The active request
+///  missed its own: it's aborted and the controller reset. Or the queue has waited
+///  too long for the bus to be free: the bus is recovered. Either way the queue
+///  goes on, so every request, sync or async, ends in a bounded time.
+static enum hrtimer_restart i2c_watchdog(struct hrtimer *timer)
+{
+    struct i2c_bus *bus = container_of(timer, struct i2c_bus, watchdog);
+    struct i2c_request *req;
+    struct i2c_request *done = NULL;
+    unsigned long flags;
+
+    spin_lock_irqsave(&bus->queue_lock, flags);
+    if ((req = bus->active) != NULL) {
+        // Unless another request got the bus while this fired
+        if (ktime_get_ns() >= req->deadline_ns) {
+            pr_warn_ratelimited("%s: %s: TIMEOUT ERROR: Transfer to 0x%02X didn't finish in %llu us.\n",
+                DRIVER_NAME, bus->name, i2c_request_addr(req), div_u64(req->deadline_ns - req->start_ns, NSEC_PER_USEC));
+            bus->stats.timeouts++;
+            __bus_recover(bus);
+            __complete_request(req, -ETIMEDOUT);
+            done = req;
+        }
+    } else if (!list_empty(&bus->queue) && !bus->recovering) {
+        if (ioread32(bus->regs + I2C_REG_IRQSTATUS_RAW) & I2C_IRQ_BB) {
+            pr_warn_ratelimited("%s: %s: TIMEOUT ERROR: I2C bus is busy.\n", DRIVER_NAME, bus->name);
+            bus->stats.bus_busy_timeouts++;
+            __bus_recover(bus);
         }
-        iowrite32(I2C_IRQSTATUS_CLR_ALL, i2c_ptr + I2C_REG_IRQSTATUS);
+        __start_next(bus);
+    }
+    spin_unlock_irqrestore(&bus->queue_lock, flags);
+
+    if (done != NULL)
+        __finish_request(done);
+    return HRTIMER_NORESTART;
+}
+
+/// @brief Handler for the IRQ of a controller ('dev_id'). Moves the data of the active
+///  request and, when it's done, starts the next queued one right away and then hands
+///  it back.
+static irqreturn_t i2c_isr(int irq_number, void *dev_id)
+{
+    struct i2c_bus *bus = dev_id;
+    struct i2c_request *req;
+    struct i2c_request *done = NULL;
+    const struct i2c_msg *msg;
+    u32 status, enabled, irq;
+    int nack_status;
+
+    spin_lock(&bus->queue_lock);
+
+    status = ioread32(bus->regs + I2C_REG_IRQSTATUS);
+    enabled = ioread32(bus->regs + I2C_REG_IRQENABLE_SET);
+    trace_lliano_i2c_isr(bus, status, enabled);
+    bus->stats.irqs++;
+
+    irq = status & enabled;
+    if (irq == 0) {
+        bus->stats.irqs_none++;
+        spin_unlock(&bus->queue_lock);
+        return IRQ_NONE;
     }
 
-    if (irq & I2C_IRQ_RRDY)  // RX
+    if ((req = bus->active) == NULL)
+    {
+        iowrite32(irq & ~I2C_IRQ_BF, bus->regs + I2C_REG_IRQSTATUS);
+    }
+    else if (irq & I2C_IRQ_NACK)
+    {
+        // The slave answered, the bus is fine: a STOP ends the transaction, with
+        // no recovery. CNT counts down the bytes left, so the whole message still
+        // there means the address wasn't acknowledged: nobody is there, and the
+        // request fails right away. A NACKed data byte may be noise on the line,
+        // so it's tried again. A STOP that can't get through leaves BB set, and
+        // the watchdog recovers the bus.
+        bus->stats.nacks++;
+        msg = &req->msgs[req->msg];
+        nack_status = (ioread32(bus->regs + I2C_REG_CNT) == msg->len) ? -ENXIO : -EREMOTEIO;
+        pr_debug("%s: %s: IRQ I2C NACK from 0x%02X (%s).\n", DRIVER_NAME, bus->name,
+            msg->addr, nack_status == -ENXIO ? "address" : "data");
+        iowrite32(I2C_BIT_ENABLE | I2C_BIT_MASTER_MODE | I2C_BIT_STOP, bus->regs + I2C_REG_CON);
+        iowrite32(irq & ~I2C_IRQ_BF, bus->regs + I2C_REG_IRQSTATUS);
+        irq &= ~I2C_IRQ_BF;     // Not yet, the STOP is still to go out
+
+        if (nack_status == -EREMOTEIO && req->attempts++ < READ_ONCE(retries))
+            __retry_request(req);
+        else {
+            __complete_request(req, nack_status);
+            done = req;
+        }
+    }
+    else if (irq & I2C_IRQ_AL)
+    {
+        bus->stats.arbitration_lost++;
+        __bus_recover(bus);
+        irq &= ~I2C_IRQ_BF;     // Left to the soft reset
+
+        if (req->attempts++ < READ_ONCE(retries))
+            __retry_request(req);
+        else {
+            pr_warn_ratelimited("%s: %s: IRQ I2C arbitration lost at 0x%02X, after %u tries.\n", DRIVER_NAME,
+                bus->name, i2c_request_addr(req), req->attempts);
+            __complete_request(req, -EAGAIN);
+            done = req;
+        }
+    }
+    else
     {
-        // Saves received data in buffer
-        data_i2c.buff_rx[data_i2c.pos_rx++] = ioread32(i2c_ptr + I2C_REG_DATA);
-
-        if(data_i2c.buff_rx_len == data_i2c.pos_rx)
-        { 
-            iowrite32(I2C_IRQENABLE_CLR_RX, i2c_ptr + I2C_REG_IRQENABLE_CLR);
-            sleeping_condition = 1;
-            wake_up_interruptible(&waiting_queue);
+        // TX: a threshold worth of free space, or the tail of the phase (XDR)
+        if (irq & I2C_IRQ_XDR)
+        {
+            __fill_tx_fifo(req, I2C_BUFSTAT_TXSTAT(ioread32(bus->regs + I2C_REG_BUFSTAT)));
+            iowrite32(I2C_IRQ_XDR, bus->regs + I2C_REG_IRQSTATUS);
+        }
+        else if (irq & I2C_IRQ_XRDY)
+        {
+            __fill_tx_fifo(req, __fifo_threshold(bus, req->msgs[req->msg].len));
+            iowrite32(I2C_IRQ_XRDY, bus->regs + I2C_REG_IRQSTATUS);
+        }
+
+        // RX: a threshold worth of data, or the tail of the phase (RDR)
+        if (irq & I2C_IRQ_RDR)
+        {
+            __drain_rx_fifo(req, I2C_BUFSTAT_RXSTAT(ioread32(bus->regs + I2C_REG_BUFSTAT)));
+            iowrite32(I2C_IRQ_RDR, bus->regs + I2C_REG_IRQSTATUS);
+        }
+        else if (irq & I2C_IRQ_RRDY)
+        {
+            __drain_rx_fifo(req, __fifo_threshold(bus, req->msgs[req->msg].len));
+            iowrite32(I2C_IRQ_RRDY, bus->regs + I2C_REG_IRQSTATUS);
         }
-        iowrite32(I2C_IRQSTATUS_CLR_ALL, i2c_ptr + I2C_REG_IRQSTATUS);
 
-    }  
+        if (irq & I2C_IRQ_ARDY) // ACCESS READY: the programmed phase is over
+        {
+            iowrite32(I2C_IRQ_ARDY, bus->regs + I2C_REG_IRQSTATUS);
+            msg = &req->msgs[req->msg];
+            if ((msg->flags & I2C_M_RD) && req->pos < msg->len)
+                __drain_rx_fifo(req, I2C_BUFSTAT_RXSTAT(ioread32(bus->regs + I2C_REG_BUFSTAT)));
+
+            if (req->msg + 1 < req->num_msgs)
+                __start_next_phase(req);
+            else {
+                __complete_request(req, 0);
+                done = req;
+            }
+        }
+    }
 
-    if (irq & I2C_IRQ_ARDY) // ACCESS READY
+    if (irq & I2C_IRQ_BF) // The bus is free again
     {
-        // Clears ACK irq enable
-        iowrite32(I2C_IRQENABLE_CLR_ACK, i2c_ptr + I2C_REG_IRQENABLE_CLR);
-        
-        // We switch to rx mode
-        iowrite32(data_i2c.buff_rx_len, i2c_ptr + I2C_REG_CNT);
-        iowrite32(I2C_BIT_ENABLE | I2C_BIT_MASTER_MODE | I2C_BIT_STOP | I2C_BIT_START, 
-            i2c_ptr + I2C_REG_CON); // (RX is enable with 0 at I2C_BIT_TX)
-            
-
-        // enables RX irq
-        iowrite32(I2C_IRQ_RRDY, i2c_ptr + I2C_REG_IRQENABLE_SET);
-
-        iowrite32(I2C_IRQSTATUS_CLR_ALL, i2c_ptr + I2C_REG_IRQSTATUS);
-    } 
-    
-    if (irq & I2C_IRQ_NACK) { // NACK NOTE: Not implemented!
-        pr_warn("IRQ I2C NACK: Not acknowledge was received.\n");
+        iowrite32(I2C_IRQ_BF, bus->regs + I2C_REG_IRQENABLE_CLR);
+        iowrite32(I2C_IRQ_BF, bus->regs + I2C_REG_IRQSTATUS);
+        __start_next(bus);
     }
 
+    spin_unlock(&bus->queue_lock);
+
+    // Outside the lock, so the callback can submit the next request.
+    if (done != NULL)
+        __finish_request(done);
     return IRQ_HANDLED;
 }
 
+/******************************************************************************
+ * Linux I2C adapter
+******************************************************************************/
+
+/// @brief master_xfer() of the adapter: the messages go through the queue of the
+///  bus like any other request.
+/// @return Number of messages done, negative error code on error.
+static int i2c_lliano_xfer(struct i2c_adapter *adap, struct i2c_msg *msgs, int num)
+{
+    struct i2c_bus *bus = i2c_get_adapdata(adap);
+    int status;
+
+    if (num > U16_MAX)
+        return -EINVAL;
+    if ((status = i2c_xfer(bus, msgs, num)) != 0)
+        return status;
+    return num;
+}
+
+/// @brief Plain I2C and the SMBus transfers the core emulates with it, except
+///  the quick command: the controller can't do zero length messages.
+static u32 i2c_lliano_functionality(struct i2c_adapter *adap)
+{
+    return I2C_FUNC_I2C | (I2C_FUNC_SMBUS_EMUL & ~I2C_FUNC_SMBUS_QUICK);
+}
+
+static const struct i2c_algorithm i2c_lliano_algorithm = {
+    .master_xfer = i2c_lliano_xfer,
+    .functionality = i2c_lliano_functionality,
+};
+
+static const struct i2c_adapter_quirks i2c_lliano_quirks = {
+    .flags = I2C_AQ_NO_ZERO_LEN,
+};
+
+/// @brief Registers the bus as a standard I2C adapter (/dev/i2c-<n> with i2c-dev),
+///  for i2c-tools and for other client drivers. It has no device tree node: the
+///  MPU6050 children belong to this driver, and the core would otherwise make them
+///  clients, taking their addresses. Clients are added through 'new_device' in sysfs.
+/// @return "0" on success, negative error code on error.
+static int __adapter_init(struct i2c_bus *bus, struct device *dev)
+{
+    struct i2c_adapter *adap = &bus->adapter;
+    int retval;
+
+    adap->owner = THIS_MODULE;
+    adap->algo = &i2c_lliano_algorithm;
+    adap->quirks = &i2c_lliano_quirks;
+    adap->dev.parent = dev;
+    snprintf(adap->name, sizeof(adap->name), "%s %s", DRIVER_NAME, bus->name);
+    i2c_set_adapdata(adap, bus);
+
+    if ((retval = i2c_add_adapter(adap)) != 0) {
+        pr_err("%s: %s: Couldn't register the I2C adapter.\n", DRIVER_NAME, bus->name);
+        return retval;
+    }
+    pr_info("%s: %s: I2C adapter %d.\n", DRIVER_NAME, bus->name, adap->nr);
+    return 0;
+}
+
+/******************************************************************************
+ * Statistics and self-test (debugfs)
+******************************************************************************/
+
+static void __stats_show_hist(struct seq_file *m, const char *name, const u32 *hist)
+{
+    int i;
+
+    seq_printf(m, "\n%s:\n", name);
+    for (i = 0; i < I2C_STATS_HIST_BUCKETS; i++) {
+        if (hist[i] != 0)
+            seq_printf(m, "  %10llu - %10llu ns  %u\n", 1ULL << i, (2ULL << i) - 1, hist[i]);
+    }
+}
+
+/// @brief Prints the statistics, as they were at a single point in time.
+static int __stats_show(struct seq_file *m, void *unused)
+{
+    struct i2c_bus *bus = m->private;
+    struct i2c_stats snapshot;
+    unsigned long flags;
+
+    spin_lock_irqsave(&bus->queue_lock, flags);
+    snapshot = bus->stats;
+    spin_unlock_irqrestore(&bus->queue_lock, flags);
+
+    seq_printf(m, "transactions_write      %llu\n", snapshot.transactions_write);
+    seq_printf(m, "transactions_read       %llu\n", snapshot.transactions_read);
+    seq_printf(m, "transactions_write_read %llu\n", snapshot.transactions_write_read);
+    seq_printf(m, "bytes_written           %llu\n", snapshot.bytes_written);
+    seq_printf(m, "bytes_read              %llu\n", snapshot.bytes_read);
+    seq_printf(m, "irqs                    %llu\n", snapshot.irqs);
+    seq_printf(m, "irqs_none               %llu\n", snapshot.irqs_none);
+    seq_printf(m, "nacks                   %llu\n", snapshot.nacks);
+    seq_printf(m, "arbitration_lost        %llu\n", snapshot.arbitration_lost);
+    seq_printf(m, "retries                 %llu\n", snapshot.retries);
+    seq_printf(m, "recoveries              %llu\n", snapshot.recoveries);
+    seq_printf(m, "timeouts                %llu\n", snapshot.timeouts);
+    seq_printf(m, "bus_busy_waits          %llu\n", snapshot.bus_busy_waits);
+    seq_printf(m, "bus_busy_timeouts       %llu\n", snapshot.bus_busy_timeouts);
+    __stats_show_hist(m, "duration", snapshot.duration_hist);
+    __stats_show_hist(m, "wait", snapshot.wait_hist);
+    return 0;
+}
+
+static int __stats_open(struct inode *inode, struct file *file)
+{
+    return single_open(file, __stats_show, inode->i_private);
+}
+
+/// @brief Any write clears the statistics.
+static ssize_t __stats_reset(struct file *file, const char __user *user_buffer, size_t count, loff_t *offs)
+{
+    struct i2c_bus *bus = file->private_data;
+    unsigned long flags;
+
+    spin_lock_irqsave(&bus->queue_lock, flags);
+    memset(&bus->stats, 0, sizeof(bus->stats));
+    spin_unlock_irqrestore(&bus->queue_lock, flags);
+    return count;
+}
+
+static const struct file_operations stats_fops = {
+    .owner = THIS_MODULE,
+    .open = __stats_open,
+    .read = seq_read,
+    .llseek = seq_lseek,
+    .release = single_release,
+};
+
+static const struct file_operations stats_reset_fops = {
+    .owner = THIS_MODULE,
+    .open = simple_open,
+    .write = __stats_reset,
+};
+
+/// @brief Prints the SCL timing and the result of the last self-test.
+static int __selftest_show(struct seq_file *m, void *unused)
+{
+    struct i2c_bus *bus = m->private;
+    struct i2c_selftest result;
+    unsigned long flags;
+
+    spin_lock_irqsave(&bus->queue_lock, flags);
+    result = bus->selftest;
+    spin_unlock_irqrestore(&bus->queue_lock, flags);
+
+    seq_printf(m, "scl_hz_asked    %u\n", bus->timing.bus_freq_hz);
+    seq_printf(m, "scl_hz          %u\n", bus->timing.scl_hz);
+    seq_printf(m, "scl_rise_ns     %u\n", bus->timing.scl_rise_ns);
+    seq_printf(m, "int_clk_hz      %u\n", bus->timing.int_clk_hz);
+    seq_printf(m, "psc             %u\n", bus->timing.psc);
+    seq_printf(m, "scll            %u\n", bus->timing.scll);
+    seq_printf(m, "sclh            %u\n", bus->timing.sclh);
+    if (result.transfers == 0)
+        return 0;
+
+    seq_printf(m, "\nselftest        0x%02x reg 0x%02x, %u x %u bytes\n", result.addr, result.reg,
+        result.transfers, result.len);
+    seq_printf(m, "errors          %u\n", result.errors);
+    seq_printf(m, "elapsed_ns      %llu\n", result.elapsed_ns);
+    if (result.elapsed_ns == 0 || result.bus_ns == 0)
+        return 0;
+    seq_printf(m, "bytes_per_s     %llu\n",
+        div64_u64((u64) (result.transfers - result.errors) * result.len * NSEC_PER_SEC, result.elapsed_ns));
+    seq_printf(m, "bus_bytes_per_s %llu\n",
+        div64_u64((u64) (result.transfers - result.errors) * result.len * NSEC_PER_SEC, result.bus_ns));
+    seq_printf(m, "scl_hz_measured %llu\n", div64_u64(result.scl_cycles * NSEC_PER_SEC, result.bus_ns));
+    return 0;
+}
+
+static int __selftest_open(struct inode *inode, struct file *file)
+{
+    return single_open(file, __selftest_show, inode->i_private);
+}
+
+/// @brief Writing "<addr> [<reg> [<len> [<transfers>]]]" reads 'len' registers from
+///  'reg' of the slave at 'addr', 'transfers' times in a row (up to
+///  I2C_SELFTEST_MAX_TRANSFERS), and keeps how long it took. Sleeps until it's
+///  done, or the writer is killed.
+static ssize_t __selftest_write(struct file *file, const char __user *user_buffer, size_t count, loff_t *offs)
+{
+    struct seq_file *m = file->private_data;
+    struct i2c_bus *bus = m->private;
+    struct i2c_selftest result = { 0 };
+    struct i2c_request req;
+    unsigned int addr, reg = I2C_SELFTEST_REG, len = I2C_SELFTEST_LEN, transfers = I2C_SELFTEST_TRANSFERS;
+    unsigned long flags;
+    char cmd[32];
+    u8 *buf;
+    u8 tx;
+    u64 start;
+    unsigned int i;
+
+    if (count >= sizeof(cmd))
+        return -EINVAL;
+    if (copy_from_user(cmd, user_buffer, count) != 0)
+        return -EFAULT;
+    cmd[count] = '\0';
+    if (sscanf(cmd, "%i %i %u %u", &addr, &reg, &len, &transfers) < 1
+            || addr > 0x7F || reg > 0xFF || len == 0 || len > I2C_SELFTEST_MAX_LEN
+            || transfers == 0 || transfers > I2C_SELFTEST_MAX_TRANSFERS)
+        return -EINVAL;
+    if ((buf = kmalloc(len, GFP_KERNEL)) == NULL)
+        return -ENOMEM;
+
+    result.addr = addr;
+    result.reg = tx = reg;
+    result.len = len;
+    start = ktime_get_ns();
+    for (i = 0; i < transfers && !fatal_signal_pending(current); i++) {
+        i2c_request_init(&req, addr, &tx, 1, buf, len, 0);
+        result.transfers++;
+        if (i2c_execute(bus, &req) != 0) {
+            result.errors++;
+            continue;
+        }
+        result.bus_ns += req.end_ns - req.start_ns;
+        result.scl_cycles += __transfer_bits(&req);
+    }
+    result.elapsed_ns = ktime_get_ns() - start;
+    kfree(buf);
+
+    spin_lock_irqsave(&bus->queue_lock, flags);
+    bus->selftest = result;
+    spin_unlock_irqrestore(&bus->queue_lock, flags);
+    return count;
+}
+
+static const struct file_operations selftest_fops = {
+    .owner = THIS_MODULE,
+    .open = __selftest_open,
+    .read = seq_read,
+    .write = __selftest_write,
+    .llseek = seq_lseek,
+    .release = single_release,
+};
+
 /******************************************************************************
  * Functions
 ******************************************************************************/
 
-/// @brief Initialize the I2C2 bus, with pins P9.21 and P9.22.
-int i2c_init(struct platform_device *pdev) {
+/// @brief Creates /sys/kernel/debug/<DRIVER_NAME>, where every controller adds its
+///  directory. Optional: the controllers work without it.
+void i2c_debugfs_init(void)
+{
+    debugfs_root = debugfs_create_dir(DRIVER_NAME, NULL);
+}
+
+/// @brief Removes what the controllers left in debugfs. After the last i2c_deinit().
+void i2c_debugfs_deinit(void)
+{
+    debugfs_remove_recursive(debugfs_root);
+    debugfs_root = NULL;
+}
+
+/// @brief Initialize the controller of a platform device: its registers come from
+///  the "reg" of the device tree (I2C1 or I2C2) and its pins from "pins". Every
+///  controller has its own 'bus', so they run in parallel.
+int i2c_init(struct i2c_bus *bus, struct platform_device *pdev) {
     struct device *i2c_dev = &pdev->dev;
+    struct resource *res;
+    void __iomem *control_module_ptr;
     u32 pins[4];
-    int retval = -1;
+    int retval;
+    int i;
+
+    memset(bus, 0, sizeof(*bus));
+    INIT_LIST_HEAD(&bus->queue);
+    spin_lock_init(&bus->queue_lock);
+    hrtimer_init(&bus->watchdog, CLOCK_MONOTONIC, HRTIMER_MODE_ABS);
+    INIT_WORK(&bus->recovery, i2c_recovery_work);
+    bus->watchdog.function = i2c_watchdog;
 
     // -------------------------
     // Working w/ devtree
     // -------------------------
 
-    // Check that parent device exists (should be target-module@9c000)
+    // Check that parent device exists (target-module@2a000 or target-module@9c000)
     if (i2c_dev->parent == NULL) {
         pr_err("I2C device doesn't have a parent.\n");
+        retval = -ENODEV;
+        goto pdev_error;
+    }
+
+    // Which controller it is
+    if ((res = platform_get_resource(pdev, IORESOURCE_MEM, 0)) == NULL) {
+        pr_err("%s: I2C device doesn't have registers (reg).\n", DRIVER_NAME);
+        retval = -EINVAL;
         goto pdev_error;
     }
+    for (i = 0; i < ARRAY_SIZE(i2c_controllers); i++) {
+        if (i2c_controllers[i].phys == res->start)
+            break;
+    }
+    if (i == ARRAY_SIZE(i2c_controllers)) {
+        pr_err("%s: No I2C controller at 0x%08llX.\n", DRIVER_NAME, (unsigned long long) res->start);
+        retval = -ENODEV;
+        goto pdev_error;
+    }
+    bus->id = i2c_controllers[i].id;
+    bus->phys = res->start;
+    snprintf(bus->name, sizeof(bus->name), "i2c%d", bus->id);
 
     // Check for device properties
     if (!device_property_present(i2c_dev, DT_PROPERTY_PINS))
     {
         pr_err("Device properties for i2c device not found.\n");
+        retval = -EINVAL;
         goto pdev_error;
     }
 
@@ -179,34 +1098,42 @@ int i2c_init(struct platform_device *pdev) {
         goto pdev_error;
     }
 
+    // SCL frequency
+    if ((retval = __timing_init(bus, i2c_dev)) != 0)
+        goto pdev_error;
+
     // -------------------------
     // Mapping Registers
     // -------------------------
-    if((clk_ptr = ioremap(CM_PER, CM_PER_LEN)) == NULL){
-        pr_alert("%s: Could not assign memory for clk_ptr (CM_PER).\n", DRIVER_NAME);
+    if((bus->clkctrl = ioremap(CM_PER + i2c_controllers[i].clkctrl, CM_PER_I2C_CLKCTRL_LEN)) == NULL){
+        pr_alert("%s: %s: Could not assign memory for clkctrl (CM_PER).\n", DRIVER_NAME, bus->name);
+        retval = -ENOMEM;
         goto pdev_error;
     }
-    pr_info("%s: clk_ptr: 0x%X\n", DRIVER_NAME, (unsigned int)clk_ptr);
 
     if((control_module_ptr = ioremap(CTRL_MODULE_BASE, CTRL_MODULE_LEN)) == NULL){
         pr_alert("%s: Could not assign memory for control_module_ptr (CTRL_MODULE_BASE).\n", DRIVER_NAME);
-        goto clk_ptr_error;
+        retval = -ENOMEM;
+        goto clkctrl_error;
     }
-    pr_info("%s: control_module_ptr: 0x%X\n", DRIVER_NAME, (unsigned int)control_module_ptr);
 
-    if((i2c_ptr = ioremap(I2C2, I2C2_LEN)) == NULL){
-        pr_alert("%s: Could not assign memory for i2c_ptr (I2C2).\n", DRIVER_NAME);
-        goto control_module_ptr_error;
+    if((bus->regs = ioremap(res->start, resource_size(res))) == NULL){
+        pr_alert("%s: %s: Could not assign memory for regs.\n", DRIVER_NAME, bus->name);
+        iounmap(control_module_ptr);
+        retval = -ENOMEM;
+        goto clkctrl_error;
     }
-    pr_info("%s: i2c_ptr: 0x%X\n", DRIVER_NAME, (unsigned int)i2c_ptr);
+    pr_info("%s: %s: regs: %p\n", DRIVER_NAME, bus->name, bus->regs);
 
     // -------------------------
     // Pinmux configuration
     // -------------------------
 
-    // Configure P9.21 and P9.22 pinmux as I2C
+    // Configure the pinmux as I2C (P9.21 and P9.22 for I2C2, P9.17 and P9.18 for
+    // I2C1). The control module is only needed for this.
     iowrite32(pins[1], control_module_ptr + pins[0]);
     iowrite32(pins[3], control_module_ptr + pins[2]);
+    iounmap(control_module_ptr);
 
 
     // -------------------------
@@ -214,304 +1141,201 @@ int i2c_init(struct platform_device *pdev) {
     // -------------------------
     
     // Turn ON I2C Clock
-    __wakeup();
+    __wakeup(bus);
 
-    // Disable I2C while configuring..
-    iowrite32(0x0, i2c_ptr + I2C_REG_CON); 
-
-    // Clock Configuration
-    iowrite32(I2C_PSC_24MHZ, i2c_ptr + I2C_REG_PSC);
-    iowrite32(I2C_SCLL_400K, i2c_ptr + I2C_REG_SCLL); 
-    iowrite32(I2C_SCLH_400K, i2c_ptr + I2C_REG_SCLH); 
+    // SCL timing, and enable it
+    __hw_setup(bus);
 
-    // Force Idle
-    iowrite32(0x00, i2c_ptr + I2C_REG_SYSC);   
-    
-    // Enable I2C device
-    iowrite32(I2C_BIT_ENABLE | I2C_BIT_MASTER_MODE | I2C_BIT_TX, // 0x8600
-        i2c_ptr + I2C_REG_CON);
+    // FIFO size, for the thresholds
+    bus->fifo_depth = I2C_BUFSTAT_FIFODEPTH(ioread32(bus->regs + I2C_REG_BUFSTAT));
     
 
     // -------------------------
     // Virtual IRQ request
     // -------------------------
 
-    if ((g_irq = platform_get_irq(pdev, 0)) < 0) {
-        pr_err("%s: Couldn't get I2C IRQ number.\n", DRIVER_NAME);
-        goto i2c_ptr_error;
+    if ((bus->irq = platform_get_irq(pdev, 0)) < 0) {
+        pr_err("%s: %s: Couldn't get I2C IRQ number.\n", DRIVER_NAME, bus->name);
+        retval = bus->irq;
+        goto regs_error;
     }
 
-    if ((request_irq(g_irq, (irq_handler_t) i2c_isr, IRQF_TRIGGER_RISING, "lliano,i2c", NULL) < 0)){//pdev->name, NULL)) < 0) {
-        pr_err("%s: Couldn't request I2C IRQ.\n", DRIVER_NAME);
-        goto i2c_ptr_error;
+    if ((retval = request_irq(bus->irq, (irq_handler_t) i2c_isr, IRQF_TRIGGER_RISING, "lliano,i2c", bus)) < 0){
+        pr_err("%s: %s: Couldn't request I2C IRQ.\n", DRIVER_NAME, bus->name);
+        goto regs_error;
     }
 
     // -------------------------
-    // Internal struct init.
+    // DMA (optional)
     // -------------------------
 
-    // We ask the kernel for memory for the buffers (4kB)
-    if ((data_i2c.buff_rx = (char *) __get_free_page (GFP_KERNEL)) < 0){
-        pr_alert("%s: Error while asking por a free page.\n", DRIVER_NAME);
-        goto virq_error;
-    }
-    if ((data_i2c.buff_tx = (char *) __get_free_page (GFP_KERNEL)) < 0){
-        pr_alert("%s: Error while asking por a free page.\n", DRIVER_NAME);
+    if ((retval = __dma_init(bus, i2c_dev)) != 0)
         goto virq_error;
-    }
 
-    pr_info("I2C successfully configured.\n");
+    // -------------------------
+    // Linux I2C adapter
+    // -------------------------
+
+    if ((retval = __adapter_init(bus, i2c_dev)) != 0)
+        goto dma_error;
+
+    // -------------------------
+    // Statistics (optional)
+    // -------------------------
+
+    bus->debugfs_dir = debugfs_create_dir(bus->name, debugfs_root);
+    debugfs_create_file("stats", 0400, bus->debugfs_dir, bus, &stats_fops);
+    debugfs_create_file("reset", 0200, bus->debugfs_dir, bus, &stats_reset_fops);
+    debugfs_create_file("selftest", 0600, bus->debugfs_dir, bus, &selftest_fops);
+
+    pr_info("%s: %s successfully configured.\n", DRIVER_NAME, bus->name);
     return 0;
 
     // -------------------------
     // Error Handling
     // -------------------------
-    virq_error: free_irq(g_irq, NULL);
-    i2c_ptr_error: iounmap(i2c_ptr);
-    control_module_ptr_error: iounmap(control_module_ptr);
-    clk_ptr_error: iounmap(clk_ptr);
-    pdev_error: retval = -1; i2c_ptr = NULL; clk_ptr = NULL; control_module_ptr = NULL;
+    dma_error: __dma_deinit(bus);
+    virq_error: free_irq(bus->irq, bus);
+    regs_error: iounmap(bus->regs);
+    clkctrl_error: iounmap(bus->clkctrl);
+    pdev_error: bus->regs = NULL; bus->clkctrl = NULL;
     return retval;
 }
 
-/// @brief Deinitialize the I2C2 bus.
-void i2c_deinit(void) {
-    if (clk_ptr != NULL) {
-        iounmap(clk_ptr);
-    } if (control_module_ptr != NULL) {
-        iounmap(control_module_ptr);
-    } if (i2c_ptr != NULL) {
-        iounmap(i2c_ptr);
+/// @brief Deinitialize a controller. Nothing may be queued on it anymore.
+void i2c_deinit(struct i2c_bus *bus) {
+    i2c_del_adapter(&bus->adapter);
+    debugfs_remove_recursive(bus->debugfs_dir);
+    bus->debugfs_dir = NULL;
+    free_irq(bus->irq, bus);
+    hrtimer_cancel(&bus->watchdog);
+    cancel_work_sync(&bus->recovery);
+    __dma_deinit(bus);
+    if (bus->clkctrl != NULL) {
+        iounmap(bus->clkctrl);
+    } if (bus->regs != NULL) {
+        iounmap(bus->regs);
     }
-    free_irq(g_irq, NULL);
-    free_page((unsigned long)data_i2c.buff_rx); 
-    free_page((unsigned long)data_i2c.buff_tx);
 }
 
-/// @brief Write a value to the I2C bus.
-/// @param slave_address Address of the I2C slave.
-/// @param data Pointer to kernel space data buffer.
-/// @param size Amount of data to be written.
-/// @return "0" on success, "-1" on error.
-int i2c_write(char slave_address, char* data, char size) 
+/// @brief Queues a request and returns right away. Requests are served in order
+///  (urgent ones first), one after the other with no gap. Once done, req->complete()
+///  is called from the I2C interrupt (or the watchdog, see I2C_DEADLINE_FACTOR) with
+///  req->status set, so it must not sleep.
+///  It may submit other requests, including 'req' itself. Safe in any context.
+/// @return "0" if the request was queued, negative error code on error.
+int i2c_submit(struct i2c_bus *bus, struct i2c_request *req)
 {
-    int retval = -1;
-    int auxReg;
-
-    if (size == 0)
-    {
-        pr_warn("%s: Write Error: Size should be greater than 0.\n", DRIVER_NAME);
-        return retval;
-    }
-
-    // Wait until no other process is using it
-    if(__wait_for_bus_busy() != 0) {
-        return retval;
+    unsigned long flags;
+    u16 i;
+
+    if (req->num_msgs == 0)
+        return -EINVAL;
+    for (i = 0; i < req->num_msgs; i++) {
+        if (req->msgs[i].flags & ~(I2C_M_RD | I2C_M_DMA_SAFE))
+            return -EOPNOTSUPP;
+        if (req->msgs[i].len == 0 || req->msgs[i].addr > 0x7F)
+            return -EINVAL;
     }
 
-    // Get control of the bus
-    mutex_lock(&lock_bus);
-
-    // Makes sure CLK is running
-    __wakeup();
-    
-    // Set slave address
-    __set_slave_address(slave_address);
-    
-    // Load the data structures and registers.
-    __clean_data_i2c();
-    memcpy(data_i2c.buff_tx, data, size);
-    data_i2c.buff_tx_len = size;
-
-    // Load I2C CNT registers
-    iowrite32(data_i2c.buff_tx_len, i2c_ptr + I2C_REG_CNT);
-
-    // Sets I2C CONFIG register w/ Master TX (=0x8600)
-    iowrite32(I2C_BIT_ENABLE | I2C_BIT_MASTER_MODE | I2C_BIT_TX, i2c_ptr + I2C_REG_CON);
-
-    // Clear IRQ Flags
-    iowrite32(I2C_IRQSTATUS_CLR_ALL, i2c_ptr + I2C_REG_IRQENABLE_CLR); 
-    iowrite32(I2C_IRQSTATUS_CLR_ALL, i2c_ptr + I2C_REG_IRQSTATUS);
-
-    // Enables ACK interrupt
-    iowrite32(I2C_IRQ_XRDY, i2c_ptr + I2C_REG_IRQENABLE_SET);
+    req->bus = bus;
+    req->msg = 0;
+    req->pos = 0;
+    req->attempts = 0;
+    req->status = -EINPROGRESS;
+    req->submit_ns = ktime_get_ns();
+    trace_lliano_i2c_submit(req);
+
+    spin_lock_irqsave(&bus->queue_lock, flags);
+    __enqueue_request(req);
+    __start_next(bus);
+    spin_unlock_irqrestore(&bus->queue_lock, flags);
+    return 0;
+}
 
-    // Check irq status (occupied or free)
-    while (ioread32(i2c_ptr + I2C_REG_IRQSTATUS_RAW) & I2C_IRQ_BB) {msleep(1);}
+/// @brief Queues a request and sleeps until the ISR has done it, or the watchdog
+///  has given up on it.
+/// @return "0" on success, "-ETIMEDOUT" if it missed its deadline, negative error
+///  code on other errors.
+int i2c_execute(struct i2c_bus *bus, struct i2c_request *req)
+{
+    int retval;
 
-    // Sends START
-    sleeping_condition = 0;     // We need to ensure the condition before sending the start
+    req->complete = NULL;
+    init_completion(&req->done);
+    if ((retval = i2c_submit(bus, req)) != 0)
+        return retval;
 
-    auxReg = ioread32(i2c_ptr + I2C_REG_CON); 
-    auxReg |= I2C_BIT_START;
-    iowrite32(auxReg, i2c_ptr + I2C_REG_CON);
+    // No timeout of its own: the watchdog ends every request ahead of this one,
+    // and this one, by their deadlines.
+    wait_for_completion(&req->done);
+    return req->status;
+}
 
-    // Sends process to sleep
-    wait_event_interruptible (waiting_queue, sleeping_condition != 0);
+/// @brief Does 'num' messages as a single bus transaction, with a repeated start
+///  between them and a STOP at the end, and sleeps until it's done. The ISR reads
+///  and writes their buffers directly.
+/// @return "0" on success, negative error code on error.
+int i2c_xfer(struct i2c_bus *bus, struct i2c_msg *msgs, u16 num)
+{
+    struct i2c_request req;
 
-    // We clear the start bit and sets the stop
-    auxReg = ioread32(i2c_ptr + I2C_REG_CON);
-    auxReg &= 0xFFFFFFFE;
-    auxReg |= I2C_BIT_STOP;
-    iowrite32(auxReg, i2c_ptr + I2C_REG_CON);
+    i2c_request_init_msgs(&req, msgs, num, 0);
+    return i2c_execute(bus, &req);
+}
 
-    // Waits for the core to send the stop and frees the mutex.
-    fsleep(100); // 100 us
-    mutex_unlock(&lock_bus);
-    if (sleeping_condition > 0)
-        retval = 0;
+/// @brief Write a value to the I2C bus.
+/// @param bus Controller the slave is on.
+/// @param slave_address Address of the I2C slave.
+/// @param data Pointer to kernel space data buffer.
+/// @param size Amount of data to be written.
+/// @return "0" on success, negative error code on error.
+int i2c_write(struct i2c_bus *bus, char slave_address, char* data, u16 size) 
+{
+    struct i2c_request req;
 
-    return retval;
+    i2c_request_init(&req, slave_address, data, size, NULL, 0, 0);
+    return i2c_execute(bus, &req);
 }
 
 /// @brief Read a value from the I2C bus.
+/// @param bus Controller the slave is on.
 /// @param slave_address Address of the I2C slave.
 /// @param data Pointer to kernel space data buffer.
 /// @param size Amount of data to be read.
-/// @return "0" on success, "-1" on error.
-int i2c_read(char slave_address, char* read_buff, char size)
+/// @return "0" on success, negative error code on error.
+int i2c_read(struct i2c_bus *bus, char slave_address, char* read_buff, u16 size)
 {
-    int retval = -1;
-    int auxReg;
-
-    if (size == 0)
-    {
-        pr_warn("%s: Write Error: Size should be greater than 0.\n", DRIVER_NAME);
-        return retval;
-    }
+    struct i2c_request req;
 
-    // Wait until no other process is using it
-    if(__wait_for_bus_busy() != 0) {
-        return retval;
-    }
-
-    // Get control of the bus
-    mutex_lock(&lock_bus);
-
-    // Makes sure CLK is running
-    __wakeup();
-
-    // Clear IRQ Flags
-    iowrite32(I2C_IRQSTATUS_CLR_ALL, i2c_ptr + I2C_REG_IRQENABLE_CLR); 
-    iowrite32(I2C_IRQSTATUS_CLR_ALL, i2c_ptr + I2C_REG_IRQSTATUS);
-    
-    // Set slave address
-    __set_slave_address(slave_address);
-    
-    // Load the data structures and registers.
-    __clean_data_i2c();
-    data_i2c.buff_rx_len = size;
-
-    // Load I2C DATA & CNT registers
-    iowrite32(data_i2c.buff_rx_len,              i2c_ptr + I2C_REG_CNT);
-
-
-    // Sets I2C CONFIG register w/ Master RX (=0x8400)
-    iowrite32(I2C_BIT_ENABLE | I2C_BIT_MASTER_MODE, i2c_ptr + I2C_REG_CON); // (RX is enable with 0 at I2C_BIT_TX)
-
-    // Enables ACK interrupt
-    iowrite32(I2C_IRQ_RRDY, i2c_ptr + I2C_REG_IRQENABLE_SET);
-
-    // Check irq status (occupied or free)
-    while (ioread32(i2c_ptr + I2C_REG_IRQSTATUS_RAW) & I2C_IRQ_BB) {msleep(1);}
-
-    // Sends START
-    sleeping_condition = 0;     // We need to ensure the condition before sending the start
-
-    auxReg = ioread32(i2c_ptr + I2C_REG_CON); 
-    auxReg |= I2C_BIT_START;
-    iowrite32(auxReg, i2c_ptr + I2C_REG_CON);
-
-    // Sends process to sleep
-    wait_event_interruptible (waiting_queue, sleeping_condition != 0);
-
-    // We clear the start bit and sets the stop
-    auxReg = ioread32(i2c_ptr + I2C_REG_CON);
-    auxReg &= 0xFFFFFFFE;
-    auxReg |= I2C_BIT_STOP;
-    iowrite32(auxReg, i2c_ptr + I2C_REG_CON);
-
-    // Waits for the core to send the stop and frees the mutex.
-    fsleep(100); // 100 us
-    mutex_unlock(&lock_bus);
-    if (sleeping_condition > 0)
-    {
-        memcpy(read_buff, data_i2c.buff_rx, size);
-        retval = 0;
-    }
- 
-    return retval;
+    i2c_request_init(&req, slave_address, NULL, 0, read_buff, size, 0);
+    return i2c_execute(bus, &req);
 }
 
 /// @brief Read a register from a compatible I2C slave. We will perform a Write + Read operation w/ repeated start.
+/// @param bus Controller the slave is on.
 /// @param slave_address Address of the I2C slave.
 /// @param reg_address Address of the register to be read.
 /// @param data Pointer to kernel space data buffer.
-/// @return "0" on success, "-1" on error.
-int i2c_read_reg(char slave_address, char reg_address, char* read_buff) 
+/// @return "0" on success, negative error code on error.
+int i2c_read_reg(struct i2c_bus *bus, char slave_address, char reg_address, char* read_buff) 
 {
-    int retval = -1;
-    int auxReg;
-
-    // Wait until no other process is using it
-    if(__wait_for_bus_busy() != 0) {
-        return retval;
-    }
-
-    // Get control of the bus
-    mutex_lock(&lock_bus);
-
-    // Makes sure CLK is running
-    __wakeup();
-    
-    // Set slave address
-    __set_slave_address(slave_address);
-    
-    // Load the data structures and registers.
-    __clean_data_i2c();
-    data_i2c.buff_rx_len = 1;
-
-    // Load I2C DATA & CNT registers
-    iowrite32(reg_address, i2c_ptr + I2C_REG_DATA);
-    iowrite32(1, i2c_ptr + I2C_REG_CNT);
-
-    // Sets I2C CONFIG register w/ Master TX (=0x8600)
-    iowrite32(I2C_BIT_ENABLE | I2C_BIT_MASTER_MODE | I2C_BIT_TX, i2c_ptr + I2C_REG_CON);
-
-    // Clear IRQ Flags
-    iowrite32(I2C_IRQSTATUS_CLR_ALL, i2c_ptr + I2C_REG_IRQENABLE_CLR); 
-    iowrite32(I2C_IRQSTATUS_CLR_ALL, i2c_ptr + I2C_REG_IRQSTATUS);
-
-    // Enables ACK interrupt
-    iowrite32(I2C_IRQ_ARDY, i2c_ptr + I2C_REG_IRQENABLE_SET);
-
-    // Check irq status (occupied or free)
-    while (ioread32(i2c_ptr + I2C_REG_IRQSTATUS_RAW) & I2C_IRQ_BB) {msleep(1);}
-
-    // Sends START
-    sleeping_condition = 0;     // We need to ensure the condition before sending the start
-
-    auxReg = ioread32(i2c_ptr + I2C_REG_CON); 
-    auxReg |= I2C_BIT_START;
-    iowrite32(auxReg, i2c_ptr + I2C_REG_CON);
-
-    // Sends process to sleep
-    wait_event_interruptible (waiting_queue, sleeping_condition != 0);
-
-    // We clear the start bit and sets the stop
-    auxReg = ioread32(i2c_ptr + I2C_REG_CON);
-    auxReg &= 0xFFFFFFFE;
-    auxReg |= I2C_BIT_STOP;
-    iowrite32(auxReg, i2c_ptr + I2C_REG_CON);
+    return i2c_read_regs(bus, slave_address, reg_address, read_buff, 1);
+}
 
-    // Waits for the core to send the stop and frees the mutex.
-    fsleep(100); // 100 us
-    mutex_unlock(&lock_bus);
-    if (sleeping_condition > 0)
-    {
-        memcpy(read_buff, data_i2c.buff_rx, 1);
-        retval = 0;
-    }
+/// @brief Burst read consecutive registers from a compatible I2C slave. The register
+///  address is written and then 'size' bytes are read after a repeated start, so the
+///  whole burst is a single bus transaction.
+/// @param bus Controller the slave is on.
+/// @param slave_address Address of the I2C slave.
+/// @param reg_address Address of the first register to be read.
+/// @param read_buff Pointer to kernel space data buffer.
+/// @param size Amount of registers to be read.
+/// @return "0" on success, negative error code on error.
+int i2c_read_regs(struct i2c_bus *bus, char slave_address, char reg_address, char* read_buff, u16 size)
+{
+    struct i2c_request req;
 
-    return retval;
-}
\ No newline at end of file
+    i2c_request_init(&req, slave_address, &reg_address, 1, read_buff, size, 0);
+    return i2c_execute(bus, &req);
+}
@@ -1,35 +1,161 @@
 #include "kernel_module.h"
 
+/******************************************************************************
+ * Sensors
+******************************************************************************/
+
+/// @brief Frees a sensor once the bus and the last open file let it go.
+static void sensor_release(struct kref *ref)
+{
+    struct mpu6050_sensor *sensor = container_of(ref, struct mpu6050_sensor, ref);
+
+    acquisition_free(&sensor->acq);
+    kfree(sensor);
+}
+
+/// @brief Drops a reference to a sensor, taken by sensor_add() or by open().
+void sensor_put(struct mpu6050_sensor *sensor)
+{
+    kref_put(&sensor->ref, sensor_release);
+}
+
+/// @brief Stops one sensor, in the reverse order of sensor_add(). The files
+///  still open get -ENODEV (EPOLLHUP from poll()), and the readers asleep on
+///  the ring are woken up to see it. The sensor is freed with the last of them.
+static void sensor_remove(struct mpu6050_sensor *sensor)
+{
+    char_device_del(sensor);
+    down_write(&sensor->lock);
+    sensor->gone = true;
+    up_write(&sensor->lock);
+    if (acquisition_is_streaming(&sensor->acq))
+        wake_up_interruptible_all(&acquisition_get_ring(&sensor->acq)->wait);
+
+    mpu6050_iio_deinit(sensor);
+    acquisition_deinit(&sensor->acq);
+    MPU6050_deinit(&sensor->mpu);
+    list_del(&sensor->node);
+    sensor_put(sensor);
+}
+
+/// @brief Brings up the MPU6050 of a child node of the bus: the sensor, its
+///  sampling engine, its IIO device and /dev/MPU6050-<bus>-<address>.
+/// @param slot Position of the sensor among the 'slots' ones of the bus.
+/// @return "0" on success, "-ENODEV" if the sensor doesn't answer, other error code on error.
+static int sensor_add(struct mpu6050_bus *bus, struct platform_device *pdev,
+    struct device_node *node, unsigned int slot, unsigned int slots)
+{
+    struct mpu6050_sensor *sensor;
+    u32 address;
+    int status = 0;
+
+    if (of_property_read_u32(node, "reg", &address) != 0) {
+        pr_warn("%s: PROBE - %pOF has no \"reg\" property.\n", DRIVER_NAME, node);
+        return -EINVAL;
+    }
+    if ((sensor = kzalloc(sizeof(*sensor), GFP_KERNEL)) == NULL)
+        return -ENOMEM;
+    sensor->index = slot;
+    kref_init(&sensor->ref);
+    init_rwsem(&sensor->lock);
+
+    if ((status = MPU6050_init(&sensor->mpu, &bus->i2c, address)) != 0) {
+        pr_warn("%s: PROBE - Error while running mpu6050_init().\n", DRIVER_NAME);
+        status = -ENODEV;
+        goto mpu6050_error;
+    }
+    if ((status = acquisition_init(&sensor->acq, &sensor->mpu, node, &pdev->dev, slot, slots)) != 0) {
+        pr_warn("%s: PROBE - Error while running acquisition_init().\n", DRIVER_NAME);
+        goto acquisition_error;
+    }
+    if ((status = mpu6050_iio_init(sensor, &pdev->dev)) != 0) {
+        pr_warn("%s: PROBE - Error while running mpu6050_iio_init().\n", DRIVER_NAME);
+        goto iio_error;
+    }
+    if ((status = char_device_add(sensor, &pdev->dev)) != 0) {
+        pr_warn("%s: PROBE - Error while running char_device_add().\n", DRIVER_NAME);
+        goto char_device_error;
+    }
+    list_add_tail(&sensor->node, &bus->sensors);
+    return 0;
+
+    char_device_error: mpu6050_iio_deinit(sensor);
+    iio_error: acquisition_deinit(&sensor->acq);
+    acquisition_error: MPU6050_deinit(&sensor->mpu);
+    mpu6050_error: sensor_put(sensor);
+    return status;
+}
+
+/// @brief Removes every sensor of a bus, newest first.
+static void sensors_remove(struct mpu6050_bus *bus)
+{
+    struct mpu6050_sensor *sensor, *tmp;
+
+    list_for_each_entry_safe_reverse(sensor, tmp, &bus->sensors, node)
+        sensor_remove(sensor);
+}
+
 /******************************************************************************
  * Platform Driver - Methods
 ******************************************************************************/
 
 /// @brief This function is called when a device matches the "compatible"
-///  property in the device tree.
+///  property in the device tree, once per controller (I2C1, I2C2). Every
+///  available MPU6050 child of the bus node gets probed. The ones that don't
+///  answer are skipped, any other error fails the whole bus. With none of them
+///  there, the bus stays registered as an I2C adapter for other clients.
 /// @param pdev Reference to the device tree.
 /// @return "0" on success, not "0" on error.
 static int i2c_probe(struct platform_device * i2c_plat_dev)
 {
+    struct mpu6050_bus *bus;
+    struct device_node *child;
+    unsigned int slots = 0, slot = 0;
     int status = 0;
     pr_info("%s: PROBE - Initializing driver.. i2c_plat_dev->name = %s\n", DRIVER_NAME, i2c_plat_dev->name);
-    
-    if ((status = i2c_init(i2c_plat_dev)) != 0) {
+
+    if ((bus = kzalloc(sizeof(*bus), GFP_KERNEL)) == NULL)
+        return -ENOMEM;
+    INIT_LIST_HEAD(&bus->sensors);
+
+    if ((status = i2c_init(&bus->i2c, i2c_plat_dev)) != 0) {
         pr_warn("%s: PROBE - Error while running i2c_init().\n", DRIVER_NAME);
         goto i2c_error;
     }
-    if ((status = MPU6050_init(i2c_plat_dev)) != 0) {
-        pr_warn("%s: PROBE - Error while running mpu6050_init().\n", DRIVER_NAME);
-        goto mpu6050_error;
+
+    for_each_available_child_of_node(i2c_plat_dev->dev.of_node, child)
+        if (of_device_is_compatible(child, MPU6050_COMPATIBLE))
+            slots++;
+    if (slots > SENSORS_MAX) {
+        pr_warn("%s: PROBE - Only the first %d MPU6050 are used.\n", DRIVER_NAME, SENSORS_MAX);
+        slots = SENSORS_MAX;
     }
-    if ((status = char_device_create()) != 0) {
-        pr_warn("%s: PROBE - Error while running char_device_create().\n", DRIVER_NAME);
-        goto char_device_error;
+
+    for_each_available_child_of_node(i2c_plat_dev->dev.of_node, child) {
+        if (!of_device_is_compatible(child, MPU6050_COMPATIBLE))
+            continue;
+        if (slot == slots) {
+            of_node_put(child);
+            break;
+        }
+        status = sensor_add(bus, i2c_plat_dev, child, slot, slots);
+        if (status == -ENODEV)
+            continue;
+        if (status != 0) {
+            of_node_put(child);
+            goto sensor_error;
+        }
+        slot++;
     }
+    if (list_empty(&bus->sensors))
+        pr_warn("%s: PROBE - No MPU6050 found on %s, only its I2C adapter is left.\n", DRIVER_NAME, bus->i2c.name);
+    platform_set_drvdata(i2c_plat_dev, bus);
     return 0;
 
-    char_device_error: MPU6050_deinit();
-    mpu6050_error: i2c_deinit();
-    i2c_error: return status;
+    sensor_error: sensors_remove(bus);
+    i2c_deinit(&bus->i2c);
+    i2c_error: kfree(bus);
+    return status;
 }
 
 
@@ -39,10 +165,12 @@ static int i2c_probe(struct platform_device * i2c_plat_dev)
 /// @return "0" on success, not "0" on error.
 static int i2c_remove(struct platform_device * i2c_plat_dev)
 {
+    struct mpu6050_bus *bus = platform_get_drvdata(i2c_plat_dev);
+
     pr_info("%s: REMOVE - Removing driver.. i2c_plat_dev->name = %s\n", DRIVER_NAME, i2c_plat_dev->name);
-    char_device_remove();
-    MPU6050_deinit();
-    i2c_deinit();
+    sensors_remove(bus);
+    i2c_deinit(&bus->i2c);
+    kfree(bus);
     return 0;
 }
 
@@ -75,8 +203,17 @@ static int __init lkm_init(void)
     
     pr_info("%s: INIT - Running init configuration..\n", DRIVER_NAME);
 
+    // Shared by every controller: the device numbers and the debugfs directory
+    if ((status = char_device_create()) != 0) {
+        pr_warn("%s: INIT - Error while running char_device_create().\n", DRIVER_NAME);
+        return status;
+    }
+    i2c_debugfs_init();
+
     if( (status = platform_driver_register(&i2c_plat_driver)) != 0) {
         pr_warn("%s: Platform Device could not be initialized.\n", DRIVER_NAME);
+        i2c_debugfs_deinit();
+        char_device_remove();
         return status;
     }
 
@@ -88,6 +225,8 @@ static void __exit lkm_exit(void)
 {
     pr_info("%s: EXIT - Doing cleanup...\n", DRIVER_NAME);
     platform_driver_unregister(&i2c_plat_driver);
+    i2c_debugfs_deinit();
+    char_device_remove();
     pr_info("%s: EXIT - LKM was removed successfully.\n", DRIVER_NAME);
 }
 
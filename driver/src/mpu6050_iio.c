@@ -0,0 +1,411 @@
+#include "mpu6050_iio.h"
+
+#if IS_ENABLED(CONFIG_IIO_TRIGGERED_BUFFER)
+
+/******************************************************************************
+ * Channels
+******************************************************************************/
+
+// Scan elements, in the order of the motion7 burst: scan_index * 2 is the
+// offset of the channel in MPU6050_getMotion7().
+enum mpu6050_iio_scan {
+    MPU6050_IIO_SCAN_ACCEL_X,
+    MPU6050_IIO_SCAN_ACCEL_Y,
+    MPU6050_IIO_SCAN_ACCEL_Z,
+    MPU6050_IIO_SCAN_TEMP,
+    MPU6050_IIO_SCAN_GYRO_X,
+    MPU6050_IIO_SCAN_GYRO_Y,
+    MPU6050_IIO_SCAN_GYRO_Z,
+    MPU6050_IIO_SCAN_TIMESTAMP,
+};
+
+// The buffer carries the values of struct mpu6050_record, already in CPU order.
+#define MPU6050_IIO_SCAN_TYPE {                 \
+    .sign = 's',                                \
+    .realbits = 16,                             \
+    .storagebits = 16,                          \
+    .endianness = IIO_CPU,                      \
+}
+
+#define MPU6050_IIO_CHANNEL(_type, _axis, _index) {                         \
+    .type = _type,                                                          \
+    .modified = 1,                                                          \
+    .channel2 = _axis,                                                      \
+    .info_mask_separate = BIT(IIO_CHAN_INFO_RAW),                           \
+    .info_mask_shared_by_type = BIT(IIO_CHAN_INFO_SCALE),                   \
+    .info_mask_shared_by_type_available = BIT(IIO_CHAN_INFO_SCALE),         \
+    .info_mask_shared_by_all = BIT(IIO_CHAN_INFO_SAMP_FREQ),                \
+    .scan_index = _index,                                                   \
+    .scan_type = MPU6050_IIO_SCAN_TYPE,                                     \
+}
+
+static const struct iio_chan_spec mpu6050_iio_channels[] = {
+    MPU6050_IIO_CHANNEL(IIO_ACCEL, IIO_MOD_X, MPU6050_IIO_SCAN_ACCEL_X),
+    MPU6050_IIO_CHANNEL(IIO_ACCEL, IIO_MOD_Y, MPU6050_IIO_SCAN_ACCEL_Y),
+    MPU6050_IIO_CHANNEL(IIO_ACCEL, IIO_MOD_Z, MPU6050_IIO_SCAN_ACCEL_Z),
+    {
+        .type = IIO_TEMP,
+        .info_mask_separate = BIT(IIO_CHAN_INFO_RAW) | BIT(IIO_CHAN_INFO_SCALE) | BIT(IIO_CHAN_INFO_OFFSET),
+        .info_mask_shared_by_all = BIT(IIO_CHAN_INFO_SAMP_FREQ),
+        .scan_index = MPU6050_IIO_SCAN_TEMP,
+        .scan_type = MPU6050_IIO_SCAN_TYPE,
+    },
+    MPU6050_IIO_CHANNEL(IIO_ANGL_VEL, IIO_MOD_X, MPU6050_IIO_SCAN_GYRO_X),
+    MPU6050_IIO_CHANNEL(IIO_ANGL_VEL, IIO_MOD_Y, MPU6050_IIO_SCAN_GYRO_Y),
+    MPU6050_IIO_CHANNEL(IIO_ANGL_VEL, IIO_MOD_Z, MPU6050_IIO_SCAN_GYRO_Z),
+    IIO_CHAN_SOFT_TIMESTAMP(MPU6050_IIO_SCAN_TIMESTAMP),
+};
+
+// Scales in nano units per LSB, indexed by MPU6050_ACCEL_FS_* / MPU6050_GYRO_FS_*,
+// as {integer, nano} pairs for read_avail().
+static const int mpu6050_iio_accel_scales[] = {   // m/s^2: 9.80665 / (16384 >> range)
+    0, 598550,
+    0, 1197101,
+    0, 2394202,
+    0, 4788403,
+};
+static const int mpu6050_iio_gyro_scales[] = {    // rad/s: (PI / 180) / (131 >> range)
+    0, 133231,
+    0, 266462,
+    0, 532113,
+    0, 1064225,
+};
+
+/******************************************************************************
+ * Private data
+******************************************************************************/
+
+// State of one IIO device, in iio_priv().
+struct mpu6050_iio {
+    struct mpu6050_sensor *sensor;
+    u32 ring_tail;          // Next sample of the ring for the buffer, with its own trigger
+    u32 ring_dropped;
+    char label[16];
+
+    // One scan, sized for every channel enabled. The timestamp is put by
+    // iio_push_to_buffers_with_timestamp() in the last 8 bytes that are in use.
+    struct {
+        s16 channels[MPU6050_IIO_SCAN_TIMESTAMP];
+        s64 timestamp __aligned(8);
+    } scan;
+};
+
+/******************************************************************************
+ * Static functions
+******************************************************************************/
+
+/// @brief Pushes the enabled channels of a record to the buffer.
+/// @param timestamp Time of the sample, in the clock of the IIO device.
+static void __push_record(struct iio_dev *indio_dev, const struct mpu6050_record *record, s64 timestamp)
+{
+    struct mpu6050_iio *priv = iio_priv(indio_dev);
+    const s16 values[] = {
+        record->accel[0], record->accel[1], record->accel[2], record->temp,
+        record->gyro[0], record->gyro[1], record->gyro[2],
+    };
+    int bit, i = 0;
+
+    for_each_set_bit(bit, indio_dev->active_scan_mask, indio_dev->masklength)
+        if (bit < MPU6050_IIO_SCAN_TIMESTAMP)
+            priv->scan.channels[i++] = values[bit];
+    iio_push_to_buffers_with_timestamp(indio_dev, &priv->scan, timestamp);
+}
+
+/// @brief Bottom half of the trigger. With our data ready trigger the samples
+///  are already in the sample ring, so they are moved over with no bus traffic
+///  and keep their own timestamps. Any other trigger (iio-trig-hrtimer, sysfs)
+///  reads the sensor once.
+static irqreturn_t mpu6050_iio_trigger_handler(int irq, void *p)
+{
+    struct iio_poll_func *pf = p;
+    struct iio_dev *indio_dev = pf->indio_dev;
+    struct mpu6050_iio *priv = iio_priv(indio_dev);
+    struct acquisition *acq = &priv->sensor->acq;
+    struct mpu6050_record record;
+    s64 clock_offset;
+
+    if (acq->trigger != NULL && indio_dev->trig == acq->trigger) {
+        // Records are stamped with ktime_get_ns(), the device may use another clock
+        clock_offset = iio_get_time_ns(indio_dev) - (s64) ktime_get_ns();
+        while (sample_ring_pop(acquisition_get_ring(acq), &priv->ring_tail, &record, &priv->ring_dropped) == 0)
+            __push_record(indio_dev, &record, (s64) record.timestamp_ns + clock_offset);
+    } else if (acquisition_read_polled(acq, &record) == 0) {
+        __push_record(indio_dev, &record, pf->timestamp);
+    } else {
+        pr_warn_ratelimited("%s: IIO 0x%02x - Couldn't read the sample.\n", DRIVER_NAME, acq->mpu->devAddr);
+    }
+
+    iio_trigger_notify_done(indio_dev->trig);
+    return IRQ_HANDLED;
+}
+
+/// @brief The buffer starts with the samples captured from now on.
+static int mpu6050_iio_buffer_preenable(struct iio_dev *dev)
+{
+    struct mpu6050_iio *priv = iio_priv(dev);
+    struct acquisition *acq = &priv->sensor->acq;
+
+    if (acquisition_is_streaming(acq))
+        priv->ring_tail = sample_ring_head(acquisition_get_ring(acq));
+    priv->ring_dropped = 0;
+    return 0;
+}
+
+/// @brief Reports the samples the buffer lost because it fell a ring behind.
+static int mpu6050_iio_buffer_postdisable(struct iio_dev *dev)
+{
+    struct mpu6050_iio *priv = iio_priv(dev);
+
+    if (priv->ring_dropped != 0)
+        pr_warn("%s: IIO 0x%02x - %u samples dropped by the buffer.\n",
+            DRIVER_NAME, priv->sensor->mpu.devAddr, priv->ring_dropped);
+    return 0;
+}
+
+/// @brief Reads a single channel from a motion7 burst.
+static int __read_channel(struct iio_dev *indio_dev, const struct iio_chan_spec *chan, int *val)
+{
+    struct mpu6050_iio *priv = iio_priv(indio_dev);
+    u8 sample[MPU6050_MOTION7_LENGTH];
+    int retval;
+
+    if ((retval = iio_device_claim_direct_mode(indio_dev)) != 0)
+        return retval;
+    retval = MPU6050_getMotion7(&priv->sensor->mpu, sample);
+    iio_device_release_direct_mode(indio_dev);
+    if (retval != 0)
+        return -EIO;
+
+    *val = (s16) get_unaligned_be16(&sample[2 * chan->scan_index]);
+    return IIO_VAL_INT;
+}
+
+static int mpu6050_iio_read_raw(struct iio_dev *dev, const struct iio_chan_spec *chan,
+    int *val, int *val2, long mask)
+{
+    struct mpu6050_iio *priv = iio_priv(dev);
+    MPU6050_t *mpu = &priv->sensor->mpu;
+    const int *scales;
+    u8 range, dlpf;
+
+    switch (mask) {
+    case IIO_CHAN_INFO_RAW:
+        return __read_channel(dev, chan, val);
+
+    case IIO_CHAN_INFO_SCALE:
+        if (chan->type == IIO_TEMP) {
+            *val = MPU6050_IIO_TEMP_SCALE_MICRO / 1000000;
+            *val2 = MPU6050_IIO_TEMP_SCALE_MICRO % 1000000;
+            return IIO_VAL_INT_PLUS_MICRO;
+        }
+        if (chan->type == IIO_ACCEL) {
+            scales = mpu6050_iio_accel_scales;
+            range = MPU6050_getFullScaleAccelRange(mpu);
+        } else {
+            scales = mpu6050_iio_gyro_scales;
+            range = MPU6050_getFullScaleGyroRange(mpu);
+        }
+        *val = scales[2 * range];
+        *val2 = scales[2 * range + 1];
+        return IIO_VAL_INT_PLUS_NANO;
+
+    case IIO_CHAN_INFO_OFFSET:
+        *val = MPU6050_IIO_TEMP_OFFSET;
+        *val2 = MPU6050_IIO_TEMP_OFFSET_MICRO;
+        return IIO_VAL_INT_PLUS_MICRO;
+
+    case IIO_CHAN_INFO_SAMP_FREQ:
+        // The gyro output rate is 8kHz with the DLPF off, 1kHz otherwise
+        dlpf = MPU6050_getDLPFMode(mpu);
+        *val = (dlpf == MPU6050_DLPF_BW_256 || dlpf > MPU6050_DLPF_BW_5 ? 8000 : 1000) / (1 + MPU6050_getRate(mpu));
+        return IIO_VAL_INT;
+    }
+    return -EINVAL;
+}
+
+static int mpu6050_iio_read_avail(struct iio_dev *dev, const struct iio_chan_spec *chan,
+    const int **vals, int *type, int *length, long mask)
+{
+    if (mask != IIO_CHAN_INFO_SCALE)
+        return -EINVAL;
+
+    *vals = chan->type == IIO_ACCEL ? mpu6050_iio_accel_scales : mpu6050_iio_gyro_scales;
+    *type = IIO_VAL_INT_PLUS_NANO;
+    *length = ARRAY_SIZE(mpu6050_iio_accel_scales);
+    return IIO_AVAIL_LIST;
+}
+
+/// @brief Only the accel and gyro scales can be changed. The sample rate belongs
+///  to the sampling engine (smplrt_div), which the char device shares.
+static int mpu6050_iio_write_raw(struct iio_dev *dev, const struct iio_chan_spec *chan,
+    int val, int val2, long mask)
+{
+    struct mpu6050_iio *priv = iio_priv(dev);
+    const int *scales;
+    int range, retval;
+
+    if (mask != IIO_CHAN_INFO_SCALE || chan->type == IIO_TEMP)
+        return -EINVAL;
+
+    scales = chan->type == IIO_ACCEL ? mpu6050_iio_accel_scales : mpu6050_iio_gyro_scales;
+    for (range = 0; range < ARRAY_SIZE(mpu6050_iio_accel_scales) / 2; range++)
+        if (scales[2 * range] == val && scales[2 * range + 1] == val2)
+            break;
+    if (range == ARRAY_SIZE(mpu6050_iio_accel_scales) / 2)
+        return -EINVAL;
+
+    // Samples in the buffer would change meaning halfway
+    if ((retval = iio_device_claim_direct_mode(dev)) != 0)
+        return retval;
+    if (chan->type == IIO_ACCEL)
+        MPU6050_setFullScaleAccelRange(&priv->sensor->mpu, range);
+    else
+        MPU6050_setFullScaleGyroRange(&priv->sensor->mpu, range);
+    iio_device_release_direct_mode(dev);
+    return 0;
+}
+
+static int mpu6050_iio_write_raw_get_fmt(struct iio_dev *dev, const struct iio_chan_spec *chan, long mask)
+{
+    return IIO_VAL_INT_PLUS_NANO;
+}
+
+/******************************************************************************
+ * Configuration structures
+******************************************************************************/
+
+static const struct iio_info mpu6050_iio_info = {
+    .read_raw = mpu6050_iio_read_raw,
+    .read_avail = mpu6050_iio_read_avail,
+    .write_raw = mpu6050_iio_write_raw,
+    .write_raw_get_fmt = mpu6050_iio_write_raw_get_fmt,
+};
+
+static const struct iio_buffer_setup_ops mpu6050_iio_buffer_ops = {
+    .preenable = mpu6050_iio_buffer_preenable,
+    .postdisable = mpu6050_iio_buffer_postdisable,
+};
+
+/// @brief The handler relies on the sample ring of the sensor that fires the
+///  trigger. Every sensor of the bus shares the parent, so
+///  iio_trigger_validate_own_device() can't tell them apart.
+static int mpu6050_iio_validate_device(struct iio_trigger *trig, struct iio_dev *dev)
+{
+    struct mpu6050_iio *priv = iio_priv(dev);
+
+    return iio_trigger_get_drvdata(trig) == &priv->sensor->acq ? 0 : -EINVAL;
+}
+
+static const struct iio_trigger_ops mpu6050_iio_trigger_ops = {
+    .validate_device = mpu6050_iio_validate_device,
+};
+
+/******************************************************************************
+ * Functions
+******************************************************************************/
+
+/// @brief Registers the data ready trigger of a sensor. Called by its sampling
+///  engine when it streams, before any sample is captured.
+/// @return "0" on success, not "0" on error.
+int mpu6050_iio_trigger_init(struct acquisition *acq, struct device *parent)
+{
+    struct iio_trigger *trigger;
+    int retval;
+
+    trigger = iio_trigger_alloc(parent, MPU6050_IIO_TRIGGER_NAME, acq->mpu->bus->id, acq->mpu->devAddr);
+    if (trigger == NULL) {
+        pr_err("%s: IIO 0x%02x - Couldn't allocate the trigger.\n", DRIVER_NAME, acq->mpu->devAddr);
+        return -ENOMEM;
+    }
+    trigger->ops = &mpu6050_iio_trigger_ops;
+    iio_trigger_set_drvdata(trigger, acq);
+
+    if ((retval = iio_trigger_register(trigger)) != 0) {
+        pr_err("%s: IIO 0x%02x - Couldn't register the trigger.\n", DRIVER_NAME, acq->mpu->devAddr);
+        iio_trigger_free(trigger);
+        return retval;
+    }
+    acq->trigger = trigger;
+    return 0;
+}
+
+/// @brief Removes the data ready trigger, once no sample can fire it.
+void mpu6050_iio_trigger_deinit(struct acquisition *acq)
+{
+    if (acq->trigger == NULL)
+        return;
+    iio_trigger_unregister(acq->trigger);
+    iio_trigger_free(acq->trigger);
+    acq->trigger = NULL;
+}
+
+/// @brief Fires the data ready trigger, after new samples were committed to the
+///  sample ring. Works from the I2C interrupt as well as from process context.
+void mpu6050_iio_trigger_poll(struct acquisition *acq)
+{
+    if (acq->trigger == NULL)
+        return;
+    if (in_task())
+        iio_trigger_poll_chained(acq->trigger);
+    else
+        iio_trigger_poll(acq->trigger);
+}
+
+/// @brief Registers the IIO device of a sensor. Its data ready trigger, when the
+///  sampling engine streams, is the default trigger.
+/// @return "0" on success, not "0" on error.
+int mpu6050_iio_init(struct mpu6050_sensor *sensor, struct device *parent)
+{
+    struct iio_dev *indio_dev;
+    struct mpu6050_iio *priv;
+    int retval;
+
+    indio_dev = iio_device_alloc(parent, sizeof(*priv));
+    if (indio_dev == NULL) {
+        pr_err("%s: IIO 0x%02x - Couldn't allocate the device.\n", DRIVER_NAME, sensor->mpu.devAddr);
+        return -ENOMEM;
+    }
+    priv = iio_priv(indio_dev);
+    priv->sensor = sensor;
+    snprintf(priv->label, sizeof(priv->label), MPU6050_IIO_LABEL, sensor->mpu.bus->id, sensor->mpu.devAddr);
+
+    indio_dev->name = MPU6050_IIO_NAME;
+    indio_dev->label = priv->label;
+    indio_dev->info = &mpu6050_iio_info;
+    indio_dev->modes = INDIO_DIRECT_MODE;
+    indio_dev->channels = mpu6050_iio_channels;
+    indio_dev->num_channels = ARRAY_SIZE(mpu6050_iio_channels);
+
+    if ((retval = iio_triggered_buffer_setup(indio_dev, iio_pollfunc_store_time,
+            mpu6050_iio_trigger_handler, &mpu6050_iio_buffer_ops)) != 0) {
+        pr_err("%s: IIO 0x%02x - Couldn't set up the buffer.\n", DRIVER_NAME, sensor->mpu.devAddr);
+        goto buffer_error;
+    }
+    if (sensor->acq.trigger != NULL)
+        indio_dev->trig = iio_trigger_get(sensor->acq.trigger);
+
+    if ((retval = iio_device_register(indio_dev)) != 0) {
+        pr_err("%s: IIO 0x%02x - Couldn't register the device.\n", DRIVER_NAME, sensor->mpu.devAddr);
+        goto register_error;
+    }
+    sensor->iio = indio_dev;
+    return 0;
+
+    register_error: iio_triggered_buffer_cleanup(indio_dev);
+    buffer_error: iio_device_free(indio_dev);
+    return retval;
+}
+
+/// @brief Removes the IIO device of a sensor. Must run before its sampling engine
+///  stops, as the device still holds a reference to the trigger.
+void mpu6050_iio_deinit(struct mpu6050_sensor *sensor)
+{
+    if (sensor->iio == NULL)
+        return;
+    iio_device_unregister(sensor->iio);
+    iio_triggered_buffer_cleanup(sensor->iio);
+    iio_device_free(sensor->iio);
+    sensor->iio = NULL;
+}
+
+#endif
@@ -0,0 +1,108 @@
+#include "sample_ring.h"
+
+#include <linux/mm.h>
+#include <linux/vmalloc.h>
+
+/******************************************************************************
+ * Ring control
+******************************************************************************/
+
+/// @brief Allocates an empty ring. The memory is zeroed and can be mapped to user space.
+/// @return "0" on success, "-ENOMEM" on error.
+int sample_ring_init(struct sample_ring *ring)
+{
+    ring->header = vmalloc_user(SAMPLE_RING_MMAP_SIZE);
+    if (ring->header == NULL)
+        return -ENOMEM;
+
+    ring->header->version = MPU6050_RECORD_VERSION;
+    ring->header->record_size = sizeof(struct mpu6050_record);
+    ring->header->slots = SAMPLE_RING_SLOTS;
+    ring->header->data_offset = SAMPLE_RING_DATA_OFFSET;
+    ring->header->mmap_size = SAMPLE_RING_MMAP_SIZE;
+    ring->header->head = 0;
+
+    ring->slots = (struct mpu6050_record *) ((char *) ring->header + SAMPLE_RING_DATA_OFFSET);
+    ring->mask = SAMPLE_RING_SLOTS - 1;
+    init_waitqueue_head(&ring->wait);
+    return 0;
+}
+
+/// @brief Frees the ring. Existing user mappings keep the pages until they're unmapped.
+void sample_ring_free(struct sample_ring *ring)
+{
+    vfree(ring->header);
+    ring->header = NULL;
+    ring->slots = NULL;
+}
+
+/// @brief Maps the ring (or its first pages) read only into a user process.
+/// @return "0" on success, negative error code on error.
+int sample_ring_mmap(struct sample_ring *ring, struct vm_area_struct *vma)
+{
+    if (vma->vm_pgoff != 0 || vma->vm_end - vma->vm_start > SAMPLE_RING_MMAP_SIZE)
+        return -EINVAL;
+
+    // Readers must not be able to corrupt the ring of the others.
+    if (vma->vm_flags & VM_WRITE)
+        return -EPERM;
+    vma->vm_flags &= ~VM_MAYWRITE;
+
+    return remap_vmalloc_range(vma, ring->header, 0);
+}
+
+/******************************************************************************
+ * Producer / Consumer
+******************************************************************************/
+
+/// @brief Gives the producer the slot of the next sample, with its sequence number
+///  already set. Must only be called from the (single) producer context, followed
+///  by sample_ring_commit() once the record is filled.
+struct mpu6050_record *sample_ring_reserve(struct sample_ring *ring)
+{
+    u32 head = ring->header->head;
+    struct mpu6050_record *record = &ring->slots[head & ring->mask];
+
+    record->seq = head;
+    return record;
+}
+
+/// @brief Publishes the record returned by sample_ring_reserve() and wakes up the readers.
+void sample_ring_commit(struct sample_ring *ring)
+{
+    // The slot must be visible before the new head.
+    smp_store_release(&ring->header->head, ring->header->head + 1);
+    wake_up_interruptible(&ring->wait);
+}
+
+/// @brief Copies the oldest sample not yet consumed by a reader.
+/// @param tail Reader position, updated on success.
+/// @param record Output record.
+/// @param dropped Incremented with the samples overwritten before the reader got to them.
+/// @return "0" on success, "-EAGAIN" if the ring is empty for this reader.
+int sample_ring_pop(struct sample_ring *ring, u32 *tail, struct mpu6050_record *record, u32 *dropped)
+{
+    u32 head;
+
+    for (;;) {
+        head = sample_ring_head(ring);
+        if (head == *tail)
+            return -EAGAIN;
+
+        // The producer may be rewriting the slot at 'head', so a reader only owns
+        // the last SAMPLE_RING_SLOTS - 1 samples.
+        if (head - *tail >= SAMPLE_RING_SLOTS) {
+            *dropped += head - *tail - (SAMPLE_RING_SLOTS - 1);
+            *tail = head - (SAMPLE_RING_SLOTS - 1);
+        }
+
+        *record = ring->slots[*tail & ring->mask];
+
+        // If the producer lapped us while copying, the data is torn: try again.
+        smp_rmb();
+        if (READ_ONCE(ring->header->head) - *tail < SAMPLE_RING_SLOTS) {
+            (*tail)++;
+            return 0;
+        }
+    }
+}
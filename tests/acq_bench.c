@@ -0,0 +1,476 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+#include <getopt.h>
+#include <time.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include "../driver/inc/uapi/lliano_mpu6050.h"
+#include "bench_stats.h"
+
+// Acquisition benchmark: reads /dev/MPU6050-2-68 with several access patterns, one
+// after the other, and prints a JSON document (see bench_stats.h) with the
+// throughput, read latency, sample age, inter-sample jitter, lost and duplicate
+// samples and CPU time of each one. sim/i2c_sim --json prints the same keys.
+
+#define PATTERN_BLOCKING    0   // read() of one record at a time
+#define PATTERN_BATCH       1   // read() of 'batch' records, watermark = batch
+#define PATTERN_POLL        2   // O_NONBLOCK read() after poll()
+#define PATTERN_MMAP        3   // Ring mapped with mmap(), poll() when empty
+#define PATTERNS            4
+
+static const char *pattern_names[PATTERNS] = { "blocking", "batch", "poll", "mmap" };
+
+// Module parameters copied into the report, to tell driver builds apart
+#define MODULE_PARAMS_DIR   "/sys/module/i2c_lucas/parameters/"
+static const char *module_params[] = { "acq_mode", "smplrt_div", "fifo_watermark", "dma_threshold" };
+
+#define POLL_TIMEOUT_MS     1000
+
+static struct {
+    const char *device;
+    const char *label;
+    double seconds;
+    unsigned int batch;
+    unsigned int watermark;
+    unsigned int patterns;
+} cfg = {
+    .device = "/dev/MPU6050-2-68",
+    .label = "",
+    .seconds = 5.0,
+    .batch = 32,
+    .watermark = 1,
+    .patterns = (1 << PATTERNS) - 1,
+};
+
+struct result {
+    int error;                  // errno of the failure, 0 if the pattern ran
+    __u64 wall_ns;
+    __u64 calls;                // read() or ring pops that returned samples
+    __u64 samples;
+    __u64 dropped;              // Gaps in 'seq'
+    __u64 duplicates;           // 'seq' not increasing
+    __u32 ring_dropped;         // mpu6050_ring_pop() count, mmap only
+    int have_last;
+    __u32 last_seq;
+    __u64 last_timestamp_ns;
+    struct bench_dist read_latency;
+    struct bench_dist age;
+    struct bench_dist interval;
+    __u64 cpu_ns;
+    struct rusage usage;
+};
+
+/******************************************************************************
+ * Accounting
+******************************************************************************/
+
+static __u64 clock_ns(clockid_t clock)
+{
+    struct timespec ts;
+
+    clock_gettime(clock, &ts);
+    return (__u64) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static __u64 now_ns(void)
+{
+    return clock_ns(CLOCK_MONOTONIC);
+}
+
+/// @brief Accounts for a record the reader got at 'got_ns' (CLOCK_MONOTONIC,
+///  like the record timestamps).
+static void account(struct result *res, const struct mpu6050_record *record, __u64 got_ns)
+{
+    __s32 gap = (__s32) (record->seq - res->last_seq);
+
+    if (res->have_last) {
+        if (gap <= 0)
+            res->duplicates++;
+        else
+            res->dropped += gap - 1;
+        if (gap == 1 && record->timestamp_ns > res->last_timestamp_ns)
+            bench_dist_add(&res->interval, record->timestamp_ns - res->last_timestamp_ns);
+    }
+    if (record->timestamp_ns != 0 && got_ns >= record->timestamp_ns)
+        bench_dist_add(&res->age, got_ns - record->timestamp_ns);
+
+    res->samples++;
+    res->have_last = 1;
+    res->last_seq = record->seq;
+    res->last_timestamp_ns = record->timestamp_ns;
+}
+
+/******************************************************************************
+ * Access patterns
+******************************************************************************/
+
+/// @brief read() of 'count' records, timed.
+/// @return Records read, or -errno.
+static int timed_read(int fd, struct result *res, struct mpu6050_record *records, unsigned int count)
+{
+    __u64 start = now_ns(), end;
+    ssize_t retval = read(fd, records, count * sizeof(*records));
+    unsigned int i;
+
+    end = now_ns();
+    if (retval < 0)
+        return -errno;
+
+    res->calls++;
+    bench_dist_add(&res->read_latency, end - start);
+    for (i = 0; i < retval / sizeof(*records); i++)
+        account(res, &records[i], end);
+    return retval / sizeof(*records);
+}
+
+static int run_blocking(int fd, struct result *res, __u64 end_ns)
+{
+    struct mpu6050_record record;
+    int retval;
+
+    while (now_ns() < end_ns) {
+        if ((retval = timed_read(fd, res, &record, 1)) < 0 && retval != -EINTR)
+            return retval;
+    }
+    return 0;
+}
+
+static int run_batch(int fd, struct result *res, __u64 end_ns)
+{
+    struct mpu6050_record *records = calloc(cfg.batch, sizeof(*records));
+    __u32 watermark = cfg.batch;
+    int retval = 0;
+
+    if (records == NULL)
+        return -ENOMEM;
+    if (ioctl(fd, MPU6050_IOC_SET_WATERMARK, &watermark) != 0) {
+        retval = -errno;
+        goto out;
+    }
+
+    while (now_ns() < end_ns) {
+        if ((retval = timed_read(fd, res, records, cfg.batch)) < 0 && retval != -EINTR)
+            goto out;
+    }
+    retval = 0;
+
+    out: free(records);
+    return retval;
+}
+
+static int run_poll(int fd, struct result *res, __u64 end_ns)
+{
+    struct mpu6050_record *records = calloc(cfg.batch, sizeof(*records));
+    struct pollfd pfd = { .fd = fd, .events = POLLIN };
+    __u32 watermark = cfg.watermark;
+    int retval = 0;
+
+    if (records == NULL)
+        return -ENOMEM;
+    if (fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK) != 0 ||
+            ioctl(fd, MPU6050_IOC_SET_WATERMARK, &watermark) != 0) {
+        retval = -errno;
+        goto out;
+    }
+
+    while (now_ns() < end_ns) {
+        if (poll(&pfd, 1, POLL_TIMEOUT_MS) < 0) {
+            if (errno == EINTR)
+                continue;
+            retval = -errno;
+            goto out;
+        }
+        // Drain what there is. In polled mode every read() succeeds, so the
+        // deadline has to be checked here too.
+        while (now_ns() < end_ns) {
+            if ((retval = timed_read(fd, res, records, cfg.batch)) == -EAGAIN)
+                break;
+            if (retval < 0 && retval != -EINTR)
+                goto out;
+        }
+    }
+    retval = 0;
+
+    out: free(records);
+    return retval;
+}
+
+static int run_mmap(int fd, struct result *res, __u64 end_ns)
+{
+    struct pollfd pfd = { .fd = fd, .events = POLLIN };
+    const struct mpu6050_ring_header *header;
+    struct mpu6050_record record;
+    __u32 watermark = cfg.watermark;
+    __u32 tail;
+    size_t page = sysconf(_SC_PAGESIZE), size;
+    void *base;
+    __u64 start, end;
+    int retval = 0;
+
+    // The first page tells the size of the whole mapping
+    if ((base = mmap(NULL, page, PROT_READ, MAP_SHARED, fd, 0)) == MAP_FAILED)
+        return -errno;
+    header = base;
+    size = header->mmap_size;
+    if (header->version != MPU6050_RECORD_VERSION || header->record_size != sizeof(record))
+        size = 0;
+    munmap(base, page);
+    if (size == 0)
+        return -EPROTO;
+    if ((base = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0)) == MAP_FAILED)
+        return -errno;
+    header = base;
+
+    if (ioctl(fd, MPU6050_IOC_SET_WATERMARK, &watermark) != 0) {
+        retval = -errno;
+        goto out;
+    }
+
+    tail = __atomic_load_n(&header->head, __ATOMIC_ACQUIRE);
+    while (now_ns() < end_ns) {
+        start = now_ns();
+        if (mpu6050_ring_pop(base, &tail, &record, &res->ring_dropped) == 0) {
+            if (poll(&pfd, 1, POLL_TIMEOUT_MS) < 0 && errno != EINTR) {
+                retval = -errno;
+                goto out;
+            }
+            continue;
+        }
+        end = now_ns();
+        res->calls++;
+        bench_dist_add(&res->read_latency, end - start);
+        account(res, &record, end);
+    }
+
+    out: munmap(base, size);
+    return retval;
+}
+
+static int (*const pattern_run[PATTERNS])(int fd, struct result *res, __u64 end_ns) = {
+    run_blocking, run_batch, run_poll, run_mmap,
+};
+
+/// @brief Runs a pattern on a freshly opened device for cfg.seconds.
+static void run_pattern(int pattern, struct result *res)
+{
+    struct rusage before, after;
+    __u64 start, cpu_start;
+    int fd;
+
+    memset(res, 0, sizeof(*res));
+    if ((fd = open(cfg.device, O_RDONLY)) == -1) {
+        res->error = errno;
+        return;
+    }
+
+    getrusage(RUSAGE_SELF, &before);
+    cpu_start = clock_ns(CLOCK_PROCESS_CPUTIME_ID);
+    start = now_ns();
+
+    res->error = -pattern_run[pattern](fd, res, start + cfg.seconds * 1e9);
+
+    res->wall_ns = now_ns() - start;
+    res->cpu_ns = clock_ns(CLOCK_PROCESS_CPUTIME_ID) - cpu_start;
+    getrusage(RUSAGE_SELF, &after);
+    res->usage.ru_utime.tv_sec = after.ru_utime.tv_sec - before.ru_utime.tv_sec;
+    res->usage.ru_utime.tv_usec = after.ru_utime.tv_usec - before.ru_utime.tv_usec;
+    res->usage.ru_stime.tv_sec = after.ru_stime.tv_sec - before.ru_stime.tv_sec;
+    res->usage.ru_stime.tv_usec = after.ru_stime.tv_usec - before.ru_stime.tv_usec;
+    res->usage.ru_nvcsw = after.ru_nvcsw - before.ru_nvcsw;
+    res->usage.ru_nivcsw = after.ru_nivcsw - before.ru_nivcsw;
+
+    close(fd);
+}
+
+/******************************************************************************
+ * Report
+******************************************************************************/
+
+static void json_string(FILE *out, const char *s)
+{
+    fputc('"', out);
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\')
+            fputc('\\', out);
+        if ((unsigned char) *s >= 0x20)
+            fputc(*s, out);
+    }
+    fputc('"', out);
+}
+
+static void print_params(FILE *out)
+{
+    char path[128], value[32];
+    size_t i;
+    int first = 1;
+    FILE *file;
+
+    fprintf(out, "  \"params\": {");
+    for (i = 0; i < sizeof(module_params) / sizeof(module_params[0]); i++) {
+        snprintf(path, sizeof(path), MODULE_PARAMS_DIR "%s", module_params[i]);
+        if ((file = fopen(path, "r")) == NULL)
+            continue;
+        if (fscanf(file, "%31s", value) == 1) {
+            fprintf(out, "%s\"%s\": ", first ? " " : ", ", module_params[i]);
+            json_string(out, value);
+            first = 0;
+        }
+        fclose(file);
+    }
+    fprintf(out, "%s},\n", first ? "" : " ");
+}
+
+static void print_result(FILE *out, int pattern, struct result *res)
+{
+    double seconds = res->wall_ns / 1e9;
+    __u64 samples = res->samples ? res->samples : 1;
+
+    fprintf(out, "    {\n      \"pattern\": \"%s\",\n", pattern_names[pattern]);
+    if (res->error != 0) {
+        fprintf(out, "      \"error\": ");
+        json_string(out, strerror(res->error));
+        fprintf(out, ",\n");
+    }
+    fprintf(out, "      \"seconds\": %.3f,\n", seconds);
+    fprintf(out, "      \"calls\": %llu,\n", (unsigned long long) res->calls);
+    fprintf(out, "      \"samples\": %llu,\n", (unsigned long long) res->samples);
+    fprintf(out, "      \"samples_per_s\": %.1f,\n", seconds > 0 ? res->samples / seconds : 0.0);
+    fprintf(out, "      \"dropped\": %llu,\n", (unsigned long long) res->dropped);
+    fprintf(out, "      \"duplicates\": %llu,\n", (unsigned long long) res->duplicates);
+    fprintf(out, "      \"ring_dropped\": %u,\n", res->ring_dropped);
+    fprintf(out, "      \"cpu_ns_per_sample\": %.1f,\n", (double) res->cpu_ns / samples);
+    fprintf(out, "      \"cpu_user_us\": %lld,\n",
+        res->usage.ru_utime.tv_sec * 1000000LL + res->usage.ru_utime.tv_usec);
+    fprintf(out, "      \"cpu_sys_us\": %lld,\n",
+        res->usage.ru_stime.tv_sec * 1000000LL + res->usage.ru_stime.tv_usec);
+    fprintf(out, "      \"context_switches\": %ld,\n", res->usage.ru_nvcsw + res->usage.ru_nivcsw);
+    fprintf(out, "      ");
+    bench_dist_json(out, "read_latency_ns", &res->read_latency);
+    fprintf(out, ",\n      ");
+    bench_dist_json(out, "sample_age_ns", &res->age);
+    fprintf(out, ",\n      ");
+    bench_dist_json(out, "interval_ns", &res->interval);
+    fprintf(out, "\n    }");
+}
+
+/******************************************************************************
+ * Main
+******************************************************************************/
+
+static void usage(const char *name)
+{
+    fprintf(stderr,
+        "usage: %s [options]\n"
+        "  -d, --device PATH        device to read (%s)\n"
+        "  -p, --patterns LIST      comma separated: blocking,batch,poll,mmap (all)\n"
+        "  -t, --seconds S          time spent on each pattern (%.0f)\n"
+        "  -b, --batch N            records per read() in batch and poll (%u)\n"
+        "  -w, --watermark N        samples that wake up poll and mmap (%u)\n"
+        "  -l, --label TEXT         copied into the report, to name the driver build\n"
+        "  -o, --output FILE        write the JSON there instead of stdout\n",
+        name, cfg.device, cfg.seconds, cfg.batch, cfg.watermark);
+}
+
+static int parse_patterns(const char *list)
+{
+    char *copy = strdup(list), *saveptr, *name;
+    int i;
+
+    cfg.patterns = 0;
+    for (name = strtok_r(copy, ",", &saveptr); name; name = strtok_r(NULL, ",", &saveptr)) {
+        for (i = 0; i < PATTERNS && strcmp(name, pattern_names[i]) != 0; i++)
+            ;
+        if (i == PATTERNS) {
+            free(copy);
+            return -1;
+        }
+        cfg.patterns |= 1 << i;
+    }
+    free(copy);
+    return cfg.patterns ? 0 : -1;
+}
+
+int main(int argc, char **argv)
+{
+    static const struct option options[] = {
+        { "device", required_argument, NULL, 'd' },
+        { "patterns", required_argument, NULL, 'p' },
+        { "seconds", required_argument, NULL, 't' },
+        { "batch", required_argument, NULL, 'b' },
+        { "watermark", required_argument, NULL, 'w' },
+        { "label", required_argument, NULL, 'l' },
+        { "output", required_argument, NULL, 'o' },
+        { "help", no_argument, NULL, 'h' },
+        { NULL, 0, NULL, 0 },
+    };
+    struct result res;
+    FILE *out = stdout;
+    int opt, pattern, first = 1, failed = 0;
+
+    while ((opt = getopt_long(argc, argv, "d:p:t:b:w:l:o:h", options, NULL)) != -1) {
+        switch (opt) {
+        case 'd': cfg.device = optarg; break;
+        case 'p':
+            if (parse_patterns(optarg) != 0)
+                goto usage;
+            break;
+        case 't': cfg.seconds = atof(optarg); break;
+        case 'b': cfg.batch = atoi(optarg); break;
+        case 'w': cfg.watermark = atoi(optarg); break;
+        case 'l': cfg.label = optarg; break;
+        case 'o':
+            if ((out = fopen(optarg, "w")) == NULL) {
+                perror(optarg);
+                return 2;
+            }
+            break;
+        default: goto usage;
+        }
+    }
+    if (cfg.seconds <= 0 || cfg.batch == 0 || cfg.watermark == 0)
+        goto usage;
+
+    fprintf(out, "{\n  \"source\": \"board\",\n  \"label\": ");
+    json_string(out, cfg.label);
+    fprintf(out, ",\n  \"device\": ");
+    json_string(out, cfg.device);
+    fprintf(out, ",\n  \"record_version\": %d,\n", MPU6050_RECORD_VERSION);
+    print_params(out);
+    fprintf(out, "  \"patterns\": [\n");
+
+    for (pattern = 0; pattern < PATTERNS; pattern++) {
+        if (!(cfg.patterns & (1 << pattern)))
+            continue;
+
+        fprintf(stderr, "%s: %gs...\n", pattern_names[pattern], cfg.seconds);
+        run_pattern(pattern, &res);
+        // There is no ring to map in polled mode
+        if (res.error != 0 && !(pattern == PATTERN_MMAP && res.error == ENODEV)) {
+            fprintf(stderr, "%s: %s\n", pattern_names[pattern], strerror(res.error));
+            failed = 1;
+        }
+        failed |= res.duplicates != 0;
+
+        fprintf(out, "%s", first ? "" : ",\n");
+        print_result(out, pattern, &res);
+        first = 0;
+
+        bench_dist_free(&res.read_latency);
+        bench_dist_free(&res.age);
+        bench_dist_free(&res.interval);
+    }
+
+    fprintf(out, "\n  ]\n}\n");
+    if (out != stdout)
+        fclose(out);
+    return failed;
+
+    usage: usage(argv[0]);
+    return 2;
+}
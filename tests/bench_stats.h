@@ -0,0 +1,97 @@
+#ifndef BENCH_STATS_H
+#define BENCH_STATS_H
+
+// Distributions and JSON output shared by acq_bench (on the board) and
+// sim/i2c_sim (on the host), so both produce the same document and their
+// results can be compared key by key:
+//
+//   {
+//     "source": "board" | "sim", "label": "...", "params": { ... },
+//     "patterns": [ {
+//       "pattern": "blocking", "seconds": 5.0, "calls": N, "samples": N,
+//       "samples_per_s": F, "dropped": N, "duplicates": N, "cpu_ns_per_sample": F,
+//       "read_latency_ns": DIST, "sample_age_ns": DIST, "interval_ns": DIST, ...
+//     }, ... ]
+//   }
+//
+// where DIST is { "count", "mean", "stddev", "min", "p50", "p99", "p999", "max" }.
+// read_latency_ns is how long each read() (or ring pop) took, sample_age_ns the
+// time from a record's timestamp until the reader got it and interval_ns the
+// time between the timestamps of consecutive samples (its stddev is the jitter).
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+
+struct bench_dist {
+    uint64_t *values;
+    size_t count;
+    size_t size;
+};
+
+static inline void bench_dist_add(struct bench_dist *dist, uint64_t value)
+{
+    uint64_t *values;
+
+    if (dist->count == dist->size) {
+        values = realloc(dist->values, (dist->size ? 2 * dist->size : 4096) * sizeof(*values));
+        if (values == NULL)
+            return;
+        dist->values = values;
+        dist->size = dist->size ? 2 * dist->size : 4096;
+    }
+    dist->values[dist->count++] = value;
+}
+
+static inline void bench_dist_free(struct bench_dist *dist)
+{
+    free(dist->values);
+    dist->values = NULL;
+    dist->count = dist->size = 0;
+}
+
+static inline int bench_u64_cmp(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *) a, y = *(const uint64_t *) b;
+
+    return (x > y) - (x < y);
+}
+
+/// @brief Nearest rank percentile of a sorted distribution.
+static inline uint64_t bench_percentile(const struct bench_dist *dist, double pct)
+{
+    size_t rank = (size_t) ceil(pct / 100.0 * dist->count);
+
+    return dist->values[rank ? rank - 1 : 0];
+}
+
+/// @brief Prints '"name": DIST' (sorting the values).
+static inline void bench_dist_json(FILE *out, const char *name, struct bench_dist *dist)
+{
+    double sum = 0, sq = 0, mean;
+    size_t i;
+
+    if (dist->count == 0) {
+        fprintf(out, "\"%s\": { \"count\": 0 }", name);
+        return;
+    }
+
+    qsort(dist->values, dist->count, sizeof(*dist->values), bench_u64_cmp);
+    for (i = 0; i < dist->count; i++)
+        sum += dist->values[i];
+    mean = sum / dist->count;
+    for (i = 0; i < dist->count; i++)
+        sq += (dist->values[i] - mean) * (dist->values[i] - mean);
+
+    fprintf(out, "\"%s\": { \"count\": %zu, \"mean\": %.1f, \"stddev\": %.1f, \"min\": %llu, "
+        "\"p50\": %llu, \"p99\": %llu, \"p999\": %llu, \"max\": %llu }",
+        name, dist->count, mean, sqrt(sq / dist->count),
+        (unsigned long long) dist->values[0],
+        (unsigned long long) bench_percentile(dist, 50),
+        (unsigned long long) bench_percentile(dist, 99),
+        (unsigned long long) bench_percentile(dist, 99.9),
+        (unsigned long long) dist->values[dist->count - 1]);
+}
+
+#endif // BENCH_STATS_H
@@ -0,0 +1,670 @@
+#include <string.h>
+#include "sim.h"
+
+// Register level model of the AM335x I2C controllers in master mode (TRM chapter
+// 21), each with its own registers, bus and interrupt line. Only what the driver
+// uses is modelled: the FIFOs with their thresholds, the data count, START /
+// repeated START / STOP, the IRQ status bits and the DMA requests. Bus timing
+// comes from PSC, SCLL and SCLH, plus the SCL rise time (sim_opts.scl_rise_ns):
+//   tLOW  = (SCLL + 7) * (PSC + 1) / 48MHz
+//   tHIGH = (SCLH + 5) * (PSC + 1) / 48MHz + t_rise
+// A byte takes 9 bit times (ACK included), START and STOP one each. When the
+// TX FIFO is empty or the RX FIFO is full, SCL is held low until the CPU (or
+// EDMA) catches up, as the real controller does. With --glitch-every some
+// address phases leave a slave holding SDA low (arbitration lost) until SCL is
+// pulsed through the SYSTEST IO mode. With --nack-every some are NACKed (some
+// data bytes written, with --data-nack-every), and with --stretch-every the
+// slave holds SCL low after some address bytes.
+
+#define FCLK_HZ         48000000ULL
+#define FIFO_DEPTH      32
+#define UNTIL_NEVER     UINT64_MAX
+
+// Registers
+#define REG_SYSC            0x10
+#define REG_IRQSTATUS_RAW   0x24
+#define REG_IRQSTATUS       0x28
+#define REG_IRQENABLE_SET   0x2C
+#define REG_IRQENABLE_CLR   0x30
+#define REG_DMARXENABLE_SET 0x38
+#define REG_DMATXENABLE_SET 0x3C
+#define REG_DMARXENABLE_CLR 0x40
+#define REG_DMATXENABLE_CLR 0x44
+#define REG_SYSS            0x90
+#define REG_BUF             0x94
+#define REG_CNT             0x98
+#define REG_DATA            0x9C
+#define REG_CON             0xA4
+#define REG_SA              0xAC
+#define REG_PSC             0xB0
+#define REG_SCLL            0xB4
+#define REG_SCLH            0xB8
+#define REG_SYSTEST         0xBC
+#define REG_BUFSTAT         0xC0
+
+#define SYSC_SRST           (1 << 1)
+#define SYSS_RDONE          (1 << 0)
+
+#define SYSTEST_ST_EN       (1 << 15)
+#define SYSTEST_TMODE_IO    (3 << 12)
+#define SYSTEST_SCL_I       (1 << 3)
+#define SYSTEST_SCL_O       (1 << 2)
+#define SYSTEST_SDA_I       (1 << 1)
+#define SYSTEST_SDA_O       (1 << 0)
+#define SYSTEST_IO(reg)     (((reg) & (SYSTEST_ST_EN | SYSTEST_TMODE_IO)) == (SYSTEST_ST_EN | SYSTEST_TMODE_IO))
+
+// SCL pulses a slave that lost the clock needs to let SDA go (the rest of its byte)
+#define STUCK_PULSES        5
+
+#define CON_EN              (1 << 15)
+#define CON_MST             (1 << 10)
+#define CON_TRX             (1 << 9)
+#define CON_STP             (1 << 1)
+#define CON_STT             (1 << 0)
+
+#define IRQ_XDR             (1 << 14)
+#define IRQ_RDR             (1 << 13)
+#define IRQ_BB              (1 << 12)
+#define IRQ_BF              (1 << 8)
+#define IRQ_XRDY            (1 << 4)
+#define IRQ_RRDY            (1 << 3)
+#define IRQ_ARDY            (1 << 2)
+#define IRQ_NACK            (1 << 1)
+#define IRQ_AL              (1 << 0)
+#define IRQ_LEVELS          (IRQ_XDR | IRQ_RDR | IRQ_XRDY | IRQ_RRDY)
+#define IRQ_ALL             0x7FFF
+
+#define BUF_RDMA_EN         (1 << 15)
+#define BUF_RXFIFO_CLR      (1 << 14)
+#define BUF_RXTRSH(reg)     ((((reg) >> 8) & 0x3F) + 1)
+#define BUF_XDMA_EN         (1 << 7)
+#define BUF_TXFIFO_CLR      (1 << 6)
+#define BUF_TXTRSH(reg)     (((reg) & 0x3F) + 1)
+
+enum bus_state {
+    BUS_IDLE,
+    BUS_START,      // START or repeated START on the wire
+    BUS_ADDR,       // Address byte
+    BUS_DATA,       // Data byte, or SCL held low waiting for the FIFO
+    BUS_HOLD,       // Phase over without STOP (or NACKed): SCL held low
+    BUS_STOP,
+};
+
+struct am335x_i2c {
+    bool present;               // Reset by the harness
+
+    // Registers
+    uint32_t con, sa, cnt, buf, psc, scll, sclh, systest;
+    uint32_t irq_raw, irq_enable;
+    bool dma_rx_enable, dma_tx_enable;
+
+    // FIFOs
+    uint8_t tx_fifo[FIFO_DEPTH];
+    uint32_t tx_head, tx_level;
+    uint8_t rx_fifo[FIFO_DEPTH];
+    uint32_t rx_head, rx_level;
+
+    // Bus
+    enum bus_state state;
+    uint64_t step_end;          // End of the current bus step, UNTIL_NEVER while held
+    uint64_t busy_since;        // START of the current transaction
+    uint64_t held_since;        // SCL held low since, while waiting for the CPU
+    bool transmit;              // Direction of the current phase
+    bool stop;                  // STOP at the end of the current phase
+    bool nacked;
+    bool stretched;             // The slave already stretched this address byte
+    uint32_t count;             // Bytes of the current phase
+    uint32_t moved;             // Bytes of the phase done on the bus
+    uint32_t loaded;            // Bytes of the write phase that got to the TX FIFO
+    uint8_t shift;              // Byte being transmitted
+
+    // A slave holding SDA low after a glitch. It belongs to the bus, so a soft
+    // reset of the controller doesn't clear it: only SCL pulses do.
+    bool sda_stuck;
+    uint32_t stuck_pulses;
+
+    const struct sim_i2c_target *targets[4];
+    const struct sim_i2c_target *target;
+};
+
+// Address phases of every controller, for --glitch-every, --nack-every and --stretch-every
+static uint64_t addr_phases;
+static uint64_t addr_phases_nack;
+static uint64_t tx_bytes_nack;
+static uint64_t addr_phases_stretch;
+
+// By controller number: I2C0, I2C1 and I2C2
+static struct am335x_i2c controllers[AM335X_I2C_COUNT];
+
+/******************************************************************************
+ * Helpers
+******************************************************************************/
+
+/// @brief Duration of one SCL period. The high time is only counted once SCL is
+///  seen high, so the rise time adds to it.
+static uint64_t bit_ns(struct am335x_i2c *i2c)
+{
+    uint64_t cycles = (uint64_t) ((i2c->scll & 0xFF) + 7 + (i2c->sclh & 0xFF) + 5) * ((i2c->psc & 0xFF) + 1);
+
+    return cycles * 1000000000ULL / FCLK_HZ + sim_opts.scl_rise_ns;
+}
+
+static bool phase_active(struct am335x_i2c *i2c)
+{
+    return i2c->state == BUS_START || i2c->state == BUS_ADDR || i2c->state == BUS_DATA;
+}
+
+/// @brief Recomputes the FIFO threshold status bits, which follow the FIFO levels.
+static void update_levels(struct am335x_i2c *i2c)
+{
+    uint32_t tx_thr = BUF_TXTRSH(i2c->buf);
+    uint32_t rx_thr = BUF_RXTRSH(i2c->buf);
+    uint32_t tx_left = i2c->count - i2c->loaded;
+    uint32_t tx_free = FIFO_DEPTH - i2c->tx_level;
+
+    i2c->irq_raw &= ~IRQ_LEVELS;
+
+    if (phase_active(i2c) && i2c->transmit && !i2c->nacked && tx_left != 0) {
+        if (tx_left >= tx_thr && tx_free >= tx_thr)
+            i2c->irq_raw |= IRQ_XRDY;
+        else if (tx_left < tx_thr && tx_free >= tx_left)
+            i2c->irq_raw |= IRQ_XDR;
+    }
+
+    if (i2c->rx_level >= rx_thr)
+        i2c->irq_raw |= IRQ_RRDY;
+    else if (i2c->rx_level != 0 && !i2c->transmit && i2c->moved == i2c->count)
+        i2c->irq_raw |= IRQ_RDR;
+}
+
+static void hold_scl(struct am335x_i2c *i2c, uint64_t t)
+{
+    i2c->step_end = UNTIL_NEVER;
+    i2c->held_since = t;
+}
+
+static void release_scl(struct am335x_i2c *i2c, uint64_t t)
+{
+    if (i2c->held_since != UNTIL_NEVER)
+        sim_stats.bus_stall_ns += t - i2c->held_since;
+    i2c->held_since = UNTIL_NEVER;
+}
+
+static void tx_fifo_push(struct am335x_i2c *i2c, uint8_t byte)
+{
+    if (i2c->tx_level == FIFO_DEPTH) {
+        sim_stats.fifo_errors++;
+        return;
+    }
+    i2c->tx_fifo[(i2c->tx_head + i2c->tx_level++) % FIFO_DEPTH] = byte;
+    i2c->loaded++;
+}
+
+static uint8_t rx_fifo_pop(struct am335x_i2c *i2c)
+{
+    uint8_t byte;
+
+    if (i2c->rx_level == 0) {
+        sim_stats.fifo_errors++;
+        return 0;
+    }
+    byte = i2c->rx_fifo[i2c->rx_head];
+    i2c->rx_head = (i2c->rx_head + 1) % FIFO_DEPTH;
+    i2c->rx_level--;
+    return byte;
+}
+
+static void clear_fifos(struct am335x_i2c *i2c, uint32_t buf)
+{
+    if (buf & BUF_TXFIFO_CLR)
+        i2c->tx_head = i2c->tx_level = 0;
+    if (buf & BUF_RXFIFO_CLR)
+        i2c->rx_head = i2c->rx_level = 0;
+}
+
+/******************************************************************************
+ * Bus state machine
+******************************************************************************/
+
+static void next_byte(struct am335x_i2c *i2c, uint64_t t);
+
+/// @brief Serves the DMA requests of the controller. The bytes move at once.
+static void dma_requests(struct am335x_i2c *i2c)
+{
+    int byte;
+
+    if ((i2c->buf & BUF_XDMA_EN) && i2c->dma_tx_enable && phase_active(i2c) && i2c->transmit) {
+        while (i2c->tx_level < FIFO_DEPTH && i2c->loaded < i2c->count && (byte = sim_edma_pull(SIM_EDMA_TX)) >= 0)
+            tx_fifo_push(i2c, byte);
+    }
+    if ((i2c->buf & BUF_RDMA_EN) && i2c->dma_rx_enable) {
+        while (i2c->rx_level != 0 && sim_edma_push(SIM_EDMA_RX, i2c->rx_fifo[i2c->rx_head]))
+            rx_fifo_pop(i2c);
+    }
+}
+
+/// @brief Lets EDMA move data after a change of its channels or of the controller.
+static void edma_service(struct am335x_i2c *i2c)
+{
+    dma_requests(i2c);
+
+    // The FIFO may have been waited on
+    if (i2c->state == BUS_DATA && i2c->step_end == UNTIL_NEVER)
+        next_byte(i2c, sim_now_ns);
+    update_levels(i2c);
+}
+
+/// @brief Another master won the bus (or SDA was held low): the controller drops
+///  out of master mode, and the bus stays busy until a STOP shows up.
+static void lose_arbitration(struct am335x_i2c *i2c, uint64_t t)
+{
+    release_scl(i2c, t);
+    i2c->irq_raw |= IRQ_AL;
+    i2c->con &= ~(CON_MST | CON_STT | CON_STP);
+    i2c->state = BUS_IDLE;
+    i2c->step_end = UNTIL_NEVER;
+    i2c->sda_stuck = true;
+    i2c->stuck_pulses = 0;
+    sim_stats.arbitration_lost++;
+}
+
+/// @brief Starts a phase programmed through CON and CNT, at time 't'.
+static void begin_phase(struct am335x_i2c *i2c, uint64_t t, bool repeated)
+{
+    if (repeated)
+        sim_stats.repeated_starts++;
+    else {
+        sim_stats.transactions++;
+        i2c->busy_since = t;
+        i2c->irq_raw |= IRQ_BB;
+    }
+    if (i2c->sda_stuck) {
+        lose_arbitration(i2c, t);
+        return;
+    }
+
+    i2c->transmit = (i2c->con & CON_TRX) != 0;
+    i2c->stop = (i2c->con & CON_STP) != 0;
+    i2c->count = i2c->cnt ? i2c->cnt : 65536;
+    i2c->moved = 0;
+    i2c->loaded = 0;
+    i2c->nacked = false;
+    i2c->target = NULL;
+    i2c->state = BUS_START;
+    i2c->step_end = t + bit_ns(i2c);
+    edma_service(i2c);
+}
+
+/// @brief Puts the next data byte of the phase on the bus, or ends the phase.
+static void next_byte(struct am335x_i2c *i2c, uint64_t t)
+{
+    dma_requests(i2c);
+
+    if (i2c->moved == i2c->count) {
+        if (i2c->stop) {
+            i2c->state = BUS_STOP;
+            i2c->step_end = t + bit_ns(i2c);
+        } else {
+            i2c->state = BUS_HOLD;
+            i2c->irq_raw |= IRQ_ARDY;
+            hold_scl(i2c, t);
+        }
+        return;
+    }
+
+    i2c->state = BUS_DATA;
+    if (i2c->transmit) {
+        if (i2c->tx_level == 0) {
+            if (i2c->held_since == UNTIL_NEVER)
+                hold_scl(i2c, t);
+            return;
+        }
+        release_scl(i2c, t);
+        i2c->shift = i2c->tx_fifo[i2c->tx_head];
+        i2c->tx_head = (i2c->tx_head + 1) % FIFO_DEPTH;
+        i2c->tx_level--;
+    } else {
+        if (i2c->rx_level == FIFO_DEPTH) {
+            if (i2c->held_since == UNTIL_NEVER)
+                hold_scl(i2c, t);
+            return;
+        }
+        release_scl(i2c, t);
+    }
+    i2c->step_end = t + 9 * bit_ns(i2c);
+}
+
+/// @brief Finishes the bus step that ended at 't'.
+static void end_step(struct am335x_i2c *i2c, uint64_t t)
+{
+    const struct sim_i2c_target *target;
+    unsigned int i;
+    bool busy;
+
+    mpu6050_model_sync(t);
+
+    switch (i2c->state) {
+    case BUS_START:
+        i2c->con &= ~CON_STT;
+        i2c->state = BUS_ADDR;
+        i2c->step_end = t + 9 * bit_ns(i2c);
+        break;
+
+    case BUS_ADDR:
+        // A slave that takes its time, holding SCL low before the ACK
+        if (sim_opts.stretch_every != 0 && !i2c->stretched
+                && ++addr_phases_stretch % sim_opts.stretch_every == 0) {
+            i2c->stretched = true;
+            i2c->step_end = t + (uint64_t) sim_opts.stretch_us * 1000;
+            sim_stats.stretches++;
+            break;
+        }
+        i2c->stretched = false;
+
+        // A glitch on the wire: the slave gets out of step and holds SDA low,
+        // which looks like a lost arbitration
+        if (sim_opts.glitch_every != 0 && ++addr_phases % sim_opts.glitch_every == 0) {
+            sim_stats.glitches++;
+            lose_arbitration(i2c, t);
+            break;
+        }
+        // A slave too busy to answer its address
+        busy = sim_opts.nack_every != 0 && ++addr_phases_nack % sim_opts.nack_every == 0;
+        sim_stats.nacks_injected += busy;
+        for (i = 0; i < 4 && !busy; i++) {
+            target = i2c->targets[i];
+            if (target != NULL && target->addr == (i2c->sa & 0x7F) && target->start(target->context, !i2c->transmit)) {
+                i2c->target = target;
+                break;
+            }
+        }
+        if (i2c->target == NULL) {
+            i2c->nacked = true;
+            i2c->irq_raw |= IRQ_NACK;
+            sim_stats.nacks++;
+            i2c->state = BUS_HOLD;
+            hold_scl(i2c, t);
+            break;
+        }
+        next_byte(i2c, t);
+        break;
+
+    case BUS_DATA:
+        i2c->moved++;
+        if (i2c->transmit) {
+            sim_stats.bytes_tx++;
+            busy = sim_opts.data_nack_every != 0 && ++tx_bytes_nack % sim_opts.data_nack_every == 0;
+            sim_stats.nacks_injected += busy;
+            if (busy || !i2c->target->write(i2c->target->context, i2c->shift)) {
+                i2c->nacked = true;
+                i2c->irq_raw |= IRQ_NACK;
+                sim_stats.nacks++;
+                i2c->state = BUS_HOLD;
+                hold_scl(i2c, t);
+                break;
+            }
+        } else {
+            sim_stats.bytes_rx++;
+            i2c->rx_fifo[(i2c->rx_head + i2c->rx_level++) % FIFO_DEPTH] = i2c->target->read(i2c->target->context);
+        }
+        next_byte(i2c, t);
+        break;
+
+    case BUS_STOP:
+        if (i2c->target != NULL)
+            i2c->target->stop(i2c->target->context);
+        i2c->con &= ~(CON_STP | CON_MST);
+        i2c->state = BUS_IDLE;
+        i2c->step_end = UNTIL_NEVER;
+        i2c->irq_raw &= ~IRQ_BB;
+        i2c->irq_raw |= IRQ_BF;
+        if (!i2c->nacked)
+            i2c->irq_raw |= IRQ_ARDY;
+        sim_stats.bus_busy_ns += t - i2c->busy_since;
+        break;
+
+    default:
+        i2c->step_end = UNTIL_NEVER;
+        break;
+    }
+}
+
+/******************************************************************************
+ * Interface
+******************************************************************************/
+
+/// @brief Soft reset: the registers and the bus go back to idle, the targets stay.
+static void i2c_reset(struct am335x_i2c *i2c)
+{
+    const struct sim_i2c_target *targets[4];
+    bool sda_stuck = i2c->sda_stuck;
+    uint32_t stuck_pulses = i2c->stuck_pulses;
+
+    memcpy(targets, i2c->targets, sizeof(targets));
+    memset(i2c, 0, sizeof(*i2c));
+    memcpy(i2c->targets, targets, sizeof(targets));
+    i2c->sda_stuck = sda_stuck;
+    i2c->stuck_pulses = stuck_pulses;
+    i2c->present = true;
+    i2c->step_end = UNTIL_NEVER;
+    i2c->held_since = UNTIL_NEVER;
+}
+
+void am335x_i2c_reset(unsigned int n)
+{
+    memset(&controllers[n], 0, sizeof(controllers[n]));
+    i2c_reset(&controllers[n]);
+}
+
+void am335x_i2c_attach(unsigned int n, const struct sim_i2c_target *target)
+{
+    struct am335x_i2c *i2c = &controllers[n];
+    unsigned int i;
+
+    for (i = 0; i < 4; i++) {
+        if (i2c->targets[i] == NULL) {
+            i2c->targets[i] = target;
+            return;
+        }
+    }
+}
+
+/// @brief Runs a bus up to 'now_ns'.
+static void i2c_sync(struct am335x_i2c *i2c, uint64_t now_ns)
+{
+    while (i2c->step_end <= now_ns)
+        end_step(i2c, i2c->step_end);
+    update_levels(i2c);
+}
+
+/// @brief Runs every bus up to 'now_ns'.
+void am335x_i2c_sync(uint64_t now_ns)
+{
+    unsigned int n;
+
+    for (n = 0; n < AM335X_I2C_COUNT; n++) {
+        if (controllers[n].present)
+            i2c_sync(&controllers[n], now_ns);
+    }
+}
+
+uint64_t am335x_i2c_next_event(void)
+{
+    uint64_t next = UNTIL_NEVER;
+    unsigned int n;
+
+    for (n = 0; n < AM335X_I2C_COUNT; n++) {
+        if (controllers[n].present && controllers[n].step_end < next)
+            next = controllers[n].step_end;
+    }
+    return next;
+}
+
+bool am335x_i2c_irq_line(unsigned int n)
+{
+    return (controllers[n].irq_raw & controllers[n].irq_enable) != 0;
+}
+
+void am335x_i2c_edma_service(void)
+{
+    unsigned int n;
+
+    for (n = 0; n < AM335X_I2C_COUNT; n++) {
+        if (controllers[n].present)
+            edma_service(&controllers[n]);
+    }
+}
+
+/// @brief In the SDA/SCL IO test mode the lines follow SCL_O and SDA_O. A stuck
+///  slave lets SDA go after STUCK_PULSES, and SDA rising while SCL is high is a
+///  STOP, which frees the bus.
+static void systest_write(struct am335x_i2c *i2c, uint32_t value)
+{
+    bool scl_was = !SYSTEST_IO(i2c->systest) || (i2c->systest & SYSTEST_SCL_O);
+    bool sda_was = !SYSTEST_IO(i2c->systest) || (i2c->systest & SYSTEST_SDA_O);
+    bool scl = !SYSTEST_IO(value) || (value & SYSTEST_SCL_O);
+    bool sda = !SYSTEST_IO(value) || (value & SYSTEST_SDA_O);
+
+    i2c->systest = value & ~(SYSTEST_SCL_I | SYSTEST_SDA_I);
+    if (!SYSTEST_IO(value))
+        return;
+
+    if (!scl_was && scl) {
+        sim_stats.recovery_pulses++;
+        if (i2c->sda_stuck && ++i2c->stuck_pulses >= STUCK_PULSES)
+            i2c->sda_stuck = false;
+    }
+    if (scl_was && scl && !sda_was && sda && !i2c->sda_stuck && (i2c->irq_raw & IRQ_BB)) {
+        sim_stats.bus_busy_ns += sim_now_ns - i2c->busy_since;
+        i2c->irq_raw &= ~IRQ_BB;
+        i2c->irq_raw |= IRQ_BF;
+    }
+}
+
+uint32_t am335x_i2c_read(unsigned int n, uint32_t offset)
+{
+    struct am335x_i2c *i2c = &controllers[n];
+    uint32_t value;
+
+    i2c_sync(i2c, sim_now_ns);
+
+    switch (offset) {
+    case REG_IRQSTATUS_RAW: return i2c->irq_raw;
+    case REG_IRQSTATUS: return i2c->irq_raw & i2c->irq_enable;
+    case REG_IRQENABLE_SET:
+    case REG_IRQENABLE_CLR: return i2c->irq_enable;
+    case REG_SYSS: return SYSS_RDONE;
+    case REG_BUF: return i2c->buf;
+    case REG_CNT: return (phase_active(i2c) || i2c->state == BUS_HOLD) ? i2c->count - i2c->moved : i2c->cnt;
+    case REG_CON: return i2c->con;
+    case REG_SA: return i2c->sa;
+    case REG_PSC: return i2c->psc;
+    case REG_SCLL: return i2c->scll;
+    case REG_SCLH: return i2c->sclh;
+    case REG_SYSTEST:
+        value = i2c->systest & ~(SYSTEST_SCL_I | SYSTEST_SDA_I);
+        if (!SYSTEST_IO(i2c->systest) || (i2c->systest & SYSTEST_SCL_O))
+            value |= SYSTEST_SCL_I;
+        if ((!SYSTEST_IO(i2c->systest) || (i2c->systest & SYSTEST_SDA_O)) && !i2c->sda_stuck)
+            value |= SYSTEST_SDA_I;
+        return value;
+    case REG_BUFSTAT:
+        value = (2 << 14) | (i2c->rx_level << 8);
+        if (i2c->transmit && phase_active(i2c))
+            value |= i2c->count - i2c->loaded;
+        return value;
+
+    case REG_DATA:
+        value = rx_fifo_pop(i2c);
+        if (i2c->state == BUS_DATA && !i2c->transmit && i2c->step_end == UNTIL_NEVER)
+            next_byte(i2c, sim_now_ns);
+        update_levels(i2c);
+        return value;
+
+    default:
+        return 0;
+    }
+}
+
+void am335x_i2c_write(unsigned int n, uint32_t offset, uint32_t value)
+{
+    struct am335x_i2c *i2c = &controllers[n];
+
+    i2c_sync(i2c, sim_now_ns);
+
+    switch (offset) {
+    case REG_SYSC:
+        if (value & SYSC_SRST) {
+            sim_stats.bus_busy_ns += (i2c->irq_raw & IRQ_BB) ? sim_now_ns - i2c->busy_since : 0;
+            i2c_reset(i2c);
+        }
+        break;
+
+    case REG_IRQSTATUS:
+        i2c->irq_raw &= ~(value & IRQ_ALL & ~IRQ_BB);
+        break;
+    case REG_IRQENABLE_SET: i2c->irq_enable |= value & IRQ_ALL; break;
+    case REG_IRQENABLE_CLR: i2c->irq_enable &= ~value; break;
+    case REG_DMARXENABLE_SET: i2c->dma_rx_enable = value & 1; break;
+    case REG_DMATXENABLE_SET: i2c->dma_tx_enable = value & 1; break;
+    case REG_DMARXENABLE_CLR: if (value & 1) i2c->dma_rx_enable = false; break;
+    case REG_DMATXENABLE_CLR: if (value & 1) i2c->dma_tx_enable = false; break;
+
+    case REG_BUF:
+        clear_fifos(i2c, value);
+        i2c->buf = value & ~(BUF_TXFIFO_CLR | BUF_RXFIFO_CLR);
+        break;
+
+    case REG_CNT: i2c->cnt = value & 0xFFFF; break;
+    case REG_SA: i2c->sa = value & 0x3FF; break;
+    case REG_PSC: i2c->psc = value; break;
+    case REG_SCLL: i2c->scll = value; break;
+    case REG_SCLH: i2c->sclh = value; break;
+    case REG_SYSTEST: systest_write(i2c, value); break;
+
+    case REG_DATA:
+        if (phase_active(i2c) && i2c->transmit && i2c->loaded < i2c->count)
+            tx_fifo_push(i2c, value);
+        else
+            sim_stats.fifo_errors++;
+        if (i2c->state == BUS_DATA && i2c->transmit && i2c->step_end == UNTIL_NEVER)
+            next_byte(i2c, sim_now_ns);
+        break;
+
+    case REG_CON:
+        i2c->con = value;
+        if (!(value & CON_EN)) {
+            if (i2c->irq_raw & IRQ_BB)
+                sim_stats.bus_busy_ns += sim_now_ns - i2c->busy_since;
+            i2c->state = BUS_IDLE;
+            i2c->step_end = UNTIL_NEVER;
+            i2c->held_since = UNTIL_NEVER;
+            i2c->irq_raw &= ~IRQ_BB;
+            break;
+        }
+        if ((value & (CON_STT | CON_MST)) == (CON_STT | CON_MST)) {
+            if (i2c->state == BUS_IDLE)
+                begin_phase(i2c, sim_now_ns, false);
+            else if (i2c->state == BUS_HOLD) {
+                release_scl(i2c, sim_now_ns);
+                begin_phase(i2c, sim_now_ns, true);
+            }
+        } else if ((value & CON_STP) && i2c->state == BUS_HOLD) {
+            release_scl(i2c, sim_now_ns);
+            i2c->state = BUS_STOP;
+            i2c->step_end = sim_now_ns + bit_ns(i2c);
+        } else if (value & CON_STP) {
+            // Abort: STOP after the byte on the wire
+            i2c->stop = true;
+            i2c->count = i2c->moved + (i2c->state == BUS_DATA && i2c->step_end != UNTIL_NEVER);
+            if (i2c->state == BUS_DATA && i2c->step_end == UNTIL_NEVER)
+                next_byte(i2c, sim_now_ns);
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    edma_service(i2c);
+}
@@ -0,0 +1,759 @@
+#ifndef SIM_KERNEL_H
+#define SIM_KERNEL_H
+
+// The part of the kernel API used by driver/src, implemented on top of the
+// simulated machine (sim.h) so the driver runs unmodified on the host. Every
+// header under linux/ and asm/ just includes this one.
+//
+// There is a single thread. Code "sleeps" by letting modelled time go by, which
+// is when interrupts, DMA completions, threaded handlers and work items run. A
+// spinlock taken twice or a sleep with interrupts off is a bug in the driver
+// and aborts the simulation.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <sys/types.h>
+#include "sim.h"
+
+/******************************************************************************
+ * Types and compiler helpers
+******************************************************************************/
+
+typedef uint8_t u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef unsigned long long u64;
+typedef int8_t s8;
+typedef int16_t s16;
+typedef int32_t s32;
+typedef long long s64;
+typedef u8 __u8;
+typedef u16 __u16;
+typedef u32 __u32;
+typedef u64 __u64;
+typedef s8 __s8;
+typedef s16 __s16;
+typedef s32 __s32;
+typedef s64 __s64;
+typedef s64 ktime_t;
+typedef unsigned int gfp_t;
+typedef unsigned short umode_t;
+typedef u64 dma_addr_t;
+typedef u64 phys_addr_t;
+typedef u64 resource_size_t;
+
+#define __iomem
+#define __user
+#define __init
+#define __exit
+#define __force
+#define __must_check
+#define __maybe_unused          __attribute__((unused))
+#define __packed                __attribute__((packed))
+#define likely(x)               __builtin_expect(!!(x), 1)
+#define unlikely(x)             __builtin_expect(!!(x), 0)
+#define READ_ONCE(x)            (*(volatile typeof(x) *) &(x))
+#define WRITE_ONCE(x, v)        (*(volatile typeof(x) *) &(x) = (v))
+#define smp_load_acquire(p)     __atomic_load_n(p, __ATOMIC_ACQUIRE)
+#define smp_store_release(p, v) __atomic_store_n(p, v, __ATOMIC_RELEASE)
+#define smp_rmb()               __atomic_thread_fence(__ATOMIC_ACQUIRE)
+#define smp_wmb()               __atomic_thread_fence(__ATOMIC_RELEASE)
+#define smp_mb()                __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+#define U16_MAX                 ((u16) ~0U)
+#define BIT(n)                  (1UL << (n))
+#define BITS_PER_LONG           (8 * sizeof(long))
+#define ARRAY_SIZE(a)           (sizeof(a) / sizeof((a)[0]))
+#define DIV_ROUND_UP(n, d)      (((n) + (d) - 1) / (d))
+#define container_of(ptr, type, member) ((type *) ((char *) (ptr) - offsetof(type, member)))
+#define min(a, b)               ((a) < (b) ? (a) : (b))
+#define max(a, b)               ((a) > (b) ? (a) : (b))
+#define min_t(t, a, b)          ((t) (a) < (t) (b) ? (t) (a) : (t) (b))
+#define div_u64(dividend, divisor) ((u64) (dividend) / (u32) (divisor))
+#define div64_u64(dividend, divisor) ((u64) (dividend) / (u64) (divisor))
+#define max_t(t, a, b)          ((t) (a) > (t) (b) ? (t) (a) : (t) (b))
+
+#define MAX_ERRNO               4095
+#define IS_ERR(p)               ((unsigned long) (p) >= (unsigned long) -MAX_ERRNO)
+#define PTR_ERR(p)              ((long) (p))
+#define ERR_PTR(e)              ((void *) (long) (e))
+
+#define EPROBE_DEFER            517
+
+#define PAGE_SIZE               4096UL
+#define PAGE_ALIGN(x)           (((x) + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1))
+
+/******************************************************************************
+ * printk and modules
+******************************************************************************/
+
+#define SIM_LOG_ERR     0
+#define SIM_LOG_WARN    1
+#define SIM_LOG_INFO    2
+
+int sim_printk(int level, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+
+#define pr_alert(...)               sim_printk(SIM_LOG_ERR, __VA_ARGS__)
+#define pr_err(...)                 sim_printk(SIM_LOG_ERR, __VA_ARGS__)
+#define pr_warn(...)                sim_printk(SIM_LOG_WARN, __VA_ARGS__)
+#define pr_info(...)                sim_printk(SIM_LOG_INFO, __VA_ARGS__)
+#define pr_debug(...)               sim_printk(SIM_LOG_INFO, __VA_ARGS__)
+#define pr_err_ratelimited(...)     pr_err(__VA_ARGS__)
+#define pr_warn_ratelimited(...)    pr_warn(__VA_ARGS__)
+#define pr_info_ratelimited(...)    pr_info(__VA_ARGS__)
+
+#define ilog2(n)                    (63 - __builtin_clzll((unsigned long long) (n)))
+
+// No optional subsystem (IIO...) is built in: only its stubs are used
+#define IS_ENABLED(option)          0
+
+// Tracepoints are never enabled here: trace_<event>() does nothing
+#define TP_PROTO(args...)           args
+#define TP_ARGS(args...)            args
+#define DECLARE_EVENT_CLASS(name, proto, args, tstruct, assign, print)
+#define DEFINE_EVENT(template, name, proto, args) \
+    static inline void trace_##name(proto) { }
+#define TRACE_EVENT(name, proto, args, tstruct, assign, print) \
+    static inline void trace_##name(proto) { }
+
+struct module;
+#define THIS_MODULE                 ((struct module *) NULL)
+#define MODULE_LICENSE(x)
+#define MODULE_AUTHOR(x)
+#define MODULE_DESCRIPTION(x)
+#define MODULE_VERSION(x)
+#define MODULE_DEVICE_TABLE(type, name)
+#define MODULE_PARM_DESC(name, desc)
+#define EXPORT_SYMBOL(x)
+#define EXPORT_SYMBOL_GPL(x)
+
+// Every parameter is registered by name, so the harness can set it before the
+// driver is initialized (sim_param_set()).
+void sim_param_register(const char *name, void *value, size_t size, bool is_signed);
+#define module_param(name, type, perm) \
+    static void __attribute__((constructor)) __sim_param_##name(void) \
+    { sim_param_register(#name, &name, sizeof(name), (typeof(name)) -1 < 0); }
+
+/******************************************************************************
+ * Time
+******************************************************************************/
+
+#define HZ              250
+#define NSEC_PER_USEC   1000UL
+#define NSEC_PER_MSEC   1000000UL
+#define NSEC_PER_SEC    1000000000UL
+
+#define jiffies         ((unsigned long) (sim_now_ns / (NSEC_PER_SEC / HZ)))
+
+static inline unsigned long msecs_to_jiffies(unsigned int ms)
+{
+    return DIV_ROUND_UP((unsigned long) ms * HZ, 1000);
+}
+
+static inline unsigned long nsecs_to_jiffies(u64 ns)
+{
+    return ns / (NSEC_PER_SEC / HZ);
+}
+
+static inline u64 ktime_get_ns(void)
+{
+    return sim_now_ns;
+}
+
+static inline ktime_t ktime_get(void)
+{
+    return (ktime_t) sim_now_ns;
+}
+
+void msleep(unsigned int ms);
+void usleep_range(unsigned long min_us, unsigned long max_us);
+void udelay(unsigned long us);
+void ndelay(unsigned long ns);
+
+// A single task, that is never killed
+struct task_struct;
+#define current                 ((struct task_struct *) NULL)
+
+static inline bool fatal_signal_pending(struct task_struct *task)
+{
+    (void) task;
+    return false;
+}
+
+/******************************************************************************
+ * Memory mapped I/O
+******************************************************************************/
+
+void __iomem *ioremap(phys_addr_t offset, size_t size);
+void iounmap(void __iomem *addr);
+u32 ioread32(const void __iomem *addr);
+void iowrite32(u32 value, void __iomem *addr);
+
+#define readl(addr)             ioread32(addr)
+#define writel(value, addr)     iowrite32(value, addr)
+
+/******************************************************************************
+ * Locking and atomic bit operations
+******************************************************************************/
+
+typedef struct {
+    int locked;
+} spinlock_t;
+
+#define DEFINE_SPINLOCK(name)   spinlock_t name = { 0 }
+
+void sim_spin_acquire(spinlock_t *lock);
+void sim_spin_release(spinlock_t *lock);
+unsigned long sim_irq_save(void);
+void sim_irq_restore(unsigned long flags);
+
+static inline void spin_lock_init(spinlock_t *lock)
+{
+    lock->locked = 0;
+}
+
+#define spin_lock(lock)                         sim_spin_acquire(lock)
+#define spin_unlock(lock)                       sim_spin_release(lock)
+#define spin_lock_irq(lock)                     do { sim_irq_save(); sim_spin_acquire(lock); } while (0)
+#define spin_unlock_irq(lock)                   do { sim_spin_release(lock); sim_irq_restore(0); } while (0)
+#define spin_lock_irqsave(lock, flags)          do { (flags) = sim_irq_save(); sim_spin_acquire(lock); } while (0)
+#define spin_unlock_irqrestore(lock, flags)     do { sim_spin_release(lock); sim_irq_restore(flags); } while (0)
+
+static inline bool test_bit(long nr, const volatile unsigned long *addr)
+{
+    return (addr[nr / BITS_PER_LONG] >> (nr % BITS_PER_LONG)) & 1;
+}
+
+static inline void set_bit(long nr, volatile unsigned long *addr)
+{
+    addr[nr / BITS_PER_LONG] |= 1UL << (nr % BITS_PER_LONG);
+}
+
+static inline void clear_bit(long nr, volatile unsigned long *addr)
+{
+    addr[nr / BITS_PER_LONG] &= ~(1UL << (nr % BITS_PER_LONG));
+}
+
+static inline bool test_and_set_bit(long nr, volatile unsigned long *addr)
+{
+    bool old = test_bit(nr, addr);
+
+    set_bit(nr, addr);
+    return old;
+}
+
+#define test_and_set_bit_lock(nr, addr)     test_and_set_bit(nr, addr)
+#define clear_bit_unlock(nr, addr)          clear_bit(nr, addr)
+
+typedef struct {
+    int counter;
+} atomic_t;
+
+static inline int atomic_inc_return(atomic_t *v)
+{
+    return ++v->counter;
+}
+
+#define BITS_TO_LONGS(bits)         DIV_ROUND_UP(bits, BITS_PER_LONG)
+#define DECLARE_BITMAP(name, bits)  unsigned long name[BITS_TO_LONGS(bits)]
+
+static inline void bitmap_zero(unsigned long *map, unsigned int bits)
+{
+    memset(map, 0, BITS_TO_LONGS(bits) * sizeof(long));
+}
+
+static inline unsigned long find_next_bit(const unsigned long *map, unsigned long size, unsigned long offset)
+{
+    for (; offset < size; offset++)
+        if (test_bit(offset, map))
+            return offset;
+    return size;
+}
+
+static inline unsigned long find_first_bit(const unsigned long *map, unsigned long size)
+{
+    return find_next_bit(map, size, 0);
+}
+
+/******************************************************************************
+ * Lists
+******************************************************************************/
+
+struct list_head {
+    struct list_head *next, *prev;
+};
+
+#define LIST_HEAD_INIT(name)    { &(name), &(name) }
+#define LIST_HEAD(name)         struct list_head name = LIST_HEAD_INIT(name)
+
+static inline void INIT_LIST_HEAD(struct list_head *list)
+{
+    list->next = list;
+    list->prev = list;
+}
+
+static inline void __list_add(struct list_head *entry, struct list_head *prev, struct list_head *next)
+{
+    next->prev = entry;
+    entry->next = next;
+    entry->prev = prev;
+    prev->next = entry;
+}
+
+static inline void list_add(struct list_head *entry, struct list_head *head)
+{
+    __list_add(entry, head, head->next);
+}
+
+static inline void list_add_tail(struct list_head *entry, struct list_head *head)
+{
+    __list_add(entry, head->prev, head);
+}
+
+static inline void list_del_init(struct list_head *entry)
+{
+    entry->next->prev = entry->prev;
+    entry->prev->next = entry->next;
+    INIT_LIST_HEAD(entry);
+}
+
+#define list_del(entry)     list_del_init(entry)
+
+static inline bool list_empty(const struct list_head *head)
+{
+    return head->next == head;
+}
+
+#define list_entry(ptr, type, member)           container_of(ptr, type, member)
+#define list_first_entry(head, type, member)    list_entry((head)->next, type, member)
+#define list_next_entry(pos, member)            list_entry((pos)->member.next, typeof(*(pos)), member)
+#define list_for_each_entry(pos, head, member) \
+    for (pos = list_first_entry(head, typeof(*pos), member); &pos->member != (head); \
+         pos = list_next_entry(pos, member))
+#define list_for_each_entry_safe(pos, n, head, member) \
+    for (pos = list_first_entry(head, typeof(*pos), member), n = list_next_entry(pos, member); \
+         &pos->member != (head); pos = n, n = list_next_entry(n, member))
+
+/******************************************************************************
+ * Sleeping: completions and wait queues
+******************************************************************************/
+
+void sim_might_sleep(void);
+void sim_wait_step(const char *what);
+
+typedef struct {
+    int unused;
+} wait_queue_head_t;
+
+#define DECLARE_WAIT_QUEUE_HEAD(name)   wait_queue_head_t name = { 0 }
+
+static inline void init_waitqueue_head(wait_queue_head_t *wq) { (void) wq; }
+static inline void wake_up(wait_queue_head_t *wq) { (void) wq; }
+static inline void wake_up_interruptible(wait_queue_head_t *wq) { (void) wq; }
+static inline void wake_up_var(void *var) { (void) var; }
+
+// Nobody else can make the condition true while we spin, only the events that
+// happen while the modelled time goes by.
+#define wait_event(wq, condition) \
+    do { sim_might_sleep(); while (!(condition)) sim_wait_step(#condition); } while (0)
+#define wait_var_event(var, condition) \
+    do { (void) (var); sim_might_sleep(); while (!(condition)) sim_wait_step(#condition); } while (0)
+
+struct completion {
+    unsigned int done;
+};
+
+static inline void init_completion(struct completion *x) { x->done = 0; }
+static inline void reinit_completion(struct completion *x) { x->done = 0; }
+static inline void complete(struct completion *x) { x->done++; }
+static inline bool completion_done(struct completion *x) { return x->done != 0; }
+
+void wait_for_completion(struct completion *x);
+unsigned long wait_for_completion_timeout(struct completion *x, unsigned long timeout);
+
+/******************************************************************************
+ * Memory
+******************************************************************************/
+
+#define GFP_KERNEL      0
+#define GFP_ATOMIC      1
+
+static inline void *kmalloc(size_t size, gfp_t flags) { (void) flags; return malloc(size); }
+static inline void *kzalloc(size_t size, gfp_t flags) { (void) flags; return calloc(1, size); }
+static inline void kfree(const void *p) { free((void *) p); }
+static inline void *vmalloc_user(unsigned long size) { return calloc(1, size); }
+static inline void vfree(const void *p) { free((void *) p); }
+
+#define VM_WRITE        0x00000002
+#define VM_MAYWRITE     0x00000020
+
+struct vm_area_struct {
+    unsigned long vm_start;
+    unsigned long vm_end;
+    unsigned long vm_pgoff;
+    unsigned long vm_flags;
+};
+
+static inline int remap_vmalloc_range(struct vm_area_struct *vma, void *addr, unsigned long pgoff)
+{
+    (void) vma; (void) addr; (void) pgoff;
+    return 0;
+}
+
+/******************************************************************************
+ * Device model, device tree and interrupts
+******************************************************************************/
+
+struct device_node {
+    const char *compatible;
+    u32 reg;                    // "reg" property, 0 if none
+    int irq;                    // First interrupt, 0 if none
+    const u32 *pins;            // "pins" property
+    bool dmas;                  // "dmas" property, with "tx" and "rx"
+    u32 clock_frequency;        // These three are left out if 0
+    u32 int_clock_frequency;
+    u32 scl_rising_time_ns;     // "i2c-scl-rising-time-ns"
+    bool disabled;              // status = "disabled"
+    struct device_node *child;  // First child
+    struct device_node *sibling;
+};
+
+struct device {
+    struct device *parent;
+    struct device_node *of_node;
+};
+
+#define IORESOURCE_MEM      0x00000200
+
+struct resource {
+    resource_size_t start;
+    resource_size_t end;
+    unsigned long flags;
+};
+
+static inline resource_size_t resource_size(const struct resource *res)
+{
+    return res->end - res->start + 1;
+}
+
+struct platform_device {
+    const char *name;
+    struct device dev;
+    struct resource *resource;  // Registers ("reg"), IORESOURCE_MEM
+    int irq;
+};
+
+struct of_device_id {
+    char compatible[128];
+};
+
+#define of_match_ptr(x)     (x)
+
+bool device_property_present(struct device *dev, const char *name);
+int device_property_read_u32_array(struct device *dev, const char *name, u32 *values, size_t count);
+int device_property_read_u32(struct device *dev, const char *name, u32 *value);
+struct device_node *of_get_next_available_child(const struct device_node *parent, struct device_node *prev);
+bool of_device_is_compatible(const struct device_node *node, const char *compatible);
+int of_property_read_u32(const struct device_node *node, const char *name, u32 *value);
+int of_irq_get(struct device_node *node, int index);
+static inline void of_node_put(struct device_node *node) { (void) node; }
+
+#define for_each_available_child_of_node(parent, child) \
+    for (child = of_get_next_available_child(parent, NULL); child != NULL; \
+        child = of_get_next_available_child(parent, child))
+struct resource *platform_get_resource(struct platform_device *pdev, unsigned int type, unsigned int num);
+int platform_get_irq(struct platform_device *pdev, unsigned int index);
+
+typedef int irqreturn_t;
+typedef irqreturn_t (*irq_handler_t)(int, void *);
+
+#define IRQ_NONE                0
+#define IRQ_HANDLED             1
+#define IRQ_WAKE_THREAD         2
+
+#define IRQF_TRIGGER_RISING     0x00000001
+#define IRQF_TRIGGER_FALLING    0x00000002
+#define IRQF_SHARED             0x00000080
+#define IRQF_ONESHOT            0x00002000
+
+int request_threaded_irq(unsigned int irq, irq_handler_t handler, irq_handler_t thread_fn,
+    unsigned long flags, const char *name, void *dev);
+void free_irq(unsigned int irq, void *dev);
+
+static inline int request_irq(unsigned int irq, irq_handler_t handler, unsigned long flags,
+    const char *name, void *dev)
+{
+    return request_threaded_irq(irq, handler, NULL, flags, name, dev);
+}
+
+/******************************************************************************
+ * I2C core
+******************************************************************************/
+
+struct i2c_msg {
+    __u16 addr;
+    __u16 flags;
+#define I2C_M_RD            0x0001
+#define I2C_M_TEN           0x0010
+#define I2C_M_DMA_SAFE      0x0200
+    __u16 len;
+    __u8 *buf;
+};
+
+#define I2C_FUNC_I2C            0x00000001
+#define I2C_FUNC_SMBUS_QUICK    0x00010000
+#define I2C_FUNC_SMBUS_EMUL     0x0eff0008
+
+struct i2c_adapter;
+
+struct i2c_algorithm {
+    int (*master_xfer)(struct i2c_adapter *adap, struct i2c_msg *msgs, int num);
+    u32 (*functionality)(struct i2c_adapter *adap);
+};
+
+#define I2C_AQ_NO_ZERO_LEN      ((1 << 4) | (1 << 5))
+
+struct i2c_adapter_quirks {
+    u64 flags;
+};
+
+// Registered adapters are numbered from 0 and can be reached with i2c_get_adapter()
+struct i2c_adapter {
+    struct module *owner;
+    const struct i2c_algorithm *algo;
+    const struct i2c_adapter_quirks *quirks;
+    struct device dev;
+    int nr;
+    char name[48];
+    void *algo_data;            // i2c_set_adapdata()
+    struct list_head node;      // Entry of the adapter list while registered
+};
+
+static inline void *i2c_get_adapdata(const struct i2c_adapter *adap) { return adap->algo_data; }
+static inline void i2c_set_adapdata(struct i2c_adapter *adap, void *data) { adap->algo_data = data; }
+int i2c_add_adapter(struct i2c_adapter *adap);
+void i2c_del_adapter(struct i2c_adapter *adap);
+struct i2c_adapter *i2c_get_adapter(int nr);
+int i2c_transfer(struct i2c_adapter *adap, struct i2c_msg *msgs, int num);
+
+/******************************************************************************
+ * High resolution timers
+******************************************************************************/
+
+// Always CLOCK_MONOTONIC, the clock of ktime_get_ns(). The callback runs with
+// interrupts off, like a hard handler.
+typedef int clockid_t;
+#define CLOCK_MONOTONIC     1
+
+enum hrtimer_restart {
+    HRTIMER_NORESTART,
+    HRTIMER_RESTART,
+};
+
+enum hrtimer_mode {
+    HRTIMER_MODE_ABS,
+    HRTIMER_MODE_REL,
+};
+
+struct hrtimer {
+    enum hrtimer_restart (*function)(struct hrtimer *timer);
+    struct list_head node;      // Entry of the hrtimer list while armed
+    u64 expires_ns;
+};
+
+void hrtimer_init(struct hrtimer *timer, clockid_t clock, enum hrtimer_mode mode);
+void hrtimer_start(struct hrtimer *timer, ktime_t time, const enum hrtimer_mode mode);
+int hrtimer_try_to_cancel(struct hrtimer *timer);
+int hrtimer_cancel(struct hrtimer *timer);
+static inline ktime_t ns_to_ktime(u64 ns) { return (ktime_t) ns; }
+
+/******************************************************************************
+ * Work queues
+******************************************************************************/
+
+struct work_struct;
+typedef void (*work_func_t)(struct work_struct *work);
+
+struct work_struct {
+    work_func_t func;
+    bool running;
+    bool pending;               // Plain work items only, see schedule_work()
+    struct list_head node;      // Entry of the list of queued ones, while pending
+};
+
+struct delayed_work {
+    struct work_struct work;
+    struct list_head node;      // Entry of the timer list while pending
+    u64 expires_ns;
+    bool pending;
+};
+
+struct workqueue_struct;
+#define system_wq   ((struct workqueue_struct *) NULL)
+
+void sim_init_work(struct work_struct *work, work_func_t func);
+bool schedule_work(struct work_struct *work);
+bool cancel_work_sync(struct work_struct *work);
+void sim_init_delayed_work(struct delayed_work *dwork, work_func_t func);
+bool queue_delayed_work(struct workqueue_struct *wq, struct delayed_work *dwork, unsigned long delay);
+bool mod_delayed_work(struct workqueue_struct *wq, struct delayed_work *dwork, unsigned long delay);
+bool cancel_delayed_work_sync(struct delayed_work *dwork);
+
+#define INIT_WORK(work, func)                   sim_init_work(work, func)
+#define INIT_DELAYED_WORK(dwork, func)          sim_init_delayed_work(dwork, func)
+#define schedule_delayed_work(dwork, delay)     queue_delayed_work(system_wq, dwork, delay)
+#define to_delayed_work(w)                      container_of(w, struct delayed_work, work)
+
+/******************************************************************************
+ * DMA engine
+******************************************************************************/
+
+struct device;
+
+struct dma_device {
+    struct device *dev;
+};
+
+struct dma_chan {
+    struct dma_device *device;
+    int channel;                // SIM_EDMA_*
+    struct dma_async_tx_descriptor *active;
+    int cookie;                 // Last one handed out by dmaengine_submit()
+    int completed_cookie;
+};
+
+typedef void (*dma_async_tx_callback)(void *param);
+typedef int dma_cookie_t;
+
+enum dma_status {
+    DMA_COMPLETE,
+    DMA_IN_PROGRESS,
+};
+
+struct dma_tx_state;
+
+enum dma_transfer_direction {
+    DMA_MEM_TO_DEV,
+    DMA_DEV_TO_MEM,
+};
+
+enum dma_slave_buswidth {
+    DMA_SLAVE_BUSWIDTH_1_BYTE = 1,
+};
+
+#define DMA_PREP_INTERRUPT  (1 << 0)
+
+struct dma_slave_config {
+    phys_addr_t src_addr;
+    phys_addr_t dst_addr;
+    enum dma_slave_buswidth src_addr_width;
+    enum dma_slave_buswidth dst_addr_width;
+    u32 src_maxburst;
+    u32 dst_maxburst;
+};
+
+struct dma_async_tx_descriptor {
+    dma_async_tx_callback callback;
+    void *callback_param;
+
+    // Simulation
+    struct dma_chan *chan;
+    dma_cookie_t cookie;
+    u8 *buf;
+    size_t len;
+    size_t pos;
+};
+
+struct dma_chan *dma_request_chan(struct device *dev, const char *name);
+void dma_release_channel(struct dma_chan *chan);
+int dmaengine_slave_config(struct dma_chan *chan, struct dma_slave_config *config);
+struct dma_async_tx_descriptor *dmaengine_prep_slave_single(struct dma_chan *chan, dma_addr_t buf,
+    size_t len, enum dma_transfer_direction dir, unsigned long flags);
+dma_cookie_t dmaengine_submit(struct dma_async_tx_descriptor *desc);
+enum dma_status dmaengine_tx_status(struct dma_chan *chan, dma_cookie_t cookie, struct dma_tx_state *state);
+void dma_async_issue_pending(struct dma_chan *chan);
+int dmaengine_terminate_async(struct dma_chan *chan);
+int dmaengine_terminate_sync(struct dma_chan *chan);
+void *dma_alloc_coherent(struct device *dev, size_t size, dma_addr_t *handle, gfp_t flags);
+void dma_free_coherent(struct device *dev, size_t size, void *addr, dma_addr_t handle);
+
+/******************************************************************************
+ * Files, seq_file and debugfs
+******************************************************************************/
+
+struct inode {
+    void *i_private;
+};
+
+struct file {
+    void *private_data;
+    unsigned int f_flags;
+};
+
+struct file_operations {
+    struct module *owner;
+    int (*open)(struct inode *inode, struct file *file);
+    ssize_t (*read)(struct file *file, char __user *buf, size_t count, loff_t *offs);
+    ssize_t (*write)(struct file *file, const char __user *buf, size_t count, loff_t *offs);
+    loff_t (*llseek)(struct file *file, loff_t offset, int whence);
+    int (*release)(struct inode *inode, struct file *file);
+};
+
+// The whole output of show() is kept in 'buf'
+struct seq_file {
+    char *buf;
+    size_t count;
+    size_t size;
+    int (*show)(struct seq_file *m, void *v);
+    void *private;
+};
+
+int seq_printf(struct seq_file *m, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+int single_open(struct file *file, int (*show)(struct seq_file *m, void *v), void *data);
+
+static inline int simple_open(struct inode *inode, struct file *file)
+{
+    file->private_data = inode->i_private;
+    return 0;
+}
+static inline unsigned long copy_from_user(void *to, const void __user *from, unsigned long n)
+{
+    memcpy(to, from, n);
+    return 0;
+}
+
+ssize_t seq_read(struct file *file, char __user *buf, size_t count, loff_t *offs);
+loff_t seq_lseek(struct file *file, loff_t offset, int whence);
+int single_release(struct inode *inode, struct file *file);
+
+// debugfs keeps the files in a table, so the harness can read and write them
+// with sim_debugfs_read() and sim_debugfs_write() by path ("dir/file").
+struct dentry;
+struct dentry *debugfs_create_dir(const char *name, struct dentry *parent);
+struct dentry *debugfs_create_file(const char *name, umode_t mode, struct dentry *parent,
+    void *data, const struct file_operations *fops);
+void debugfs_remove_recursive(struct dentry *dentry);
+
+/******************************************************************************
+ * ioctl numbers and byte order
+******************************************************************************/
+
+#define _IOC(dir, type, nr, size)   (((dir) << 30) | ((size) << 16) | ((type) << 8) | (nr))
+#define _IO(type, nr)               _IOC(0U, type, nr, 0)
+#define _IOW(type, nr, arg)         _IOC(1U, type, nr, sizeof(arg))
+#define _IOR(type, nr, arg)         _IOC(2U, type, nr, sizeof(arg))
+#define _IOWR(type, nr, arg)        _IOC(3U, type, nr, sizeof(arg))
+
+static inline u16 get_unaligned_be16(const void *p)
+{
+    const u8 *b = p;
+
+    return (b[0] << 8) | b[1];
+}
+
+#endif // SIM_KERNEL_H
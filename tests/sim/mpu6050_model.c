@@ -0,0 +1,356 @@
+#include <string.h>
+#include "sim.h"
+
+// MPU6050 register file behind the I2C bus: auto-incrementing register pointer,
+// burst reads latched at the START, the 1024 byte FIFO, INT_STATUS with the
+// data ready and FIFO overflow events, and the INT pin. The sample clock follows
+// SMPLRT_DIV and DLPF_CFG like the real device:
+//   Sample Rate = Gyroscope Output Rate / (1 + SMPLRT_DIV)
+// with an 8kHz gyroscope output rate when DLPF_CFG is 0 or 7 and 1kHz otherwise,
+// off by sim_opts.mpu_clock_ppm.
+//
+// The samples encode their own index so the harness can tell lost, repeated and
+// torn ones apart: ACCEL_XOUT is the low 16 bits of the index, ACCEL_YOUT the
+// high ones, GYRO_[XYZ]OUT are the index times 3, 5 and 7 and TEMP_OUT and
+// ACCEL_ZOUT are constant (25C and 1g at +-2g).
+//
+// There are SIM_MPU6050_MAX of them, each with its own oscillator started when
+// it wakes up and its INT pin on SIM_IRQ_MPU6050 + n.
+
+#define REG_SMPLRT_DIV      0x19
+#define REG_CONFIG          0x1A
+#define REG_FIFO_EN         0x23
+#define REG_INT_PIN_CFG     0x37
+#define REG_INT_ENABLE      0x38
+#define REG_INT_STATUS      0x3A
+#define REG_ACCEL_XOUT_H    0x3B
+#define REG_GYRO_ZOUT_L     0x48
+#define REG_SIGNAL_PATH_RESET 0x68
+#define REG_USER_CTRL       0x6A
+#define REG_PWR_MGMT_1      0x6B
+#define REG_FIFO_COUNTH     0x72
+#define REG_FIFO_COUNTL     0x73
+#define REG_FIFO_R_W        0x74
+#define REG_WHO_AM_I        0x75
+
+#define INT_DATA_RDY        (1 << 0)
+#define INT_FIFO_OFLOW      (1 << 4)
+#define INT_PIN_LATCH_EN    (1 << 5)
+#define INT_PIN_RD_CLEAR    (1 << 4)
+#define FIFO_EN_TEMP        (1 << 7)
+#define FIFO_EN_XG          (1 << 6)
+#define FIFO_EN_YG          (1 << 5)
+#define FIFO_EN_ZG          (1 << 4)
+#define FIFO_EN_ACCEL       (1 << 3)
+#define USER_CTRL_FIFO_EN   (1 << 6)
+#define USER_CTRL_FIFO_RESET (1 << 2)
+#define USER_CTRL_RESETS    0x0F
+#define PWR1_DEVICE_RESET   (1 << 7)
+#define PWR1_SLEEP          (1 << 6)
+
+#define FIFO_SIZE           1024
+#define RESET_NS            50000000ULL     // The device NACKs while it resets
+#define TEMP_25C            ((int16_t) ((25.0 - 36.53) * 340))
+#define HISTORY             4096            // Sample times kept for the harness
+
+struct mpu6050_model {
+    struct sim_i2c_target target;
+    int irq;
+
+    uint8_t regs[128];
+    uint8_t latch[REG_GYRO_ZOUT_L - REG_ACCEL_XOUT_H + 1];  // Data registers of the burst
+    uint8_t ptr;                    // Register pointer
+    bool expect_ptr;                // Next byte written is the register address
+
+    uint8_t fifo[FIFO_SIZE];
+    uint32_t fifo_head, fifo_count;
+
+    uint32_t index;                 // Samples taken so far
+    uint64_t next_sample;           // UINT64_MAX while sleeping
+    uint64_t busy_until;            // End of a device reset
+    bool int_latched;               // INT held high until INT_STATUS is read
+    uint64_t history[HISTORY];
+};
+
+static struct mpu6050_model models[SIM_MPU6050_MAX];
+static unsigned int model_count;    // Reset so far, the only ones on the bus
+
+/******************************************************************************
+ * Sampling
+******************************************************************************/
+
+static uint64_t sample_period_ns(struct mpu6050_model *mpu)
+{
+    uint32_t dlpf = mpu->regs[REG_CONFIG] & 0x07;
+    double gyro_hz = (dlpf == 0 || dlpf == 7) ? 8000.0 : 1000.0;
+
+    gyro_hz *= 1.0 + sim_opts.mpu_clock_ppm / 1e6;
+    return (uint64_t) (1e9 * (1 + mpu->regs[REG_SMPLRT_DIV]) / gyro_hz);
+}
+
+static bool sleeping(struct mpu6050_model *mpu)
+{
+    return (mpu->regs[REG_PWR_MGMT_1] & PWR1_SLEEP) != 0;
+}
+
+static void put_be16(struct mpu6050_model *mpu, uint8_t reg, int16_t value)
+{
+    mpu->regs[reg] = (uint16_t) value >> 8;
+    mpu->regs[reg + 1] = (uint16_t) value & 0xFF;
+}
+
+static void fifo_push(struct mpu6050_model *mpu, const uint8_t *data, uint32_t len)
+{
+    while (len--) {
+        if (mpu->fifo_count == FIFO_SIZE) {
+            // The oldest byte is dropped
+            mpu->fifo_head = (mpu->fifo_head + 1) % FIFO_SIZE;
+            mpu->fifo_count--;
+            if (!(mpu->regs[REG_INT_STATUS] & INT_FIFO_OFLOW))
+                sim_stats.fifo_overflows++;
+            mpu->regs[REG_INT_STATUS] |= INT_FIFO_OFLOW;
+        }
+        mpu->fifo[(mpu->fifo_head + mpu->fifo_count++) % FIFO_SIZE] = *data++;
+    }
+}
+
+static void raise_int(struct mpu6050_model *mpu, uint8_t events)
+{
+    if (!(events & mpu->regs[REG_INT_ENABLE]))
+        return;
+    if (mpu->regs[REG_INT_PIN_CFG] & INT_PIN_LATCH_EN) {
+        if (mpu->int_latched)
+            return;
+        mpu->int_latched = true;
+    }
+    if (sim_opts.mpu_int)
+        sim_raise_irq(mpu->irq);
+}
+
+/// @brief Takes a sample at 't'.
+static void take_sample(struct mpu6050_model *mpu, uint64_t t)
+{
+    uint32_t n = mpu->index++;
+    uint8_t fifo_en = mpu->regs[REG_FIFO_EN];
+    uint8_t before = mpu->regs[REG_INT_STATUS];
+
+    mpu->history[n % HISTORY] = t;
+    sim_stats.samples++;
+
+    put_be16(mpu, 0x3B, (int16_t) n);
+    put_be16(mpu, 0x3D, (int16_t) (n >> 16));
+    put_be16(mpu, 0x3F, 16384);
+    put_be16(mpu, 0x41, TEMP_25C);
+    put_be16(mpu, 0x43, (int16_t) (n * 3));
+    put_be16(mpu, 0x45, (int16_t) (n * 5));
+    put_be16(mpu, 0x47, (int16_t) (n * 7));
+    mpu->regs[REG_INT_STATUS] |= INT_DATA_RDY;
+
+    if (mpu->regs[REG_USER_CTRL] & USER_CTRL_FIFO_EN) {
+        if (fifo_en & FIFO_EN_ACCEL)
+            fifo_push(mpu, &mpu->regs[0x3B], 6);
+        if (fifo_en & FIFO_EN_TEMP)
+            fifo_push(mpu, &mpu->regs[0x41], 2);
+        if (fifo_en & FIFO_EN_XG)
+            fifo_push(mpu, &mpu->regs[0x43], 2);
+        if (fifo_en & FIFO_EN_YG)
+            fifo_push(mpu, &mpu->regs[0x45], 2);
+        if (fifo_en & FIFO_EN_ZG)
+            fifo_push(mpu, &mpu->regs[0x47], 2);
+    }
+
+    // Every sample is an event, even if INT_STATUS wasn't read since the last one
+    raise_int(mpu, INT_DATA_RDY | (mpu->regs[REG_INT_STATUS] & ~before));
+}
+
+static void reset_registers(struct mpu6050_model *mpu)
+{
+    memset(mpu->regs, 0, sizeof(mpu->regs));
+    mpu->regs[REG_PWR_MGMT_1] = PWR1_SLEEP;
+    mpu->regs[REG_WHO_AM_I] = 0x68;
+    mpu->fifo_head = mpu->fifo_count = 0;
+    mpu->next_sample = UINT64_MAX;
+    mpu->int_latched = false;
+}
+
+/******************************************************************************
+ * Register access
+******************************************************************************/
+
+static uint8_t read_register(struct mpu6050_model *mpu, uint8_t reg)
+{
+    uint8_t value;
+
+    if (reg >= REG_ACCEL_XOUT_H && reg <= REG_GYRO_ZOUT_L)
+        return mpu->latch[reg - REG_ACCEL_XOUT_H];
+
+    switch (reg) {
+    case REG_INT_STATUS:
+        value = mpu->regs[REG_INT_STATUS];
+        mpu->regs[REG_INT_STATUS] = 0;
+        mpu->int_latched = false;
+        return value;
+    case REG_FIFO_COUNTH:
+        return mpu->fifo_count >> 8;
+    case REG_FIFO_COUNTL:
+        return mpu->fifo_count & 0xFF;
+    case REG_FIFO_R_W:
+        if (mpu->fifo_count == 0)
+            return 0xFF;
+        value = mpu->fifo[mpu->fifo_head];
+        mpu->fifo_head = (mpu->fifo_head + 1) % FIFO_SIZE;
+        mpu->fifo_count--;
+        return value;
+    default:
+        if (mpu->regs[REG_INT_PIN_CFG] & INT_PIN_RD_CLEAR)
+            mpu->int_latched = false;
+        return mpu->regs[reg & 0x7F];
+    }
+}
+
+static void write_register(struct mpu6050_model *mpu, uint8_t reg, uint8_t value)
+{
+    bool was_sleeping = sleeping(mpu);
+
+    switch (reg) {
+    case REG_WHO_AM_I:
+    case REG_INT_STATUS:
+    case REG_FIFO_COUNTH:
+    case REG_FIFO_COUNTL:
+        return;
+    case REG_FIFO_R_W:
+        fifo_push(mpu, &value, 1);
+        return;
+    case REG_SIGNAL_PATH_RESET:
+        return;
+    case REG_USER_CTRL:
+        if (value & USER_CTRL_FIFO_RESET)
+            mpu->fifo_head = mpu->fifo_count = 0;
+        mpu->regs[reg] = value & ~USER_CTRL_RESETS;
+        return;
+    case REG_PWR_MGMT_1:
+        if (value & PWR1_DEVICE_RESET) {
+            reset_registers(mpu);
+            mpu->busy_until = sim_now_ns + RESET_NS;
+            return;
+        }
+        break;
+    default:
+        break;
+    }
+
+    if (reg < sizeof(mpu->regs))
+        mpu->regs[reg] = value;
+    if (was_sleeping && !sleeping(mpu))
+        mpu->next_sample = sim_now_ns + sample_period_ns(mpu);
+    else if (!was_sleeping && sleeping(mpu))
+        mpu->next_sample = UINT64_MAX;
+}
+
+/******************************************************************************
+ * I2C target
+******************************************************************************/
+
+static bool mpu_start(void *context, bool read)
+{
+    struct mpu6050_model *mpu = context;
+
+    if (sim_now_ns < mpu->busy_until)
+        return false;
+    mpu->expect_ptr = !read;
+    if (read)
+        memcpy(mpu->latch, &mpu->regs[REG_ACCEL_XOUT_H], sizeof(mpu->latch));
+    return true;
+}
+
+static bool mpu_write(void *context, uint8_t byte)
+{
+    struct mpu6050_model *mpu = context;
+
+    if (mpu->expect_ptr) {
+        mpu->ptr = byte;
+        mpu->expect_ptr = false;
+        return true;
+    }
+    write_register(mpu, mpu->ptr, byte);
+    if (mpu->ptr != REG_FIFO_R_W)
+        mpu->ptr++;
+    return true;
+}
+
+static uint8_t mpu_read(void *context)
+{
+    struct mpu6050_model *mpu = context;
+    uint8_t value = read_register(mpu, mpu->ptr);
+
+    if (mpu->ptr != REG_FIFO_R_W)
+        mpu->ptr++;
+    return value;
+}
+
+static void mpu_stop(void *context)
+{
+}
+
+/******************************************************************************
+ * Interface
+******************************************************************************/
+
+void mpu6050_model_reset(unsigned int n, uint8_t addr)
+{
+    struct mpu6050_model *mpu = &models[n];
+
+    memset(mpu, 0, sizeof(*mpu));
+    mpu->irq = SIM_IRQ_MPU6050 + n;
+    mpu->target = (struct sim_i2c_target) {
+        .addr = addr,
+        .context = mpu,
+        .start = mpu_start,
+        .write = mpu_write,
+        .read = mpu_read,
+        .stop = mpu_stop,
+    };
+    reset_registers(mpu);
+    if (model_count < n + 1)
+        model_count = n + 1;
+}
+
+const struct sim_i2c_target *mpu6050_model_target(unsigned int n)
+{
+    return &models[n].target;
+}
+
+/// @brief Takes every sample due up to 'now_ns', on every sensor.
+void mpu6050_model_sync(uint64_t now_ns)
+{
+    struct mpu6050_model *mpu;
+
+    for (mpu = models; mpu < models + model_count; mpu++) {
+        while (mpu->next_sample <= now_ns) {
+            take_sample(mpu, mpu->next_sample);
+            mpu->next_sample += sample_period_ns(mpu);
+        }
+    }
+}
+
+uint64_t mpu6050_model_next_event(void)
+{
+    uint64_t next = UINT64_MAX;
+    unsigned int n;
+
+    for (n = 0; n < model_count; n++)
+        if (models[n].next_sample < next)
+            next = models[n].next_sample;
+    return next;
+}
+
+/// @brief Time at which sample 'index' of sensor 'n' was taken, if it's still remembered.
+bool mpu6050_model_sample_time(unsigned int n, uint32_t index, uint64_t *time_ns)
+{
+    struct mpu6050_model *mpu = &models[n];
+
+    if (index >= mpu->index || mpu->index - index > HISTORY)
+        return false;
+    *time_ns = mpu->history[index % HISTORY];
+    return true;
+}
@@ -0,0 +1,139 @@
+#ifndef SIM_H
+#define SIM_H
+
+// Simulated machine the driver runs on: modelled time, the interrupt controller,
+// EDMA, and the hooks between the peripheral models. Shared by the kernel shim,
+// the models and the harness. Everything runs on a single host thread.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+// IRQ numbers handed to the driver through the platform devices
+#define SIM_IRQ_I2C0        70      // INTC lines of the I2C controllers
+#define SIM_IRQ_I2C1        71
+#define SIM_IRQ_I2C2        30
+#define SIM_IRQ_MPU6050     160     // GPIO line wired to the INT pin of the first MPU6050,
+                                    // the next ones follow
+#define SIM_IRQ_MAX         256
+
+// MPU6050 on the buses, at 0x68, 0x69...
+#define SIM_MPU6050_MAX     2
+
+// EDMA channels handed to the driver ("tx" and "rx" of the device tree). Only
+// the I2C2 node has them, like in the overlay.
+#define SIM_EDMA_TX         0
+#define SIM_EDMA_RX         1
+
+// Knobs of the model. The defaults are rough BeagleBone Black figures.
+struct sim_options {
+    uint32_t mmio_read_ns;      // CPU stall of a read of an L4 peripheral register
+    uint32_t mmio_write_ns;     // CPU cost of a (posted) register write
+    uint32_t irq_entry_ns;      // Exception entry, INTC dispatch and return
+    uint32_t dma_irq_ns;        // EDMA completion interrupt to the driver callback
+    bool dma;                   // Provide the "tx" and "rx" EDMA channels
+    bool mpu_int;               // The MPU6050 INT pin is wired to a GPIO
+    int32_t mpu_clock_ppm;      // Error of the MPU6050 internal oscillator
+    uint32_t scl_rise_ns;       // SCL rise time, the controller waits it out every bit
+    uint32_t glitch_every;      // A slave holds SDA low after every Nth address phase, 0: never
+    uint32_t nack_every;        // Every Nth address phase is NACKed, 0: never
+    uint32_t data_nack_every;   // Every Nth data byte written is NACKed, 0: never
+    uint32_t stretch_every;     // The slave stretches SCL after every Nth address, 0: never
+    uint32_t stretch_us;        // ... for this long
+    int verbose;                // 0: warnings and errors, 1: every driver message
+};
+
+// Counters of everything the models see. Reset with sim_reset_stats().
+struct sim_stats {
+    // CPU
+    uint64_t irqs[SIM_IRQ_MAX];     // Hard handler invocations per line
+    uint64_t irqs_none;             // Handlers that returned IRQ_NONE
+    uint64_t edges_lost;            // GPIO edges that arrived with one still pending
+    uint64_t mmio_reads;
+    uint64_t mmio_writes;
+    uint64_t irq_ns;                // CPU time spent in hard IRQ context
+    uint64_t idle_ns;               // Modelled time with nothing to run
+
+    // I2C controllers, all of them together
+    uint64_t transactions;          // START conditions on a free bus
+    uint64_t repeated_starts;
+    uint64_t bytes_tx;              // Data bytes, addresses not included
+    uint64_t bytes_rx;
+    uint64_t nacks;
+    uint64_t arbitration_lost;
+    uint64_t glitches;              // Injected with --glitch-every
+    uint64_t nacks_injected;        // Injected with --nack-every and --data-nack-every
+    uint64_t recovery_pulses;       // SCL pulses driven through SYSTEST
+    uint64_t stretches;             // Injected with --stretch-every
+    uint64_t bus_busy_ns;           // Time between START and STOP
+    uint64_t bus_stall_ns;          // Part of it with SCL held low waiting for the CPU
+    uint64_t fifo_errors;           // TX overflows and RX underflows
+
+    // EDMA
+    uint64_t dma_bytes;
+    uint64_t dma_callbacks;
+
+    // MPU6050
+    uint64_t samples;               // Samples taken by the sensor
+    uint64_t fifo_overflows;
+};
+
+extern struct sim_options sim_opts;
+extern struct sim_stats sim_stats;
+extern uint64_t sim_now_ns;
+
+// Time
+void sim_advance(uint64_t ns);
+bool sim_idle(uint64_t deadline_ns);
+void sim_run_for(uint64_t ns);
+void sim_reset_stats(void);
+
+// Interrupts and DMA, for the models
+void sim_raise_irq(int irq);
+int sim_edma_pull(int channel);
+bool sim_edma_push(int channel, uint8_t byte);
+
+// Driver module parameters, by name
+int sim_param_set(const char *name, long value);
+
+// debugfs files created by the driver, by path ("dir/file")
+int sim_debugfs_read(const char *path, FILE *out);
+int sim_debugfs_write(const char *path, const char *text);
+
+// I2C slave connected to the bus. 'start' is called after the address byte and
+// 'write' after every byte written; returning false NACKs it. Every callback gets
+// 'context' back.
+struct sim_i2c_target {
+    uint8_t addr;
+    void *context;
+    bool (*start)(void *context, bool read);
+    bool (*write)(void *context, uint8_t byte);
+    uint8_t (*read)(void *context);
+    void (*stop)(void *context);
+};
+
+// AM335x I2C controllers (am335x_i2c.c), 'n' being the controller number. Only
+// the ones reset by the harness exist. Sync, next event and EDMA cover all of them.
+#define AM335X_I2C_COUNT    3
+#define AM335X_I2C0_BASE    0x44E0B000
+#define AM335X_I2C1_BASE    0x4802A000
+#define AM335X_I2C2_BASE    0x4819C000
+#define AM335X_I2C_LEN      0x1000
+void am335x_i2c_reset(unsigned int n);
+void am335x_i2c_attach(unsigned int n, const struct sim_i2c_target *target);
+uint32_t am335x_i2c_read(unsigned int n, uint32_t offset);
+void am335x_i2c_write(unsigned int n, uint32_t offset, uint32_t value);
+void am335x_i2c_sync(uint64_t now_ns);
+uint64_t am335x_i2c_next_event(void);
+bool am335x_i2c_irq_line(unsigned int n);
+void am335x_i2c_edma_service(void);
+
+// MPU6050 (mpu6050_model.c), 'n' from 0 to SIM_MPU6050_MAX - 1. Sync and next
+// event cover all of them.
+void mpu6050_model_reset(unsigned int n, uint8_t addr);
+const struct sim_i2c_target *mpu6050_model_target(unsigned int n);
+void mpu6050_model_sync(uint64_t now_ns);
+uint64_t mpu6050_model_next_event(void);
+bool mpu6050_model_sample_time(unsigned int n, uint32_t index, uint64_t *time_ns);
+
+#endif // SIM_H
@@ -0,0 +1,1163 @@
+#include <stdarg.h>
+#include <sys/mman.h>
+#include "kernel/sim_kernel.h"
+
+/******************************************************************************
+ * Machine state
+******************************************************************************/
+
+struct sim_options sim_opts = {
+    .mmio_read_ns = 250,
+    .mmio_write_ns = 80,
+    .irq_entry_ns = 1500,
+    .dma_irq_ns = 4000,
+    .dma = false,
+    .mpu_int = true,
+    .mpu_clock_ppm = 0,
+    .scl_rise_ns = 300,
+    .stretch_us = 5000,
+    .verbose = 0,
+};
+
+struct sim_stats sim_stats;
+uint64_t sim_now_ns;
+
+static int irq_nesting;         // Running a hard handler
+static int irqs_off;            // local_irq_save() depth, hard handlers included
+static bool in_thread;          // Running a threaded handler or a work item
+
+// Lines requested by the driver
+struct sim_irq {
+    irq_handler_t handler;
+    irq_handler_t thread_fn;
+    unsigned long flags;
+    void *dev;
+    bool requested;
+    bool edge_pending;          // Edge latched by the GPIO controller
+    bool thread_pending;        // The threaded handler has to run
+    bool masked;                // IRQF_ONESHOT line waiting for its thread
+};
+static struct sim_irq irqs[SIM_IRQ_MAX];
+
+// Memory mapped regions handed out by ioremap()
+#define SIM_MAX_REGIONS 8
+struct sim_region {
+    phys_addr_t phys;
+    size_t size;
+    u8 *virt;
+};
+static struct sim_region regions[SIM_MAX_REGIONS];
+
+// Work items waiting for their timer
+static LIST_HEAD(timers);
+
+// Work items queued with schedule_work()
+static LIST_HEAD(works);
+
+// Armed high resolution timers
+static LIST_HEAD(hrtimers);
+
+// Registered I2C adapters, and the number of the next one
+static LIST_HEAD(i2c_adapters);
+static int i2c_adapters_next;
+
+// EDMA
+static struct dma_device edma_device;
+static struct dma_chan edma_chans[2] = {
+    { .device = &edma_device, .channel = SIM_EDMA_TX },
+    { .device = &edma_device, .channel = SIM_EDMA_RX },
+};
+static struct dma_async_tx_descriptor edma_descs[2];
+static struct dma_async_tx_descriptor *edma_done;   // Completed, callback not run yet
+static u64 edma_done_ns;
+
+// I2C controllers, by number
+static const struct {
+    phys_addr_t base;
+    int irq;
+} i2c_controllers[AM335X_I2C_COUNT] = {
+    { AM335X_I2C0_BASE, SIM_IRQ_I2C0 },
+    { AM335X_I2C1_BASE, SIM_IRQ_I2C1 },
+    { AM335X_I2C2_BASE, SIM_IRQ_I2C2 },
+};
+
+// Module parameters
+#define SIM_MAX_PARAMS 16
+struct sim_param {
+    const char *name;
+    void *value;
+    size_t size;
+    bool is_signed;
+};
+static struct sim_param params[SIM_MAX_PARAMS];
+static int param_count;
+
+static void __attribute__((noreturn, format(printf, 1, 2))) sim_bug(const char *fmt, ...)
+{
+    va_list args;
+
+    fprintf(stderr, "sim: BUG at %llu ns: ", (unsigned long long) sim_now_ns);
+    va_start(args, fmt);
+    vfprintf(stderr, fmt, args);
+    va_end(args);
+    fputc('\n', stderr);
+    abort();
+}
+
+/******************************************************************************
+ * Time and events
+******************************************************************************/
+
+/// @brief Brings the models up to the current time.
+static void sim_sync(void)
+{
+    am335x_i2c_sync(sim_now_ns);
+    mpu6050_model_sync(sim_now_ns);
+}
+
+/// @brief The CPU is busy for 'ns': the models keep going meanwhile.
+void sim_advance(uint64_t ns)
+{
+    sim_now_ns += ns;
+    if (irq_nesting != 0)
+        sim_stats.irq_ns += ns;
+    sim_sync();
+}
+
+/// @brief Runs a hard handler, in interrupt context.
+static void sim_run_handler(int irq, struct sim_irq *line)
+{
+    irqreturn_t ret;
+
+    irq_nesting++;
+    irqs_off++;
+    sim_stats.irqs[irq]++;
+    sim_advance(sim_opts.irq_entry_ns);
+
+    if (line->handler == NULL)
+        ret = IRQ_WAKE_THREAD;
+    else
+        ret = line->handler(irq, line->dev);
+    if (ret == IRQ_NONE)
+        sim_stats.irqs_none++;
+    if (ret == IRQ_WAKE_THREAD && line->thread_fn != NULL) {
+        line->thread_pending = true;
+        line->masked = (line->flags & IRQF_ONESHOT) != 0;
+    }
+
+    irqs_off--;
+    irq_nesting--;
+}
+
+/// @brief Interrupt line of an I2C controller that is high, or "-1".
+static int sim_i2c_irq_pending(void)
+{
+    unsigned int n;
+    int irq;
+
+    for (n = 0; n < AM335X_I2C_COUNT; n++) {
+        irq = i2c_controllers[n].irq;
+        if (irqs[irq].requested && am335x_i2c_irq_line(n))
+            return irq;
+    }
+    return -1;
+}
+
+/// @brief Runs every interrupt that is due, unless interrupts are off. The I2C
+///  lines are level triggered, so they are taken again for as long as they stay high.
+static void sim_deliver_irqs(void)
+{
+    struct dma_async_tx_descriptor *desc;
+    struct hrtimer *timer;
+    unsigned int storm = 0;
+    int irq;
+
+    if (irqs_off != 0)
+        return;
+
+    for (;;) {
+        sim_sync();
+
+        if ((irq = sim_i2c_irq_pending()) >= 0) {
+            if (++storm > 100000)
+                sim_bug("I2C interrupt storm on line %d: the handler doesn't clear its source.", irq);
+            sim_run_handler(irq, &irqs[irq]);
+            continue;
+        }
+
+        for (irq = 0; irq < SIM_IRQ_MAX; irq++) {
+            if (irqs[irq].edge_pending && !irqs[irq].masked)
+                break;
+        }
+        if (irq < SIM_IRQ_MAX) {
+            irqs[irq].edge_pending = false;
+            sim_run_handler(irq, &irqs[irq]);
+            continue;
+        }
+
+        // EDMA completion interrupt. The dmaengine callback runs from it.
+        if (edma_done != NULL && edma_done_ns <= sim_now_ns) {
+            desc = edma_done;
+            edma_done = NULL;
+            irq_nesting++;
+            irqs_off++;
+            sim_stats.dma_callbacks++;
+            sim_advance(sim_opts.irq_entry_ns);
+            if (desc->callback != NULL)
+                desc->callback(desc->callback_param);
+            irqs_off--;
+            irq_nesting--;
+            continue;
+        }
+
+        // Timer interrupt
+        list_for_each_entry(timer, &hrtimers, node) {
+            if (timer->expires_ns <= sim_now_ns)
+                break;
+        }
+        if (&timer->node != &hrtimers) {
+            list_del_init(&timer->node);
+            irq_nesting++;
+            irqs_off++;
+            sim_advance(sim_opts.irq_entry_ns);
+            if (timer->function(timer) == HRTIMER_RESTART && list_empty(&timer->node))
+                list_add_tail(&timer->node, &hrtimers);
+            irqs_off--;
+            irq_nesting--;
+            continue;
+        }
+        return;
+    }
+}
+
+/// @brief Runs one threaded handler or due work item, in process context.
+/// @return "true" if something ran.
+static bool sim_run_process_context(void)
+{
+    struct delayed_work *dwork;
+    struct work_struct *work;
+    struct sim_irq *line;
+    bool nested = in_thread;
+    int irq;
+
+    // Queued work runs even from inside another, as on another kworker: the
+    // bus recovery has to, while a FIFO drain waits for its transfer.
+    list_for_each_entry(work, &works, node) {
+        list_del_init(&work->node);
+        work->pending = false;
+        work->running = true;
+        in_thread = true;
+        work->func(work);
+        in_thread = nested;
+        work->running = false;
+        return true;
+    }
+
+    // Don't start a new one from inside another: the kernel would, but on
+    // another thread, and one level is all the rest of the driver needs.
+    if (in_thread)
+        return false;
+
+    for (irq = 0; irq < SIM_IRQ_MAX; irq++) {
+        line = &irqs[irq];
+        if (!line->thread_pending)
+            continue;
+        line->thread_pending = false;
+        in_thread = true;
+        line->thread_fn(irq, line->dev);
+        in_thread = false;
+        line->masked = false;
+        return true;
+    }
+
+    list_for_each_entry(dwork, &timers, node) {
+        if (dwork->expires_ns > sim_now_ns || dwork->work.running)
+            continue;
+        list_del_init(&dwork->node);
+        dwork->pending = false;
+        dwork->work.running = true;
+        in_thread = true;
+        dwork->work.func(&dwork->work);
+        in_thread = false;
+        dwork->work.running = false;
+        return true;
+    }
+    return false;
+}
+
+/// @brief Time of the next thing that will happen by itself.
+static u64 sim_next_event(void)
+{
+    struct delayed_work *dwork;
+    struct hrtimer *timer;
+    u64 next = min(am335x_i2c_next_event(), mpu6050_model_next_event());
+
+    if (!list_empty(&works))
+        return sim_now_ns;
+    if (edma_done != NULL)
+        next = min(next, edma_done_ns);
+    list_for_each_entry(timer, &hrtimers, node)
+        next = min(next, timer->expires_ns);
+    // Work due while another one sleeps waits for it, see sim_run_process_context()
+    if (in_thread)
+        return next;
+    list_for_each_entry(dwork, &timers, node) {
+        if (!dwork->work.running)
+            next = min(next, dwork->expires_ns);
+    }
+    return next;
+}
+
+/// @brief Lets the CPU idle until the next event or 'deadline_ns', and runs
+///  everything that became due.
+/// @return "false" once the deadline is reached.
+bool sim_idle(uint64_t deadline_ns)
+{
+    u64 next;
+
+    sim_deliver_irqs();
+    if (sim_run_process_context())
+        return sim_now_ns < deadline_ns;
+    if (sim_now_ns >= deadline_ns)
+        return false;
+
+    next = min(sim_next_event(), deadline_ns);
+    if (next == UINT64_MAX)
+        sim_bug("Waiting forever: nothing left that could wake us up.");
+    if (next > sim_now_ns) {
+        sim_stats.idle_ns += next - sim_now_ns;
+        sim_now_ns = next;
+    }
+
+    sim_deliver_irqs();
+    sim_run_process_context();
+    return sim_now_ns < deadline_ns;
+}
+
+/// @brief Lets 'ns' of modelled time go by.
+void sim_run_for(uint64_t ns)
+{
+    u64 deadline = sim_now_ns + ns;
+
+    while (sim_idle(deadline))
+        ;
+}
+
+void sim_reset_stats(void)
+{
+    memset(&sim_stats, 0, sizeof(sim_stats));
+}
+
+/******************************************************************************
+ * Models' hooks
+******************************************************************************/
+
+/// @brief Edge on an interrupt line. The GPIO controller latches one.
+void sim_raise_irq(int irq)
+{
+    if (!irqs[irq].requested)
+        return;
+    if (irqs[irq].edge_pending || irqs[irq].masked)
+        sim_stats.edges_lost++;
+    irqs[irq].edge_pending = true;
+}
+
+/// @brief EDMA serving a TX request of the controller.
+/// @return Next byte of the active descriptor, "-1" if there is none.
+int sim_edma_pull(int channel)
+{
+    struct dma_async_tx_descriptor *desc = edma_chans[channel].active;
+
+    if (desc == NULL || desc->pos == desc->len)
+        return -1;
+    sim_stats.dma_bytes++;
+    if (desc->pos + 1 == desc->len)
+        edma_chans[channel].completed_cookie = desc->cookie;
+    return desc->buf[desc->pos++];
+}
+
+/// @brief EDMA serving an RX request of the controller. The callback is raised
+///  once the descriptor is full.
+/// @return "false" if there is no descriptor to take the byte.
+bool sim_edma_push(int channel, uint8_t byte)
+{
+    struct dma_async_tx_descriptor *desc = edma_chans[channel].active;
+
+    if (desc == NULL || desc->pos == desc->len)
+        return false;
+    sim_stats.dma_bytes++;
+    desc->buf[desc->pos++] = byte;
+    if (desc->pos == desc->len) {
+        edma_chans[channel].active = NULL;
+        edma_chans[channel].completed_cookie = desc->cookie;
+        edma_done = desc;
+        edma_done_ns = sim_now_ns + sim_opts.dma_irq_ns;
+    }
+    return true;
+}
+
+int sim_param_set(const char *name, long value)
+{
+    int i;
+
+    for (i = 0; i < param_count; i++) {
+        if (strcmp(params[i].name, name) != 0)
+            continue;
+        switch (params[i].size) {
+        case 1: *(u8 *) params[i].value = value; break;
+        case 2: *(u16 *) params[i].value = value; break;
+        case 4: *(u32 *) params[i].value = value; break;
+        default: *(u64 *) params[i].value = value; break;
+        }
+        return 0;
+    }
+    return -ENOENT;
+}
+
+void sim_param_register(const char *name, void *value, size_t size, bool is_signed)
+{
+    if (param_count == SIM_MAX_PARAMS)
+        sim_bug("Too many module parameters.");
+    params[param_count++] = (struct sim_param) { name, value, size, is_signed };
+}
+
+/******************************************************************************
+ * printk
+******************************************************************************/
+
+int sim_printk(int level, const char *fmt, ...)
+{
+    va_list args;
+    int len;
+
+    if (level == SIM_LOG_INFO && sim_opts.verbose == 0)
+        return 0;
+
+    fprintf(stderr, "[%10.6f] ", sim_now_ns / 1e9);
+    va_start(args, fmt);
+    len = vfprintf(stderr, fmt, args);
+    va_end(args);
+    return len;
+}
+
+/******************************************************************************
+ * Sleeping
+******************************************************************************/
+
+void sim_might_sleep(void)
+{
+    if (irqs_off != 0)
+        sim_bug("Sleeping with interrupts off or in interrupt context.");
+}
+
+void sim_wait_step(const char *what)
+{
+    if (!sim_idle(UINT64_MAX))
+        sim_bug("Nothing left that could make '%s' true.", what);
+}
+
+void msleep(unsigned int ms)
+{
+    u64 deadline = sim_now_ns + (u64) ms * NSEC_PER_MSEC;
+
+    sim_might_sleep();
+    while (sim_idle(deadline))
+        ;
+}
+
+void usleep_range(unsigned long min_us, unsigned long max_us)
+{
+    u64 deadline = sim_now_ns + (u64) min_us * NSEC_PER_USEC;
+
+    (void) max_us;
+    sim_might_sleep();
+    while (sim_idle(deadline))
+        ;
+}
+
+/// @brief Busy waits: no idle time, but interrupts still come in.
+void udelay(unsigned long us)
+{
+    ndelay(us * NSEC_PER_USEC);
+}
+
+void ndelay(unsigned long ns)
+{
+    u64 deadline = sim_now_ns + ns;
+
+    while (sim_now_ns < deadline) {
+        sim_advance(min_t(u64, deadline - sim_now_ns, 100));
+        sim_deliver_irqs();
+    }
+}
+
+void wait_for_completion(struct completion *x)
+{
+    sim_might_sleep();
+    while (x->done == 0)
+        sim_wait_step("wait_for_completion()");
+    x->done--;
+}
+
+unsigned long wait_for_completion_timeout(struct completion *x, unsigned long timeout)
+{
+    u64 deadline = sim_now_ns + (u64) timeout * (NSEC_PER_SEC / HZ);
+
+    sim_might_sleep();
+    while (x->done == 0) {
+        if (!sim_idle(deadline) && x->done == 0)
+            return 0;
+    }
+    x->done--;
+    return max_t(unsigned long, 1, (deadline - sim_now_ns) / (NSEC_PER_SEC / HZ));
+}
+
+/******************************************************************************
+ * Locking
+******************************************************************************/
+
+void sim_spin_acquire(spinlock_t *lock)
+{
+    if (lock->locked)
+        sim_bug("Spinlock %p taken twice: deadlock.", (void *) lock);
+    lock->locked = 1;
+}
+
+void sim_spin_release(spinlock_t *lock)
+{
+    if (!lock->locked)
+        sim_bug("Spinlock %p released but not held.", (void *) lock);
+    lock->locked = 0;
+}
+
+unsigned long sim_irq_save(void)
+{
+    return irqs_off++;
+}
+
+/// @brief Interrupts that came in while they were off are taken right away.
+void sim_irq_restore(unsigned long flags)
+{
+    irqs_off = flags;
+    sim_deliver_irqs();
+}
+
+/******************************************************************************
+ * Memory mapped I/O
+******************************************************************************/
+
+void __iomem *ioremap(phys_addr_t offset, size_t size)
+{
+    struct sim_region *region;
+    void *virt;
+    int i;
+
+    for (i = 0; i < SIM_MAX_REGIONS && regions[i].virt != NULL; i++)
+        ;
+    if (i == SIM_MAX_REGIONS)
+        return NULL;
+    region = &regions[i];
+
+    // The driver keeps these pointers in 32 bit integers now and then, as it
+    // was written for the AM335x. Ask for low addresses so they survive.
+    virt = mmap((void *) (0x10000000UL + i * 0x100000UL), size, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (virt == MAP_FAILED)
+        return NULL;
+    if ((uintptr_t) virt + size > 0x80000000UL)
+        sim_bug("ioremap() got %p, too high to fit in 32 bits.", virt);
+
+    region->phys = offset;
+    region->size = size;
+    region->virt = virt;
+    return virt;
+}
+
+void iounmap(void __iomem *addr)
+{
+    int i;
+
+    for (i = 0; i < SIM_MAX_REGIONS; i++) {
+        if (regions[i].virt == addr) {
+            munmap(regions[i].virt, regions[i].size);
+            regions[i].virt = NULL;
+            return;
+        }
+    }
+    sim_bug("iounmap() of %p, which wasn't mapped.", addr);
+}
+
+/// @brief Number of the I2C controller at 'phys', or "-1".
+static int sim_i2c_controller(phys_addr_t phys)
+{
+    int n;
+
+    for (n = 0; n < AM335X_I2C_COUNT; n++) {
+        if (i2c_controllers[n].base == phys)
+            return n;
+    }
+    return -1;
+}
+
+/// @brief Region of a mapped address.
+static struct sim_region *sim_find_region(const void *addr, u32 *offset)
+{
+    const u8 *p = addr;
+    int i;
+
+    for (i = 0; i < SIM_MAX_REGIONS; i++) {
+        if (regions[i].virt != NULL && p >= regions[i].virt && p < regions[i].virt + regions[i].size) {
+            *offset = p - regions[i].virt;
+            return &regions[i];
+        }
+    }
+    sim_bug("Access to %p, which isn't mapped.", addr);
+}
+
+u32 ioread32(const void __iomem *addr)
+{
+    u32 offset;
+    struct sim_region *region = sim_find_region(addr, &offset);
+    int n = sim_i2c_controller(region->phys);
+
+    sim_stats.mmio_reads++;
+    sim_advance(sim_opts.mmio_read_ns);
+    if (n >= 0)
+        return am335x_i2c_read(n, offset);
+    return *(const u32 *) addr;
+}
+
+void iowrite32(u32 value, void __iomem *addr)
+{
+    u32 offset;
+    struct sim_region *region = sim_find_region(addr, &offset);
+    int n = sim_i2c_controller(region->phys);
+
+    sim_stats.mmio_writes++;
+    sim_advance(sim_opts.mmio_write_ns);
+    if (n >= 0)
+        am335x_i2c_write(n, offset, value);
+    else
+        *(u32 *) addr = value;
+}
+
+/******************************************************************************
+ * Device tree and interrupts
+******************************************************************************/
+
+bool device_property_present(struct device *dev, const char *name)
+{
+    return strcmp(name, "pins") == 0 && dev->of_node != NULL && dev->of_node->pins != NULL;
+}
+
+int device_property_read_u32_array(struct device *dev, const char *name, u32 *values, size_t count)
+{
+    if (!device_property_present(dev, name))
+        return -EINVAL;
+    memcpy(values, dev->of_node->pins, count * sizeof(u32));
+    return 0;
+}
+
+int device_property_read_u32(struct device *dev, const char *name, u32 *value)
+{
+    const struct device_node *node = dev->of_node;
+    u32 found = 0;
+
+    if (node == NULL)
+        return -EINVAL;
+    if (strcmp(name, "clock-frequency") == 0)
+        found = node->clock_frequency;
+    else if (strcmp(name, "int-clock-frequency") == 0)
+        found = node->int_clock_frequency;
+    else if (strcmp(name, "i2c-scl-rising-time-ns") == 0)
+        found = node->scl_rising_time_ns;
+    if (found == 0)
+        return -EINVAL;
+    *value = found;
+    return 0;
+}
+
+struct device_node *of_get_next_available_child(const struct device_node *parent, struct device_node *prev)
+{
+    struct device_node *node = (prev != NULL) ? prev->sibling : parent->child;
+
+    while (node != NULL && node->disabled)
+        node = node->sibling;
+    return node;
+}
+
+bool of_device_is_compatible(const struct device_node *node, const char *compatible)
+{
+    return node->compatible != NULL && strcmp(node->compatible, compatible) == 0;
+}
+
+int of_property_read_u32(const struct device_node *node, const char *name, u32 *value)
+{
+    if (strcmp(name, "reg") != 0 || node->reg == 0)
+        return -EINVAL;
+    *value = node->reg;
+    return 0;
+}
+
+int of_irq_get(struct device_node *node, int index)
+{
+    return (index == 0 && node->irq != 0) ? node->irq : -EINVAL;
+}
+
+struct resource *platform_get_resource(struct platform_device *pdev, unsigned int type, unsigned int num)
+{
+    return (type == IORESOURCE_MEM && num == 0) ? pdev->resource : NULL;
+}
+
+int platform_get_irq(struct platform_device *pdev, unsigned int index)
+{
+    return index == 0 ? pdev->irq : -ENXIO;
+}
+
+int request_threaded_irq(unsigned int irq, irq_handler_t handler, irq_handler_t thread_fn,
+    unsigned long flags, const char *name, void *dev)
+{
+    (void) name;
+    if (irq >= SIM_IRQ_MAX || (handler == NULL && thread_fn == NULL))
+        return -EINVAL;
+    if (irqs[irq].requested)
+        return -EBUSY;
+
+    irqs[irq] = (struct sim_irq) {
+        .handler = handler,
+        .thread_fn = thread_fn,
+        .flags = flags,
+        .dev = dev,
+        .requested = true,
+    };
+    return 0;
+}
+
+void free_irq(unsigned int irq, void *dev)
+{
+    if (irq >= SIM_IRQ_MAX || !irqs[irq].requested || irqs[irq].dev != dev)
+        sim_bug("free_irq(%u) of a line that wasn't requested.", irq);
+    if (irq_nesting != 0 || in_thread)
+        sim_bug("free_irq(%u) would wait for itself.", irq);
+    memset(&irqs[irq], 0, sizeof(irqs[irq]));
+}
+
+/******************************************************************************
+ * I2C core
+******************************************************************************/
+
+int i2c_add_adapter(struct i2c_adapter *adap)
+{
+    if (adap->algo == NULL || adap->algo->master_xfer == NULL || adap->name[0] == '\0')
+        return -EINVAL;
+    adap->nr = i2c_adapters_next++;
+    list_add_tail(&adap->node, &i2c_adapters);
+    return 0;
+}
+
+void i2c_del_adapter(struct i2c_adapter *adap)
+{
+    list_del_init(&adap->node);
+}
+
+struct i2c_adapter *i2c_get_adapter(int nr)
+{
+    struct i2c_adapter *adap;
+
+    list_for_each_entry(adap, &i2c_adapters, node) {
+        if (adap->nr == nr)
+            return adap;
+    }
+    return NULL;
+}
+
+/// @brief Like the core: checks the quirks, then hands the messages to the adapter.
+int i2c_transfer(struct i2c_adapter *adap, struct i2c_msg *msgs, int num)
+{
+    int i;
+
+    if (adap->quirks != NULL && (adap->quirks->flags & I2C_AQ_NO_ZERO_LEN)) {
+        for (i = 0; i < num; i++) {
+            if (msgs[i].len == 0)
+                return -EOPNOTSUPP;
+        }
+    }
+    return adap->algo->master_xfer(adap, msgs, num);
+}
+
+/******************************************************************************
+ * High resolution timers
+******************************************************************************/
+
+void hrtimer_init(struct hrtimer *timer, clockid_t clock, enum hrtimer_mode mode)
+{
+    (void) clock;
+    (void) mode;
+    timer->function = NULL;
+    INIT_LIST_HEAD(&timer->node);
+}
+
+void hrtimer_start(struct hrtimer *timer, ktime_t time, const enum hrtimer_mode mode)
+{
+    list_del_init(&timer->node);
+    timer->expires_ns = (mode == HRTIMER_MODE_REL) ? sim_now_ns + time : (u64) time;
+    list_add_tail(&timer->node, &hrtimers);
+}
+
+/// @return "1" if it was armed, "0" if not. A running callback (single CPU) can
+///  only be the caller, so "-1" never happens.
+int hrtimer_try_to_cancel(struct hrtimer *timer)
+{
+    if (list_empty(&timer->node))
+        return 0;
+    list_del_init(&timer->node);
+    return 1;
+}
+
+int hrtimer_cancel(struct hrtimer *timer)
+{
+    return hrtimer_try_to_cancel(timer);
+}
+
+/******************************************************************************
+ * Work queues
+******************************************************************************/
+
+void sim_init_work(struct work_struct *work, work_func_t func)
+{
+    work->func = func;
+    work->running = false;
+    work->pending = false;
+    INIT_LIST_HEAD(&work->node);
+}
+
+bool schedule_work(struct work_struct *work)
+{
+    if (work->pending)
+        return false;
+    work->pending = true;
+    list_add_tail(&work->node, &works);
+    return true;
+}
+
+bool cancel_work_sync(struct work_struct *work)
+{
+    bool pending = work->pending;
+
+    if (work->running)
+        sim_bug("cancel_work_sync() from the work itself.");
+    if (pending) {
+        list_del_init(&work->node);
+        work->pending = false;
+    }
+    return pending;
+}
+
+void sim_init_delayed_work(struct delayed_work *dwork, work_func_t func)
+{
+    dwork->work.func = func;
+    dwork->work.running = false;
+    dwork->pending = false;
+    INIT_LIST_HEAD(&dwork->node);
+}
+
+bool queue_delayed_work(struct workqueue_struct *wq, struct delayed_work *dwork, unsigned long delay)
+{
+    (void) wq;
+    if (dwork->pending)
+        return false;
+    dwork->pending = true;
+    dwork->expires_ns = sim_now_ns + (u64) delay * (NSEC_PER_SEC / HZ);
+    list_add_tail(&dwork->node, &timers);
+    return true;
+}
+
+bool mod_delayed_work(struct workqueue_struct *wq, struct delayed_work *dwork, unsigned long delay)
+{
+    bool pending = dwork->pending;
+
+    if (pending) {
+        list_del_init(&dwork->node);
+        dwork->pending = false;
+    }
+    queue_delayed_work(wq, dwork, delay);
+    return pending;
+}
+
+bool cancel_delayed_work_sync(struct delayed_work *dwork)
+{
+    bool pending = dwork->pending;
+
+    if (dwork->work.running)
+        sim_bug("cancel_delayed_work_sync() from the work itself.");
+    if (pending) {
+        list_del_init(&dwork->node);
+        dwork->pending = false;
+    }
+    return pending;
+}
+
+/******************************************************************************
+ * EDMA
+******************************************************************************/
+
+struct dma_chan *dma_request_chan(struct device *dev, const char *name)
+{
+    if (!sim_opts.dma || dev->of_node == NULL || !dev->of_node->dmas)
+        return ERR_PTR(-ENODEV);
+    if (strcmp(name, "tx") == 0)
+        return &edma_chans[SIM_EDMA_TX];
+    if (strcmp(name, "rx") == 0)
+        return &edma_chans[SIM_EDMA_RX];
+    return ERR_PTR(-ENODEV);
+}
+
+void dma_release_channel(struct dma_chan *chan)
+{
+    chan->active = NULL;
+}
+
+int dmaengine_slave_config(struct dma_chan *chan, struct dma_slave_config *config)
+{
+    (void) chan;
+    if (config->src_addr != AM335X_I2C2_BASE + 0x9C || config->dst_addr != AM335X_I2C2_BASE + 0x9C)
+        sim_bug("EDMA configured for %#llx, not for I2C2 DATA.", (unsigned long long) config->src_addr);
+    return 0;
+}
+
+struct dma_async_tx_descriptor *dmaengine_prep_slave_single(struct dma_chan *chan, dma_addr_t buf,
+    size_t len, enum dma_transfer_direction dir, unsigned long flags)
+{
+    struct dma_async_tx_descriptor *desc = &edma_descs[chan->channel];
+
+    (void) flags;
+    if ((dir == DMA_DEV_TO_MEM) != (chan->channel == SIM_EDMA_RX))
+        sim_bug("EDMA channel %d prepared in the wrong direction.", chan->channel);
+    if (desc == edma_done)
+        edma_done = NULL;
+
+    *desc = (struct dma_async_tx_descriptor) {
+        .chan = chan,
+        .buf = (u8 *) (uintptr_t) buf,
+        .len = len,
+    };
+    return desc;
+}
+
+dma_cookie_t dmaengine_submit(struct dma_async_tx_descriptor *desc)
+{
+    desc->cookie = ++desc->chan->cookie;
+    return desc->cookie;
+}
+
+enum dma_status dmaengine_tx_status(struct dma_chan *chan, dma_cookie_t cookie, struct dma_tx_state *state)
+{
+    (void) state;
+    return (cookie - chan->completed_cookie <= 0) ? DMA_COMPLETE : DMA_IN_PROGRESS;
+}
+
+void dma_async_issue_pending(struct dma_chan *chan)
+{
+    chan->active = &edma_descs[chan->channel];
+    am335x_i2c_edma_service();
+}
+
+int dmaengine_terminate_async(struct dma_chan *chan)
+{
+    if (chan == NULL)
+        sim_bug("dmaengine_terminate_async(NULL).");
+    chan->active = NULL;
+    if (edma_done == &edma_descs[chan->channel])
+        edma_done = NULL;
+    return 0;
+}
+
+int dmaengine_terminate_sync(struct dma_chan *chan)
+{
+    return dmaengine_terminate_async(chan);
+}
+
+void *dma_alloc_coherent(struct device *dev, size_t size, dma_addr_t *handle, gfp_t flags)
+{
+    void *p = calloc(1, size);
+
+    (void) dev; (void) flags;
+    *handle = (dma_addr_t) (uintptr_t) p;
+    return p;
+}
+
+void dma_free_coherent(struct device *dev, size_t size, void *addr, dma_addr_t handle)
+{
+    (void) dev; (void) size; (void) handle;
+    free(addr);
+}
+
+/******************************************************************************
+ * seq_file and debugfs
+******************************************************************************/
+
+int seq_printf(struct seq_file *m, const char *fmt, ...)
+{
+    va_list args;
+    int len;
+
+    va_start(args, fmt);
+    len = vsnprintf(NULL, 0, fmt, args);
+    va_end(args);
+
+    if (m->count + len + 1 > m->size) {
+        m->size = 2 * (m->count + len + 1);
+        if ((m->buf = realloc(m->buf, m->size)) == NULL)
+            sim_bug("Out of memory.");
+    }
+    va_start(args, fmt);
+    vsnprintf(m->buf + m->count, len + 1, fmt, args);
+    va_end(args);
+    m->count += len;
+    return 0;
+}
+
+int single_open(struct file *file, int (*show)(struct seq_file *m, void *v), void *data)
+{
+    struct seq_file *m = calloc(1, sizeof(*m));
+
+    m->show = show;
+    m->private = data;
+    file->private_data = m;
+    return 0;
+}
+
+ssize_t seq_read(struct file *file, char __user *buf, size_t count, loff_t *offs)
+{
+    struct seq_file *m = file->private_data;
+    int retval;
+
+    if (*offs == 0) {
+        m->count = 0;
+        if ((retval = m->show(m, NULL)) != 0)
+            return retval;
+    }
+    if ((size_t) *offs >= m->count)
+        return 0;
+    count = min_t(size_t, count, m->count - *offs);
+    memcpy(buf, m->buf + *offs, count);
+    *offs += count;
+    return count;
+}
+
+loff_t seq_lseek(struct file *file, loff_t offset, int whence)
+{
+    return -ESPIPE;
+}
+
+int single_release(struct inode *inode, struct file *file)
+{
+    struct seq_file *m = file->private_data;
+
+    free(m->buf);
+    free(m);
+    return 0;
+}
+
+#define SIM_MAX_DEBUGFS 16
+static struct sim_debugfs_entry {
+    char path[64];
+    const struct file_operations *fops;
+    void *data;
+    bool used;
+} debugfs[SIM_MAX_DEBUGFS];
+
+// Directories are entries with no file operations
+struct dentry *debugfs_create_dir(const char *name, struct dentry *parent)
+{
+    return debugfs_create_file(name, 0755, parent, NULL, NULL);
+}
+
+struct dentry *debugfs_create_file(const char *name, umode_t mode, struct dentry *parent,
+    void *data, const struct file_operations *fops)
+{
+    struct sim_debugfs_entry *entry;
+    int i;
+
+    for (i = 0; i < SIM_MAX_DEBUGFS && debugfs[i].used; i++)
+        ;
+    if (i == SIM_MAX_DEBUGFS)
+        sim_bug("Too many debugfs files.");
+    entry = &debugfs[i];
+    if (snprintf(entry->path, sizeof(entry->path), "%s%s%s",
+            parent ? ((struct sim_debugfs_entry *) parent)->path : "", parent ? "/" : "", name) >= (int) sizeof(entry->path))
+        sim_bug("debugfs path too long: %s.", name);
+    entry->fops = fops;
+    entry->data = data;
+    entry->used = true;
+    return (struct dentry *) entry;
+}
+
+void debugfs_remove_recursive(struct dentry *dentry)
+{
+    struct sim_debugfs_entry *dir = (struct sim_debugfs_entry *) dentry;
+    size_t len;
+    int i;
+
+    if (dir == NULL)
+        return;
+    len = strlen(dir->path);
+    for (i = 0; i < SIM_MAX_DEBUGFS; i++) {
+        if (&debugfs[i] != dir && strncmp(debugfs[i].path, dir->path, len) == 0 && debugfs[i].path[len] == '/')
+            debugfs[i].used = false;
+    }
+    dir->used = false;
+}
+
+static struct sim_debugfs_entry *sim_debugfs_find(const char *path)
+{
+    int i;
+
+    for (i = 0; i < SIM_MAX_DEBUGFS; i++) {
+        if (debugfs[i].used && debugfs[i].fops != NULL && strcmp(debugfs[i].path, path) == 0)
+            return &debugfs[i];
+    }
+    return NULL;
+}
+
+int sim_debugfs_read(const char *path, FILE *out)
+{
+    struct sim_debugfs_entry *entry = sim_debugfs_find(path);
+    struct inode inode;
+    struct file file = { 0 };
+    char buf[256];
+    loff_t offs = 0;
+    ssize_t len;
+    int retval;
+
+    if (entry == NULL || entry->fops->read == NULL)
+        return -ENOENT;
+    inode.i_private = entry->data;
+    if (entry->fops->open != NULL && (retval = entry->fops->open(&inode, &file)) != 0)
+        return retval;
+    while ((len = entry->fops->read(&file, buf, sizeof(buf), &offs)) > 0)
+        fwrite(buf, 1, len, out);
+    if (entry->fops->release != NULL)
+        entry->fops->release(&inode, &file);
+    return len < 0 ? len : 0;
+}
+
+int sim_debugfs_write(const char *path, const char *text)
+{
+    struct sim_debugfs_entry *entry = sim_debugfs_find(path);
+    struct inode inode;
+    struct file file = { 0 };
+    loff_t offs = 0;
+    ssize_t len;
+    int retval;
+
+    if (entry == NULL || entry->fops->write == NULL)
+        return -ENOENT;
+    inode.i_private = entry->data;
+    if (entry->fops->open != NULL && (retval = entry->fops->open(&inode, &file)) != 0)
+        return retval;
+    len = entry->fops->write(&file, text, strlen(text), &offs);
+    if (entry->fops->release != NULL)
+        entry->fops->release(&inode, &file);
+    return len < 0 ? len : 0;
+}
@@ -0,0 +1,685 @@
+#include <getopt.h>
+#include "kernel/sim_kernel.h"
+#include "i2c.h"
+#include "MPU6050.h"
+#include "acquisition.h"
+#include "sample_ring.h"
+#include "../bench_stats.h"
+
+// Runs the driver on the simulated BeagleBone: probes it like lucas_lkm.c does,
+// lets it stream for a while in one of its modes and reports what the bus and
+// the CPU went through. Every sample is checked against what the sensor model
+// produced (see mpu6050_model.c). With --sensors 2 a second MPU6050 at 0x69
+// shares the bus and both are read at once. With --buses 2 as well, each one is
+// at 0x68 on its own controller (I2C2 and I2C1), which run in parallel.
+
+#define MODE_POLLED     0
+#define MODE_DRDY       1
+#define MODE_FIFO       2
+#define MODE_BURST      3
+
+static const char *mode_names[] = { "polled", "drdy", "fifo", "burst" };
+
+// Device tree of the overlay: the bus nodes (I2C2 with EDMA, then I2C1) and
+// their parent target-module
+#define SIM_BUSES_MAX   2
+static const u32 pins[SIM_BUSES_MAX][4] = {
+    { 0x978, 0x33, 0x97C, 0x33 },
+    { 0x95C, 0x32, 0x958, 0x32 },
+};
+static struct device_node mpu_nodes[SIM_MPU6050_MAX];
+static struct device target_module;
+static struct {
+    unsigned int controller;
+    struct device_node node;
+    struct resource res;
+    struct platform_device pdev;
+    struct i2c_bus i2c;
+} buses[SIM_BUSES_MAX] = {
+    { .controller = 2, .node = { .compatible = "lliano,i2c", .pins = pins[0], .dmas = true,
+                                 .int_clock_frequency = 12000000 },
+      .res = { AM335X_I2C2_BASE, AM335X_I2C2_BASE + AM335X_I2C_LEN - 1, IORESOURCE_MEM },
+      .pdev = { .name = "4819c000.i2c", .irq = SIM_IRQ_I2C2 } },
+    { .controller = 1, .node = { .compatible = "lliano,i2c", .pins = pins[1],
+                                 .int_clock_frequency = 12000000 },
+      .res = { AM335X_I2C1_BASE, AM335X_I2C1_BASE + AM335X_I2C_LEN - 1, IORESOURCE_MEM },
+      .pdev = { .name = "4802a000.i2c", .irq = SIM_IRQ_I2C1 } },
+};
+
+static struct {
+    int mode;
+    double seconds;
+    unsigned int rate_div;
+    unsigned int watermark;
+    long dma_threshold;
+    unsigned int reader_period_us;
+    unsigned int burst_len;
+    unsigned int sensors;
+    unsigned int buses;
+    unsigned int scl_hz;
+    bool json;
+    bool driver_stats;
+    bool selftest;
+} cfg = {
+    .mode = MODE_DRDY,
+    .sensors = 1,
+    .buses = 1,
+    .scl_hz = 400000,
+    .seconds = 1.0,
+    .rate_div = ACQUISITION_DEFAULT_RATE_DIV,
+    .watermark = ACQUISITION_DEFAULT_FIFO_WATERMARK,
+    .dma_threshold = -1,
+    .reader_period_us = 0,
+    .burst_len = 32 * MPU6050_MOTION7_LENGTH,
+};
+
+// The sensors, as i2c_probe() brings them up, and the last sample the reader
+// got from each
+static struct {
+    unsigned int bus;
+    MPU6050_t mpu;
+    struct acquisition acq;
+    u64 records;
+    u32 last_index;
+    u64 last_timestamp_ns;
+} sensors[SIM_MPU6050_MAX];
+
+// What the reader got, from every sensor
+static struct {
+    u64 records;
+    u64 lost;               // Samples of the sensor that never showed up
+    u64 repeated;
+    u64 torn;               // Registers of different samples mixed up
+    u32 ring_dropped;       // Overwritten in the ring before they were read
+    u64 latency_sum_ns;     // Record timestamp - time the sensor took the sample
+    u64 latency_max_ns;
+    u64 latency_count;
+    int errors;
+    u64 calls;              // Reads that returned samples
+    struct bench_dist read_latency; // Modelled time of each read
+    struct bench_dist age;          // Time the reader got a record - its timestamp
+    struct bench_dist interval;     // Between the timestamps of consecutive samples
+} rd;
+
+/******************************************************************************
+ * Sample checks
+******************************************************************************/
+
+/// @brief Accounts for a record of sensor 'n' against the sample pattern of its model.
+static void check_record(unsigned int n, const struct mpu6050_record *record)
+{
+    u32 index = (u16) record->accel[0] | ((u32) (u16) record->accel[1] << 16);
+    uint64_t taken;
+
+    if (record->accel[2] != 16384 || record->gyro[0] != (s16) (index * 3) ||
+            record->gyro[1] != (s16) (index * 5) || record->gyro[2] != (s16) (index * 7)) {
+        rd.torn++;
+        return;
+    }
+
+    if (sensors[n].records != 0) {
+        if ((s32) (index - sensors[n].last_index) <= 0)
+            rd.repeated++;
+        else
+            rd.lost += index - sensors[n].last_index - 1;
+        if (index - sensors[n].last_index == 1 && record->timestamp_ns > sensors[n].last_timestamp_ns)
+            bench_dist_add(&rd.interval, record->timestamp_ns - sensors[n].last_timestamp_ns);
+    }
+    rd.records++;
+    sensors[n].records++;
+    sensors[n].last_index = index;
+    sensors[n].last_timestamp_ns = record->timestamp_ns;
+    if (record->timestamp_ns != 0 && sim_now_ns >= record->timestamp_ns)
+        bench_dist_add(&rd.age, sim_now_ns - record->timestamp_ns);
+
+    if (record->timestamp_ns != 0 && mpu6050_model_sample_time(n, index, &taken) && record->timestamp_ns >= taken) {
+        rd.latency_sum_ns += record->timestamp_ns - taken;
+        rd.latency_max_ns = max(rd.latency_max_ns, record->timestamp_ns - taken);
+        rd.latency_count++;
+    }
+}
+
+/// @brief Builds a record out of a motion7 burst, as the driver does.
+static void decode_motion7(struct mpu6050_record *record, const u8 *raw)
+{
+    int i;
+
+    memset(record, 0, sizeof(*record));
+    for (i = 0; i < 3; i++) {
+        record->accel[i] = (s16) get_unaligned_be16(&raw[2 * i]);
+        record->gyro[i] = (s16) get_unaligned_be16(&raw[8 + 2 * i]);
+    }
+    record->temp = (s16) get_unaligned_be16(&raw[6]);
+}
+
+/******************************************************************************
+ * Readers
+******************************************************************************/
+
+static void run_polled(u64 end_ns)
+{
+    struct mpu6050_record record;
+    unsigned int n;
+    u64 start;
+
+    while (sim_now_ns < end_ns) {
+        for (n = 0; n < cfg.sensors; n++) {
+            start = sim_now_ns;
+            if (acquisition_read_polled(&sensors[n].acq, &record) != 0) {
+                rd.errors++;
+            } else {
+                rd.calls++;
+                bench_dist_add(&rd.read_latency, sim_now_ns - start);
+                check_record(n, &record);
+            }
+        }
+        usleep_range(cfg.reader_period_us, cfg.reader_period_us);
+    }
+}
+
+static void run_ring(u64 end_ns)
+{
+    struct mpu6050_record record;
+    u32 tails[SIM_MPU6050_MAX];
+    unsigned int n;
+
+    for (n = 0; n < cfg.sensors; n++)
+        tails[n] = sample_ring_head(acquisition_get_ring(&sensors[n].acq));
+
+    while (sim_now_ns < end_ns) {
+        usleep_range(cfg.reader_period_us, cfg.reader_period_us);
+        // Popping takes no modelled time
+        for (n = 0; n < cfg.sensors; n++) {
+            while (sample_ring_pop(acquisition_get_ring(&sensors[n].acq), &tails[n], &record, &rd.ring_dropped) == 0) {
+                rd.calls++;
+                bench_dist_add(&rd.read_latency, 0);
+                check_record(n, &record);
+            }
+        }
+    }
+}
+
+/// @brief Complete frames in the MPU6050 FIFO, or 0 if the count couldn't be read.
+static unsigned int fifo_frames(MPU6050_t *mpu)
+{
+    u8 regs[2];
+
+    if (i2c_read_regs(mpu->bus, mpu->devAddr, MPU6050_RA_FIFO_COUNTH, (char *) regs, sizeof(regs)) != 0) {
+        rd.errors++;
+        return 0;
+    }
+    return (((unsigned int) regs[0] << 8) | regs[1]) / MPU6050_MOTION7_LENGTH;
+}
+
+/// @brief Long reads of the MPU6050 FIFO, to exercise the FIFO thresholds and EDMA.
+static void run_burst(u64 end_ns)
+{
+    u8 *data = malloc(cfg.burst_len);
+    struct mpu6050_record record;
+    unsigned int frames = cfg.burst_len / MPU6050_MOTION7_LENGTH;
+    unsigned int count, i, n;
+    MPU6050_t *mpu;
+    u64 start;
+
+    for (n = 0; n < cfg.sensors; n++) {
+        mpu = &sensors[n].mpu;
+        MPU6050_setFIFOEnabled(mpu, false);
+        MPU6050_resetFIFO(mpu);
+        MPU6050_setAccelFIFOEnabled(mpu, true);
+        MPU6050_setTempFIFOEnabled(mpu, true);
+        MPU6050_setXGyroFIFOEnabled(mpu, true);
+        MPU6050_setYGyroFIFOEnabled(mpu, true);
+        MPU6050_setZGyroFIFOEnabled(mpu, true);
+        MPU6050_setFIFOEnabled(mpu, true);
+    }
+
+    while (sim_now_ns < end_ns) {
+        usleep_range(cfg.reader_period_us, cfg.reader_period_us);
+        for (n = 0; n < cfg.sensors; n++) {
+            mpu = &sensors[n].mpu;
+            count = fifo_frames(mpu);
+            while (count != 0) {
+                count = min(count, frames);
+                start = sim_now_ns;
+                if (MPU6050_getFIFOBytes(mpu, data, count * MPU6050_MOTION7_LENGTH) != 0) {
+                    // Part of a frame may be gone: realign
+                    rd.errors++;
+                    MPU6050_resetFIFO(mpu);
+                    break;
+                }
+                rd.calls++;
+                bench_dist_add(&rd.read_latency, sim_now_ns - start);
+                for (i = 0; i < count; i++) {
+                    decode_motion7(&record, &data[i * MPU6050_MOTION7_LENGTH]);
+                    check_record(n, &record);
+                }
+                count = fifo_frames(mpu);
+            }
+        }
+    }
+
+    for (n = 0; n < cfg.sensors; n++)
+        MPU6050_setFIFOEnabled(&sensors[n].mpu, false);
+    free(data);
+}
+
+/// @brief Checks that every sensor of bus 'b' answered 0x68 to WHO_AM_I, and clears the answers.
+static bool check_who_am_i(unsigned int b, u8 *who)
+{
+    bool ok = true;
+    unsigned int n;
+
+    for (n = b; n < cfg.sensors; n += cfg.buses) {
+        ok = ok && who[n] == 0x68;
+        who[n] = 0;
+    }
+    return ok;
+}
+
+/// @brief Reads WHO_AM_I of every sensor on a bus, a write and a read per sensor
+///  all in a single transaction: with i2c_xfer(), and then through the I2C adapter
+///  of the bus, as a client driver or i2c-dev would.
+/// @return "0" if every sensor answered 0x68 both times, negative error code otherwise.
+static int check_xfer(unsigned int b)
+{
+    struct i2c_adapter *adap = i2c_get_adapter(buses[b].i2c.adapter.nr);
+    struct i2c_msg msgs[2 * SIM_MPU6050_MAX];
+    u8 reg = MPU6050_RA_WHO_AM_I;
+    u8 who[SIM_MPU6050_MAX];
+    u64 transactions = sim_stats.transactions;
+    u64 repeated_starts = sim_stats.repeated_starts;
+    u64 recoveries;
+    unsigned int n, num = 0;
+    int retval;
+
+    for (n = b; n < cfg.sensors; n += cfg.buses) {
+        msgs[num++] = (struct i2c_msg) { .addr = sensors[n].mpu.devAddr, .len = 1, .buf = &reg };
+        msgs[num++] = (struct i2c_msg) { .addr = sensors[n].mpu.devAddr, .flags = I2C_M_RD, .len = 1, .buf = &who[n] };
+    }
+    if ((retval = i2c_xfer(&buses[b].i2c, msgs, num)) != 0)
+        return retval;
+    if (!check_who_am_i(b, who))
+        return -EIO;
+
+    if (adap != &buses[b].i2c.adapter || !(adap->algo->functionality(adap) & I2C_FUNC_I2C))
+        return -ENODEV;
+    if ((retval = i2c_transfer(adap, msgs, num)) < 0)
+        return retval;
+    if (retval != (int) num || !check_who_am_i(b, who))
+        return -EIO;
+
+    printf("# i2c_xfer(%s), i2c_transfer(%s)\n", buses[b].i2c.name, adap->name);
+    printf("msgs                    %u\n", num);
+    printf("transactions            %llu\n", sim_stats.transactions - transactions);
+    printf("repeated_starts         %llu\n\n", sim_stats.repeated_starts - repeated_starts);
+
+    // Nobody at 0x50: the address NACK fails the transfer right away, without
+    // recovering the bus
+    recoveries = buses[b].i2c.stats.recoveries;
+    msgs[0] = (struct i2c_msg) { .addr = 0x50, .len = 1, .buf = &reg };
+    msgs[1] = (struct i2c_msg) { .addr = 0x50, .flags = I2C_M_RD, .len = 1, .buf = &who[b] };
+    if ((retval = i2c_xfer(&buses[b].i2c, msgs, 2)) != -ENXIO || (retval = i2c_transfer(adap, msgs, 2)) != -ENXIO)
+        return retval < 0 ? retval : -EIO;
+    if (buses[b].i2c.stats.recoveries != recoveries)
+        return -EIO;
+    return 0;
+}
+
+/******************************************************************************
+ * Report
+******************************************************************************/
+
+static double per(u64 value, u64 count)
+{
+    return count ? (double) value / count : 0.0;
+}
+
+/// @brief Interrupts of every controller in use.
+static u64 i2c_irqs(void)
+{
+    u64 irqs = 0;
+    unsigned int b;
+
+    for (b = 0; b < cfg.buses; b++)
+        irqs += sim_stats.irqs[buses[b].pdev.irq];
+    return irqs;
+}
+
+static void report(u64 elapsed_ns, u64 probe_ns, const struct sim_stats *probe)
+{
+    const struct sim_stats *s = &sim_stats;
+    u64 samples = rd.records ? rd.records : 1;
+    u64 mpu_irqs = 0;
+    unsigned int n;
+
+    printf("mode                    %s\n", mode_names[cfg.mode]);
+    printf("sample_rate_hz          %.1f\n", 1000.0 / (1 + cfg.rate_div));
+    printf("dma                     %s\n", sim_opts.dma ? "on" : "off");
+    printf("modelled_time_s         %.3f\n", elapsed_ns / 1e9);
+    printf("probe_time_ms           %.3f\n", probe_ns / 1e6);
+    printf("probe_transactions      %llu\n", (unsigned long long) probe->transactions);
+    printf("probe_bus_busy_ms       %.3f\n", probe->bus_busy_ns / 1e6);
+    printf("buses                   %u\n", cfg.buses);
+    printf("sensors                 %u\n", cfg.sensors);
+    printf("sensor_samples          %llu\n", (unsigned long long) s->samples);
+    printf("records                 %llu\n", (unsigned long long) rd.records);
+    if (cfg.sensors > 1)
+        for (n = 0; n < cfg.sensors; n++)
+            printf("records_%s_0x%02x       %llu\n", buses[sensors[n].bus].i2c.name, sensors[n].mpu.devAddr,
+                (unsigned long long) sensors[n].records);
+    printf("records_lost            %llu\n", (unsigned long long) rd.lost);
+    printf("records_repeated        %llu\n", (unsigned long long) rd.repeated);
+    printf("records_torn            %llu\n", (unsigned long long) rd.torn);
+    printf("ring_dropped            %u\n", rd.ring_dropped);
+    printf("sensor_fifo_overflows   %llu\n", (unsigned long long) s->fifo_overflows);
+    printf("read_errors             %d\n", rd.errors);
+    printf("latency_mean_us         %.2f\n", per(rd.latency_sum_ns, rd.latency_count) / 1e3);
+    printf("latency_max_us          %.2f\n", rd.latency_max_ns / 1e3);
+    printf("transactions            %llu\n", (unsigned long long) s->transactions);
+    printf("transactions_per_sample %.3f\n", per(s->transactions, samples));
+    printf("repeated_starts         %llu\n", (unsigned long long) s->repeated_starts);
+    printf("bytes_tx                %llu\n", (unsigned long long) s->bytes_tx);
+    printf("bytes_rx                %llu\n", (unsigned long long) s->bytes_rx);
+    printf("nacks                   %llu\n", (unsigned long long) s->nacks);
+    printf("arbitration_lost        %llu\n", (unsigned long long) s->arbitration_lost);
+    printf("scl_recovery_pulses     %llu\n", (unsigned long long) s->recovery_pulses);
+    printf("scl_stretches           %llu\n", (unsigned long long) s->stretches);
+    printf("bus_busy_ms             %.3f\n", s->bus_busy_ns / 1e6);
+    printf("bus_utilization_pct     %.2f\n", 100.0 * per(s->bus_busy_ns, elapsed_ns));
+    printf("bus_busy_us_per_sample  %.2f\n", per(s->bus_busy_ns, samples) / 1e3);
+    printf("scl_held_by_cpu_us      %.2f\n", s->bus_stall_ns / 1e3);
+    printf("i2c_irqs                %llu\n", (unsigned long long) i2c_irqs());
+    printf("i2c_irqs_per_transfer   %.3f\n", per(i2c_irqs(), s->transactions));
+    for (n = 0; n < cfg.sensors; n++)
+        mpu_irqs += s->irqs[SIM_IRQ_MPU6050 + n];
+    printf("mpu_irqs                %llu\n", (unsigned long long) mpu_irqs);
+    printf("mpu_edges_lost          %llu\n", (unsigned long long) s->edges_lost);
+    printf("irqs_unhandled          %llu\n", (unsigned long long) s->irqs_none);
+    printf("dma_bytes               %llu\n", (unsigned long long) s->dma_bytes);
+    printf("dma_callbacks           %llu\n", (unsigned long long) s->dma_callbacks);
+    printf("fifo_errors             %llu\n", (unsigned long long) s->fifo_errors);
+    printf("irq_cpu_us_per_sample   %.3f\n", per(s->irq_ns, samples) / 1e3);
+    printf("mmio_reads_per_sample   %.2f\n", per(s->mmio_reads, samples));
+    printf("mmio_writes_per_sample  %.2f\n", per(s->mmio_writes, samples));
+    printf("cpu_idle_pct            %.2f\n", 100.0 * per(s->idle_ns, elapsed_ns));
+}
+
+/// @brief Same document as tests/acq_bench (see bench_stats.h), with the single
+///  access pattern closest to what the reader of each mode does.
+static void report_json(u64 elapsed_ns)
+{
+    static const char *patterns[] = { "blocking", "mmap", "mmap", "burst" };
+    const struct sim_stats *s = &sim_stats;
+    double seconds = elapsed_ns / 1e9;
+    u64 samples = rd.records ? rd.records : 1;
+
+    printf("{\n  \"source\": \"sim\",\n");
+    printf("  \"label\": \"%s%s\",\n", mode_names[cfg.mode], sim_opts.dma ? " dma" : "");
+    printf("  \"device\": \"i2c_sim\",\n");
+    printf("  \"record_version\": %d,\n", MPU6050_RECORD_VERSION);
+    printf("  \"params\": { \"acq_mode\": \"%d\", \"smplrt_div\": \"%u\", \"fifo_watermark\": \"%u\"",
+        cfg.mode == MODE_BURST ? ACQUISITION_MODE_POLLED : cfg.mode, cfg.rate_div, cfg.watermark);
+    if (cfg.dma_threshold >= 0)
+        printf(", \"dma_threshold\": \"%ld\"", cfg.dma_threshold);
+    printf(" },\n  \"patterns\": [\n    {\n");
+    printf("      \"pattern\": \"%s\",\n", patterns[cfg.mode]);
+    printf("      \"seconds\": %.3f,\n", seconds);
+    printf("      \"calls\": %llu,\n", (unsigned long long) rd.calls);
+    printf("      \"samples\": %llu,\n", (unsigned long long) rd.records);
+    printf("      \"samples_per_s\": %.1f,\n", seconds > 0 ? rd.records / seconds : 0.0);
+    printf("      \"dropped\": %llu,\n", (unsigned long long) rd.lost);
+    printf("      \"duplicates\": %llu,\n", (unsigned long long) rd.repeated);
+    printf("      \"ring_dropped\": %u,\n", rd.ring_dropped);
+    printf("      \"cpu_ns_per_sample\": %.1f,\n", per(elapsed_ns - min(s->idle_ns, elapsed_ns), samples));
+    printf("      \"torn\": %llu,\n", (unsigned long long) rd.torn);
+    printf("      \"transactions_per_sample\": %.3f,\n", per(s->transactions, samples));
+    printf("      \"i2c_irqs_per_transfer\": %.3f,\n", per(i2c_irqs(), s->transactions));
+    printf("      \"bus_utilization_pct\": %.2f,\n", 100.0 * per(s->bus_busy_ns, elapsed_ns));
+    printf("      ");
+    bench_dist_json(stdout, "read_latency_ns", &rd.read_latency);
+    printf(",\n      ");
+    bench_dist_json(stdout, "sample_age_ns", &rd.age);
+    printf(",\n      ");
+    bench_dist_json(stdout, "interval_ns", &rd.interval);
+    printf("\n    }\n  ]\n}\n");
+}
+
+/******************************************************************************
+ * Main
+******************************************************************************/
+
+static void usage(const char *name)
+{
+    fprintf(stderr,
+        "usage: %s [options]\n"
+        "  -m, --mode MODE          polled, drdy (default), fifo or burst\n"
+        "  -t, --seconds S          modelled streaming time (1)\n"
+        "  -r, --rate-div N         SMPLRT_DIV: 1kHz / (1 + N) samples per second (0)\n"
+        "  -w, --watermark N        samples per drain in fifo mode (48)\n"
+        "  -p, --reader-period US   how often the reader wakes up (every sample\n"
+        "                           when polled, 10000 otherwise)\n"
+        "  -b, --burst-len N        longest read in burst mode, in bytes (448)\n"
+        "  -d, --dma                provide EDMA channels\n"
+        "  -D, --dma-threshold N    dma_threshold module parameter\n"
+        "  -n, --no-int             MPU6050 INT pin not wired\n"
+        "  -S, --sensors N          MPU6050 on the bus, at 0x68 onwards (1, up to %d)\n"
+        "  -B, --buses N            controllers, I2C2 and then I2C1 (1 or 2). The\n"
+        "                           sensors are spread over them\n"
+        "  -c, --clock-ppm N        error of the MPU6050 oscillator (0)\n"
+        "      --mmio-read-ns N     cost of a register read (%u)\n"
+        "      --mmio-write-ns N    cost of a register write (%u)\n"
+        "      --irq-ns N           interrupt entry and exit (%u)\n"
+        "      --scl-rise-ns N      SCL rise time of the buses (%u)\n"
+        "      --scl-hz N           clock-frequency of the buses (400000)\n"
+        "  -g, --glitch-every N     a slave holds SDA low after every Nth address phase (never)\n"
+        "      --nack-every N       every Nth address phase is NACKed (never)\n"
+        "      --data-nack-every N  every Nth data byte written is NACKed (never)\n"
+        "      --stretch-every N    the slave holds SCL low after every Nth address (never)\n"
+        "      --stretch-us US      ... for this long (%u)\n"
+        "  -T, --selftest           run the driver's bus self-test after probing\n"
+        "  -s, --stats              print the driver's debugfs statistics too\n"
+        "  -j, --json               print the report in tests/acq_bench's format\n"
+        "  -v, --verbose            print every driver message\n",
+        name, SIM_MPU6050_MAX, sim_opts.mmio_read_ns, sim_opts.mmio_write_ns, sim_opts.irq_entry_ns,
+        sim_opts.scl_rise_ns, sim_opts.stretch_us);
+}
+
+static int parse_args(int argc, char **argv)
+{
+    static const struct option options[] = {
+        { "mode", required_argument, NULL, 'm' },
+        { "seconds", required_argument, NULL, 't' },
+        { "rate-div", required_argument, NULL, 'r' },
+        { "watermark", required_argument, NULL, 'w' },
+        { "reader-period", required_argument, NULL, 'p' },
+        { "burst-len", required_argument, NULL, 'b' },
+        { "dma", no_argument, NULL, 'd' },
+        { "dma-threshold", required_argument, NULL, 'D' },
+        { "no-int", no_argument, NULL, 'n' },
+        { "sensors", required_argument, NULL, 'S' },
+        { "buses", required_argument, NULL, 'B' },
+        { "clock-ppm", required_argument, NULL, 'c' },
+        { "mmio-read-ns", required_argument, NULL, 1 },
+        { "mmio-write-ns", required_argument, NULL, 2 },
+        { "irq-ns", required_argument, NULL, 3 },
+        { "scl-rise-ns", required_argument, NULL, 4 },
+        { "scl-hz", required_argument, NULL, 5 },
+        { "selftest", no_argument, NULL, 'T' },
+        { "glitch-every", required_argument, NULL, 'g' },
+        { "nack-every", required_argument, NULL, 8 },
+        { "data-nack-every", required_argument, NULL, 9 },
+        { "stretch-every", required_argument, NULL, 6 },
+        { "stretch-us", required_argument, NULL, 7 },
+        { "stats", no_argument, NULL, 's' },
+        { "json", no_argument, NULL, 'j' },
+        { "verbose", no_argument, NULL, 'v' },
+        { "help", no_argument, NULL, 'h' },
+        { NULL, 0, NULL, 0 },
+    };
+    int opt, i;
+
+    while ((opt = getopt_long(argc, argv, "m:t:r:w:p:b:dD:nS:B:c:Tg:sjvh", options, NULL)) != -1) {
+        switch (opt) {
+        case 'm':
+            for (i = 0; i < (int) ARRAY_SIZE(mode_names) && strcmp(optarg, mode_names[i]) != 0; i++)
+                ;
+            if (i == (int) ARRAY_SIZE(mode_names))
+                return -1;
+            cfg.mode = i;
+            break;
+        case 't': cfg.seconds = atof(optarg); break;
+        case 'r': cfg.rate_div = atoi(optarg); break;
+        case 'w': cfg.watermark = atoi(optarg); break;
+        case 'p': cfg.reader_period_us = atoi(optarg); break;
+        case 'b': cfg.burst_len = atoi(optarg); break;
+        case 'd': sim_opts.dma = true; break;
+        case 'D': cfg.dma_threshold = atol(optarg); break;
+        case 'n': sim_opts.mpu_int = false; break;
+        case 'S': cfg.sensors = atoi(optarg); break;
+        case 'B': cfg.buses = atoi(optarg); break;
+        case 'c': sim_opts.mpu_clock_ppm = atoi(optarg); break;
+        case 1: sim_opts.mmio_read_ns = atoi(optarg); break;
+        case 2: sim_opts.mmio_write_ns = atoi(optarg); break;
+        case 3: sim_opts.irq_entry_ns = atoi(optarg); break;
+        case 4: sim_opts.scl_rise_ns = atoi(optarg); break;
+        case 5: cfg.scl_hz = atoi(optarg); break;
+        case 'T': cfg.selftest = true; break;
+        case 'g': sim_opts.glitch_every = atoi(optarg); break;
+        case 6: sim_opts.stretch_every = atoi(optarg); break;
+        case 7: sim_opts.stretch_us = atoi(optarg); break;
+        case 8: sim_opts.nack_every = atoi(optarg); break;
+        case 9: sim_opts.data_nack_every = atoi(optarg); break;
+        case 's': cfg.driver_stats = true; break;
+        case 'j': cfg.json = true; break;
+        case 'v': sim_opts.verbose = 1; break;
+        default: return -1;
+        }
+    }
+    if (cfg.rate_div > 255 || cfg.burst_len < MPU6050_MOTION7_LENGTH ||
+            cfg.sensors == 0 || cfg.sensors > SIM_MPU6050_MAX || cfg.buses == 0 || cfg.buses > SIM_BUSES_MAX)
+        return -1;
+    if (cfg.reader_period_us == 0)
+        cfg.reader_period_us = (cfg.mode == MODE_POLLED) ? 1000 * (1 + cfg.rate_div) : 10000;
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    struct sim_stats probe;
+    struct device_node *node, **last;
+    u64 start_ns, probe_ns;
+    unsigned int n, b, slot, slots;
+    char path[64];
+    int retval;
+
+    if (parse_args(argc, argv) != 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    // What insmod would pass
+    sim_param_set("smplrt_div", cfg.rate_div);
+    sim_param_set("acq_mode", cfg.mode == MODE_BURST ? ACQUISITION_MODE_POLLED : cfg.mode);
+    sim_param_set("fifo_watermark", cfg.watermark);
+    if (cfg.dma_threshold >= 0)
+        sim_param_set("dma_threshold", cfg.dma_threshold);
+
+    // Sensor n goes to bus n % buses, at 0x68 onwards on each bus
+    for (b = 0; b < cfg.buses; b++) {
+        am335x_i2c_reset(buses[b].controller);
+        buses[b].pdev.dev = (struct device) { .parent = &target_module, .of_node = &buses[b].node };
+        buses[b].pdev.resource = &buses[b].res;
+        buses[b].node.clock_frequency = cfg.scl_hz;
+        last = &buses[b].node.child;
+        for (n = b; n < cfg.sensors; n += cfg.buses) {
+            sensors[n].bus = b;
+            mpu6050_model_reset(n, 0x68 + n / cfg.buses);
+            am335x_i2c_attach(buses[b].controller, mpu6050_model_target(n));
+            mpu_nodes[n] = (struct device_node) {
+                .compatible = MPU6050_COMPATIBLE,
+                .reg = 0x68 + n / cfg.buses,
+                .irq = sim_opts.mpu_int ? SIM_IRQ_MPU6050 + n : 0,
+            };
+            *last = &mpu_nodes[n];
+            last = &mpu_nodes[n].sibling;
+        }
+    }
+
+    // Same order as lkm_init() and i2c_probe(), once per bus
+    i2c_debugfs_init();
+    for (b = 0; b < cfg.buses; b++) {
+        if ((retval = i2c_init(&buses[b].i2c, &buses[b].pdev)) != 0) {
+            fprintf(stderr, "i2c_init(I2C%u) failed: %d\n", buses[b].controller, retval);
+            return 1;
+        }
+        slots = (cfg.sensors - b + cfg.buses - 1) / cfg.buses;
+        slot = 0;
+        n = b;
+        for_each_available_child_of_node(&buses[b].node, node) {
+            if ((retval = MPU6050_init(&sensors[n].mpu, &buses[b].i2c, node->reg)) != 0) {
+                fprintf(stderr, "MPU6050_init(0x%02x) failed: %d\n", node->reg, retval);
+                return 1;
+            }
+            if ((retval = acquisition_init(&sensors[n].acq, &sensors[n].mpu, node, &buses[b].pdev.dev,
+                    slot, slots)) != 0) {
+                fprintf(stderr, "acquisition_init(0x%02x) failed: %d\n", node->reg, retval);
+                return 1;
+            }
+            slot++;
+            n += cfg.buses;
+        }
+    }
+    if (cfg.mode != MODE_BURST && cfg.mode != MODE_POLLED && !acquisition_is_streaming(&sensors[0].acq))
+        cfg.mode = MODE_POLLED;
+    probe_ns = sim_now_ns;
+    probe = sim_stats;
+
+    // Bursts of the sensor registers at 0x68, back to back, before streaming
+    for (b = 0; b < cfg.buses && cfg.selftest; b++) {
+        snprintf(path, sizeof(path), DRIVER_NAME "/%s/selftest", buses[b].i2c.name);
+        if ((retval = sim_debugfs_write(path, "0x68\n")) != 0) {
+            fprintf(stderr, "%s failed: %d\n", path, retval);
+            return 1;
+        }
+        printf("# %s\n", path);
+        sim_debugfs_read(path, stdout);
+        printf("\n");
+        if ((retval = check_xfer(b)) != 0) {
+            fprintf(stderr, "i2c_xfer(%s) failed: %d\n", buses[b].i2c.name, retval);
+            return 1;
+        }
+    }
+
+    // The driver's statistics, like the simulator's, cover the streaming only
+    sim_reset_stats();
+    for (b = 0; b < cfg.buses; b++) {
+        snprintf(path, sizeof(path), DRIVER_NAME "/%s/reset", buses[b].i2c.name);
+        sim_debugfs_write(path, "1\n");
+    }
+    start_ns = sim_now_ns;
+    switch (cfg.mode) {
+    case MODE_POLLED: run_polled(start_ns + cfg.seconds * 1e9); break;
+    case MODE_BURST: run_burst(start_ns + cfg.seconds * 1e9); break;
+    default: run_ring(start_ns + cfg.seconds * 1e9); break;
+    }
+    if (cfg.json)
+        report_json(sim_now_ns - start_ns);
+    else
+        report(sim_now_ns - start_ns, probe_ns, &probe);
+    for (b = 0; b < cfg.buses && cfg.driver_stats && !cfg.json; b++) {
+        snprintf(path, sizeof(path), DRIVER_NAME "/%s/stats", buses[b].i2c.name);
+        printf("\n# %s\n", path);
+        sim_debugfs_read(path, stdout);
+    }
+
+    for (n = cfg.sensors; n-- > 0; ) {
+        acquisition_deinit(&sensors[n].acq);
+        MPU6050_deinit(&sensors[n].mpu);
+        acquisition_free(&sensors[n].acq);
+    }
+    for (b = cfg.buses; b-- > 0; )
+        i2c_deinit(&buses[b].i2c);
+    i2c_debugfs_deinit();
+
+    return (rd.torn != 0 || rd.repeated != 0 || rd.errors != 0 || sim_stats.fifo_errors != 0) ? 1 : 0;
+}